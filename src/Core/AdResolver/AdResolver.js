@@ -16,7 +16,7 @@
 // AdResolver module implementation.
 
 // Inform linters of our namespaces:
-/*global PLAYER_SEQUENCER_TEST_LIBRARY, DOMParser, Text, Document, Element, Attr, CDATASection */
+/*global PLAYER_SEQUENCER_TEST_LIBRARY, Text, Document, Element */
 
 //
 // The namespace object
@@ -48,13 +48,12 @@ PLAYER_SEQUENCER.AdResolverError.prototype.constructor = PLAYER_SEQUENCER.AdReso
 // Note: The purpose of this pool is to provide a unique mapping of id numbers to adResolverEntry
 //       objects which allows holding references to objects through the JSON thunk.
 //       Therefore, the pool can be a Singleton since the objects are independent.
+//       The ids come from a generational slab pool, so ids of released entries are never valid again.
 //
 PLAYER_SEQUENCER.theAdResolverEntryPool = (function () {
 "use strict";
 
-    var poolNextEntryId = 1,          // start with 1 so id is always truthy
-        poolBaseId = poolNextEntryId, // the segmentId of the zeroth pool element
-        pool = [],
+    var pool = PLAYER_SEQUENCER.createSlabPool(PLAYER_SEQUENCER.AdResolverError),
     
     // private methods
     throwSetterInhibited = function ( value ) {
@@ -62,51 +61,46 @@ PLAYER_SEQUENCER.theAdResolverEntryPool = (function () {
     };
 
     return {
-        createEntry: function (aParsedDocument) {
+        createEntry: function (anAdModel, aCacheKey) {
             ///<summary>Create a new AdResolverEntry object</summary>
-            ///<param name="aParsedDocument" type="Object">A reference to a DOM document object</param>
+            ///<param name="anAdModel" type="Object">A reference to the AdModelNode at the root of the ad model</param>
+            ///<param name="aCacheKey" type="String" mayBeNull="true">The theAdModelCache key if the model was acquired from the cache, released with the entry</param>
             ///<returns type="Number">The idNumber of the AdResolver entry created</param>
-            var myIdNumber = poolNextEntryId,
-                myParsedDocument = aParsedDocument,
+            var myIdNumber,
+                myAdModel = anAdModel,
+                myCacheKey = aCacheKey || null,
                 adResolverEntry;
 
-            poolNextEntryId += 1;
-
             // DEFINITION of a AdResolverEntry:
             adResolverEntry = {
                 /// <field name="idNumber" type="Number">unique id number of the AdResolver entry</field>
                 get idNumber() { return myIdNumber; },
                 set idNumber(value) { throwSetterInhibited(value); },
-                /// <field name="parsedDocument" type="Object">reference to a parsed XML document object</field>
-                get parsedDocument() { return myParsedDocument; },
-                set parsedDocument(value) { 
-                    if (myParsedDocument) {
+                /// <field name="adModel" type="Object">reference to the AdModelNode at the root of the ad model</field>
+                get adModel() { return myAdModel; },
+                set adModel(value) { 
+                    if (myAdModel) {
                         throwSetterInhibited(value); 
                     } else {
-                        myParsedDocument = value;
+                        myAdModel = value;
                     }
-                }
+                },
+                /// <field name="cacheKey" type="String" mayBeNull="true">theAdModelCache key of the ad model, null if not cached</field>
+                get cacheKey() { return myCacheKey; },
+                set cacheKey(value) { throwSetterInhibited(value); }
             };
-            pool[myIdNumber - poolBaseId] = adResolverEntry;
+            myIdNumber = pool.insert(adResolverEntry);
             return adResolverEntry;
         },
 
         releaseEntry: function (idNumber) {
             ///<summary>Release the entry pool reference to the AdResolver entry object so it can be GCed</summary>
             ///<param name="idNumber" type="Number">The idNumber of the AdResolver entry to be released from the pool</param>
-            if (pool[idNumber - poolBaseId] === undefined) {
-                throw new PLAYER_SEQUENCER.AdResolverError('invalid releaseEntry Id: ' + idNumber.toString());
-            }
-            if (idNumber === poolBaseId) {
-                do {
-                    // shift out all contiguous released items starting at the base Id
-                    pool.shift();
-                    poolBaseId += 1;
-                } while (pool.length > 0 && pool[0] === null); 
-            }
-            else {
-                // just release the Id and it will be shifted out once all those before it have been released
-                pool[idNumber - poolBaseId] = null;
+            var cacheKey = pool.get(idNumber, 'releaseEntry').cacheKey;
+
+            pool.release(idNumber, 'releaseEntry');
+            if (cacheKey) {
+                PLAYER_SEQUENCER.theAdModelCache.release(cacheKey);
             }
         },
 
@@ -114,25 +108,412 @@ PLAYER_SEQUENCER.theAdResolverEntryPool = (function () {
             ///<summary>Get a a reference to the AdResolver entry object with the given idNumber</summary>
             ///<param name="idNumber" type="Number">The id number of the AdResolver entry to be referenced</param>
             ///<returns type="Object">adResolverEntry object reference</returns>
-            var entry = pool[idNumber - poolBaseId], 
-                ex;
-            if (!entry) {
-                ex = new PLAYER_SEQUENCER.AdResolverError('invalid getEntryFromId Id: ' + idNumber.toString());
-                throw ex;
-            }
-            return entry;
+            return pool.get(idNumber, 'getEntryFromId');
+        },
+
+        getStatistics: function () {
+            ///<summary>Get the occupancy and high-water mark counters of the AdResolver entry pool</summary>
+            ///<returns type="Object">See createSlabPool getStatistics</returns>
+            return pool.getStatistics();
+        },
+
+        getLeakReport: function () {
+            ///<summary>List the AdResolver entries that have not been released, oldest first</summary>
+            ///<returns type="Array">See createSlabPool getLeakReport</returns>
+            return pool.getLeakReport();
         },
 
         testProbe_toJSON: function () {
             ///<summary>For testing purposes, return JSON string of the entire AdResolver entry pool</summary>
-            ///<returns type="String">JSON of the entire playbackSegment pool</returns>
-            return '{' + JSON.stringify(pool) + ',"poolBaseId":' + poolBaseId.toString() + ',"poolNextEntryId":' + poolNextEntryId.toString() + '}';
+            ///<returns type="String">JSON of the entire AdResolver entry pool</returns>
+            return JSON.stringify(pool);
+        },
+
+        testProbe_reset: function () {
+            ///<summary>For testing purposes, reset the entire AdResolver entry pool and the ad model cache it references</summary>
+            pool.releaseAll();
+            PLAYER_SEQUENCER.theAdModelCache.testProbe_reset();
+        }
+    };
+}());
+
+
+// -------------------------
+// The Ad model parser
+// -------------------------
+// Note: The purpose of this parser is to build the compact ad model held by the AdResolver entries
+//       instead of a DOM document. The XML string is scanned once, SAX style, and every element becomes
+//       an AdModelNode which keeps only what theAdResolver accessors read: the local name, the attributes,
+//       the child elements (also indexed by local name), the first CDATA section and the text value.
+//       Comments, processing instructions and DOCTYPE are skipped and line endings are normalized to '\n'
+//       as an XML parser does. Like DOMParser, a document which is not well formed gives a model with a
+//       single <parsererror> element, so the path checks of the create functions fail.
+//
+PLAYER_SEQUENCER.AdModelNode = function (name, attrs) {
+    ///<summary>Constructor for an element (or the document) of the ad model.</summary>
+    ///<param name="name" type="String">The element localName, '#document' for the root</param>
+    ///<param name="attrs" type="Array">The attributes as [nodeName, nodeValue, nodeName, nodeValue, ...]</param>
+    ///<returns type="Object">A new AdModelNode object instance.</returns>
+    "use strict";
+    /// <field name="name" type="String">the element localName</field>
+    this.name = name;
+    /// <field name="attrs" type="Array">the attributes as nodeName, nodeValue pairs in document order</field>
+    this.attrs = attrs;
+    /// <field name="children" type="Array">the child element nodes in document order</field>
+    this.children = PLAYER_SEQUENCER.AdModelNode.noChildren;
+    /// <field name="childrenByName" type="Object" mayBeNull="true">the child element nodes by localName</field>
+    this.childrenByName = null;
+    /// <field name="cdata" type="String" mayBeNull="true">the value of the first CDATA section, undefined if none</field>
+    this.cdata = undefined;
+    /// <field name="textValue" type="String" mayBeNull="true">the value of the leading text when there is text other than a single newline, else undefined</field>
+    this.textValue = undefined;
+};
+PLAYER_SEQUENCER.AdModelNode.noChildren = [];
+
+PLAYER_SEQUENCER.theAdModelParser = (function () {
+"use strict";
+
+    var entities = { lt: '<', gt: '>', amp: '&', quot: '"', apos: "'" },
+        noAttrs = [],
+
+    // private methods
+    decodeEntities = function (text) {
+        if (text.indexOf('&') < 0) {
+            return text;
+        }
+        return text.replace(/&(#x[0-9a-fA-F]+|#[0-9]+|[a-zA-Z]+);/g, function (match, name) {
+            if (name.charAt(0) === '#') {
+                return String.fromCharCode(name.charAt(1) === 'x' ? parseInt(name.substring(2), 16) : parseInt(name.substring(1), 10));
+            }
+            return entities.hasOwnProperty(name) ? entities[name] : match;
+        });
+    },
+
+    // The parse events. The open elements are kept in a stack of frames that also track the leading text
+    // until the element ends, so the nodes themselves only keep the final values.
+
+    startElement = function (frames, localName, attrs) {
+        var parentNode = frames[frames.length - 1].node,
+            node = new PLAYER_SEQUENCER.AdModelNode(localName, attrs);
+
+        frames[frames.length - 1].hasChild = true;
+        if (parentNode.children === PLAYER_SEQUENCER.AdModelNode.noChildren) {
+            parentNode.children = [];
+            parentNode.childrenByName = Object.create(null);
+        }
+        parentNode.children.push(node);
+        if (parentNode.childrenByName[localName]) {
+            parentNode.childrenByName[localName].push(node);
+        } else {
+            parentNode.childrenByName[localName] = [node];
+        }
+        frames.push({ node: node, hasChild: false, leadingText: undefined, hasText: false });
+    },
+
+    endElement = function (frames) {
+        var frame = frames.pop();
+
+        if (frame.hasText) {
+            frame.node.textValue = frame.leadingText;
+        }
+    },
+
+    addText = function (frames, text) {
+        var frame = frames[frames.length - 1];
+
+        if (!frame.hasChild) {
+            frame.hasChild = true;
+            frame.leadingText = text;
+        }
+        if (text !== '\n') {
+            frame.hasText = true;
+        }
+    },
+
+    addCDATA = function (frames, text) {
+        var frame = frames[frames.length - 1];
+
+        frame.hasChild = true;
+        if (frame.node.cdata === undefined) {
+            frame.node.cdata = text;
+        }
+    },
+
+    createErrorModel = function (message) {
+        var frames = [{ node: new PLAYER_SEQUENCER.AdModelNode('#document', noAttrs) }];
+
+        startElement(frames, 'parsererror', noAttrs);
+        addText(frames, message);
+        endElement(frames);
+        return frames[0].node;
+    },
+
+    addDocNodeChildren = function (frames, docNode) {
+        var childIndex,
+            attrIndex,
+            docNodeChild,
+            attrs;
+
+        for (childIndex = 0; childIndex < docNode.childNodes.length; childIndex += 1) {
+            docNodeChild = docNode.childNodes[childIndex];
+            if (Element.prototype.isPrototypeOf(docNodeChild)) {
+                attrs = noAttrs;
+                if (docNodeChild.attributes && docNodeChild.attributes.length > 0) {
+                    attrs = [];
+                    for (attrIndex = 0; attrIndex < docNodeChild.attributes.length; attrIndex += 1) {
+                        attrs.push(docNodeChild.attributes[attrIndex].nodeName, docNodeChild.attributes[attrIndex].nodeValue);
+                    }
+                }
+                startElement(frames, docNodeChild.localName, attrs);
+                addDocNodeChildren(frames, docNodeChild);
+                endElement(frames);
+            }
+            else if (frames.length > 1 && docNodeChild.nodeName === '#cdata-section') {
+                addCDATA(frames, docNodeChild.nodeValue);
+            }
+            else if (frames.length > 1 && Text.prototype.isPrototypeOf(docNodeChild)) {
+                addText(frames, docNodeChild.nodeValue);
+            }
+        }
+    };
+
+    return {
+        parseFromString: function (xmlString) {
+            ///<summary>Build the ad model of an XML string in a single pass.</summary>
+            ///<param name="xmlString" type="String">The VAST or VMAP manifest</param>
+            ///<returns type="Object">The AdModelNode of the document</returns>
+            var text = String(xmlString).replace(/\r\n?/g, '\n'),
+                frames = [{ node: new PLAYER_SEQUENCER.AdModelNode('#document', noAttrs) }],
+                qualifiedNames = [],
+                markupPattern = /<!\[CDATA\[([\s\S]*?)\]\]>|<!--[\s\S]*?-->|<\?[\s\S]*?\?>|<!DOCTYPE[^>]*>|<\/([^\s>]+)\s*>|<([^\s\/>]+)((?:\s+[^\s=\/>]+\s*=\s*(?:"[^"]*"|'[^']*'))*)\s*(\/?)>|([^<]+)|</g,
+                attrPattern = /([^\s=\/>]+)\s*=\s*(?:"([^"]*)"|'([^']*)')/g,
+                match,
+                attrMatch,
+                attrs;
+
+            while ((match = markupPattern.exec(text)) !== null) {
+                if (match[1] !== undefined) {
+                    // CDATA outside of the document element is ignored like text
+                    if (frames.length > 1) {
+                        addCDATA(frames, match[1]);
+                    }
+                }
+                else if (match[2] !== undefined) {
+                    if (qualifiedNames.length === 0 || qualifiedNames[qualifiedNames.length - 1] !== match[2]) {
+                        return createErrorModel('mismatched end tag ' + match[2]);
+                    }
+                    qualifiedNames.pop();
+                    endElement(frames);
+                }
+                else if (match[3] !== undefined) {
+                    attrs = noAttrs;
+                    if (match[4]) {
+                        attrs = [];
+                        attrPattern.lastIndex = 0;
+                        while ((attrMatch = attrPattern.exec(match[4])) !== null) {
+                            attrs.push(attrMatch[1], decodeEntities(attrMatch[2] !== undefined ? attrMatch[2] : attrMatch[3]));
+                        }
+                    }
+                    startElement(frames, match[3].substring(match[3].indexOf(':') + 1), attrs);
+                    if (match[5] === '/') {
+                        endElement(frames);
+                    } else {
+                        qualifiedNames.push(match[3]);
+                    }
+                }
+                else if (match[6] !== undefined) {
+                    // text outside of the document element is ignored like whitespace
+                    if (frames.length > 1) {
+                        addText(frames, decodeEntities(match[6]));
+                    }
+                }
+                else if (match[0] === '<') {
+                    return createErrorModel('invalid markup at ' + String(match.index));
+                }
+                // comments, processing instructions and DOCTYPE are skipped
+            }
+
+            if (qualifiedNames.length > 0) {
+                return createErrorModel('unclosed element ' + qualifiedNames[qualifiedNames.length - 1]);
+            }
+            return frames[0].node;
+        },
+
+        fromDocNode: function (docNode) {
+            ///<summary>Build the ad model of a DOM Document or Element, for callers which already have one.</summary>
+            ///<param name="docNode" type="Object">The DOM Document, or the Element whose children are the top level elements</param>
+            ///<returns type="Object">The AdModelNode of the document</returns>
+            var frames = [{ node: new PLAYER_SEQUENCER.AdModelNode('#document', noAttrs) }];
+
+            addDocNodeChildren(frames, docNode);
+            return frames[0].node;
+        }
+    };
+}());
+
+
+// -------------------------
+// The Ad model cache
+// -------------------------
+// Note: The purpose of this cache is to parse a manifest only once when the ad server returns the same
+//       document for several breaks, e.g. sponsor bumpers and house ads. Models are keyed by a hash of
+//       the manifest text, so entries created from identical manifests share one read only model.
+//       A model is referenced by every AdResolver entry using it and only unreferenced models are evicted,
+//       least recently used first, when the estimated size of the cached models exceeds the budget.
+//       The size of a model is estimated as two bytes per manifest character.
+//
+PLAYER_SEQUENCER.theAdModelCache = (function () {
+"use strict";
+
+    var records = {},
+        // the unreferenced records form a list from least to most recently used
+        lruHead = null,
+        lruTail = null,
+        recordCount = 0,
+        totalBytes = 0,
+        maxBytes = 4 * 1024 * 1024,
+        hitCount = 0,
+        missCount = 0,
+        evictionCount = 0,
+
+    // private methods
+    keyFromManifest = function (manifest) {
+        // FNV-1a and djb2 hashes together with the length make collisions of different manifests negligible.
+        var fnvHash = 0x811c9dc5,
+            djbHash = 5381,
+            charCode,
+            i;
+
+        for (i = 0; i < manifest.length; i += 1) {
+            charCode = manifest.charCodeAt(i);
+            fnvHash ^= charCode;
+            // fnvHash *= 16777619 without losing precision:
+            fnvHash = (fnvHash + (fnvHash << 1) + (fnvHash << 4) + (fnvHash << 7) + (fnvHash << 8) + (fnvHash << 24)) >>> 0;
+            djbHash = ((djbHash << 5) + djbHash + charCode) | 0;
+        }
+        return manifest.length.toString(36) + '.' + fnvHash.toString(36) + '.' + (djbHash >>> 0).toString(36);
+    },
+
+    unlinkRecord = function (record) {
+        if (record.lruPrev) {
+            record.lruPrev.lruNext = record.lruNext;
+        } else {
+            lruHead = record.lruNext;
+        }
+        if (record.lruNext) {
+            record.lruNext.lruPrev = record.lruPrev;
+        } else {
+            lruTail = record.lruPrev;
+        }
+        record.lruPrev = null;
+        record.lruNext = null;
+    },
+
+    appendRecord = function (record) {
+        record.lruPrev = lruTail;
+        record.lruNext = null;
+        if (lruTail) {
+            lruTail.lruNext = record;
+        } else {
+            lruHead = record;
+        }
+        lruTail = record;
+    },
+
+    evictUnreferenced = function () {
+        var record;
+
+        while (totalBytes > maxBytes && lruHead) {
+            record = lruHead;
+            unlinkRecord(record);
+            delete records[record.key];
+            recordCount -= 1;
+            totalBytes -= record.bytes;
+            evictionCount += 1;
+        }
+    };
+
+    return {
+        acquire: function (manifest, parseFunc) {
+            ///<summary>Get the model of a manifest, parsing it only if it is not cached, and add a reference to it</summary>
+            ///<param name="manifest" type="String">The manifest as an XML string</param>
+            ///<param name="parseFunc" type="Function">Called with the manifest to build the model on a cache miss</param>
+            ///<returns type="Object">An object with properties: key (to pass to release) and model (the AdModelNode)</returns>
+            var key = keyFromManifest(manifest),
+                record = records[key];
+
+            if (record) {
+                hitCount += 1;
+                if (record.refCount === 0) {
+                    unlinkRecord(record);
+                }
+            } else {
+                missCount += 1;
+                record = { key: key, model: parseFunc(manifest), bytes: 2 * manifest.length, refCount: 0, lruPrev: null, lruNext: null };
+                records[key] = record;
+                recordCount += 1;
+                totalBytes += record.bytes;
+                evictUnreferenced();
+            }
+            record.refCount += 1;
+            return { key: key, model: record.model };
+        },
+
+        release: function (key) {
+            ///<summary>Remove a reference to a cached model obtained from acquire</summary>
+            ///<param name="key" type="String">The key returned by acquire</param>
+            var record = records[key];
+
+            if (!record || record.refCount === 0) {
+                throw new PLAYER_SEQUENCER.AdResolverError('theAdModelCache.release: no reference to release for key ' + key);
+            }
+            record.refCount -= 1;
+            if (record.refCount === 0) {
+                appendRecord(record);
+                evictUnreferenced();
+            }
+        },
+
+        setBudget: function (aMaxBytes) {
+            ///<summary>Set the memory budget of the cache and evict unreferenced models exceeding it</summary>
+            ///<param name="aMaxBytes" type="Number">The budget in estimated bytes, 0 to keep only referenced models</param>
+            if (typeof aMaxBytes !== 'number' || !(aMaxBytes >= 0)) {
+                throw new PLAYER_SEQUENCER.AdResolverError('theAdModelCache.setBudget: invalid budget ' + String(aMaxBytes));
+            }
+            maxBytes = aMaxBytes;
+            evictUnreferenced();
+        },
+
+        getStatistics: function () {
+            ///<summary>Get the counters of the cache for tuning the budget</summary>
+            ///<returns type="Object">An object with properties: hits, misses, evictions (totals so far), models (models cached), referencedModels (models used by entries), bytes (estimated size of the models cached) and maxBytes (the budget)</returns>
+            var referencedCount = recordCount,
+                record;
+
+            for (record = lruHead; record; record = record.lruNext) {
+                referencedCount -= 1;
+            }
+            return {
+                hits: hitCount,
+                misses: missCount,
+                evictions: evictionCount,
+                models: recordCount,
+                referencedModels: referencedCount,
+                bytes: totalBytes,
+                maxBytes: maxBytes
+            };
         },
 
         testProbe_reset: function () {
-            ///<summary>For testing purposes, reset the entire AdResolver entry pool</summary>
-            pool = [];
-            poolBaseId = poolNextEntryId; // the segmentId of the zeroth pool element
+            ///<summary>For testing purposes, drop all cached models and reset the counters</summary>
+            records = {};
+            lruHead = null;
+            lruTail = null;
+            recordCount = 0;
+            totalBytes = 0;
+            hitCount = 0;
+            missCount = 0;
+            evictionCount = 0;
         }
     };
 }());
@@ -143,11 +524,13 @@ PLAYER_SEQUENCER.theAdResolverEntryPool = (function () {
 // -------------------------
 // Note: The purpose of this object is to provide an API for AdResolver XML documents.
 //       This can be a singleton since the objects are independent.
+//       The accessors read the compact ad model built by theAdModelParser when the entry is created.
 //
 PLAYER_SEQUENCER.theAdResolver = (function () {
 "use strict";
     // private variables
-    var myDOMParser = new DOMParser(),
+    var myAdModelParser = PLAYER_SEQUENCER.theAdModelParser,
+        myAdModelCache = PLAYER_SEQUENCER.theAdModelCache,
         myAdResolverEntryPool = PLAYER_SEQUENCER.theAdResolverEntryPool,
 
     // private methods
@@ -156,166 +539,210 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
     //       instead of the "nodeName" (fully qualified) since the namespace identifier is arbitrary.
     //       The fully qualified name for attributes is always given in the results list.
 
-    myDocNodeFromElementPath = function(parsedDocument, eltPathNameArray) {
-        ///<summary>Walk the parsedDocument tree following the path of elements provided in eltPathNameArray and return the document node found.</summary>
+    myModelNodeFromElementPath = function(adModel, eltPathNameArray) {
+        ///<summary>Walk the ad model following the path of elements provided in eltPathNameArray and return the model node found.</summary>
         ///<param name="eltPathNameArray" type="Array">Array of strings containing eltName:index where eltName is element name (or "*"" for wildcard) and index is the ordinal of the Element child</param>
-        ///<returns type="Object">A reference to the node in the document</returns>
+        ///<returns type="Object">A reference to the AdModelNode</returns>
         var paramIx,
-            currentDocNode = parsedDocument,
+            currentModelNode = adModel,
             currentPathElt,
-            nodeIx,
-            nodeCount;
+            candidates,
+            ordinal;
 
         for (paramIx = 0; paramIx < eltPathNameArray.length; paramIx += 1) {
             currentPathElt = eltPathNameArray[paramIx].split(':');
-            nodeCount = currentDocNode.childNodes.length;
-            for (nodeIx = 0; nodeIx < nodeCount; nodeIx += 1) {
-                if (Element.prototype.isPrototypeOf(currentDocNode.childNodes[nodeIx]) && 
-                    ( currentPathElt[0] === '*' || currentPathElt[0] === currentDocNode.childNodes[nodeIx].localName)) {
-                    if (currentPathElt.length === 1 || currentPathElt[1] < 1) {
-                        currentDocNode = currentDocNode.childNodes[nodeIx];
-                        break;
-                    }
-                    if (currentPathElt.length > 1) {
-                        currentPathElt[1] -= 1;
-                    }
-                }
+            if (currentPathElt[0] === '*') {
+                candidates = currentModelNode.children;
+            } else {
+                candidates = currentModelNode.childrenByName && currentModelNode.childrenByName[currentPathElt[0]];
             }
-            if (nodeIx === nodeCount) {
+            // a missing, negative or fractional ordinal selects like the count down of the DOM walk did
+            ordinal = currentPathElt.length === 1 ? 0 : Math.max(0, Math.floor(Number(currentPathElt[1])));
+            currentModelNode = candidates && candidates[ordinal];
+            if (!currentModelNode) {
                 throw new PLAYER_SEQUENCER.AdResolverError("Failed to find path " + JSON.stringify(eltPathNameArray));
             }
         }
 
-        return currentDocNode;
+        return currentModelNode;
+    },
+
+    myAttrsObjectFromModelNode = function(modelNode) {
+        ///<summary>Create the attributes object of a model node.</summary>
+        ///<param name="modelNode" type="Object">AdModelNode to use</param>
+        ///<returns type="Object" mayBeNull="true">Object of attribute name:value pairs, undefined if the node has no attributes</returns>
+        var attrsObj,
+            attrIndex;
+
+        if (modelNode.attrs.length === 0) {
+            return undefined;
+        }
+        attrsObj = {};
+        for (attrIndex = 0; attrIndex < modelNode.attrs.length; attrIndex += 2) {
+            attrsObj[modelNode.attrs[attrIndex]] = modelNode.attrs[attrIndex + 1];
+        }
+        return attrsObj;
+    },
+
+    myChildModelNodes = function(modelNode, eltName) {
+        ///<summary>Get the child elements with the given name.</summary>
+        ///<param name="modelNode" type="Object">AdModelNode to use</param>
+        ///<param name="eltName" type="String">Element name</param>
+        ///<returns type="Array">The child AdModelNodes in document order, empty if none</returns>
+        return (modelNode.childrenByName && modelNode.childrenByName[eltName]) || PLAYER_SEQUENCER.AdModelNode.noChildren;
     },
 
-    myArrayFromDocNode = function(docNode, nodeNameFilter) {
+    myArrayFromModelNode = function(modelNode, nodeNameFilter) {
         ///<summary>Create object from next level elements and their attributes.</summary>
-        ///<param name="docNode" type="Object">document sub-node to use</param>
+        ///<param name="modelNode" type="Object">AdModelNode to use</param>
         ///<param name="nodeNameFilter" type="String">Element name filter</param>
         ///<returns type="Array">Array of Element 'name', 'value' and 'attrs' properties</returns>
         var result = [],
-            docChildIndex,
-            contentIndex,
+            eltNodes = nodeNameFilter ? myChildModelNodes(modelNode, nodeNameFilter) : modelNode.children,
+            eltIndex,
+            childIndex,
             eltNode,
             childEltNames,
             resultObj;
 
-        for (docChildIndex = 0; docChildIndex < docNode.childNodes.length; docChildIndex += 1) {
-            eltNode = docNode.childNodes[docChildIndex];
-            if (Element.prototype.isPrototypeOf(eltNode) && (!nodeNameFilter || eltNode.localName === nodeNameFilter)) {
+        for (eltIndex = 0; eltIndex < eltNodes.length; eltIndex += 1) {
+            eltNode = eltNodes[eltIndex];
+            if (nodeNameFilter) {
+                resultObj = {};
+            } else {
+                resultObj = { name: eltNode.name };
+            }
+            // CDATA text
+            if (eltNode.cdata !== undefined) {
+                resultObj.value = eltNode.cdata;
+            }
+            // If contained elements just give count
+            else if (eltNode.children.length > 0) {
                 if (nodeNameFilter) {
-                    resultObj = {};
-                } else {
-                    resultObj = { name: eltNode.localName };
-                }
-                // CDATA text
-                for (contentIndex = 0; contentIndex < eltNode.childNodes.length; contentIndex += 1) {
-                    if (eltNode.childNodes[contentIndex].nodeName === "#cdata-section") {
-                        resultObj.value = eltNode.childNodes[contentIndex].nodeValue;
-                        break;
-                    }
-                }
-                // If no CDATA
-                if (contentIndex === eltNode.childNodes.length) {
-                    // Count the number of contained elements
                     childEltNames = [];
-                    for (contentIndex = 0; contentIndex < eltNode.childNodes.length; contentIndex += 1) {
-                        if (Element.prototype.isPrototypeOf(eltNode.childNodes[contentIndex])) {
-                            childEltNames.push(eltNode.childNodes[contentIndex].localName);
-                        }
-                    }
-                    // If contained elements just give count
-                    if (childEltNames.length > 0) {
-                        if (nodeNameFilter) {
-                            resultObj.elements = childEltNames;
-                        } else {
-                            resultObj.elements = childEltNames.length;
-                        }
-                    } else {
-                        // give value of first Text element that is not just a newline
-                        // for now only newline is ignored. We may consider to ignore all the white spaces in the future.
-                        for (contentIndex = 0; contentIndex < eltNode.childNodes.length; contentIndex += 1) {
-                            if (Text.prototype.isPrototypeOf(eltNode.childNodes[contentIndex])) {
-                                if (eltNode.childNodes[contentIndex].nodeValue !== '\n') {
-                                    resultObj.value = eltNode.firstChild.nodeValue;
-                                    break;
-                                }                            
-                            }
-                        }
-                    }
-                }
-                // attributes
-                if (eltNode.attributes && eltNode.attributes.length > 0) {
-                    resultObj.attrs = {};
-                    for (contentIndex = 0; contentIndex < eltNode.attributes.length; contentIndex += 1) {
-                        resultObj.attrs[eltNode.attributes[contentIndex].nodeName] = eltNode.attributes[contentIndex].nodeValue;
+                    for (childIndex = 0; childIndex < eltNode.children.length; childIndex += 1) {
+                        childEltNames.push(eltNode.children[childIndex].name);
                     }
+                    resultObj.elements = childEltNames;
+                } else {
+                    resultObj.elements = eltNode.children.length;
                 }
-                result.push(resultObj);
             }
+            // else the text, if it is not just a newline
+            else if (eltNode.textValue !== undefined) {
+                resultObj.value = eltNode.textValue;
+            }
+            // attributes
+            if (eltNode.attrs.length > 0) {
+                resultObj.attrs = myAttrsObjectFromModelNode(eltNode);
+            }
+            result.push(resultObj);
         }
         return result;
     },
 
-    myArrayOfChildrenFromDocNode = function(docNode, parentName) {
+    myObjectFromParentNode = function(modelNodeParent) {
+        ///<summary>Create object from the first child element of a parent element, e.g. the InLine or Wrapper of an Ad.</summary>
+        ///<param name="modelNodeParent" type="Object">AdModelNode of the parent element</param>
+        ///<returns type="Object" mayBeNull="true">Object with type, parentAttrs, attrs and elements (with 'name', 'value' and 'attrs' properties), null if the parent has no child element</returns>
+        var nodeObj,
+            modelNodeChild = modelNodeParent.children[0],
+            childElements;
+
+        if (!modelNodeChild) {
+            return null;
+        }
+
+        nodeObj = { type: modelNodeChild.name };
+        // Parent attributes
+        if (modelNodeParent.attrs.length > 0) {
+            nodeObj.parentAttrs = myAttrsObjectFromModelNode(modelNodeParent);
+        }
+        // Child attributes
+        if (modelNodeChild.attrs.length > 0) {
+            nodeObj.attrs = myAttrsObjectFromModelNode(modelNodeChild);
+        }
+        // Child elements if any, else CDATA section if one.
+        childElements = myArrayFromModelNode(modelNodeChild);
+        if (childElements.length > 0) {
+            nodeObj.elements = childElements;
+        } else if (modelNodeChild.cdata !== undefined) {
+            nodeObj.value = modelNodeChild.cdata;
+        }
+        return nodeObj;
+    },
+
+    myArrayOfChildrenFromModelNode = function(modelNode, parentName) {
         ///<summary>Create object from next level elements and their attributes.</summary>
-        ///<param name="docNode" type="Object">document sub-node to use</param>
+        ///<param name="modelNode" type="Object">AdModelNode to use</param>
         ///<returns type="Array">Array of type, parentAttrs, and elements (with 'name', 'value' and 'attrs' properties)</returns>
-        var 
-        result = [],
+        var result = [],
+            parentNodes = myChildModelNodes(modelNode, parentName),
             nodeObj,
-            docNodeParent,
-            docNodeChild,
-            contentIndex,
-            parentIndex,
-            childIndex,
-            childElements,
-            parentOrdinal = 0;
-
-        for (parentIndex = 0; parentIndex < docNode.childNodes.length; parentIndex += 1) {
-            docNodeParent = docNode.childNodes[parentIndex];
-            if (Element.prototype.isPrototypeOf(docNodeParent) && docNodeParent.localName === parentName) {
-                for (childIndex = 0; childIndex < docNodeParent.childNodes.length; childIndex += 1) {
-                    docNodeChild = docNodeParent.childNodes[childIndex];
-                    if (Element.prototype.isPrototypeOf(docNodeChild)) {
-                        nodeObj = { type: docNodeChild.localName };
-                        // Parent attributes
-                        if (docNodeParent.attributes && docNodeParent.attributes.length > 0) {
-                            nodeObj.parentAttrs = {};
-                            for (contentIndex = 0; contentIndex < docNodeParent.attributes.length; contentIndex += 1) {
-                                nodeObj.parentAttrs[docNodeParent.attributes[contentIndex].nodeName] = docNodeParent.attributes[contentIndex].nodeValue;
-                            }
-                        }
-                        // Child attributes
-                        if (docNodeChild.attributes && docNodeChild.attributes.length > 0) {
-                            nodeObj.attrs = {};
-                            for (contentIndex = 0; contentIndex < docNodeChild.attributes.length; contentIndex += 1) {
-                                nodeObj.attrs[docNodeChild.attributes[contentIndex].nodeName] = docNodeChild.attributes[contentIndex].nodeValue;
-                            }
-                        }
-                        // Child elements if any, else CDATA section if one.
-                        childElements = myArrayFromDocNode(docNodeChild);
-                        if (childElements.length > 0) {
-                            nodeObj.elements = childElements;
-                        } else {
-                            for (contentIndex = 0; contentIndex < docNodeChild.childNodes.length; contentIndex += 1) {
-                                if (docNodeChild.childNodes[contentIndex].nodeName === "#cdata-section") {
-                                    nodeObj.value = docNodeChild.childNodes[contentIndex].nodeValue;
-                                    break;
-                                }
-                            }
-                        }
-                        result.push(nodeObj);
-                        break;
-                    }
-                }
-                parentOrdinal += 1;
+            parentIndex;
+
+        for (parentIndex = 0; parentIndex < parentNodes.length; parentIndex += 1) {
+            nodeObj = myObjectFromParentNode(parentNodes[parentIndex]);
+            if (nodeObj) {
+                result.push(nodeObj);
             }
         }
         return result;
     },
 
+    myArrayFromOptionalChild = function(modelNode, eltName, parentName) {
+        ///<summary>Create the list for a child element which may be missing.</summary>
+        ///<param name="modelNode" type="Object">AdModelNode to use</param>
+        ///<param name="eltName" type="String">Name of the child element containing the list</param>
+        ///<param name="parentName" type="String" mayBeNull="true">If given, list the children of the eltName parent elements as myArrayOfChildrenFromModelNode does, else list the elements as myArrayFromModelNode does</param>
+        ///<returns type="Array">The list, empty if there is no eltName child</returns>
+        var modelNodeChild = myChildModelNodes(modelNode, eltName)[0];
+
+        if (!modelNodeChild) {
+            return [];
+        }
+        return parentName ? myArrayOfChildrenFromModelNode(modelNodeChild, parentName) : myArrayFromModelNode(modelNodeChild);
+    },
+
+    myCreateEntryFromManifest = function(aManifest, acceptElement, funcName, requiredPath) {
+        ///<summary>Create a AdResolverEntry for the manifest given to a create function. XML strings get their model from the ad model cache.</summary>
+        ///<param name="aManifest" type="Object">An XML string, an AdModelNode, or a DOM Document (or Element if acceptElement)</param>
+        ///<param name="acceptElement" type="Boolean">true if a DOM Element may be given</param>
+        ///<param name="funcName" type="String">The create function name for the error message</param>
+        ///<param name="requiredPath" type="Array">The element path the document must contain</param>
+        ///<returns type="Number">The idNumber for the AdResolverEntry that was created. Throws AdResolverError if aManifest is not one of the accepted types or does not contain requiredPath.</returns>
+        var cached = null,
+            adModel;
+
+        if (typeof aManifest === 'string') {
+            cached = myAdModelCache.acquire(aManifest, myAdModelParser.parseFromString);
+            adModel = cached.model;
+        }
+        else if (PLAYER_SEQUENCER.AdModelNode.prototype.isPrototypeOf(aManifest)) {
+            adModel = aManifest;
+        }
+        else if (typeof Document !== 'undefined' &&
+                 (Document.prototype.isPrototypeOf(aManifest) || (acceptElement && Element.prototype.isPrototypeOf(aManifest)))) {
+            adModel = myAdModelParser.fromDocNode(aManifest);
+        }
+        else {
+            throw new PLAYER_SEQUENCER.AdResolverError(funcName + ' parameter invalid! ' + aManifest.toString());
+        }
+
+        try {
+            // myModelNodeFromElementPath throws an exception if path not found
+            myModelNodeFromElementPath(adModel, requiredPath);
+        }
+        catch (ex) {
+            if (cached) {
+                myAdModelCache.release(cached.key);
+            }
+            throw ex;
+        }
+
+        return myAdResolverEntryPool.createEntry(adModel, cached ? cached.key : null).idNumber;
+    },
+
     // ---------------------------------
     // public methods
     // ---------------------------------
@@ -326,27 +753,13 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
         vast: { // === VAST Parsed document information access ===
 
             createEntry: function (aManifest) {
-                ///<summary>Create a AdResolverEntry by parsing an XML string or using a DOM Document.</summary>
+                ///<summary>Create a AdResolverEntry by parsing an XML string into the ad model or converting a DOM Document.</summary>
                 ///<param name="aManifest" type="String">The manifest as an XML string</param>
-                ///<param name="aManifest" type="Object">The manifest as an object derived from Document</param>
+                ///<param name="aManifest" type="Object">The manifest as an object derived from Document or Element, or an AdModelNode</param>
                 ///<returns type="Number">The idNumber for the AdResolverEntry that was created. Throws AdResolverError if invalid AdResolver document.</returns>
-                var parsedDocument;
-
-                if (typeof aManifest === 'string') {
-                    parsedDocument = myDOMParser.parseFromString(aManifest, "application/xml");
-                }
-                else if (Document.prototype.isPrototypeOf(aManifest) || Element.prototype.isPrototypeOf(aManifest)) {
-                    parsedDocument = aManifest;
-                }
-                else {
-                    throw new PLAYER_SEQUENCER.AdResolverError('vast.createEntry parameter invalid! ' + aManifest.toString());
-                }
 
                 // Assert the top level element is <VAST> and it contains at least one <Ad>.
-                myDocNodeFromElementPath(parsedDocument, ['VAST', 'Ad']);
-                // myDocNodeFromElementPath throws an exception if path not found
-
-                return myAdResolverEntryPool.createEntry(parsedDocument).idNumber;
+                return myCreateEntryFromManifest(aManifest, true, 'vast.createEntry', ['VAST', 'Ad']);
             },
 
             getAdList: function (params) {
@@ -354,9 +767,9 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                 ///<param name="params" type="Object">An object with "entryId" (result of the create function)</param>
                 ///<returns type="Array">Array of objects for each 'Ad': { type: "InLine" | "Wrapper", attrs: { Ad attrs }, elements: [<childElts>] }</returns>
                 var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
-                    docNodeVAST = myDocNodeFromElementPath(entry.parsedDocument, ['VAST']);
+                    modelNodeVAST = myModelNodeFromElementPath(entry.adModel, ['VAST']);
 
-                return myArrayOfChildrenFromDocNode(docNodeVAST, 'Ad');
+                return myArrayOfChildrenFromModelNode(modelNodeVAST, 'Ad');
             },
 
             getCreativeList: function (params) {
@@ -365,9 +778,9 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                 ///<returns type="Array">Array of objects { type (Linear/Companion/NonLinear), Creative attributes }</returns>
                 var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
                     adIndex = params.adOrdinal || 0,
-                    docNodeCreatives;
+                    modelNodeCreatives;
 
-                docNodeCreatives = myDocNodeFromElementPath(entry.parsedDocument,
+                modelNodeCreatives = myModelNodeFromElementPath(entry.adModel,
                     [
                         'VAST',
                         'Ad:' + adIndex.toString(),
@@ -375,7 +788,7 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                         'Creatives'
                     ]);
 
-                return myArrayOfChildrenFromDocNode(docNodeCreatives, 'Creative');
+                return myArrayOfChildrenFromModelNode(modelNodeCreatives, 'Creative');
             },
 
             getLinearTrackingEventsList: function (params) {
@@ -385,9 +798,9 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                 var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
                     adIndex = params.adOrdinal || 0,
                     creativeIndex = params.creativeOrdinal || 0,
-                    docTrackingEvents;
+                    modelNodeTrackingEvents;
 
-                docTrackingEvents = myDocNodeFromElementPath(entry.parsedDocument,
+                modelNodeTrackingEvents = myModelNodeFromElementPath(entry.adModel,
                     [
                         'VAST',
                         'Ad:' + adIndex.toString(),
@@ -398,7 +811,7 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                         'TrackingEvents'
                     ]);
 
-                return myArrayFromDocNode(docTrackingEvents);
+                return myArrayFromModelNode(modelNodeTrackingEvents);
             },
 
             getVideoClicksList: function (params) {
@@ -408,9 +821,9 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                 var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
                     adIndex = params.adOrdinal || 0,
                     creativeIndex = params.creativeOrdinal || 0,
-                    docVideoClicks;
+                    modelNodeVideoClicks;
 
-                docVideoClicks = myDocNodeFromElementPath(entry.parsedDocument,
+                modelNodeVideoClicks = myModelNodeFromElementPath(entry.adModel,
                     [
                         'VAST',
                         'Ad:' + adIndex.toString(),
@@ -421,7 +834,7 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                         'VideoClicks'
                     ]);
 
-                return myArrayFromDocNode(docVideoClicks);
+                return myArrayFromModelNode(modelNodeVideoClicks);
             },
 
             getIconsList: function (params) {
@@ -431,9 +844,9 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                 var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
                     adIndex = params.adOrdinal || 0,
                     creativeIndex = params.creativeOrdinal || 0,
-                    docIcons;
+                    modelNodeIcons;
 
-                docIcons = myDocNodeFromElementPath(entry.parsedDocument,
+                modelNodeIcons = myModelNodeFromElementPath(entry.adModel,
                     [
                         'VAST',
                         'Ad:' + adIndex.toString(),
@@ -444,7 +857,7 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                         'Icons'
                     ]);
 
-                return myArrayOfChildrenFromDocNode(docIcons, 'Icon');
+                return myArrayOfChildrenFromModelNode(modelNodeIcons, 'Icon');
             },
 
             getMediaFileList: function (params) {
@@ -454,9 +867,9 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                 var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
                     adIndex = params.adOrdinal || 0,
                     creativeIndex = params.creativeOrdinal || 0,
-                    docNodeMediaFiles;
+                    modelNodeMediaFiles;
 
-                docNodeMediaFiles = myDocNodeFromElementPath(entry.parsedDocument,
+                modelNodeMediaFiles = myModelNodeFromElementPath(entry.adModel,
                     [
                         'VAST',
                         'Ad:' + adIndex.toString(),
@@ -467,7 +880,7 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                         'MediaFiles'
                     ]);
 
-                return myArrayFromDocNode(docNodeMediaFiles);
+                return myArrayFromModelNode(modelNodeMediaFiles);
             },
 
             getCompanionAdsList: function (params) {
@@ -477,9 +890,9 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                 var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
                     adIndex = params.adOrdinal || 0,
                     creativeIndex = params.creativeOrdinal || 0,
-                    docCompanionAds;
+                    modelNodeCompanionAds;
 
-                docCompanionAds = myDocNodeFromElementPath(entry.parsedDocument,
+                modelNodeCompanionAds = myModelNodeFromElementPath(entry.adModel,
                     [
                         'VAST',
                         'Ad:' + adIndex.toString(),
@@ -489,7 +902,7 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                         'CompanionAds'
                     ]);
 
-                return myArrayOfChildrenFromDocNode(docCompanionAds, 'Companion');
+                return myArrayOfChildrenFromModelNode(modelNodeCompanionAds, 'Companion');
             },
 
             getNonLinearAdsList: function (params) {
@@ -499,9 +912,9 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                 var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
                     adIndex = params.adOrdinal || 0,
                     creativeIndex = params.creativeOrdinal || 0,
-                    docNonLinearAds;
+                    modelNodeNonLinearAds;
 
-                docNonLinearAds = myDocNodeFromElementPath(entry.parsedDocument,
+                modelNodeNonLinearAds = myModelNodeFromElementPath(entry.adModel,
                     [
                         'VAST',
                         'Ad:' + adIndex.toString(),
@@ -511,34 +924,71 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                         'NonLinearAds'
                     ]);
 
-                return myArrayOfChildrenFromDocNode(docNonLinearAds, 'Companion');
+                return myArrayOfChildrenFromModelNode(modelNodeNonLinearAds, 'Companion');
+            },
+
+            resolveAll: function (params) {
+                ///<summary>Get the whole Ad tree in one traversal instead of calling getAdList, getCreativeList and the per creative list functions for each Ad and Creative.</summary>
+                ///<param name="params" type="Object">An object with "entryId" (result of the create function)</param>
+                ///<returns type="Array">The getAdList array where each Ad object also has a 'creatives' array of getCreativeList objects. A Linear creative has 'mediaFiles' (InLine only), 'trackingEvents', 'videoClicks' and 'icons' lists, a CompanionAds creative a 'companionAds' list and a NonLinearAds creative a 'nonLinearAds' list. Lists of missing elements are empty.</returns>
+                var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
+                    modelNodeVAST = myModelNodeFromElementPath(entry.adModel, ['VAST']),
+                    modelNodeAds = myChildModelNodes(modelNodeVAST, 'Ad'),
+                    result = [],
+                    adIndex,
+                    creativeIndex,
+                    modelNodeCreatives,
+                    modelNodeCreativeList,
+                    modelNodeCreative,
+                    modelNodeCreativeType,
+                    adObj,
+                    creativeObj;
+
+                for (adIndex = 0; adIndex < modelNodeAds.length; adIndex += 1) {
+                    adObj = myObjectFromParentNode(modelNodeAds[adIndex]);
+                    if (adObj) {
+                        adObj.creatives = [];
+                        modelNodeCreatives = myChildModelNodes(modelNodeAds[adIndex].children[0], 'Creatives')[0];
+                        modelNodeCreativeList = modelNodeCreatives ? myChildModelNodes(modelNodeCreatives, 'Creative') : [];
+                        for (creativeIndex = 0; creativeIndex < modelNodeCreativeList.length; creativeIndex += 1) {
+                            modelNodeCreative = modelNodeCreativeList[creativeIndex];
+                            creativeObj = myObjectFromParentNode(modelNodeCreative);
+                            if (creativeObj) {
+                                modelNodeCreativeType = modelNodeCreative.children[0];
+                                if (creativeObj.type === 'Linear') {
+                                    creativeObj.mediaFiles = adObj.type === 'InLine' ? myArrayFromOptionalChild(modelNodeCreativeType, 'MediaFiles') : [];
+                                    creativeObj.trackingEvents = myArrayFromOptionalChild(modelNodeCreativeType, 'TrackingEvents');
+                                    creativeObj.videoClicks = myArrayFromOptionalChild(modelNodeCreativeType, 'VideoClicks');
+                                    creativeObj.icons = myArrayFromOptionalChild(modelNodeCreativeType, 'Icons', 'Icon');
+                                }
+                                else if (creativeObj.type === 'CompanionAds') {
+                                    creativeObj.companionAds = myArrayOfChildrenFromModelNode(modelNodeCreativeType, 'Companion');
+                                }
+                                else if (creativeObj.type === 'NonLinearAds') {
+                                    // same element name as getNonLinearAdsList
+                                    creativeObj.nonLinearAds = myArrayOfChildrenFromModelNode(modelNodeCreativeType, 'Companion');
+                                }
+                                adObj.creatives.push(creativeObj);
+                            }
+                        }
+                        result.push(adObj);
+                    }
+                }
+
+                return result;
             },
         },
 
         vmap: { // === VMAP Parsed document information access ===
 
             createEntry: function (aManifest) {
-                ///<summary>Create a AdResolverEntry by parsing an XML string or using a DOM Document.</summary>
+                ///<summary>Create a AdResolverEntry by parsing an XML string into the ad model or converting a DOM Document.</summary>
                 ///<param name="aManifest" type="String">The manifest as an XML string</param>
-                ///<param name="aManifest" type="Object">The manifest as an object derived from Document</param>
+                ///<param name="aManifest" type="Object">The manifest as an object derived from Document, or an AdModelNode</param>
                 ///<returns type="Number">The idNumber for the AdResolverEntry that was created. Throws AdResolverError if invalid AdResolver document.</returns>
-                var parsedDocument;
-
-                if (typeof aManifest === 'string') {
-                    parsedDocument = myDOMParser.parseFromString(aManifest, "application/xml");
-                }
-                else if (Document.prototype.isPrototypeOf(aManifest)) {
-                    parsedDocument = aManifest;
-                }
-                else {
-                    throw new PLAYER_SEQUENCER.AdResolverError('vmap.createEntry parameter invalid! ' + aManifest.toString());
-                }
 
                 // Assert the top level element is <VMAP> and it contains at least one <AdBreak>.
-                myDocNodeFromElementPath(parsedDocument, ['VMAP', 'AdBreak']);
-                // myDocNodeFromElementPath throws an exception if path not found
-
-                return myAdResolverEntryPool.createEntry(parsedDocument).idNumber;
+                return myCreateEntryFromManifest(aManifest, false, 'vmap.createEntry', ['VMAP', 'AdBreak']);
             },
 
             getAdBreakList: function (params) {
@@ -546,9 +996,9 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                 ///<param name="params" type="Object">An object with "entryId" (result of the createEntry function)</param>
                 ///<returns type="Array">Array of objects, one for each 'AdBreak' element: [{elements:[string array of next level elements],attrs:{set of attribute name:value pairs}]</returns>
                 var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
-                    docNodeVMAP = myDocNodeFromElementPath(entry.parsedDocument, ['VMAP']);
+                    modelNodeVMAP = myModelNodeFromElementPath(entry.adModel, ['VMAP']);
 
-                return myArrayFromDocNode(docNodeVMAP, 'AdBreak');
+                return myArrayFromModelNode(modelNodeVMAP, 'AdBreak');
             },
 
             getAdSource: function (params) {
@@ -557,9 +1007,9 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                 ///<returns type="Object">An Object containing: {type:(enum VASTAdData,CustomAdData,AdTagURI),attrs:{set of attribute name:value pairs},value</returns>
                 var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
                     adBreakIndex = params.adBreakOrdinal || 0,
-                    docNode = myDocNodeFromElementPath(entry.parsedDocument, ['VMAP', 'AdBreak:' + adBreakIndex.toString()]);
+                    modelNode = myModelNodeFromElementPath(entry.adModel, ['VMAP', 'AdBreak:' + adBreakIndex.toString()]);
 
-                return myArrayOfChildrenFromDocNode(docNode, 'AdSource');
+                return myArrayOfChildrenFromModelNode(modelNode, 'AdSource');
             },
 
             createVASTEntryFromAdBreak: function (params) {
@@ -568,9 +1018,9 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                 ///<returns type="Number">A VASTEntry idNumber</returns>
                 var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
                     adBreakIndex = params.adBreakOrdinal || 0,
-                    docNode;
+                    modelNode;
 
-                    docNode = myDocNodeFromElementPath(entry.parsedDocument, 
+                    modelNode = myModelNodeFromElementPath(entry.adModel, 
                         [
                             'VMAP', 
                             'AdBreak:' + adBreakIndex.toString(), 
@@ -578,7 +1028,7 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                             'VASTAdData'
                         ]);
 
-                return publicAPI.vast.createEntry(docNode);
+                return publicAPI.vast.createEntry(modelNode);
             },
 
             getTrackingEventsList: function (params) {
@@ -587,9 +1037,9 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                 ///<returns type="Array">An array of Tracking element objects: { value, attrs }</returns>
                 var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
                     adBreakIndex = params.adBreakOrdinal || 0,
-                    docNode = myDocNodeFromElementPath(entry.parsedDocument, ['VMAP', 'AdBreak:' + adBreakIndex.toString(), 'TrackingEvents']);
+                    modelNode = myModelNodeFromElementPath(entry.adModel, ['VMAP', 'AdBreak:' + adBreakIndex.toString(), 'TrackingEvents']);
 
-                return myArrayFromDocNode(docNode, 'Tracking');
+                return myArrayFromModelNode(modelNode, 'Tracking');
             },
 
             getExtensionsList: function (params) {
@@ -598,9 +1048,9 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
                 ///<returns type="Array">An array of Extension element objects: {elements, attrs}</returns>
                 var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
                     adBreakIndex = params.adBreakOrdinal || 0,
-                    docNode = myDocNodeFromElementPath(entry.parsedDocument, ['VMAP', 'AdBreak:' + adBreakIndex.toString(), 'Extensions']);
+                    modelNode = myModelNodeFromElementPath(entry.adModel, ['VMAP', 'AdBreak:' + adBreakIndex.toString(), 'Extensions']);
 
-                return myArrayFromDocNode(docNode, 'Extension');
+                return myArrayFromModelNode(modelNode, 'Extension');
             },
 
         },
@@ -612,9 +1062,21 @@ PLAYER_SEQUENCER.theAdResolver = (function () {
             ///<param name="params" type="Object">An object with "entryId" (result of the create function) and "path" (array of Element name:count strings) optionally filtered by "nodeName"</param>
             ///<returns type="Array">An array of objects representing the elements within the node specified. </returns>
             var entry = myAdResolverEntryPool.getEntryFromId(params.entryId),
-                docNode = myDocNodeFromElementPath(entry.parsedDocument, params.path);
+                modelNode = myModelNodeFromElementPath(entry.adModel, params.path);
+
+            return myArrayFromModelNode(modelNode, params.nodeName);
+        },
+
+        getCacheStatistics: function () {
+            ///<summary>Get the counters of the ad model cache shared by entries created from identical manifests</summary>
+            ///<returns type="Object">See theAdModelCache getStatistics</returns>
+            return myAdModelCache.getStatistics();
+        },
 
-            return myArrayFromDocNode(docNode, params.nodeName);
+        setCacheBudget: function (params) {
+            ///<summary>Set the memory budget of the ad model cache. Unreferenced models are evicted least recently used first when it is exceeded.</summary>
+            ///<param name="params" type="Object">An object with "maxBytes" (the budget in estimated bytes, 0 to keep only the models of unreleased entries)</param>
+            myAdModelCache.setBudget(params.maxBytes);
         },
 
         releaseEntry: function (adResolverEntryIdNumber) {
@@ -0,0 +1,161 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+
+// This file contains a DOMParser stand-in for JavaScript engines without a DOM (JavaScriptCore JSContext, node).
+// AdResolver.js builds its ad model without a DOM, this is for scripts which parse XML documents themselves.
+// It does nothing when the engine already has a DOMParser.
+
+//
+// The namespace object
+//
+var PLAYER_SEQUENCER = PLAYER_SEQUENCER || {};
+
+// ------------------------
+// The headless XML DOM
+// ------------------------
+// Note: Only a small subset of the DOM is provided: DOMParser.parseFromString and the
+//       Node, Element, Text and Document constructors for the isPrototypeOf checks. The nodes have
+//       childNodes, firstChild, nodeName, localName, nodeValue and attributes (with nodeName and nodeValue).
+//       Like the browser DOMParser, a document which is not well formed gives a <parsererror> document.
+//
+PLAYER_SEQUENCER.createHeadlessDOM = function (globalObject) {
+"use strict";
+
+    var Node = function () {},
+        Element = function () {},
+        Text = function () {},
+        CDATASection = function () {},
+        Document = function () {},
+        DOMParser,
+
+        entities = { lt: '<', gt: '>', amp: '&', quot: '"', apos: "'" },
+
+    // private methods
+    decodeEntities = function (text) {
+        return text.replace(/&(#x[0-9a-fA-F]+|#[0-9]+|[a-zA-Z]+);/g, function (match, name) {
+            if (name.charAt(0) === '#') {
+                return String.fromCharCode(name.charAt(1) === 'x' ? parseInt(name.substring(2), 16) : parseInt(name.substring(1), 10));
+            }
+            return entities.hasOwnProperty(name) ? entities[name] : match;
+        });
+    },
+
+    createNode = function (prototypeObj, nodeName, nodeValue) {
+        var node = Object.create(prototypeObj);
+
+        node.nodeName = nodeName;
+        node.nodeValue = nodeValue;
+        node.childNodes = [];
+        return node;
+    },
+
+    appendChild = function (parentNode, childNode) {
+        if (parentNode.childNodes.length === 0) {
+            parentNode.firstChild = childNode;
+        }
+        parentNode.childNodes.push(childNode);
+    },
+
+    createErrorDocument = function (message) {
+        var doc = createNode(Document.prototype, '#document', null),
+            errorNode = createNode(Element.prototype, 'parsererror', null);
+
+        errorNode.localName = 'parsererror';
+        errorNode.attributes = [];
+        appendChild(errorNode, createNode(Text.prototype, '#text', message));
+        appendChild(doc, errorNode);
+        return doc;
+    },
+
+    parseXML = function (xmlString) {
+        var doc = createNode(Document.prototype, '#document', null),
+            openNodes = [doc],
+            markupPattern = /<!\[CDATA\[([\s\S]*?)\]\]>|<!--[\s\S]*?-->|<\?[\s\S]*?\?>|<!DOCTYPE[^>]*>|<\/([^\s>]+)\s*>|<([^\s\/>]+)((?:\s+[^\s=\/>]+\s*=\s*(?:"[^"]*"|'[^']*'))*)\s*(\/?)>|([^<]+)|</g,
+            attrPattern = /([^\s=\/>]+)\s*=\s*(?:"([^"]*)"|'([^']*)')/g,
+            match,
+            attrMatch,
+            currentNode,
+            node;
+
+        markupPattern.lastIndex = 0;
+        while ((match = markupPattern.exec(xmlString)) !== null) {
+            currentNode = openNodes[openNodes.length - 1];
+
+            if (match[1] !== undefined) {
+                appendChild(currentNode, createNode(CDATASection.prototype, '#cdata-section', match[1]));
+            }
+            else if (match[2] !== undefined) {
+                if (currentNode === doc || currentNode.nodeName !== match[2]) {
+                    return createErrorDocument('mismatched end tag ' + match[2]);
+                }
+                openNodes.pop();
+            }
+            else if (match[3] !== undefined) {
+                node = createNode(Element.prototype, match[3], null);
+                node.localName = match[3].substring(match[3].indexOf(':') + 1);
+                node.attributes = [];
+                attrPattern.lastIndex = 0;
+                while ((attrMatch = attrPattern.exec(match[4])) !== null) {
+                    node.attributes.push({
+                        nodeName: attrMatch[1],
+                        nodeValue: decodeEntities(attrMatch[2] !== undefined ? attrMatch[2] : attrMatch[3])
+                    });
+                }
+                appendChild(currentNode, node);
+                if (match[5] !== '/') {
+                    openNodes.push(node);
+                }
+            }
+            else if (match[6] !== undefined) {
+                // text outside of the document element is ignored like whitespace
+                if (currentNode !== doc) {
+                    appendChild(currentNode, createNode(Text.prototype, '#text', decodeEntities(match[6])));
+                }
+            }
+            else if (match[0] === '<') {
+                return createErrorDocument('invalid markup at ' + String(match.index));
+            }
+            // comments, processing instructions and DOCTYPE are skipped
+        }
+
+        if (openNodes.length > 1) {
+            return createErrorDocument('unclosed element ' + openNodes[openNodes.length - 1].nodeName);
+        }
+        return doc;
+    };
+
+    Element.prototype = Object.create(Node.prototype);
+    Text.prototype = Object.create(Node.prototype);
+    CDATASection.prototype = Object.create(Text.prototype);
+    Document.prototype = Object.create(Node.prototype);
+
+    DOMParser = function () {
+        this.parseFromString = function (xmlString, mimeType) {
+            return parseXML(String(xmlString));
+        };
+    };
+
+    globalObject.Node = Node;
+    globalObject.Element = Element;
+    globalObject.Text = Text;
+    globalObject.CDATASection = CDATASection;
+    globalObject.Document = Document;
+    globalObject.DOMParser = DOMParser;
+};
+
+if (typeof DOMParser === 'undefined') {
+    PLAYER_SEQUENCER.createHeadlessDOM(this);
+}
@@ -0,0 +1,170 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+
+// This file contains the generational slab pool used by the Sequencer and AdResolver id pools.
+
+//
+// The namespace object
+//
+var PLAYER_SEQUENCER = PLAYER_SEQUENCER || {};
+
+// ---------------------------
+// The generational slab pool
+// ---------------------------
+// Note: Objects are kept in slots that are reused through a free list, so insert, release and get are O(1)
+//       and a long-lived object does not pin the slots of the objects created after it.
+//       An id packs the slot index with the generation of the slot. The generation is bumped whenever
+//       the slot is released, so an id that has been released is detected as stale even after its slot is reused.
+//
+PLAYER_SEQUENCER.createSlabPool = function (ErrorType) {
+"use strict";
+
+    // ids are passed to the native code as 32 bit integers: 16 bits of slot index and 15 bits of generation
+    var slotsPerGeneration = 65536,
+        maxGeneration = 32767,
+
+        slots = [],             // the pooled objects; null for a free slot
+        generations = [],       // the current generation of every slot (1 to maxGeneration)
+        insertOrders = [],      // the insert count at the time every slot was filled, for the leak report
+        freeSlots = [],         // stack of free slot indexes
+        occupancy = 0,
+        highWaterMark = 0,
+        insertCount = 0,
+        releaseCount = 0,
+
+    // private methods
+    slotFromId = function (id, callerName) {
+        // the native side passes some ids as strings of digits, e.g. theAdResolver releaseEntry
+        var idNumber = (typeof id === 'string') ? Number(id) : id,
+            slot,
+            generation;
+
+        if (typeof idNumber === 'number' && idNumber > 0) {
+            slot = idNumber % slotsPerGeneration;
+            generation = (idNumber - slot) / slotsPerGeneration;
+            if (slot < slots.length && generations[slot] === generation && slots[slot] !== null) {
+                return slot;
+            }
+        }
+        throw new ErrorType('invalid ' + callerName + ' Id: ' + String(id));
+    },
+
+    idFromSlot = function (slot) {
+        return generations[slot] * slotsPerGeneration + slot;
+    };
+
+    return {
+        insert: function (anObject) {
+            ///<summary>Add an object to the pool</summary>
+            ///<param name="anObject" type="Object">The object to be pooled</param>
+            ///<returns type="Number">The id of the object; never 0</returns>
+            var slot;
+
+            if (freeSlots.length > 0) {
+                slot = freeSlots.pop();
+            }
+            else {
+                slot = slots.length;
+                if (slot >= slotsPerGeneration) {
+                    throw new ErrorType('pool full: ' + slot.toString() + ' objects not released');
+                }
+                generations[slot] = 1;
+            }
+            slots[slot] = anObject;
+            insertCount += 1;
+            insertOrders[slot] = insertCount;
+
+            occupancy += 1;
+            if (occupancy > highWaterMark) {
+                highWaterMark = occupancy;
+            }
+            return idFromSlot(slot);
+        },
+
+        release: function (id, callerName) {
+            ///<summary>Release the pool reference to an object so it can be GCed</summary>
+            ///<param name="id" type="Number">The id of the object to be released</param>
+            ///<param name="callerName" type="String">The name used in the exception thrown for an invalid id</param>
+            var slot = slotFromId(id, callerName);
+
+            slots[slot] = null;
+            generations[slot] = (generations[slot] % maxGeneration) + 1;
+            freeSlots.push(slot);
+            occupancy -= 1;
+            releaseCount += 1;
+        },
+
+        get: function (id, callerName) {
+            ///<summary>Get a reference to a pooled object</summary>
+            ///<param name="id" type="Number">The id of the object</param>
+            ///<param name="callerName" type="String">The name used in the exception thrown for an invalid id</param>
+            ///<returns type="Object">The pooled object</returns>
+            return slots[slotFromId(id, callerName)];
+        },
+
+        releaseAll: function () {
+            ///<summary>Release all the objects in the pool</summary>
+            var slot;
+
+            for (slot = 0; slot < slots.length; slot += 1) {
+                if (slots[slot] !== null) {
+                    this.release(idFromSlot(slot), 'releaseAll');
+                }
+            }
+        },
+
+        getStatistics: function () {
+            ///<summary>Get the pool counters</summary>
+            ///<returns type="Object">An object with properties: occupancy (objects currently pooled), highWaterMark (the largest occupancy so far), capacity (slots allocated), inserted and released (totals so far)</returns>
+            return {
+                occupancy: occupancy,
+                highWaterMark: highWaterMark,
+                capacity: slots.length,
+                inserted: insertCount,
+                released: releaseCount
+            };
+        },
+
+        getLeakReport: function () {
+            ///<summary>List the objects that have not been released, oldest first</summary>
+            ///<returns type="Array">Objects with properties: id and insertOrder (the value of the inserted counter when the object was added)</returns>
+            var report = [],
+                slot;
+
+            for (slot = 0; slot < slots.length; slot += 1) {
+                if (slots[slot] !== null) {
+                    report.push({ id: idFromSlot(slot), insertOrder: insertOrders[slot] });
+                }
+            }
+            report.sort(function (a, b) { return a.insertOrder - b.insertOrder; });
+            return report;
+        },
+
+        toJSON: function () {
+            ///<summary>For testing purposes, return the pooled objects and the counters</summary>
+            ///<returns type="Object">An object with properties: pool (the pooled objects by id) and statistics</returns>
+            var pool = {},
+                slot;
+
+            for (slot = 0; slot < slots.length; slot += 1) {
+                if (slots[slot] !== null) {
+                    pool[idFromSlot(slot)] = slots[slot];
+                }
+            }
+            return { pool: pool, statistics: this.getStatistics() };
+        }
+    };
+};
@@ -48,6 +48,18 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
         privateMethodKey = Math.random(),
         playlistDuration = 0,
 
+        // index over the playlist array, updated in place by the insert and remove methods
+        // and rebuilt lazily after the bulk changes:
+        entryFromId = {},       // id -> playlistEntry in playlist (positions are found by binary search on the start time)
+        maxEndTimes = [],       // maxEndTimes[i] is the largest linear end time of playlist[0..i]
+        isIndexValid = true,
+        isTimeOrdered = true,   // false if linearStartTime is not non-decreasing (index falls back to scanning)
+
+        // bounded journal of the most recent changes, so callers can fetch deltas instead of the whole playlist:
+        version = 0,            // incremented for every change recorded in the journal
+        changeJournal = [],
+        maxJournalLength = 256,
+
     // ---------------------------------
     // private methods
     // ---------------------------------
@@ -61,22 +73,185 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
         }
     },
 
-    indexFromId = function ( idToFind, callerName ) {
+    invalidateIndex = function () {
+        isIndexValid = false;
+    },
+
+    journalChange = function (operation, playlistEntry, idRelated) {
+        // operation: 'insert', 'split' (idRelated is the new entry for the tail), 'weld' (idRelated is the entry welded on and removed),
+        //            'update' (times changed), 'remove' or 'removeAll'
+        version += 1;
+        changeJournal.push({
+            version: version,
+            operation: operation,
+            id: playlistEntry ? playlistEntry.id : 0,
+            idRelated: idRelated || 0,
+            linearStartTime: playlistEntry ? playlistEntry.linearStartTime : 0,
+            linearDuration: playlistEntry ? playlistEntry.linearDuration : 0
+        });
+        if (changeJournal.length > maxJournalLength) {
+            changeJournal.shift();
+        }
+    },
+
+    appendToIndex = function (i) {
+        var endTime = playlist[i].linearStartTime + playlist[i].linearDuration;
+
+        entryFromId[playlist[i].id] = playlist[i];
+        if (i > 0) {
+            if (playlist[i].linearStartTime < playlist[i - 1].linearStartTime) {
+                isTimeOrdered = false;
+            }
+            if (endTime < maxEndTimes[i - 1]) {
+                endTime = maxEndTimes[i - 1];
+            }
+        }
+        maxEndTimes[i] = endTime;
+    },
+
+    validateIndex = function () {
         var i;
-        for (i = 0; i < playlist.length; i += 1) {
-            if (playlist[i].id === idToFind) {
-                return i;
+
+        if (!isIndexValid) {
+            entryFromId = {};
+            maxEndTimes = [];
+            isTimeOrdered = true;
+            for (i = 0; i < playlist.length; i += 1) {
+                appendToIndex(i);
+            }
+            isIndexValid = true;
+        }
+    },
+
+    refreshIndex = function (position, changeCount) {
+        // recompute the running max end times from position: the changeCount entries from there have new times,
+        // after those the old values are still right as soon as one of them matches again
+        var j,
+            endTime;
+
+        if (!isIndexValid) {
+            return;
+        }
+        for (j = Math.max(position, 0); j < playlist.length; j += 1) {
+            endTime = playlist[j].linearStartTime + playlist[j].linearDuration;
+            if (j > 0) {
+                if (playlist[j].linearStartTime < playlist[j - 1].linearStartTime) {
+                    // out of order, the rebuild sets isTimeOrdered so lookups fall back to scanning
+                    invalidateIndex();
+                    return;
+                }
+                if (endTime < maxEndTimes[j - 1]) {
+                    endTime = maxEndTimes[j - 1];
+                }
             }
+            if (j >= position + changeCount && maxEndTimes[j] === endTime) {
+                break;
+            }
+            maxEndTimes[j] = endTime;
+        }
+    },
+
+    splicePlaylist = function (position, removeCount, entriesToInsert) {
+        // playlist.splice that keeps a valid index up to date instead of invalidating it
+        var removed = playlist.splice.apply(playlist, [position, removeCount].concat(entriesToInsert)),
+            i;
+
+        if (isIndexValid && isTimeOrdered) {
+            for (i = 0; i < removed.length; i += 1) {
+                delete entryFromId[removed[i].id];
+            }
+            for (i = 0; i < entriesToInsert.length; i += 1) {
+                entryFromId[entriesToInsert[i].id] = entriesToInsert[i];
+            }
+            maxEndTimes.splice.apply(maxEndTimes, [position, removeCount].concat(entriesToInsert.map(function () { return 0; })));
+            refreshIndex(position, entriesToInsert.length);
+        }
+        else {
+            invalidateIndex();
+        }
+        return removed;
+    },
+
+    indexFromId = function ( idToFind, callerName ) {
+        var entry,
+            i;
+
+        validateIndex();
+        entry = entryFromId.hasOwnProperty(idToFind) ? entryFromId[idToFind] : null;
+        if (entry && isTimeOrdered) {
+            // the entry is among the entries with its start time
+            i = lowerBound(playlist.length, function (j) {
+                return playlist[j].linearStartTime >= entry.linearStartTime;
+            });
+            while (i < playlist.length && playlist[i] !== entry && playlist[i].linearStartTime === entry.linearStartTime) {
+                i += 1;
+            }
+        }
+        else if (entry) {
+            i = playlist.indexOf(entry);
+        }
+        if (entry && playlist[i] === entry) {
+            return i;
         }
         throw new PLAYER_SEQUENCER.SchedulerError( (callerName || "[unnamed]") + ' called indexFromId with invalid id ' + idToFind.toString());
     },
 
+    createNullEntry = function (entryToSplitFrom) {
+        var myId = nextId,
+            myIdSplitFrom = entryToSplitFrom ? entryToSplitFrom.idSplitFrom : nextId,
+            mySplitCount = 0;
+        nextId += 1;
+
+        // DEFINITION of playlistEntry
+        return {
+        //  -----------------------------------------------------------------------
+            clipURI: null,              // string
+            eClipType: null,            // string - 'Media', 'Static', 'VAST', 'SeekToStart', 'ProgramContent'
+            linearStartTime: 0,         // number
+            linearDuration: 0,          // number - zero for pause timeline true
+            clipBeginMediaTime: 0,      // number - clip begin
+            clipEndMediaTime: 0,        // number - clip end
+            isAdvertisement: true,      // boolean
+            playbackPolicyObj: {},      // opaque - playback policy object
+            deleteAfterPlayed: false,     // boolean
+            get id () { return myId; },
+            set id (value) { throwSetterInhibited(value); },
+            get idSplitFrom () { return myIdSplitFrom; },
+            set idSplitFrom (value) { throwSetterInhibited(value); },
+            get splitCount () { return mySplitCount; },
+            set splitCount (value) { throwSetterInhibited(value); },
+            incrementSplitCount: function ( passKey ) { 
+                validatePrivateMethodAccess(passKey);
+                mySplitCount += 1; 
+            }
+        //  -----------------------------------------------------------------------
+        };
+    },
+
     isNearZero = function (value, tolerance) {
         // default to 1 millisecond to accommodate number roundoff errors
         return Math.abs( value ) < (tolerance || 0.001);
     },
 
-    findEntryIndexAtTime = function (timeToFind) {
+    lowerBound = function (count, isAtOrAfter) {
+        // binary search for the first position in [0, count) for which isAtOrAfter is true (count if none)
+        var low = 0,
+            high = count,
+            mid;
+
+        while (low < high) {
+            mid = (low + high) >>> 1;
+            if (isAtOrAfter(mid)) {
+                high = mid;
+            }
+            else {
+                low = mid + 1;
+            }
+        }
+        return low;
+    },
+
+    findEntryIndexAtTimeByScan = function (timeToFind) {
         var i,
             startTime;
 
@@ -93,6 +268,33 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
         return i;
     },
 
+    findEntryIndexAtTime = function (timeToFind) {
+        var firstNear,
+            firstContaining;
+
+        validateIndex();
+        if (!isTimeOrdered) {
+            return findEntryIndexAtTimeByScan(timeToFind);
+        }
+
+        // Same result as the forward scan above, found with two binary searches:
+        // every entry before firstNear starts at least 1 millisecond before timeToFind, so it can only match
+        // by containing timeToFind, and the first of those is the first entry whose running max end time passes timeToFind.
+        firstNear = lowerBound(playlist.length, function (i) {
+            return playlist[i].linearStartTime > timeToFind - 0.001;
+        });
+        firstContaining = lowerBound(firstNear, function (i) {
+            return maxEndTimes[i] > timeToFind;
+        });
+        if (firstContaining < firstNear) {
+            return firstContaining;
+        }
+        if (firstNear < playlist.length && isNearZero(playlist[firstNear].linearStartTime - timeToFind)) {
+            return firstNear;
+        }
+        return playlist.length;
+    },
+
     // ---------------------------------
     // public sequentialPlaylist methods
     // ---------------------------------
@@ -106,44 +308,19 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                 ///<param name="splitOffsetTime" type="number">when idSplitFrom given, required time offset of the split point.</param>
                 ///<returns type="Object">A playlistEntry object to be filled in before insertEntry is called using it.</returns>
                 var playlistEntry,
-                    myId = nextId,
-                    myIdSplitFrom = nextId,
-                    mySplitCount = 0,
                     indexToSplitFrom,
                     splitTimeDelta;
-                nextId += 1;
                 
                 if (idSplitFrom) {
                     indexToSplitFrom = indexFromId(idSplitFrom, "createEntry");
                     if (playlist[indexToSplitFrom].linearDuration === 0) {
                         throw new PLAYER_SEQUENCER.SchedulerError( 'createEntry idToSplitFrom ' + idSplitFrom.toString() + ' cannot be split');
                     }
-                    myIdSplitFrom = playlist[indexToSplitFrom].idSplitFrom;
-                }
-                // DEFINITION of playlistEntry
-                playlistEntry = {
-                //  -----------------------------------------------------------------------
-                    clipURI: null,              // string
-                    eClipType: null,            // string - 'Media', 'Static', 'VAST', 'SeekToStart', 'ProgramContent'
-                    linearStartTime: 0,         // number
-                    linearDuration: 0,          // number - zero for pause timeline true
-                    clipBeginMediaTime: 0,      // number - clip begin
-                    clipEndMediaTime: 0,        // number - clip end
-                    isAdvertisement: true,      // boolean
-                    playbackPolicyObj: {},      // opaque - playback policy object
-                    deleteAfterPlayed: false,     // boolean
-                    get id () { return myId; },
-                    set id (value) { throwSetterInhibited(value); },
-                    get idSplitFrom () { return myIdSplitFrom; },
-                    set idSplitFrom (value) { throwSetterInhibited(value); },
-                    get splitCount () { return mySplitCount; },
-                    set splitCount (value) { throwSetterInhibited(value); },
-                    incrementSplitCount: function ( passKey ) { 
-                        validatePrivateMethodAccess(passKey);
-                        mySplitCount += 1; 
-                    }
-                //  -----------------------------------------------------------------------
-                };
+                    playlistEntry = createNullEntry(playlist[indexToSplitFrom]);
+                }
+                else {
+                    playlistEntry = createNullEntry();
+                }
 
                 if (idSplitFrom) {
                     // copy the properties (with times adjusted for the split offset)
@@ -198,9 +375,12 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                         entryFound.linearDuration -= playlistEntry.linearDuration;
                         entryFound.incrementSplitCount( privateMethodKey );
                         entryFound.clipBeginMediaTime += playlistEntry.linearDuration;
+                        refreshIndex(indexFound, 1);
+                        journalChange('update', entryFound);
                     }
 
-                    playlist.splice(indexFound, 0, playlistEntry);
+                    splicePlaylist(indexFound, 0, [playlistEntry]);
+                    journalChange('insert', playlistEntry);
                 }
                 else {
                     // split the existing entry
@@ -212,6 +392,7 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                     entryFound.incrementSplitCount( privateMethodKey );
                     entryFound.clipEndMediaTime = entrySplit.clipBeginMediaTime;
                     entryFound.linearDuration = splitOffsetTime;
+                    refreshIndex(indexFound, 1);
 
                     playlistEntry.linearStartTime = entryFound.linearStartTime + entryFound.linearDuration;
 
@@ -226,9 +407,10 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                     }
 
                     // insert new entry after the first part and the second part after that
-                    playlist.splice(indexFound + 1, 0, playlistEntry);
-                    indexFound = indexFromId( playlistEntry.id, "insertEntry split" );
-                    playlist.splice(indexFound + 1, 0, entrySplit);
+                    splicePlaylist(indexFound + 1, 0, [playlistEntry, entrySplit]);
+                    journalChange('split', entryFound, entrySplit.id);
+                    journalChange('insert', playlistEntry);
+                    journalChange('insert', entrySplit);
                 }
             },
 
@@ -244,7 +426,8 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                     playlistEntry.linearStartTime = playlist[i-1].linearStartTime + playlist[i-1].linearDuration;
                 }
                 playlistDuration += playlistEntry.linearDuration;
-                playlist.push(playlistEntry);
+                splicePlaylist(i, 0, [playlistEntry]);
+                journalChange('insert', playlistEntry);
             },
 
             insertEntryBeforeBeginning: function (playlistEntry) {
@@ -266,8 +449,11 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                     entryFound.linearDuration -= playlistEntry.linearDuration;
                     entryFound.incrementSplitCount( privateMethodKey );
                     entryFound.clipBeginMediaTime += playlistEntry.linearDuration;
+                    refreshIndex(0, 1);
+                    journalChange('update', entryFound);
                 }
-                playlist.unshift(playlistEntry);
+                splicePlaylist(0, 0, [playlistEntry]);
+                journalChange('insert', playlistEntry);
             },
 
             insertEntryAfterId: function (idToFind, playlistEntry) {
@@ -284,7 +470,8 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
 
                 playlistEntry.linearStartTime = playlist[i].linearStartTime + playlist[i].linearDuration;
                 if (playlistEntry.linearDuration === 0) {
-                    playlist.splice(i + 1, 0, playlistEntry);
+                    splicePlaylist(i + 1, 0, [playlistEntry]);
+                    journalChange('insert', playlistEntry);
                 }
                 else {
                     // handle overlay ad case (adjust underlying main content linear and begin/end media times)
@@ -304,6 +491,7 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                         entryAfter.linearDuration += entryBefore.linearDuration;
                         entryAfter.incrementSplitCount( privateMethodKey );
                         entryAfter.clipBeginMediaTime -= entryBefore.linearDuration;
+                        refreshIndex(i + 1, 1);
                     }                    
                     
                     if ( playlistEntry.linearDuration > entryAfter.linearDuration) {
@@ -313,7 +501,10 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                     entryAfter.linearDuration -= playlistEntry.linearDuration;
                     entryAfter.incrementSplitCount( privateMethodKey );
                     entryAfter.clipBeginMediaTime += playlistEntry.linearDuration;
-                    playlist.splice(i + 1, 0, playlistEntry);
+                    splicePlaylist(i + 1, 0, [playlistEntry]);
+                    refreshIndex(i + 2, 1);
+                    journalChange('update', entryAfter);
+                    journalChange('insert', playlistEntry);
                 }
             },
 
@@ -329,13 +520,379 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                     }
                     if (playlist[i].linearDuration > 0) {
                         playlistEntry.eClipType = "SeekToStart";
-                        playlist.splice(i, 0, playlistEntry);
+                        splicePlaylist(i, 0, [playlistEntry]);
+                        journalChange('insert', playlistEntry);
                         return playlistEntry;
                     }
                 }
                 throw new PLAYER_SEQUENCER.SchedulerError('insertSeekToStart cannot be inserted inside playlist with no content');
             },        
+
+            insertEntries: function (insertions) {
+                ///<summary>Insert a set of advertisement entries in a single merge pass over the playList. The result is the one of calling insertEntryBeforeBeginning, insertEntryAfterEnd, insertEntry or insertEntryAfterId for each entry in array order, with the entries inserted at a time taken in order of start time, except that no empty program content entry is left in front of an overlay ad. If any entry cannot be inserted the playList is left unchanged.</summary>
+                ///<param name="insertions" type="Array">Objects with properties: playlistEntry (the entry to insert), insertAt ('Beginning', 'End', 'Time' or 'AfterId') and idToFind (for 'AfterId', the id of an entry in the playList or of an earlier entry in the array).</param>
+                var atBeginning = [],
+                    atTime = [],
+                    atEnd = [],
+                    afterId = {},
+                    batchOrderFromId = {},
+                    merged = [],
+                    newPlaylist = [],
+                    pendingOverlay = null,
+                    endDuration = 0,
+                    i,
+                    m = 0,
+                    splitCount,
+                    entry,
+                    record,
+                    midRecord,
+                    tail,
+                    emitted,
+                    splitOffsetTime,
+
+                    // Records hold the new times of an entry until the whole set has been merged,
+                    // so nothing in the playList is touched if an exception is thrown.
+                    recordFromEntry = function (playlistEntry, isInPlaylist) {
+                        return {
+                            entry: playlistEntry,
+                            entryToSplitFrom: null,
+                            isInPlaylist: isInPlaylist,
+                            order: isInPlaylist ? -1 : batchOrderFromId[playlistEntry.id],    // the position in the array of a new entry
+                            shiftOrder: -1,         // the last position in the array of the overlay ads which moved the start
+                            isChanged: false,
+                            splitCountDelta: 0,     // the incrementSplitCount calls the sequential inserts would make
+                            isAdvertisement: playlistEntry.isAdvertisement,
+                            linearStartTime: playlistEntry.linearStartTime,
+                            linearDuration: playlistEntry.linearDuration,
+                            clipBeginMediaTime: playlistEntry.clipBeginMediaTime,
+                            clipEndMediaTime: playlistEntry.clipEndMediaTime
+                        };
+                    },
+
+                    shiftStart = function (target, delta) {
+                        target.linearStartTime += delta;
+                        target.linearDuration -= delta;
+                        target.clipBeginMediaTime += delta;
+                        target.isChanged = true;
+                    },
+
+                    applyPendingOverlay = function (target) {
+                        // overlay ads inserted after an id take their time from the next program content clip
+                        // Note: overlay ads are not allowed to span RCE clips or content split by other ads
+                        if (pendingOverlay) {
+                            if (target.isAdvertisement) {
+                                throw new PLAYER_SEQUENCER.SchedulerError('insertEntry overlay across another ad');
+                            }
+                            shiftStart(target, -pendingOverlay.lateBindingDuration);
+                            if (pendingOverlay.duration > target.linearDuration) {
+                                throw new PLAYER_SEQUENCER.SchedulerError('insertEntry overlay beyond end of program content clip');
+                            }
+                            shiftStart(target, pendingOverlay.duration);
+                            target.splitCountDelta += pendingOverlay.splitCountDelta;
+                            target.shiftOrder = Math.max(target.shiftOrder, pendingOverlay.order);
+                            pendingOverlay = null;
+                        }
+                    },
+
+                    findEmittedAtTime = function (midRecord) {
+                        // the first entry already merged which insertEntry would find at the time of midRecord: the entries
+                        // inserted at the beginning, after an id or at the same time. Entries later in the array than midRecord
+                        // are skipped, as insertEntry would be called before they are in the playList.
+                        var j,
+                            target,
+                            found = -1;
+
+                        for (j = merged.length - 1; j >= 0; j -= 1) {
+                            target = merged[j];
+                            if (isNearZero(target.linearStartTime - midRecord.linearStartTime) ||
+                                (target.linearStartTime <= midRecord.linearStartTime && midRecord.linearStartTime < target.linearStartTime + target.linearDuration)) {
+                                if (target.order < midRecord.order) {
+                                    found = j;
+                                }
+                            }
+                            else if (target.linearStartTime < midRecord.linearStartTime) {
+                                break;
+                            }
+                        }
+                        return found;
+                    },
+
+                    emitBeforeEmitted = function (midRecord, emitted) {
+                        // an ad of the set is already at the time of midRecord, see insertEntry
+                        var emittedAfter;
+
+                        if (!isNearZero(merged[emitted].linearStartTime - midRecord.linearStartTime)) {
+                            throw new PLAYER_SEQUENCER.SchedulerError('insertEntry splitting ad');
+                        }
+                        if (midRecord.linearDuration > 0) {
+                            throw new PLAYER_SEQUENCER.SchedulerError('insertEntry overlay across another ad');
+                        }
+                        midRecord.linearStartTime = merged[emitted].linearStartTime;
+
+                        emittedAfter = merged.splice(emitted, merged.length - emitted);
+                        emit(midRecord);
+                        if (pendingOverlay && emittedAfter.length > 0) {
+                            throw new PLAYER_SEQUENCER.SchedulerError('insertEntry overlay across another ad');
+                        }
+                        merged.push.apply(merged, emittedAfter);
+                    },
+
+                    emit = function (target, splitOrder) {
+                        // splitOrder: for the first part of a split entry, the position in the array of the entry splitting it
+
+                        // an overlay ad inserted after an id is followed by what followed that id when it was inserted,
+                        // so it cannot be followed by an ad which was already there
+                        if (pendingOverlay && target.isAdvertisement && target.order < pendingOverlay.order) {
+                            throw new PLAYER_SEQUENCER.SchedulerError('insertEntry overlay across another ad');
+                        }
+                        merged.push(target);
+                        emitAfterId(target, target.linearStartTime + target.linearDuration, splitOrder);
+                    },
+
+                    emitAfterId = function (target, endTime, splitOrder) {
+                        var idEntry = target.entry || target.entryToSplitFrom,
+                            pods, podRecord, j;
+
+                        if (!idEntry || !afterId.hasOwnProperty(idEntry.id)) {
+                            return;
+                        }
+                        if (idEntry.eClipType === "SeekToStart") {
+                            throw new PLAYER_SEQUENCER.SchedulerError('insertEntryAfterId ' + idEntry.id.toString() + ' cannot be inserted after SeekToStart');
+                        }
+                        // each entry is inserted right after the id, so the last one comes first. An entry inserted after an id
+                        // before the entry splitting it follows the last part of the split instead of the first.
+                        pods = afterId[idEntry.id];
+                        for (j = pods.length - 1; j >= 0; j -= 1) {
+                            if (splitOrder !== undefined && batchOrderFromId[pods[j].id] < splitOrder) {
+                                continue;
+                            }
+                            podRecord = recordFromEntry(pods.splice(j, 1)[0], false);
+                            podRecord.linearStartTime = endTime;
+                            if (podRecord.linearDuration > 0) {
+                                pendingOverlay = pendingOverlay || { duration: 0, lateBindingDuration: 0, splitCountDelta: 0, order: -1 };
+                                pendingOverlay.order = Math.max(pendingOverlay.order, podRecord.order);
+                                if (idEntry.eClipType === "VAST" && podRecord.entry.eClipType === "Media" && target.linearDuration > 0) {
+                                    // late-binding of a VAST manifest, see insertEntryAfterId
+                                    podRecord.linearStartTime = target.linearStartTime;
+                                    pendingOverlay.lateBindingDuration += target.linearDuration;
+                                    pendingOverlay.splitCountDelta += 1;
+                                }
+                                pendingOverlay.duration += podRecord.linearDuration;
+                                pendingOverlay.splitCountDelta += 1;
+                            }
+                            emit(podRecord);
+                        }
+                    };
+
+                validateIndex();
+
+                // Group the entries by where they are inserted
+                for (i = 0; i < insertions.length; i += 1) {
+                    entry = insertions[i].playlistEntry;
+                    if (!entry.isAdvertisement) {
+                        throw new PLAYER_SEQUENCER.SchedulerError('insertEntries of non-advertisement');
+                    }
+                    switch (insertions[i].insertAt) {
+                        case 'Beginning':
+                            atBeginning.push(entry);
+                            break;
+
+                        case 'End':
+                            if (entry.linearDuration > 0) {
+                                throw new PLAYER_SEQUENCER.SchedulerError('insertEntryAfterEnd an overlay ad');
+                            }
+                            atEnd.push(entry);
+                            break;
+
+                        case 'Time':
+                            atTime.push({ entry: entry, order: i });
+                            break;
+
+                        case 'AfterId':
+                            if (!batchOrderFromId.hasOwnProperty(insertions[i].idToFind) && !entryFromId.hasOwnProperty(insertions[i].idToFind)) {
+                                throw new PLAYER_SEQUENCER.SchedulerError('insertEntries called with invalid id ' + String(insertions[i].idToFind));
+                            }
+                            if (!afterId.hasOwnProperty(insertions[i].idToFind)) {
+                                afterId[insertions[i].idToFind] = [];
+                            }
+                            afterId[insertions[i].idToFind].push(entry);
+                            break;
+
+                        default:
+                            throw new PLAYER_SEQUENCER.SchedulerError('insertEntries invalid insertAt: ' + String(insertions[i].insertAt));
+                    }
+                    batchOrderFromId[entry.id] = i;
+                }
+
+                // Sort by start time, keeping the array order for equal times
+                atTime.sort(function (a, b) {
+                    return (a.entry.linearStartTime - b.entry.linearStartTime) || (a.order - b.order);
+                });
+
+                // each entry is inserted before the beginning, so the last one comes first
+                for (i = atBeginning.length - 1; i >= 0; i -= 1) {
+                    emit(recordFromEntry(atBeginning[i], false));
+                }
+
+                // Merge the entries inserted at a time with the playList entries
+                for (i = 0; i < playlist.length; i += 1) {
+                    record = recordFromEntry(playlist[i], true);
+                    applyPendingOverlay(record);
+
+                    while (m < atTime.length) {
+                        midRecord = recordFromEntry(atTime[m].entry, false);
+                        splitOffsetTime = midRecord.linearStartTime - record.linearStartTime;
+                        emitted = findEmittedAtTime(midRecord);
+
+                        if (emitted >= 0) {
+                            emitBeforeEmitted(midRecord, emitted);
+                        }
+                        else if (isNearZero(splitOffsetTime)) {
+                            // insert before the entry, see insertEntry
+                            if (midRecord.linearStartTime > record.linearStartTime) {
+                                midRecord.linearStartTime = record.linearStartTime;
+                            }
+                            if (!record.isAdvertisement && record.shiftOrder > midRecord.order) {
+                                // insertEntry would have split the entry before the overlay ads later in the array emptied
+                                // the first part, so the entries inserted after its id later than midRecord stay in front
+                                emitAfterId(record, midRecord.linearStartTime, midRecord.order);
+                            }
+                            if (midRecord.linearDuration > 0) {
+                                if (record.isAdvertisement) {
+                                    throw new PLAYER_SEQUENCER.SchedulerError('insertEntry overlay across another ad');
+                                }
+                                if (midRecord.linearDuration > record.linearDuration) {
+                                    throw new PLAYER_SEQUENCER.SchedulerError('insertEntry overlay beyond end of program content clip');
+                                }
+                                shiftStart(record, midRecord.linearDuration);
+                                record.splitCountDelta += 1;
+                                record.shiftOrder = Math.max(record.shiftOrder, midRecord.order);
+                            }
+                            emit(midRecord);
+                        }
+                        else if (splitOffsetTime > 0 && splitOffsetTime < record.linearDuration) {
+                            // split the entry, see insertEntry
+                            if (record.isAdvertisement) {
+                                throw new PLAYER_SEQUENCER.SchedulerError('insertEntry splitting ad');
+                            }
+                            tail = recordFromEntry(record, false);
+                            tail.entry = null;
+                            tail.order = -1;
+                            tail.entryToSplitFrom = record.entry || record.entryToSplitFrom;
+                            shiftStart(tail, splitOffsetTime);
+
+                            record.isChanged = true;
+                            record.splitCountDelta += 1;
+                            record.tail = tail;
+                            record.clipEndMediaTime = tail.clipBeginMediaTime;
+                            record.linearDuration = splitOffsetTime;
+
+                            midRecord.linearStartTime = record.linearStartTime + record.linearDuration;
+                            if (midRecord.linearDuration > 0) {
+                                if (midRecord.linearDuration > tail.linearDuration) {
+                                    throw new PLAYER_SEQUENCER.SchedulerError('insertEntry overlay beyond end of program content clip');
+                                }
+                                shiftStart(tail, midRecord.linearDuration);
+                            }
+                            emit(record, midRecord.order);
+                            if (pendingOverlay) {
+                                throw new PLAYER_SEQUENCER.SchedulerError('insertEntry overlay across another ad');
+                            }
+                            emit(midRecord);
+                            record = tail;
+                        }
+                        else if (splitOffsetTime < 0) {
+                            throw new PLAYER_SEQUENCER.SchedulerError('insertEntry linearStartTime ' + midRecord.linearStartTime.toString() + ' outside playlist range');
+                        }
+                        else {
+                            break;
+                        }
+                        applyPendingOverlay(record);
+                        m += 1;
+                    }
+                    emit(record);
+                }
+
+                for (i = 0; i < atEnd.length; i += 1) {
+                    if (pendingOverlay) {
+                        throw new PLAYER_SEQUENCER.SchedulerError('insertEntry overlay across another ad');
+                    }
+                    record = recordFromEntry(atEnd[i], false);
+                    if (merged.length > 0) {
+                        record.linearStartTime = merged[merged.length - 1].linearStartTime + merged[merged.length - 1].linearDuration;
+                    }
+                    endDuration += record.linearDuration;
+                    emit(record);
+                }
+
+                // The entries at the end time can only go in front of the ads inserted at the end before them
+                for (; m < atTime.length; m += 1) {
+                    midRecord = recordFromEntry(atTime[m].entry, false);
+                    emitted = findEmittedAtTime(midRecord);
+                    if (emitted < 0) {
+                        throw new PLAYER_SEQUENCER.SchedulerError('insertEntry linearStartTime ' + midRecord.linearStartTime.toString() + ' outside playlist range');
+                    }
+                    emitBeforeEmitted(midRecord, emitted);
+                }
+                if (pendingOverlay) {
+                    throw new PLAYER_SEQUENCER.SchedulerError('insertEntry overlay beyond end of program content clip');
+                }
+
+                // Everything fits, so apply the new times and replace the playList
+                for (i = 0; i < merged.length; i += 1) {
+                    record = merged[i];
+                    entry = record.entry;
+                    if (!entry) {
+                        entry = createNullEntry(record.entryToSplitFrom);
+                        entry.clipURI = record.entryToSplitFrom.clipURI;
+                        entry.eClipType = record.entryToSplitFrom.eClipType;
+                        entry.isAdvertisement = record.entryToSplitFrom.isAdvertisement;
+                        entry.playbackPolicyObj = record.entryToSplitFrom.playbackPolicyObj;
+                        entry.deleteAfterPlayed = record.entryToSplitFrom.deleteAfterPlayed;
+                    }
+                    for (splitCount = 0; splitCount < record.splitCountDelta; splitCount += 1) {
+                        entry.incrementSplitCount( privateMethodKey );
+                    }
+                    if (!record.isInPlaylist || record.isChanged) {
+                        entry.linearStartTime = record.linearStartTime;
+                        entry.linearDuration = record.linearDuration;
+                        entry.clipBeginMediaTime = record.clipBeginMediaTime;
+                        entry.clipEndMediaTime = record.clipEndMediaTime;
+                    }
+                    record.entry = entry;
+                    newPlaylist.push(entry);
+                }
+                playlist = newPlaylist;
+                for (i = 0; i < merged.length; i += 1) {
+                    record = merged[i];
+                    if (!record.isInPlaylist) {
+                        journalChange('insert', record.entry);
+                    }
+                    else if (record.tail) {
+                        journalChange('split', record.entry, record.tail.entry.id);
+                    }
+                    else if (record.isChanged) {
+                        journalChange('update', record.entry);
+                    }
+                }
+                playlistDuration += endDuration;
+                invalidateIndex();
+            },
             
+            releaseEntries: function (playlistEntries) {
+                ///<summary>Give back the ids of entries which were created but are not going to be inserted, e.g. the entries of a rejected batch. Only the ids of the most recently created entries can be given back, any other entry is ignored.</summary>
+                ///<param name="playlistEntries" type="Array">The playlistEntries in the order they were created.</param>
+                var i;
+
+                validateIndex();
+                for (i = playlistEntries.length - 1; i >= 0; i -= 1) {
+                    if (playlistEntries[i].id !== nextId - 1 || entryFromId.hasOwnProperty(playlistEntries[i].id)) {
+                        break;
+                    }
+                    nextId -= 1;
+                }
+            },
+
             remove: function (idToRemove) {
                 ///<summary>Insert the provided entry at a list position based on the values.</summary>
                 ///<param name="idToRemove" type="Object">The id of the playlistEntry to be removed from the sequentialPlayList.</param>
@@ -348,7 +905,7 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                     throw new PLAYER_SEQUENCER.SchedulerError( 'remove main content currently not allowed' );
                 }
                 // remove the specified entry from the list:
-                playlist.splice(i,1);
+                splicePlaylist(i, 1, []);
                 if (i === playlist.length) {
                     playlistDuration -= objRemoved.linearDuration;
                 }
@@ -356,6 +913,7 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                 objRemoved.incrementSplitCount( privateMethodKey );
                 // Clear the deleteAfterPlayed flag so access.onPlayedEntry will not remove again
                 objRemoved.deleteAfterPlayed = false;
+                journalChange('remove', objRemoved);
 
                 // if entry after the one removed was spliced from the entry before the one removed,
                 if (i > 0 && i < playlist.length && playlist[i-1].idSplitFrom === playlist[i].idSplitFrom) {
@@ -366,7 +924,9 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                     // indicate the after entry has changed:
                     playlist[i].incrementSplitCount( privateMethodKey );
                     // remove the after entry from the list:
-                    playlist.splice(i,1);
+                    journalChange('weld', playlist[i-1], playlist[i].id);
+                    splicePlaylist(i, 1, []);
+                    refreshIndex(i - 1, 1);
                 }
                 // handle overlay ads by adjusting start times of any following ads and the
                 // next overlaid main content item and the main content item duration.
@@ -381,6 +941,8 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                     playlist[i].linearStartTime -= objRemoved.linearDuration;
                     playlist[i].clipBeginMediaTime -= objRemoved.linearDuration;
                     playlist[i].incrementSplitCount( privateMethodKey );                    
+                    refreshIndex(i, 1);
+                    journalChange('update', playlist[i]);
                 }
                 return objRemoved;
             },
@@ -389,6 +951,8 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                 ///<summary>Remove all entries from the playList.</summary>
                 playlist = [];
                 playlistDuration = 0;
+                invalidateIndex();
+                journalChange('removeAll');
             },
 
             removeEntriesBeforeTime: function (startTime) {
@@ -396,6 +960,8 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                 ///<param name="startTime" type="Number">The start time for playlist. Any entries before this time except preroll ads should be removed.</param>
                 var i = 0;
                 
+                invalidateIndex();
+
                 // Skip all the preroll ads and seekToStart entry
                 while (i < playlist.length && playlist[i].isAdvertisement && playlist[i].linearDuration === 0) {
                     i += 1;
@@ -409,6 +975,7 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                 while (i < playlist.length && playlist[i].linearStartTime < startTime) {
                     if (playlist[i].linearStartTime + playlist[i].linearDuration <= startTime) {
                         // The entry is totally before the start time, remove it
+                        journalChange('remove', playlist[i]);
                         playlist.splice(i, 1);
                     }
                     else {
@@ -417,6 +984,7 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                         playlist[i].clipBeginMediaTime += startTime - playlist[i].linearStartTime;
                         playlist[i].linearStartTime = startTime;
                         playlist[i].incrementSplitCount(privateMethodKey);
+                        journalChange('update', playlist[i]);
                         break;
                     }
                 }
@@ -427,10 +995,13 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                 ///<param name="endTime" type="Number">The end time for playlist. Any entries after this time except post-roll ads should be removed.</param>
                 var i = playlist.length - 1;
                 
+                invalidateIndex();
+
                 // Skip through all the post roll ads but unpdates their linear time
                 while (i >= 0 && playlist[i].isAdvertisement && playlist[i].linearDuration === 0) {
                     playlist[i].linearStartTime = endTime;
                     playlist[i].incrementSplitCount( privateMethodKey );                    
+                    journalChange('update', playlist[i]);
                     i -= 1;
                 }
 
@@ -442,6 +1013,7 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                 if (playlist[i].linearStartTime + playlist[i].linearDuration <= endTime) {
                     playlist[i].linearDuration = endTime - playlist[i].linearStartTime;
                     playlist[i].incrementSplitCount( privateMethodKey );                    
+                    journalChange('update', playlist[i]);
                     return;
                 }
 
@@ -449,6 +1021,7 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                 while (i >= 0 && playlist[i].linearStartTime + playlist[i].linearDuration > endTime) {
                     if (playlist[i].linearStartTime >= endTime) {
                         // The entry is totally beyond the end time, remove it
+                        journalChange('remove', playlist[i]);
                         playlist.splice(i, 1);
                     }
                     else {
@@ -456,6 +1029,7 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                         playlist[i].linearDuration = endTime - playlist[i].linearStartTime;
                         playlist[i].clipEndMediaTime = playlist[i].clipBeginMediaTime + playlist[i].linearDuration;
                         playlist[i].incrementSplitCount( privateMethodKey );                    
+                        journalChange('update', playlist[i]);
                         break;
                     }
 
@@ -472,6 +1046,40 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                 /// <returns type="Object">The playlistEntry found (the first if multiple zero-duration entrys start at the same time)</returns>
                 return playlist[findEntryIndexAtTime(timeToFind)];
             },
+
+            getEntriesInRange: function (startTime, endTime) {
+                /// <summary>Get the playlistEntries that overlap a linear time range.</summary>
+                /// <param name="startTime" type="number">The start of the range (inclusive).</param>
+                /// <param name="endTime" type="number">The end of the range (exclusive).</param>
+                /// <returns type="Array">The playlistEntries in playlist order. Zero-duration entries are included if they start inside the range.</returns>
+                var entries = [],
+                    i,
+                    entry;
+
+                validateIndex();
+                if (isTimeOrdered) {
+                    // skip the entries that end at or before startTime (zero-duration entries need to start at or after it)
+                    i = Math.min(
+                        lowerBound(playlist.length, function (j) { return maxEndTimes[j] > startTime; }),
+                        lowerBound(playlist.length, function (j) { return playlist[j].linearStartTime >= startTime; }));
+                }
+                else {
+                    i = 0;
+                }
+
+                for (; i < playlist.length; i += 1) {
+                    entry = playlist[i];
+                    if (entry.linearStartTime >= endTime) {
+                        if (isTimeOrdered) {
+                            break;
+                        }
+                    }
+                    else if (entry.linearDuration > 0 ? entry.linearStartTime + entry.linearDuration > startTime : entry.linearStartTime >= startTime) {
+                        entries.push(entry);
+                    }
+                }
+                return entries;
+            },
             
             // Fetch the entry that follows the one with the idToFind
             // returns: playlistEntry; falsy if idToFind at end of list
@@ -502,6 +1110,28 @@ PLAYER_SEQUENCER.createSequentialPlaylist = function () {
                 return objFound;
             },
             
+            getVersion: function () {
+                /// <summary>Get the current version of the sequentialPlaylist. The version is incremented for every change.</summary>
+                /// <returns type="number">The version number; 0 before the first change.</returns>
+                return version;
+            },
+
+            getChangesSince: function (sinceVersion) {
+                /// <summary>Get the changes made to the sequentialPlaylist after a given version.</summary>
+                /// <param name="sinceVersion" type="number">The version the caller last saw (0 for all the changes still in the journal).</param>
+                /// <returns type="Object">An object with properties: version (the current version), isComplete (false if older changes were dropped from the journal, so the caller has to re-read the whole sequentialPlaylist) and changes (an array of records with version, operation, id, idRelated, linearStartTime and linearDuration).</returns>
+                var i = changeJournal.length;
+
+                while (i > 0 && changeJournal[i - 1].version > sinceVersion) {
+                    i -= 1;
+                }
+                return {
+                    version: version,
+                    isComplete: changeJournal.length === 0 || changeJournal[0].version <= sinceVersion + 1,
+                    changes: changeJournal.slice(i)
+                };
+            },
+
             getPlaylistLinearDuration: function () {
                 /// <summary>Get the total linear duration of the entire sequentialPlaylist.</summary>
                 /// <returns type="number">The duration in seconds.</returns>
@@ -542,6 +1172,78 @@ PLAYER_SEQUENCER.createScheduler = function (sequentialPlaylist) {
         return duration < 1.0; // this value is replicated in the createContentClipParams comment below
     },
 
+    createContentEntry = function (params, funcName) {
+        // create the playlistEntry for a content clip from the appendContentClip params
+        var playlistEntry;
+
+        playlistEntry = mySequentialPlaylist.createEntry();
+
+        playlistEntry.clipURI = params.clipURI;
+        // Note: eClipType is ignored:
+        playlistEntry.eClipType = 'ProgramContent';
+
+        if (typeof params.clipBeginMediaTime !== 'number') {
+            throw new PLAYER_SEQUENCER.SchedulerError(funcName + ' clipBeginMediaTime not a number');
+        }
+        playlistEntry.clipBeginMediaTime = params.clipBeginMediaTime;
+
+        if (typeof params.clipEndMediaTime !== 'number') {
+            throw new PLAYER_SEQUENCER.SchedulerError(funcName + ' clipEndMediaTime not a number');
+        }
+        playlistEntry.clipEndMediaTime = params.clipEndMediaTime;
+
+        playlistEntry.linearDuration = playlistEntry.clipEndMediaTime - playlistEntry.clipBeginMediaTime;
+
+        if (isDurationTooSmall(playlistEntry.linearDuration)) {
+            throw new PLAYER_SEQUENCER.SchedulerError(funcName + ' duration too small: ' + playlistEntry.linearDuration.toString());
+        }
+        playlistEntry.isAdvertisement = false;
+
+        return playlistEntry;
+    },
+
+    createClipEntry = function (params) {
+        // create the playlistEntry for an ad clip from the scheduleClip params (eRollType is not used here)
+        // Note: the params are validated before the entry is created, so an invalid clip does not use up an id
+        var playlistEntry,
+            clipBeginMediaTime = (params.clipBeginMediaTime !== undefined) ? params.clipBeginMediaTime : 0,
+            clipEndMediaTime,
+            clipMediaTimeDuration;
+
+        if (params.clipEndMediaTime !== undefined) {
+            clipMediaTimeDuration = params.clipEndMediaTime - clipBeginMediaTime;
+            if (isDurationTooSmall(clipMediaTimeDuration)) {
+                throw new PLAYER_SEQUENCER.SchedulerError('scheduleClip clipEndMediaTime too small. Delta: ' + clipMediaTimeDuration.toString());
+            }
+            clipEndMediaTime = params.clipEndMediaTime;
+        }
+        else if (params.linearDuration === 0) {
+            throw new PLAYER_SEQUENCER.SchedulerError('scheduleClip cannot determine clipEndMediaTime given missing clipEndMediaTime and zero linearDuration');
+        }
+        else {
+            clipEndMediaTime = clipBeginMediaTime + params.linearDuration;
+        }
+
+        playlistEntry = mySequentialPlaylist.createEntry();
+
+        playlistEntry.clipURI = params.clipURI;
+        playlistEntry.eClipType = params.eClipType;
+        playlistEntry.linearDuration = params.linearDuration;
+        playlistEntry.clipBeginMediaTime = clipBeginMediaTime;
+        playlistEntry.clipEndMediaTime = clipEndMediaTime;
+
+        playlistEntry.isAdvertisement = true;
+
+        if (params.playbackPolicyObj !== undefined) {
+            playlistEntry.playbackPolicyObj = params.playbackPolicyObj;
+        }
+        if (params.deleteAfterPlayed !== undefined) {
+            playlistEntry.deleteAfterPlayed = params.deleteAfterPlayed;
+        }
+
+        return playlistEntry;
+    },
+
     // ---------------------------------
     // public methods
     // ---------------------------------
@@ -591,73 +1293,43 @@ PLAYER_SEQUENCER.createScheduler = function (sequentialPlaylist) {
             ///<summary>Append a content (non-ad media) clip to the sequential playlist to build up the main content. Must be called one or more times before scheduleClip.</summary>
             ///<param name="params" type="Object">An object obtained with createContentClipParams and then filled in with specific values.</param>
             ///<returns type="Object">The playlistEntry created for the clip.</returns>
-            var playlistEntry;
+            var playlistEntry = createContentEntry(params, 'appendContentClip');
 
-            playlistEntry = mySequentialPlaylist.createEntry();
+            mySequentialPlaylist.insertEntryAfterEnd(playlistEntry);
+
+            return playlistEntry;
+        },
 
-            playlistEntry.clipURI = params.clipURI;
-            // Note: eClipType is ignored:
-            playlistEntry.eClipType = 'ProgramContent';
+        appendContentClips: function (params) {
+            ///<summary>Append a set of content clips as one transaction. All the clips are validated before any is appended; if any clip fails nothing is appended.</summary>
+            ///<param name="params" type="Object">An object with property: clips (an array of objects obtained with createContentClipParams and then filled in), appended in array order.</param>
+            ///<returns type="Object">An object with property: ids (the ids of the playlistEntries created, in the order of the clips).</returns>
+            var playlistEntries = [],
+                ids = [],
+                i;
 
-            if (typeof params.clipBeginMediaTime !== 'number') {
-                throw new PLAYER_SEQUENCER.SchedulerError('appendContentClip clipBeginMediaTime not a number');
+            if (!params || Object.prototype.toString.call(params.clips) !== '[object Array]') {
+                throw new PLAYER_SEQUENCER.SchedulerError('appendContentClips clips missing or not an array');
             }
-            playlistEntry.clipBeginMediaTime = params.clipBeginMediaTime;
 
-            if (typeof params.clipEndMediaTime !== 'number') {
-                throw new PLAYER_SEQUENCER.SchedulerError('appendContentClip clipEndMediaTime not a number');
+            for (i = 0; i < params.clips.length; i += 1) {
+                playlistEntries.push(createContentEntry(params.clips[i], 'appendContentClips'));
             }
-            playlistEntry.clipEndMediaTime = params.clipEndMediaTime;
-
-            playlistEntry.linearDuration = playlistEntry.clipEndMediaTime - playlistEntry.clipBeginMediaTime;
 
-            if (isDurationTooSmall(playlistEntry.linearDuration)) {
-                throw new PLAYER_SEQUENCER.SchedulerError('appendContentClip duration too small: ' + playlistEntry.linearDuration.toString());
+            // appending content cannot fail, so the playList is only changed once all the clips are valid
+            for (i = 0; i < playlistEntries.length; i += 1) {
+                mySequentialPlaylist.insertEntryAfterEnd(playlistEntries[i]);
+                ids.push(playlistEntries[i].id);
             }
-            playlistEntry.isAdvertisement = false;
-
-            mySequentialPlaylist.insertEntryAfterEnd(playlistEntry);
 
-            return playlistEntry;
+            return { ids: ids };
         },
 
         scheduleClip: function (params) {
             ///<summary>Schedule an ad clip. Must not be called until main content that contains the clip has been scheduled.</summary>
             ///<param name="params" type="Object">An object obtained with createScheduleClipParams and then filled in with specific values.</param>
             ///<returns type="Object">The playlistEntry created for the clip.</returns>
-            var playlistEntry, clipMediaTimeDuration;
-
-            playlistEntry = mySequentialPlaylist.createEntry();
-
-            playlistEntry.clipURI = params.clipURI;
-            playlistEntry.eClipType = params.eClipType;
-            playlistEntry.linearDuration = params.linearDuration;
-
-            if (params.clipBeginMediaTime !== undefined) {
-                playlistEntry.clipBeginMediaTime = params.clipBeginMediaTime;
-            }
-            if (params.clipEndMediaTime !== undefined) {
-                clipMediaTimeDuration = params.clipEndMediaTime - playlistEntry.clipBeginMediaTime;
-                if (isDurationTooSmall(clipMediaTimeDuration)) {
-                    throw new PLAYER_SEQUENCER.SchedulerError('scheduleClip clipEndMediaTime too small. Delta: ' + clipMediaTimeDuration.toString());
-                }
-                playlistEntry.clipEndMediaTime = params.clipEndMediaTime;
-            }
-            else if (playlistEntry.linearDuration === 0) {
-                throw new PLAYER_SEQUENCER.SchedulerError('scheduleClip cannot determine clipEndMediaTime given missing clipEndMediaTime and zero linearDuration');
-            }
-            else {
-                playlistEntry.clipEndMediaTime = playlistEntry.clipBeginMediaTime + playlistEntry.linearDuration;
-            }
-
-            playlistEntry.isAdvertisement = true;
-
-            if (params.playbackPolicyObj !== undefined) {
-                playlistEntry.playbackPolicyObj = params.playbackPolicyObj;
-            }
-            if (params.deleteAfterPlayed !== undefined) {
-                playlistEntry.deleteAfterPlayed = params.deleteAfterPlayed;
-            }
+            var playlistEntry = createClipEntry(params);
 
             switch (params.eRollType) {
                 case 'Pre':
@@ -686,6 +1358,107 @@ PLAYER_SEQUENCER.createScheduler = function (sequentialPlaylist) {
             return playlistEntry;
         },
 
+        scheduleClips: function (params) {
+            ///<summary>Schedule a set of ad clips as one transaction. The clips are validated as a set and merged into the sequential playlist in a single pass; if any clip fails nothing is scheduled.</summary>
+            ///<param name="params" type="Object">An object with property: clips (an array of objects obtained with createScheduleClipParams and then filled in). The result is the one of calling scheduleClip for each clip in array order, with the 'Mid' clips taken in order of startTime. A 'Pod' clip with appendTo of -1 is appended to the clip before it in the array.</param>
+            ///<returns type="Object">An object with property: ids (the ids of the playlistEntries created, in the order of the clips).</returns>
+            var insertions = [],
+                playlistEntries = [],
+                ids = [],
+                clipParams,
+                playlistEntry,
+                i;
+
+            if (!params || Object.prototype.toString.call(params.clips) !== '[object Array]') {
+                throw new PLAYER_SEQUENCER.SchedulerError('scheduleClips clips missing or not an array');
+            }
+
+            // the entries are created before they can be validated as a set, so their ids are given back if the set is rejected
+            try {
+                for (i = 0; i < params.clips.length; i += 1) {
+                    clipParams = params.clips[i];
+                    playlistEntry = createClipEntry(clipParams);
+                    playlistEntries.push(playlistEntry);
+
+                    switch (clipParams.eRollType) {
+                        case 'Pre':
+                            playlistEntry.linearDuration = 0;
+                            insertions.push({ playlistEntry: playlistEntry, insertAt: 'Beginning' });
+                            break;
+
+                        case 'Post':
+                            playlistEntry.linearDuration = 0;
+                            insertions.push({ playlistEntry: playlistEntry, insertAt: 'End' });
+                            break;
+
+                        case 'Pod':
+                            if (clipParams.appendTo !== undefined && clipParams.appendTo >= 0) {
+                                insertions.push({ playlistEntry: playlistEntry, insertAt: 'AfterId', idToFind: clipParams.appendTo });
+                            }
+                            else if (i > 0) {
+                                insertions.push({ playlistEntry: playlistEntry, insertAt: 'AfterId', idToFind: ids[i - 1] });
+                            }
+                            else {
+                                throw new PLAYER_SEQUENCER.SchedulerError('scheduleClips first clip is a Pod without appendTo');
+                            }
+                            break;
+
+                        case 'Mid':
+                            if (typeof clipParams.startTime !== 'number') {
+                                throw new PLAYER_SEQUENCER.SchedulerError('scheduleClips startTime not a number');
+                            }
+                            playlistEntry.linearStartTime = clipParams.startTime;
+                            insertions.push({ playlistEntry: playlistEntry, insertAt: 'Time' });
+                            break;
+
+                        default:
+                            throw new PLAYER_SEQUENCER.SchedulerError('scheduleClips invalid eRollType: ' + String(clipParams.eRollType));
+                    }
+                    ids.push(playlistEntry.id);
+                }
+
+                mySequentialPlaylist.insertEntries(insertions);
+            }
+            catch (ex) {
+                mySequentialPlaylist.releaseEntries(playlistEntries);
+                throw ex;
+            }
+
+            return { ids: ids };
+        },
+
+        getPlaylistChanges: function (params) {
+            ///<summary>Get the changes made to the sequential playlist after a given version, instead of reading the whole playlist.</summary>
+            ///<param name="params" type="Object">An object with property: sinceVersion (the version last seen; 0 for all the changes in the journal).</param>
+            ///<returns type="Object">The result of sequentialPlaylist.access.getChangesSince.</returns>
+            return sequentialPlaylist.access.getChangesSince((params && params.sinceVersion) || 0);
+        },
+
+        getEntriesInRange: function (params) {
+            ///<summary>Get the playlist entries that overlap a linear time range, e.g. the VAST entries ahead of the playback position to resolve them early.</summary>
+            ///<param name="params" type="Object">An object with properties: startTime, endTime and an optional eClipType to only get the entries of one clip type.</param>
+            ///<returns type="Object">An object with property entries: an array of records with id, eClipType, clipURI, linearStartTime and linearDuration, in playlist order.</returns>
+            var entries, records = [], i;
+
+            if (typeof params.startTime !== 'number' || typeof params.endTime !== 'number') {
+                throw new PLAYER_SEQUENCER.SchedulerError('getEntriesInRange startTime or endTime not a number');
+            }
+
+            entries = sequentialPlaylist.access.getEntriesInRange(params.startTime, params.endTime);
+            for (i = 0; i < entries.length; i += 1) {
+                if (!params.eClipType || entries[i].eClipType === params.eClipType) {
+                    records.push({
+                        id: entries[i].id,
+                        eClipType: entries[i].eClipType,
+                        clipURI: entries[i].clipURI,
+                        linearStartTime: entries[i].linearStartTime,
+                        linearDuration: entries[i].linearDuration
+                    });
+                }
+            }
+            return { entries: records };
+        },
+
         setSeekToStart: function (params) {
             ///<summary>Set seek-to-start marker. Must not be called until main content has been scheduled.</summary>
             ///<param name="params" type="Object">An optional object with a clipURI property (indicates live content).</param>
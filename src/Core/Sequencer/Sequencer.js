@@ -41,19 +41,29 @@ PLAYER_SEQUENCER.SequencerError = function (message) {
 PLAYER_SEQUENCER.SequencerError.prototype = new Error();
 PLAYER_SEQUENCER.SequencerError.prototype.constructor = PLAYER_SEQUENCER.SequencerError;
 
+// Status codes of the sequencer plugin results.
+// Note: Expected conditions are returned as a status instead of thrown as a SequencerError, since an exception
+//       is serialized with its stack trace by runJSON and it can happen on every seekbar update of a live stream.
+//       mediaToSeekbarTime results always have a status, the seek results only have one when the seek failed.
+PLAYER_SEQUENCER.sequencerStatus = {
+    ok: 'ok',                           // the call succeeded
+    dvrTakeover: 'dvrTakeover',         // the current playback position was taken over by the left DVR edge
+    rangeExceeded: 'rangeExceeded',     // the position is outside the range of the current playback segment
+    outsidePlaylist: 'outsidePlaylist'  // the position is outside the range of the sequential playlist
+};
+
 // -------------------------
 // The playback segment pool
 // -------------------------
 // Note: The purpose of this pool is to provide a unique mapping of segment id numbers to 
 //       playback segment objects which allows referencing the objects through the JSON thunk.
 //       Therefore, the pool can be a Singleton regardless of the number of Sequencer instances used.
+//       The ids come from a generational slab pool, so ids of released segments are never valid again.
 //
 PLAYER_SEQUENCER.playbackSegmentPool = (function () {
 "use strict";
 
-    var nextSegmentId = 1,          // start with 1 so never false
-        poolBaseId = nextSegmentId, // the segmentId of the zeroth pool element
-        pool = [],
+    var pool = PLAYER_SEQUENCER.createSlabPool(PLAYER_SEQUENCER.SequencerError),
     
     // private methods
     throwSetterInhibited = function ( value ) {
@@ -67,15 +77,13 @@ PLAYER_SEQUENCER.playbackSegmentPool = (function () {
             ///<param name="aStartTime" type="Number">media time of where to start playing in the new segment</param>
             ///<param name="aPlaybackRate" type="Number">initial playback rate</param>
             ///<returns type="Object">playbackSegment object that was created</returns>
-            var myId = nextSegmentId,
+            var myId,
                 myClip = aClip,
                 myStartTime = aStartTime,
                 myPlaybackRate = aPlaybackRate,
                 mySplitCount = aClip.splitCount,
                 playbackSegment;
 
-            nextSegmentId += 1;
-
             // DEFINITION of a playbackSegment:
             playbackSegment = {
                 /// <field name="clip" type="Object" mayBeNull="true">reference to a Scheduler sequentialPlaylist object</field>
@@ -94,48 +102,38 @@ PLAYER_SEQUENCER.playbackSegmentPool = (function () {
                 get isClipChanged() { return mySplitCount !== myClip.splitCount; },
                 set isClipChanged(value) { throwSetterInhibited(value); }
             };
-            pool[myId - poolBaseId] = playbackSegment;
+            myId = pool.insert(playbackSegment);
             return playbackSegment;
         },
         releasePlaybackSegment: function (segmentId) {
             ///<summary>Release the segment pool reference to the playback segment object so it can be GCed</summary>
             ///<param name="segmentId" type="Number">The segmentId number of the playback segment to be released from the pool</param>
-            if (pool[segmentId - poolBaseId] === undefined) {
-                throw new PLAYER_SEQUENCER.SequencerError('invalid releasePlaybackSegment Id: ' + segmentId.toString());
-            }
-            if (segmentId === poolBaseId) {
-                do {
-                    // shift out all contiguous released items starting at the base Id
-                    pool.shift();
-                    poolBaseId += 1;
-                } while (pool.length > 0 && pool[0] === null); 
-            }
-            else {
-                // just release the Id and it will be shifted out when all before are released
-                pool[segmentId - poolBaseId] = null;
-            }
+            pool.release(segmentId, 'releasePlaybackSegment');
         },
         getPlaybackSegment: function (segmentId) {
             ///<summary>Get a a reference to the playbackSegment object with the given segmentId</summary>
             ///<param name="segmentId" type="Number">The segmentId number of the playback segment to be referenced</param>
             ///<returns type="Object">playbackSegment object reference</returns>
-            var ps = pool[segmentId - poolBaseId], 
-                ex;
-            if (!ps) {
-                ex = new PLAYER_SEQUENCER.SequencerError('invalid getPlaybackSegment Id: ' + segmentId.toString());
-                throw ex;
-            }
-            return ps;
+            return pool.get(segmentId, 'getPlaybackSegment');
+        },
+        getStatistics: function () {
+            ///<summary>Get the occupancy and high-water mark counters of the playbackSegment pool</summary>
+            ///<returns type="Object">See createSlabPool getStatistics</returns>
+            return pool.getStatistics();
+        },
+        getLeakReport: function () {
+            ///<summary>List the playback segments that have not been released, oldest first</summary>
+            ///<returns type="Array">See createSlabPool getLeakReport</returns>
+            return pool.getLeakReport();
         },
         testProbe_toJSON: function () {
             ///<summary>For testing purposes, return JSON string of the entire playbackSegment pool</summary>
             ///<returns type="String">JSON of the entire playbackSegment pool</returns>
-            return '{' + JSON.stringify(pool) + ',"poolBaseId":' + poolBaseId.toString() + ',"nextSegmentId":' + nextSegmentId.toString() + '}';
+            return JSON.stringify(pool);
         },
         testProbe_reset: function () {
             ///<summary>For testing purposes, reset the entire playbackSegment pool</summary>
-            pool = [];
-            poolBaseId = nextSegmentId; // the segmentId of the zeroth pool element
+            pool.releaseAll();
         }
     };
 }());
@@ -184,9 +182,16 @@ PLAYER_SEQUENCER.createSequencerPluginChain = function ( sequentialPlaylistAcces
                 mediaToSeekbarTime: function ( params ) {
                     ///<summary>Convert media time to seekbar time. Should be called several times per second to keep seekbar updated and catch playlist changes.</summary>
                     ///<param name="params" type="Object">An object with properties: currentSegmentId, playbackRate, currentPlaybackPosition</param>
-                    ///<returns type="Object">An object with properties: currentSeekbarPosition, minSeekbarPosition, maxSeekbarPosition, playbackPolicy, playbackRangeExceeded</returns>
+                    ///<returns type="Object">An object with properties: currentSeekbarPosition, minSeekbarPosition, maxSeekbarPosition, playbackPolicy, playbackRangeExceeded, status (a PLAYER_SEQUENCER.sequencerStatus value)</returns>
                     return nextSequencer.mediaToSeekbarTime(params);
                 },
+
+                getSeekbarMapping: function ( params ) {
+                    ///<summary>Export the media to seekbar time mapping for the current playback segment so the caller can convert positions without calling mediaToSeekbarTime each time. A plugin that overrides mediaToSeekbarTime must either override this too or return null.</summary>
+                    ///<param name="params" type="Object">An object with properties: currentSegmentId</param>
+                    ///<returns type="Object" mayBeNull="true">An object with properties: seekbarOffset, minSeekbarPosition, maxSeekbarPosition, isClampedToRange, playbackPolicy, clipBeginMediaTime, clipEndMediaTime, isLiveWindowApplied (null when the caller must use mediaToSeekbarTime)</returns>
+                    return nextSequencer.getSeekbarMapping(params);
+                },
         
                 mediaToLinearTime: function ( params ) {
                     ///<summary>Convert media time to linear time. Used to determine where to resume from last played position.</summary>
@@ -198,14 +203,14 @@ PLAYER_SEQUENCER.createSequencerPluginChain = function ( sequentialPlaylistAcces
                 seekFromLinearPosition: function ( params ) {
                     ///<summary>Seek to linear time. Used to resume from last played position (no currentSegmentId given0 or to seek out of a zero-linear-duration currentSegmentId.</summary>
                     ///<param name="params" type="Object">An object with properties: currentSegmentId (optional), linearSeekPosition</param>
-                    ///<returns type="Object">A playback segment object reference</returns>
+                    ///<returns type="Object">A playback segment object reference, or an object with properties: status (a PLAYER_SEQUENCER.sequencerStatus value), clip (null) when the seek failed</returns>
                     return nextSequencer.seekFromLinearPosition( params );
                 },
         
                 seekFromSeekbarPosition: function ( params ) {
                     ///<summary>Seek to a position relative to the current playback segment seekbar range.</summary>
                     ///<param name="params" type="Object">An object with properties: currentSegmentId, seekbarSeekPosition</param>
-                    ///<returns type="Object">A playback segment object reference (may be same as that for currentSegmentId)</returns>
+                    ///<returns type="Object">A playback segment object reference (may be same as that for currentSegmentId), or an object with properties: status (a PLAYER_SEQUENCER.sequencerStatus value), clip (null) when the seek failed</returns>
                     return nextSequencer.seekFromSeekbarPosition( params );
                 },
         
@@ -223,6 +228,13 @@ PLAYER_SEQUENCER.createSequencerPluginChain = function ( sequentialPlaylistAcces
                     return nextSequencer.onEndOfBuffering( params );
                 },
         
+                getUpcomingSegments: function ( params ) {
+                    ///<summary>Look ahead of the current playback segment for the playlist entries to be played next, so the caller can preload more than one of them. Unlike onEndOfBuffering no playback segment is created and the Scheduler is not notified.</summary>
+                    ///<param name="params" type="Object">An object with properties: currentSegmentId, currentPlaybackRate, count</param>
+                    ///<returns type="Object">An object with property segments: an array of up to count objects with properties clip, initialPlaybackStartTime, initialPlaybackRate (segmentId is 0 since they are not in the playback segment pool)</returns>
+                    return nextSequencer.getUpcomingSegments( params );
+                },
+        
                 onError: function ( params ) {
                     ///<summary>Notify playback error to get a new playback segment object for the next segment in the sequence to use after an error.</summary>
                     ///<param name="params" type="Object">An object with properties: currentSegmentId, currentPlaybackPosition (in media time), currentPlaybackRate, isNotPlayed, isEndOfSequence, errorDescription</param>
@@ -230,6 +242,13 @@ PLAYER_SEQUENCER.createSequencerPluginChain = function ( sequentialPlaylistAcces
                     return nextSequencer.onError( params );
                 },
 
+                updateLiveWindow: function ( params ) {
+                    ///<summary>Notify the live window tracked from the live playlist refreshes. Called once per refresh, not per seekbar update.</summary>
+                    ///<param name="params" type="Object">An object with properties: leftDvrEdge, livePosition (in media time), leftDvrEdgeRate, livePositionRate (in seconds per second)</param>
+                    ///<returns mayBeNull="true">null</returns>
+                    return nextSequencer.updateLiveWindow( params );
+                },
+
                 testProbe: function ( params ) {
                     ///<summary>For testing purposes: generic invocation of a test probe. This is a "tunneling" mechanism for a private contract between the caller and a specific sequencer plugin.</summary>
                     ///<param name="params" type="Object">An object with properties dependent upon the specific probe to be performed.</param>
@@ -419,7 +438,35 @@ PLAYER_SEQUENCER.createDefaultSequencerPlugin = function (basePlugin) {
             minSeekbarPosition: minSeekbarPosition,
             maxSeekbarPosition: maxSeekbarPosition,
             playbackPolicy: playbackPolicy,
-            playbackRangeExceeded: playbackRangeExceeded
+            playbackRangeExceeded: playbackRangeExceeded,
+            status: playbackRangeExceeded ? PLAYER_SEQUENCER.sequencerStatus.rangeExceeded : PLAYER_SEQUENCER.sequencerStatus.ok
+        };
+    };
+
+    basePlugin.getSeekbarMapping = function ( params ) {
+        /* params:
+        currentSegmentId,           // number: the unique Id for the playback segment
+        */
+        // Within one playlist entry mediaToSeekbarTime is a fixed offset with an optional clamp, so
+        // export those terms. The mapping stays valid until the playlist or the segment changes.
+        var currentSegment = myPlaybackSegmentPool.getPlaybackSegment(params.currentSegmentId),
+            entry = currentSegment.clip,
+            isLinearAd = entry.isAdvertisement && entry.linearDuration === 0;
+
+        if (currentSegment.isClipChanged) {
+            // mediaToSeekbarTime must anneal the segment clip first
+            return null;
+        }
+
+        return {
+            seekbarOffset: isLinearAd ? -entry.clipBeginMediaTime : entry.linearStartTime - entry.clipBeginMediaTime,
+            minSeekbarPosition: 0,
+            maxSeekbarPosition: isLinearAd ? entry.clipEndMediaTime - entry.clipBeginMediaTime : mySequentialPlaylist.getPlaylistLinearDuration(),
+            isClampedToRange: isLinearAd,
+            playbackPolicy: isLinearAd ? entry.playbackPolicyObj : null,
+            clipBeginMediaTime: entry.clipBeginMediaTime,
+            clipEndMediaTime: entry.clipEndMediaTime,
+            isLiveWindowApplied: false
         };
     };
 
@@ -457,7 +504,7 @@ PLAYER_SEQUENCER.createDefaultSequencerPlugin = function (basePlugin) {
             if (currentSegment) {
                 myPlaybackSegmentPool.releasePlaybackSegment(currentSegment.segmentId);
             }
-            throw new PLAYER_SEQUENCER.SequencerError('seekFromLinearPosition outside playlist range');
+            return { status: PLAYER_SEQUENCER.sequencerStatus.outsidePlaylist, clip: null };
         }
 
         if (currentSegment) {
@@ -490,7 +537,7 @@ PLAYER_SEQUENCER.createDefaultSequencerPlugin = function (basePlugin) {
             // Note: For non-zero-duration clips, seekbar time is the same as linear time.
             seekPlaylistEntry = mySequentialPlaylist.getEntryAtTime(params.seekbarSeekPosition);
             if (!seekPlaylistEntry) {
-                throw new PLAYER_SEQUENCER.SequencerError('seekFromSeekbarPosition outside playlist range');
+                return { status: PLAYER_SEQUENCER.sequencerStatus.outsidePlaylist, clip: null };
             }
             initialPlaybackRate = currentSegment.initialPlaybackRate;
             initialPlaybackStartTime = seekPlaylistEntry.clipBeginMediaTime;
@@ -501,7 +548,7 @@ PLAYER_SEQUENCER.createDefaultSequencerPlugin = function (basePlugin) {
         }
         else if (params.seekbarSeekPosition > currentSegment.clip.clipEndMediaTime - currentSegment.clip.clipBeginMediaTime) {
             // for zero-duration clips seeking must be within the clip
-            throw new PLAYER_SEQUENCER.SequencerError('seekFromSeekbarPosition outside segment range');
+            return { status: PLAYER_SEQUENCER.sequencerStatus.rangeExceeded, clip: null };
         }
         else {
             // use the same zero-duration clip to create the new segment
@@ -525,12 +572,44 @@ PLAYER_SEQUENCER.createDefaultSequencerPlugin = function (basePlugin) {
         return myOnEnd(params, false);
     };
 
+    basePlugin.getUpcomingSegments = function ( params ) {
+        /* params:
+        currentSegmentId            // number: the unique Id for the playback segment
+        currentPlaybackRate         // number: the current playback rate
+        count                       // number: the maximum number of segments to look ahead
+        */
+        // Walk the playlist the same way as myOnEnd, without creating playback segments
+        var entry = myPlaybackSegmentPool.getPlaybackSegment(params.currentSegmentId).clip,
+            isPlayForward = 0 <= params.currentPlaybackRate,
+            segments = [];
+
+        while (segments.length < params.count) {
+            entry = isPlayForward ? mySequentialPlaylist.getEntryAfterId(entry.id) : mySequentialPlaylist.getEntryBeforeId(entry.id);
+            if (!entry) {
+                break;
+            }
+            segments.push({
+                clip: entry,
+                initialPlaybackStartTime: isPlayForward ? entry.clipBeginMediaTime : entry.clipEndMediaTime,
+                initialPlaybackRate: params.currentPlaybackRate,
+                segmentId: 0
+            });
+        }
+
+        return { segments: segments };
+    };
+
     basePlugin.onError = function ( params ) {
         // NOTE: The default implementation treats onError the same as onEndOfMedia.
         //       A sequencer plugin is required to take some other action.
         return myOnEnd(params, true);
     };
 
+    basePlugin.updateLiveWindow = function ( params ) {
+        // The default sequencer has no live window
+        return null;
+    };
+
     basePlugin.testProbe = function ( params ) {
         // we can add testProbe functionallity based on 'params' here
         return "default sequencer";
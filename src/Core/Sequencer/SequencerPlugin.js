@@ -67,10 +67,11 @@ PLAYER_SEQUENCER.createLiveSequencerPlugin = function (livePlugin) {
             else if (!(params.leftDvrEdge === undefined && params.livePosition === undefined || entry.isAdvertisement && currentSegment.clip.linearDuration === 0)) {
                 // override the base sequencer seekbar range
                 if (params.leftDvrEdge !== undefined) {
-                    // throw exception for left DVR take-over
+                    // report the left DVR take-over, the caller snaps the position to the left DVR edge
                     if (currentPosition < params.leftDvrEdge) {
-                        throw new PLAYER_SEQUENCER.SequencerError(
-                                                                  'mediaToSeekbarTime failed since current playback position ' + currentPosition.toString() + 'is taken over by left DVR edge ' + params.leftDvrEdge.toString());
+                        result.currentSeekbarPosition = currentPosition;
+                        result.status = PLAYER_SEQUENCER.sequencerStatus.dvrTakeover;
+                        return result;
                     }
                     
                     // override the seekbar range with left DVR edge
@@ -91,6 +92,23 @@ PLAYER_SEQUENCER.createLiveSequencerPlugin = function (livePlugin) {
         return result;
     };
 
+    livePlugin.getSeekbarMapping = function (params) {
+        /* params:
+        currentSegmentId,           // number: the unique Id for the playback segment
+        */
+        var result = livePlugin.getNextSequencer().getSeekbarMapping(params),
+            entry;
+
+        if (result) {
+            // the caller applies the left DVR edge and live position to the seekbar range the same way as
+            // mediaToSeekbarTime does, and calls mediaToSeekbarTime when the left DVR edge takes over
+            entry = PLAYER_SEQUENCER.playbackSegmentPool.getPlaybackSegment(params.currentSegmentId).clip;
+            result.isLiveWindowApplied = !(entry.isAdvertisement && entry.linearDuration === 0);
+        }
+
+        return result;
+    };
+
     livePlugin.seekFromLinearPosition = function (params) {
         /* params:
         currentSegmentId,           // number: optional unique Id for the currrent playback segment; 0 or undefined for no current segment
@@ -109,6 +127,7 @@ PLAYER_SEQUENCER.createLiveSequencerPlugin = function (livePlugin) {
 
         return livePlugin.getNextSequencer().seekFromLinearPosition(params);
     };
+
 };
 
 PLAYER_SEQUENCER.createCustomSequencerPlugin = function (customPlugin) {
@@ -121,6 +140,13 @@ PLAYER_SEQUENCER.createCustomSequencerPlugin = function (customPlugin) {
     // if you want to implement a custom sequencer plugin
 //    customPlugin.mediaToSeekbarTime = function ( params ) {
 //        throw new PLAYER_SEQUENCER.SequencerError('If you see this the plugin is correctly added to the project');
+//    };
+
+    // A plugin which replaces mediaToSeekbarTime must also replace getSeekbarMapping, otherwise the native
+    // side converts media time with the mapping of the plugins further down the chain. Returning null makes
+    // the native side call mediaToSeekbarTime on every seekbar update.
+//    customPlugin.getSeekbarMapping = function ( params ) {
+//        return null;
 //    };
 };
 
@@ -0,0 +1,214 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+// This file contains a node.js benchmark of the ad model parser in AdResolver.js. It scales the VAST pod sample
+// to documents of more and more ads, then measures for each size the time to create an AdResolver entry and the
+// heap retained by the created entries, once from the XML string with the ad model parser and once through the
+// DOM path, where the string is parsed with DOMParser and the Document is given to createEntry.
+//
+// Usage: node [--expose-gc] AdResolverBenchmark.js [--sizes <ad count>,<ad count>...] [--iterations <count>] [--verify]
+//
+// The DOM path holds on to the parsed Documents while its entries are held, as the AdResolver did before it kept
+// the ad model, so the retained heap compares the model with the DOM. Run node with --expose-gc for a stable heap
+// measurement. --verify compares the resolveAll results of the two paths. The exit code is 1 if any result differs.
+
+var fs = require('fs'),
+    path = require('path'),
+    TRACE_REPLAYER = require('./TraceReplayer.js');
+
+var ADRESOLVER_BENCHMARK = (function () {
+"use strict";
+
+    var samplePath = path.join(__dirname, '..', '..', 'HTML', 'Samples', 'Player', 'PlayerTestVASTPod.xml'),
+        heldEntryCount = 20,    // the entries held at once for the retained heap measurement
+
+    // private methods
+    elapsedMs = function (startTime) {
+        var elapsed = process.hrtime(startTime);
+
+        return elapsed[0] * 1e3 + elapsed[1] / 1e6;
+    },
+
+    heapUsed = function () {
+        if (typeof global.gc === 'function') {
+            global.gc();
+        }
+        return process.memoryUsage().heapUsed;
+    },
+
+    // every manifest differs by a trailing comment so the ad model cache never returns an earlier model
+    uniqueManifest = function (manifest, iteration) {
+        return manifest + '<!-- ' + iteration + ' -->';
+    },
+
+    parseWithModel = function (context, manifest) {
+        return { entryId: context.PLAYER_SEQUENCER.theAdResolver.vast.createEntry(manifest), doc: null };
+    },
+
+    parseWithDOM = function (context, manifest) {
+        var doc = new context.DOMParser().parseFromString(manifest);
+
+        return { entryId: context.PLAYER_SEQUENCER.theAdResolver.vast.createEntry(doc), doc: doc };
+    },
+
+    measure = function (context, manifest, iterations, parseFunc) {
+        var resolver = context.PLAYER_SEQUENCER.theAdResolver,
+            held = [],
+            heapBefore,
+            startTime,
+            parsed,
+            result = {},
+            i;
+
+        startTime = process.hrtime();
+        for (i = 0; i < iterations; i += 1) {
+            parsed = parseFunc(context, uniqueManifest(manifest, i));
+            resolver.releaseEntry(parsed.entryId);
+        }
+        result.parseMs = elapsedMs(startTime) / iterations;
+
+        heapBefore = heapUsed();
+        for (i = 0; i < heldEntryCount; i += 1) {
+            held.push(parseFunc(context, uniqueManifest(manifest, iterations + i)));
+        }
+        result.retainedBytes = (heapUsed() - heapBefore) / heldEntryCount;
+        held.forEach(function (entry) {
+            resolver.releaseEntry(entry.entryId);
+        });
+        return result;
+    };
+
+    return {
+        ///<summary>Build a VAST document with a given number of ads from the VAST pod sample</summary>
+        ///<param name="adCount" type="Number">the number of ads in the document</param>
+        ///<returns type="String">the VAST document</returns>
+        createManifest: function (adCount) {
+            var sample = fs.readFileSync(samplePath, 'utf8'),
+                adsPattern = /<Ad[\s>][\s\S]*<\/Ad>/,
+                ads = sample.match(adsPattern)[0],
+                scaledAds = [],
+                i;
+
+            for (i = 0; i < adCount; i += 1) {
+                scaledAds.push(ads);
+            }
+            return sample.replace(adsPattern, function () { return scaledAds.join('\n'); });
+        },
+
+        ///<summary>Measure the model parser and the DOM path for one document size</summary>
+        ///<param name="adCount" type="Number">the number of times the ads of the sample are repeated</param>
+        ///<param name="iterations" type="Number">the number of entries created for the parse time</param>
+        ///<param name="verify" type="Boolean">true to compare the resolveAll results of the two paths</param>
+        ///<returns type="Object">the report with the document size, the parse times in ms, the retained bytes per entry and the mismatches</returns>
+        run: function (adCount, iterations, verify) {
+            var context = TRACE_REPLAYER.createCore(),
+                resolver = context.PLAYER_SEQUENCER.theAdResolver,
+                manifest = this.createManifest(adCount),
+                report = { adCount: adCount, manifestBytes: manifest.length, mismatches: 0 },
+                model,
+                dom,
+                modelEntry,
+                domEntry;
+
+            // with no budget the cache keeps only the models of held entries, so the retained heap is theirs alone
+            context.PLAYER_SEQUENCER.theAdModelCache.setBudget(0);
+            model = measure(context, manifest, iterations, parseWithModel);
+            dom = measure(context, manifest, iterations, parseWithDOM);
+            report.modelParseMs = model.parseMs;
+            report.domParseMs = dom.parseMs;
+            report.modelRetainedBytes = model.retainedBytes;
+            report.domRetainedBytes = dom.retainedBytes;
+
+            if (verify) {
+                modelEntry = parseWithModel(context, manifest);
+                domEntry = parseWithDOM(context, manifest);
+                if (JSON.stringify(resolver.vast.resolveAll({ entryId: modelEntry.entryId })) !==
+                    JSON.stringify(resolver.vast.resolveAll({ entryId: domEntry.entryId }))) {
+                    report.mismatches += 1;
+                }
+                resolver.releaseEntry(modelEntry.entryId);
+                resolver.releaseEntry(domEntry.entryId);
+            }
+            return report;
+        },
+
+        ///<summary>Format the reports of runs as a table</summary>
+        ///<param name="reports" type="Array">the reports returned by run</param>
+        ///<returns type="String">the table</returns>
+        formatReports: function (reports) {
+            var lines = ['      ads     bytes  model ms    DOM ms  model KB    DOM KB'];
+
+            reports.forEach(function (report) {
+                lines.push(('         ' + report.adCount).slice(-9) +
+                           ('          ' + report.manifestBytes).slice(-10) +
+                           ('          ' + report.modelParseMs.toFixed(3)).slice(-10) +
+                           ('          ' + report.domParseMs.toFixed(3)).slice(-10) +
+                           ('          ' + (report.modelRetainedBytes / 1024).toFixed(1)).slice(-10) +
+                           ('          ' + (report.domRetainedBytes / 1024).toFixed(1)).slice(-10));
+            });
+            return lines.join('\n');
+        }
+    };
+}());
+
+module.exports = ADRESOLVER_BENCHMARK;
+
+if (require.main === module) {
+    (function () {
+        "use strict";
+
+        var args = process.argv.slice(2),
+            sizes = [1, 10, 100, 1000],
+            iterations = 50,
+            verify = false,
+            reports = [],
+            mismatchCount = 0,
+            i;
+
+        for (i = 0; i < args.length; i += 1) {
+            if (args[i] === '--sizes') {
+                i += 1;
+                sizes = args[i].split(',').map(function (size) { return parseInt(size, 10); });
+            }
+            else if (args[i] === '--iterations') {
+                i += 1;
+                iterations = parseInt(args[i], 10);
+            }
+            else if (args[i] === '--verify') {
+                verify = true;
+            }
+            else {
+                console.log('Usage: node [--expose-gc] AdResolverBenchmark.js [--sizes <ad count>,<ad count>...] [--iterations <count>] [--verify]');
+                process.exit(2);
+            }
+        }
+
+        if (typeof global.gc !== 'function') {
+            console.log('Run node with --expose-gc for a stable retained heap measurement');
+        }
+        sizes.forEach(function (size) {
+            var report = ADRESOLVER_BENCHMARK.run(size, iterations, verify);
+
+            reports.push(report);
+            mismatchCount += report.mismatches;
+        });
+
+        console.log(ADRESOLVER_BENCHMARK.formatReports(reports));
+        if (verify) {
+            console.log(mismatchCount + ' mismatched results');
+        }
+        process.exit(mismatchCount > 0 ? 1 : 0);
+    }());
+}
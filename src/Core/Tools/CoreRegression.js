@@ -0,0 +1,323 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+// This file contains a node.js regression test of the sequencer core which runs headless, e.g. on a Linux CI box.
+// It replays every trace in the Traces directory and verifies each result, then runs the scheduler and the ad
+// model parser benchmarks in their verify mode at small sizes, and reports the latencies of the replayed calls.
+// It also schedules random sets of ad clips with scheduleClips and compares each one with scheduleClip called
+// for every clip of the set in turn.
+//
+// Usage: node CoreRegression.js [--traces <directory>] [--batches <count>]
+//
+// The traces have the format written by RecordingEngineHost. A trace must be recorded again when a change of the
+// core scripts changes one of its results on purpose. The exit code is 1 if any trace result, benchmark result or
+// scheduled set does not match.
+
+var fs = require('fs'),
+    path = require('path'),
+    TRACE_REPLAYER = require('./TraceReplayer.js'),
+    SCHEDULER_BENCHMARK = require('./SchedulerBenchmark.js'),
+    ADRESOLVER_BENCHMARK = require('./AdResolverBenchmark.js');
+
+var CORE_REGRESSION = (function () {
+"use strict";
+
+    var schedulerSizes = [1000, 10000],
+        schedulerLookupCount = 1000,
+        adCounts = [1, 10],
+        adIterations = 5,
+        rollTypes = ['Pre', 'Post', 'Mid', 'Mid', 'Mid', 'Pod'],
+        startTimes = [0, 10, 10, 12, 15, 20, 50, 99, 100, 130, 160],
+        linearDurations = [0, 0, 5, 10],
+
+    // private methods
+    createRandom = function (seed) {
+        // the same generator as SchedulerBenchmark, so every run schedules the same sets
+        var state = seed;
+
+        return function () {
+            state = (state * 1103515245 + 12345) % 2147483648;
+            return state / 2147483648;
+        };
+    },
+
+    pick = function (random, values) {
+        return values[Math.floor(random() * values.length)];
+    },
+
+    createClips = function (random, name) {
+        // up to 5 ad clips, a Pod is appended to the clip before it or to an entry already in the playlist.
+        // scheduleClips merges the mid-rolls in start time order, so they are listed in that order.
+        var clipCount = 1 + Math.floor(random() * 5),
+            clips = [],
+            mids,
+            i;
+
+        for (i = 0; i < clipCount; i += 1) {
+            clips.push({
+                clipURI: 'http://regression/' + name + i + '.m3u8',
+                eRollType: (i === 0) ? pick(random, ['Pre', 'Post', 'Mid']) : pick(random, rollTypes),
+                startTime: pick(random, startTimes),
+                linearDuration: pick(random, linearDurations),
+                appendToPlaylist: random() < 0.2,
+                playlistIndex: Math.floor(random() * 100)
+            });
+        }
+        mids = clips.filter(function (clip) {
+            return clip.eRollType === 'Mid';
+        });
+        mids.sort(function (a, b) {
+            return a.startTime - b.startTime;
+        });
+        return clips.map(function (clip) {
+            return (clip.eRollType === 'Mid') ? mids.shift() : clip;
+        });
+    },
+
+    createScheduleClipParams = function (scheduler, sequentialPlaylist, clip) {
+        var params = scheduler.createScheduleClipParams(),
+            entries;
+
+        params.clipURI = clip.clipURI;
+        params.eClipType = 'Media';
+        params.clipEndMediaTime = clip.linearDuration || 3;
+        params.linearDuration = clip.linearDuration;
+        params.startTime = clip.startTime;
+        params.eRollType = clip.eRollType;
+        if (clip.eRollType === 'Pod' && clip.appendToPlaylist) {
+            entries = JSON.parse(sequentialPlaylist.testProbe_toJSON());
+            params.appendTo = entries[clip.playlistIndex % entries.length].id;
+        }
+        return params;
+    },
+
+    createSchedule = function (context, random, clips) {
+        // program content with the ads already scheduled one at a time, skipping the ones which do not fit
+        var sequentialPlaylist = context.PLAYER_SEQUENCER.createSequentialPlaylist(),
+            scheduler = context.PLAYER_SEQUENCER.createScheduler(sequentialPlaylist),
+            contentParams = scheduler.createContentClipParams(),
+            lastId = -1;
+
+        contentParams.clipURI = 'http://regression/content.m3u8';
+        contentParams.clipEndMediaTime = 100;
+        scheduler.appendContentClip(contentParams);
+        if (random() < 0.3) {
+            contentParams.clipEndMediaTime = 60;
+            scheduler.appendContentClip(contentParams);
+        }
+        clips.forEach(function (clip) {
+            var params = createScheduleClipParams(scheduler, sequentialPlaylist, clip);
+
+            if (clip.eRollType === 'Pod' && !clip.appendToPlaylist) {
+                params.appendTo = lastId;
+            }
+            try {
+                lastId = scheduler.scheduleClip(params).id;
+            }
+            catch (ex) {
+                lastId = -1;
+            }
+        });
+        return { sequentialPlaylist: sequentialPlaylist, scheduler: scheduler };
+    },
+
+    describePlaylist = function (sequentialPlaylist) {
+        // the ids are left out, and so are the empty content entries the sequential inserts leave between overlay ads
+        return JSON.parse(sequentialPlaylist.testProbe_toJSON()).filter(function (entry) {
+            return entry.isAdvertisement || entry.linearDuration > 0;
+        }).map(function (entry) {
+            return [entry.clipURI, entry.linearStartTime.toFixed(3), entry.linearDuration.toFixed(3),
+                    entry.clipBeginMediaTime.toFixed(3), entry.clipEndMediaTime.toFixed(3)].join(' ');
+        }).join('\n');
+    },
+
+    scheduleRandomClips = function (context, seed) {
+        // schedule the same random set of clips on two copies of a random playlist, one clip at a time and as a set
+        var random = createRandom(seed),
+            scheduledClips = createClips(random, 'scheduled'),
+            clips = createClips(random, 'ad'),
+            sequential = createSchedule(context, createRandom(seed), scheduledClips),
+            batch = createSchedule(context, createRandom(seed), scheduledClips),
+            result = { seed: seed, clips: clips },
+            playlistBefore = describePlaylist(batch.sequentialPlaylist),
+            lastId = -1,
+            params = [],
+            i;
+
+        // the params are created first, so a Pod appended to an entry of the playlist gets the same entry in both
+        for (i = 0; i < clips.length; i += 1) {
+            params.push(createScheduleClipParams(sequential.scheduler, sequential.sequentialPlaylist, clips[i]));
+        }
+        try {
+            for (i = 0; i < clips.length; i += 1) {
+                if (clips[i].eRollType === 'Pod' && !clips[i].appendToPlaylist) {
+                    params[i].appendTo = lastId;
+                }
+                lastId = sequential.scheduler.scheduleClip(params[i]).id;
+            }
+            result.expected = describePlaylist(sequential.sequentialPlaylist);
+        }
+        catch (ex) {
+            result.expected = 'rejected';
+        }
+
+        try {
+            // a Pod with appendTo of -1 is appended to the clip before it
+            params = [];
+            for (i = 0; i < clips.length; i += 1) {
+                params.push(createScheduleClipParams(batch.scheduler, batch.sequentialPlaylist, clips[i]));
+            }
+            batch.scheduler.scheduleClips({ clips: params });
+            result.actual = describePlaylist(batch.sequentialPlaylist);
+        }
+        catch (ex) {
+            // a rejected set must leave the playlist as it was
+            result.actual = (describePlaylist(batch.sequentialPlaylist) === playlistBefore) ? 'rejected' : 'rejected with changes';
+        }
+        return result;
+    };
+
+    return {
+        ///<summary>Replay the traces of a directory and verify every result</summary>
+        ///<param name="traceDirectory" type="String">the directory of the .trace files</param>
+        ///<returns type="Object">{ traceCount, callCount, mismatches: [{ trace, index, name, expected, actual }], latencies: { name: [ms] } }</returns>
+        replayTraces: function (traceDirectory) {
+            var report = { traceCount: 0, callCount: 0, mismatches: [], latencies: {} };
+
+            fs.readdirSync(traceDirectory).filter(function (fileName) {
+                return path.extname(fileName) === '.trace';
+            }).sort().forEach(function (fileName) {
+                var records = TRACE_REPLAYER.loadTrace(path.join(traceDirectory, fileName)),
+                    replay = TRACE_REPLAYER.replay(records, true);
+
+                report.traceCount += 1;
+                report.callCount += records.length;
+                replay.mismatches.forEach(function (mismatch) {
+                    mismatch.trace = fileName;
+                    report.mismatches.push(mismatch);
+                });
+                Object.keys(replay.latencies).forEach(function (name) {
+                    report.latencies[name] = (report.latencies[name] || []).concat(replay.latencies[name]);
+                });
+            });
+            return report;
+        },
+
+        ///<summary>Run the scheduler benchmark in its verify mode</summary>
+        ///<returns type="Number">the number of mismatched lookups</returns>
+        verifyScheduler: function () {
+            return schedulerSizes.reduce(function (mismatchCount, size) {
+                return mismatchCount + SCHEDULER_BENCHMARK.run(size, schedulerLookupCount, true).mismatches;
+            }, 0);
+        },
+
+        ///<summary>Schedule random sets of ad clips with scheduleClips and with scheduleClip for every clip in turn, and compare the results</summary>
+        ///<param name="batchCount" type="Number">the number of sets</param>
+        ///<returns type="Object">{ batchCount, rejectedCount, mismatches: [{ seed, clips, expected, actual }] }</returns>
+        verifyScheduleClips: function (batchCount) {
+            var context = TRACE_REPLAYER.createCore(),
+                report = { batchCount: batchCount, rejectedCount: 0, mismatches: [] },
+                result,
+                seed;
+
+            for (seed = 1; seed <= batchCount; seed += 1) {
+                result = scheduleRandomClips(context, seed);
+                if (result.expected === 'rejected') {
+                    report.rejectedCount += 1;
+                }
+                if (result.expected !== result.actual) {
+                    report.mismatches.push(result);
+                }
+            }
+            return report;
+        },
+
+        ///<summary>Run the ad model parser benchmark in its verify mode</summary>
+        ///<returns type="Number">the number of mismatched results</returns>
+        verifyAdResolver: function () {
+            return adCounts.reduce(function (mismatchCount, adCount) {
+                return mismatchCount + ADRESOLVER_BENCHMARK.run(adCount, adIterations, true).mismatches;
+            }, 0);
+        }
+    };
+}());
+
+module.exports = CORE_REGRESSION;
+
+if (require.main === module) {
+    (function () {
+        "use strict";
+
+        var args = process.argv.slice(2),
+            traceDirectory = path.join(__dirname, 'Traces'),
+            maxReportedMismatches = 10,
+            batchCount = 3000,
+            failureCount = 0,
+            traces,
+            schedulerMismatchCount,
+            adResolverMismatchCount,
+            scheduleClips,
+            i;
+
+        for (i = 0; i < args.length; i += 1) {
+            if (args[i] === '--traces') {
+                i += 1;
+                traceDirectory = args[i];
+            }
+            else if (args[i] === '--batches') {
+                i += 1;
+                batchCount = parseInt(args[i], 10);
+            }
+            else {
+                console.log('Usage: node CoreRegression.js [--traces <directory>] [--batches <count>]');
+                process.exit(2);
+            }
+        }
+
+        traces = CORE_REGRESSION.replayTraces(traceDirectory);
+        traces.mismatches.slice(0, maxReportedMismatches).forEach(function (mismatch) {
+            console.log('Mismatch in ' + mismatch.trace + ' at call ' + mismatch.index + ' (' + mismatch.name + ')');
+            console.log('  expected: ' + mismatch.expected);
+            console.log('  actual:   ' + mismatch.actual);
+        });
+        console.log(TRACE_REPLAYER.formatLatencies(traces.latencies));
+        console.log(traces.traceCount + ' traces, ' + traces.callCount + ' calls, ' + traces.mismatches.length + ' mismatched results');
+        failureCount += traces.mismatches.length;
+        if (traces.traceCount === 0) {
+            console.log('No traces in ' + traceDirectory);
+            failureCount += 1;
+        }
+
+        schedulerMismatchCount = CORE_REGRESSION.verifyScheduler();
+        console.log('Scheduler: ' + schedulerMismatchCount + ' mismatched lookups');
+        failureCount += schedulerMismatchCount;
+
+        adResolverMismatchCount = CORE_REGRESSION.verifyAdResolver();
+        console.log('AdResolver: ' + adResolverMismatchCount + ' mismatched results');
+        failureCount += adResolverMismatchCount;
+
+        scheduleClips = CORE_REGRESSION.verifyScheduleClips(batchCount);
+        scheduleClips.mismatches.slice(0, maxReportedMismatches).forEach(function (mismatch) {
+            console.log('Mismatch in scheduleClips set ' + mismatch.seed + ': ' + JSON.stringify(mismatch.clips));
+            console.log('  expected: ' + mismatch.expected.replace(/\n/g, '\n            '));
+            console.log('  actual:   ' + mismatch.actual.replace(/\n/g, '\n            '));
+        });
+        console.log('scheduleClips: ' + scheduleClips.batchCount + ' sets (' + scheduleClips.rejectedCount + ' rejected), ' +
+                    scheduleClips.mismatches.length + ' mismatched sets');
+        failureCount += scheduleClips.mismatches.length;
+
+        process.exit(failureCount > 0 ? 1 : 0);
+    }());
+}
@@ -0,0 +1,229 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+// This file contains a node.js benchmark of the sequential playlist index in Scheduler.js. It builds a playlist
+// of split program content and mid-roll ads in random order, then measures the cost of the inserts and of the
+// getEntryAtTime, getEntryAfterId and getEntriesInRange lookups at each playlist size.
+//
+// Usage: node SchedulerBenchmark.js [--sizes <count>,<count>...] [--lookups <count>] [--verify]
+//
+// --verify compares every lookup with a forward scan of the playlist. The exit code is 1 if any lookup differs.
+
+var TRACE_REPLAYER = require('./TraceReplayer.js');
+
+var SCHEDULER_BENCHMARK = (function () {
+"use strict";
+
+    var contentSlotDuration = 10,   // each mid-roll splits a slot of program content this long
+
+    // private methods
+    createRandom = function (seed) {
+        // a small deterministic generator, so every run schedules the same playlist
+        var state = seed;
+
+        return function () {
+            state = (state * 1103515245 + 12345) % 2147483648;
+            return state / 2147483648;
+        };
+    },
+
+    shuffle = function (list, random) {
+        var i, j, value;
+
+        for (i = list.length - 1; i > 0; i -= 1) {
+            j = Math.floor(random() * (i + 1));
+            value = list[i];
+            list[i] = list[j];
+            list[j] = value;
+        }
+        return list;
+    },
+
+    elapsedMs = function (startTime) {
+        var elapsed = process.hrtime(startTime);
+
+        return elapsed[0] * 1e3 + elapsed[1] / 1e6;
+    },
+
+    // the lookups as the linear scans did them before the playlist was indexed
+    scanEntryAtTime = function (entries, timeToFind) {
+        var i;
+
+        for (i = 0; i < entries.length; i += 1) {
+            if (Math.abs(entries[i].linearStartTime - timeToFind) < 0.001 ||
+                (entries[i].linearStartTime <= timeToFind && timeToFind < entries[i].linearStartTime + entries[i].linearDuration)) {
+                return entries[i];
+            }
+        }
+        return undefined;
+    },
+
+    scanEntriesInRange = function (entries, startTime, endTime) {
+        return entries.filter(function (entry) {
+            return entry.linearStartTime < endTime &&
+                   (entry.linearDuration > 0 ? entry.linearStartTime + entry.linearDuration > startTime : entry.linearStartTime >= startTime);
+        });
+    },
+
+    idOf = function (entry) {
+        return entry ? entry.id : 0;
+    };
+
+    return {
+        ///<summary>Build a playlist of about entryCount entries and measure the inserts and lookups</summary>
+        ///<param name="entryCount" type="Number">the number of playlist entries (each mid-roll adds two)</param>
+        ///<param name="lookupCount" type="Number">the number of lookups of each kind</param>
+        ///<param name="verify" type="Boolean">true to compare every lookup with a forward scan</param>
+        ///<returns type="Object">{ entryCount, insertMs, entryAtTimeMs, entryAfterIdMs, entriesInRangeMs (per call), mismatches }</returns>
+        run: function (entryCount, lookupCount, verify) {
+            var context = TRACE_REPLAYER.createCore(),
+                sequentialPlaylist = context.PLAYER_SEQUENCER.createSequentialPlaylist(),
+                scheduler = context.PLAYER_SEQUENCER.createScheduler(sequentialPlaylist),
+                random = createRandom(entryCount),
+                adCount = Math.floor(entryCount / 2),
+                slots = [],
+                ids = [],
+                times = [],
+                contentParams = scheduler.createContentClipParams(),
+                clipParams,
+                entries,
+                report = { entryCount: 0, mismatches: 0 },
+                startTime,
+                result,
+                i;
+
+            contentParams.clipURI = 'http://benchmark/content.m3u8';
+            contentParams.clipEndMediaTime = (adCount + 1) * contentSlotDuration;
+            ids.push(scheduler.appendContentClip(contentParams).id);
+
+            for (i = 0; i < adCount; i += 1) {
+                slots.push(i);
+            }
+            shuffle(slots, random);
+
+            // the mid-rolls are scheduled in random order, so most of them split content in the middle of the playlist
+            startTime = process.hrtime();
+            for (i = 0; i < adCount; i += 1) {
+                clipParams = scheduler.createScheduleClipParams();
+                clipParams.clipURI = 'http://benchmark/ad' + i + '.m3u8';
+                clipParams.eClipType = 'Media';
+                clipParams.clipEndMediaTime = 15;
+                clipParams.eRollType = 'Mid';
+                clipParams.startTime = slots[i] * contentSlotDuration + contentSlotDuration / 2;
+                ids.push(scheduler.scheduleClip(clipParams).id);
+            }
+            report.insertMs = elapsedMs(startTime) / Math.max(adCount, 1);
+
+            entries = JSON.parse(sequentialPlaylist.testProbe_toJSON());
+            report.entryCount = entries.length;
+
+            for (i = 0; i < lookupCount; i += 1) {
+                times.push(random() * (adCount + 1) * contentSlotDuration);
+            }
+
+            startTime = process.hrtime();
+            for (i = 0; i < lookupCount; i += 1) {
+                result = sequentialPlaylist.access.getEntryAtTime(times[i]);
+                if (verify && idOf(result) !== idOf(scanEntryAtTime(entries, times[i]))) {
+                    report.mismatches += 1;
+                }
+            }
+            report.entryAtTimeMs = elapsedMs(startTime) / lookupCount;
+
+            startTime = process.hrtime();
+            for (i = 0; i < lookupCount; i += 1) {
+                result = sequentialPlaylist.access.getEntryAfterId(entries[i % entries.length].id);
+                if (verify && idOf(result) !== idOf(entries[i % entries.length + 1])) {
+                    report.mismatches += 1;
+                }
+            }
+            report.entryAfterIdMs = elapsedMs(startTime) / lookupCount;
+
+            startTime = process.hrtime();
+            for (i = 0; i < lookupCount; i += 1) {
+                result = sequentialPlaylist.access.getEntriesInRange(times[i], times[i] + 60);
+                if (verify && result.map(idOf).join() !== scanEntriesInRange(entries, times[i], times[i] + 60).map(idOf).join()) {
+                    report.mismatches += 1;
+                }
+            }
+            report.entriesInRangeMs = elapsedMs(startTime) / lookupCount;
+
+            return report;
+        },
+
+        ///<summary>Format the reports of run</summary>
+        ///<param name="reports" type="Array">the reports returned by run</param>
+        ///<returns type="String">one line per playlist size</returns>
+        formatReports: function (reports) {
+            var lines = ['  entries  insert ms  entryAtTime ms  entryAfterId ms  entriesInRange ms'];
+
+            reports.forEach(function (report) {
+                lines.push(('         ' + report.entryCount).slice(-9) +
+                           ('           ' + report.insertMs.toFixed(4)).slice(-11) +
+                           ('                ' + report.entryAtTimeMs.toFixed(4)).slice(-16) +
+                           ('                 ' + report.entryAfterIdMs.toFixed(4)).slice(-17) +
+                           ('                   ' + report.entriesInRangeMs.toFixed(4)).slice(-19));
+            });
+            return lines.join('\n');
+        }
+    };
+}());
+
+module.exports = SCHEDULER_BENCHMARK;
+
+if (require.main === module) {
+    (function () {
+        "use strict";
+
+        var args = process.argv.slice(2),
+            sizes = [10000, 100000],
+            lookupCount = 10000,
+            verify = false,
+            reports = [],
+            mismatchCount = 0,
+            i;
+
+        for (i = 0; i < args.length; i += 1) {
+            if (args[i] === '--sizes') {
+                i += 1;
+                sizes = args[i].split(',').map(function (size) { return parseInt(size, 10); });
+            }
+            else if (args[i] === '--lookups') {
+                i += 1;
+                lookupCount = parseInt(args[i], 10);
+            }
+            else if (args[i] === '--verify') {
+                verify = true;
+            }
+            else {
+                console.log('Usage: node SchedulerBenchmark.js [--sizes <count>,<count>...] [--lookups <count>] [--verify]');
+                process.exit(2);
+            }
+        }
+
+        sizes.forEach(function (size) {
+            var report = SCHEDULER_BENCHMARK.run(size, lookupCount, verify);
+
+            reports.push(report);
+            mismatchCount += report.mismatches;
+        });
+
+        console.log(SCHEDULER_BENCHMARK.formatReports(reports));
+        if (verify) {
+            console.log(mismatchCount + ' mismatched lookups');
+        }
+        process.exit(mismatchCount > 0 ? 1 : 0);
+    }());
+}
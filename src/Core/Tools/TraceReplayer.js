@@ -0,0 +1,223 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+
+// This file contains a node.js tool which replays a JavaScript bridge trace recorded by RecordingEngineHost
+// against the sequencer core scripts at full speed. It verifies that every call returns the recorded result
+// and reports the latency percentiles of each kind of call.
+//
+// Usage: node TraceReplayer.js <trace file> [--iterations <count>] [--no-verify]
+//
+// The exit code is 1 if any result does not match the recorded result.
+
+var fs = require('fs'),
+    path = require('path'),
+    vm = require('vm');
+
+var TRACE_REPLAYER = (function () {
+"use strict";
+
+    var coreScripts = [
+            'Common/HeadlessDOM.js',
+            'Common/SlabPool.js',
+            'Scheduler/Scheduler.js',
+            'Sequencer/Sequencer.js',
+            'AdResolver/AdResolver.js',
+            'Sequencer/SequencerPlugin.js'
+        ],
+
+    // private methods
+    callName = function (script) {
+        var match = /^PLAYER_SEQUENCER\.(\w+)\.runJSON\(\s*"\{\\"func\\":\s*\\"([\w.]+)\\"/.exec(script);
+
+        if (match) {
+            return match[1] + '.' + match[2];
+        }
+        match = /^PLAYER_SEQUENCER\.([\w.]+)/.exec(script);
+        return match ? match[1] : 'other';
+    },
+
+    // The exception stack depends on the engine and the call site, only the name and message are compared
+    resultWithoutStack = function (result) {
+        var stackIndex = result.indexOf(',"stack":');
+
+        return (result.indexOf('{"EXCEPTION":') === 0 && stackIndex >= 0) ? result.substring(0, stackIndex) : result;
+    },
+
+    percentile = function (sortedList, fraction) {
+        return sortedList[Math.min(sortedList.length - 1, Math.floor(sortedList.length * fraction))];
+    };
+
+    return {
+        ///<summary>Load a trace file</summary>
+        ///<param name="tracePath" type="String">the path of the trace file</param>
+        ///<returns type="Array">the [time in ms, script, result, evaluation time in ms] records of the trace</returns>
+        loadTrace: function (tracePath) {
+            var lines = fs.readFileSync(tracePath, 'utf8').split('\n'),
+                header = JSON.parse(lines[0]),
+                records = [],
+                i;
+
+            if (header.format !== 'SequencerBridgeTrace' || header.version !== 1) {
+                throw new Error('unsupported trace file ' + tracePath);
+            }
+            for (i = 1; i < lines.length; i += 1) {
+                if (lines[i].length > 0) {
+                    records.push(JSON.parse(lines[i]));
+                }
+            }
+            return records;
+        },
+
+        ///<summary>Load the sequencer core scripts into a new context, the same as the JSContext engine host</summary>
+        ///<returns type="Object">the context the scripts run in</returns>
+        createCore: function () {
+            var context = vm.createContext({}),
+                coreDirectory = path.join(__dirname, '..');
+
+            coreScripts.forEach(function (scriptName) {
+                var scriptPath = path.join(coreDirectory, scriptName);
+                vm.runInContext(fs.readFileSync(scriptPath, 'utf8'), context, { filename: scriptPath });
+            });
+            return context;
+        },
+
+        ///<summary>Evaluate a script the same way as the engine hosts do</summary>
+        ///<param name="context" type="Object">the context created by createCore</param>
+        ///<param name="script" type="String">the script to evaluate</param>
+        ///<returns type="String">the result converted to a string, an empty string for undefined, null or an exception</returns>
+        evaluateScript: function (context, script) {
+            var value;
+
+            try {
+                value = vm.runInContext(script, context);
+            }
+            catch (ex) {
+                return '';
+            }
+            return (value === undefined || value === null) ? '' : String(value);
+        },
+
+        ///<summary>Replay the records of a trace against a new sequencer core</summary>
+        ///<param name="records" type="Array">the records returned by loadTrace</param>
+        ///<param name="verify" type="Boolean">true to compare every result with the recorded result</param>
+        ///<returns type="Object">{ latencies: { name: [ms] }, mismatches: [{ index, name, expected, actual }], totalTime: ms }</returns>
+        replay: function (records, verify) {
+            var context = this.createCore(),
+                latencies = {},
+                mismatches = [],
+                startTime = process.hrtime(),
+                callStartTime,
+                elapsed,
+                result,
+                name,
+                i;
+
+            for (i = 0; i < records.length; i += 1) {
+                name = callName(records[i][1]);
+                callStartTime = process.hrtime();
+                result = this.evaluateScript(context, records[i][1]);
+                elapsed = process.hrtime(callStartTime);
+
+                if (!latencies.hasOwnProperty(name)) {
+                    latencies[name] = [];
+                }
+                latencies[name].push(elapsed[0] * 1e3 + elapsed[1] / 1e6);
+
+                if (verify && resultWithoutStack(result) !== resultWithoutStack(records[i][2])) {
+                    mismatches.push({ index: i, name: name, expected: records[i][2], actual: result });
+                }
+            }
+
+            elapsed = process.hrtime(startTime);
+            return { latencies: latencies, mismatches: mismatches, totalTime: elapsed[0] * 1e3 + elapsed[1] / 1e6 };
+        },
+
+        ///<summary>Format the latency percentiles of replays</summary>
+        ///<param name="latencies" type="Object">the latencies of the replays by call name</param>
+        ///<returns type="String">one line per call name</returns>
+        formatLatencies: function (latencies) {
+            var lines = ['call                                          count   p50 ms   p90 ms   p99 ms   max ms'];
+
+            Object.keys(latencies).sort().forEach(function (name) {
+                var sortedList = latencies[name].slice().sort(function (a, b) { return a - b; }),
+                    columns = [percentile(sortedList, 0.5), percentile(sortedList, 0.9), percentile(sortedList, 0.99), sortedList[sortedList.length - 1]];
+
+                lines.push((name + '                                              ').substring(0, 44) +
+                           ('        ' + sortedList.length).slice(-7) +
+                           columns.map(function (value) { return ('         ' + value.toFixed(3)).slice(-9); }).join(''));
+            });
+            return lines.join('\n');
+        }
+    };
+}());
+
+module.exports = TRACE_REPLAYER;
+
+if (require.main === module) {
+    (function () {
+        "use strict";
+
+        var args = process.argv.slice(2),
+            iterations = 1,
+            verify = true,
+            tracePath = null,
+            maxReportedMismatches = 10,
+            records,
+            latencies = {},
+            mismatchCount = 0,
+            report,
+            i;
+
+        for (i = 0; i < args.length; i += 1) {
+            if (args[i] === '--iterations') {
+                i += 1;
+                iterations = parseInt(args[i], 10);
+            }
+            else if (args[i] === '--no-verify') {
+                verify = false;
+            }
+            else {
+                tracePath = args[i];
+            }
+        }
+        if (tracePath === null || !(iterations > 0)) {
+            console.log('Usage: node TraceReplayer.js <trace file> [--iterations <count>] [--no-verify]');
+            process.exit(2);
+        }
+
+        records = TRACE_REPLAYER.loadTrace(tracePath);
+        for (i = 0; i < iterations; i += 1) {
+            report = TRACE_REPLAYER.replay(records, verify);
+            Object.keys(report.latencies).forEach(function (name) {
+                latencies[name] = (latencies[name] || []).concat(report.latencies[name]);
+            });
+            // the core is recreated for every iteration, so every iteration must match
+            mismatchCount += report.mismatches.length;
+            report.mismatches.slice(0, i === 0 ? maxReportedMismatches : 0).forEach(function (mismatch) {
+                console.log('Mismatch at call ' + mismatch.index + ' (' + mismatch.name + ')');
+                console.log('  expected: ' + mismatch.expected);
+                console.log('  actual:   ' + mismatch.actual);
+            });
+            console.log('Iteration ' + (i + 1) + ': ' + records.length + ' calls in ' + report.totalTime.toFixed(3) + ' ms');
+        }
+
+        console.log(TRACE_REPLAYER.formatLatencies(latencies));
+        if (verify) {
+            console.log(mismatchCount + ' mismatched results');
+        }
+        process.exit(mismatchCount > 0 ? 1 : 0);
+    }());
+}
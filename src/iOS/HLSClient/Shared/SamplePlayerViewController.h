@@ -21,7 +21,7 @@
 @class SequencerAVPlayerFramework;
 @class PlaylistEntry;
 
-@interface SamplePlayerViewController : UIViewController <VASTAdSelection>
+@interface SamplePlayerViewController : UIViewController <VASTAdSelection, SeekbarStateObserver>
 {
 @private
     UITextField *urlText;
@@ -19,6 +19,7 @@
 #import <MediaTime.h>
 #import <SeekbarTime.h>
 #import <Scheduler.h>
+#import <Sequencer.h>
 #import <AdResolver.h>
 #import <MediaFile.h>
 
@@ -416,8 +417,9 @@ NSString * const MIME_TYPE_MP4 = @"video/mp4";
         hasStarted = YES;
     }
     
-    // Register for seekbar notification
-    [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(seekbarUpdatedNotification:) name:SeekbarTimeUpdatedNotification object:framework];
+    // Observe the seekbar updates, the seekbar notification is not needed
+    framework.seekbarObserver = self;
+    framework.postsSeekbarNotifications = NO;
     
     // Register for playlist entry changed notification
     [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(playlistEntryChangedNotification:) name:PlaylistEntryChangedNotification object:framework];
@@ -566,8 +568,8 @@ NSString * const MIME_TYPE_MP4 = @"video/mp4";
         // Unregister for playlist entry changed notification
         [[NSNotificationCenter defaultCenter] removeObserver:self name:PlaylistEntryChangedNotification object:framework];
         
-        // Unregister for seekbar notification
-        [[NSNotificationCenter defaultCenter] removeObserver:self name:SeekbarTimeUpdatedNotification object:framework];
+        // Stop observing the seekbar updates
+        framework.seekbarObserver = nil;
         
         isPlaying = NO;
         isPaused = NO;
@@ -757,39 +759,28 @@ NSString * const MIME_TYPE_MP4 = @"video/mp4";
 }
 
 //
-// Notification callback when the seekbar is updated.
+// Seekbar observer callback when the seekbar is updated.
 //
 // Arguments:
-// [notification]  An NSNotification object that wraps the seekbar time update.
+// [state]  The seekbar state of the update.
 //
 // Returns: none.
 //
-- (void) seekbarUpdatedNotification:(NSNotification *)notification
+- (void) seekbarStateUpdated:(SeekbarState)state
 {
-    NSLog(@"Inside seekbar updated notification callback ...");
-    
-    NSDictionary *userInfo = [notification userInfo];
-    SeekbarTimeUpdatedEventArgs *args = (SeekbarTimeUpdatedEventArgs *)[userInfo objectForKey:SeekbarTimeUpdatedArgsUserInfoKey];
-    if (nil == args.seekbarTime)
+    [seekbarViewController setSliderMinValue:state.minSeekbarPosition];
+    if (state.minSeekbarPosition < state.maxSeekbarPosition)
     {
-        NSLog(@"There is an error in the seekbar time callback.");
-    }
-    else
-    {
-        [seekbarViewController setSliderMinValue:args.seekbarTime.minSeekbarPosition];
-        if (args.seekbarTime.minSeekbarPosition < args.seekbarTime.maxSeekbarPosition)
-        {
-            [seekbarViewController setSliderMaxValue:(args.seekbarTime.maxSeekbarPosition)];
-        }
-            
-        [seekbarViewController setSliderValue:args.seekbarTime.currentSeekbarPosition];
+        [seekbarViewController setSliderMaxValue:(state.maxSeekbarPosition)];
     }
+        
+    [seekbarViewController setSliderValue:state.currentSeekbarPosition];
 
-    currentSeekbarPosition = args.seekbarTime.currentSeekbarPosition;
+    currentSeekbarPosition = state.currentSeekbarPosition;
     
     NSString *time = [NSString stringWithFormat:@"%@ / %@", 
-                      [self stringFromNSTimeInterval:args.seekbarTime.currentSeekbarPosition],
-                      [self stringFromNSTimeInterval:args.seekbarTime.maxSeekbarPosition]];
+                      [self stringFromNSTimeInterval:state.currentSeekbarPosition],
+                      [self stringFromNSTimeInterval:state.maxSeekbarPosition]];
  
     [seekbarViewController updateTime:time];
     [seekbarViewController updateStatus:[NSString stringWithFormat:@"%@", stateText]];
@@ -822,7 +813,7 @@ NSString * const MIME_TYPE_MP4 = @"video/mp4";
     NSError *error = (NSError *)[userInfo objectForKey:PlayerSequencerErrorArgsUserInfoKey];
     NSLog(@"Error with domain name:%@, description:%@ and reason:%@", error.domain, error.localizedDescription, error.localizedFailureReason);
     
-    if ([[error.userInfo valueForKey:NSLocalizedFailureReasonErrorKey] rangeOfString:@"taken over by left DVR edge"].location != NSNotFound)
+    if ([error.domain isEqualToString:SequencerErrorDomain] && SequencerErrorCode_DvrTakeover == error.code)
     {
         NSLog(@"WARNING: left DVR edge take cover the current position\n");
         if (isPaused)
@@ -1019,6 +1010,7 @@ NSString * const MIME_TYPE_MP4 = @"video/mp4";
     [urlText release];
     [playerView release];
     [spinner release];
+    framework.seekbarObserver = nil;
     [framework release];
 
     [urlList release];
@@ -16,6 +16,9 @@
 #import <Foundation/Foundation.h>
 #import <UIKit/UIkit.h>
 
+#import "JavaScriptEngineHost.h"
+#import "ManifestDownloadManager.h"
+
 @class VASTParser;
 @class VMAPParser;
 
@@ -35,20 +38,21 @@
 {
 @private
     NSError *lastError;
-    UIWebView *webView;
+    id<JavaScriptEngineHost> engineHost;
     VASTParser *vastParser;
     VMAPParser *vmapParser;
-    NSMutableData *downloadData;
-    NSURLConnection *downloadConnection;
+    ManifestDownloadManager *downloadManager;
 }
 
 @property(nonatomic, retain) NSError *lastError;
 @property(nonatomic, readonly) VASTParser *vastParser;
 @property(nonatomic, readonly) VMAPParser *vmapParser;
+@property(nonatomic, readonly) ManifestDownloadManager *downloadManager;
 @property(nonatomic, readonly) BOOL isReady;
 
 - (BOOL) downloadManifestAsyncWithURL:(NSURL *)aUrl;
 - (BOOL) downloadManifest:(NSString **)manifest withURL:(NSURL *)aUrl;
+- (BOOL) downloadManifest:(NSString **)manifest withURL:(NSURL *)aUrl allowStale:(BOOL)allowStale;
 - (BOOL) releaseEntry:(int32_t)entryId;
 - (BOOL) getElementList:(NSArray **)elementList withPath:(NSArray *)xmlPath;
 
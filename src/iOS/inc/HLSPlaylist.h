@@ -0,0 +1,120 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+
+//
+// A variant stream of a master playlist (#EXT-X-STREAM-INF)
+//
+@interface HLSVariant : NSObject
+{
+@private
+    NSString *uri;
+    uint64_t bandwidth;
+    NSUInteger width;
+    NSUInteger height;
+}
+
+@property(nonatomic, readonly) NSString *uri;
+@property(nonatomic, readonly) uint64_t bandwidth;
+@property(nonatomic, readonly) NSUInteger width;
+@property(nonatomic, readonly) NSUInteger height;
+
+- (id) initWithURI:(NSString *)anUri bandwidth:(uint64_t)aBandwidth width:(NSUInteger)aWidth height:(NSUInteger)aHeight;
+
+@end
+
+//
+// The summary of an HLS (m3u8) playlist. The playlist is tokenized in a single pass over its
+// bytes, only the variants and the discontinuities allocate objects, so media playlists with
+// tens of thousands of segments are parsed without a string per line or token.
+// A master playlist has variants and no segments, a media playlist has segments and no variants.
+//
+@interface HLSPlaylist : NSObject
+{
+@private
+    NSTimeInterval targetDuration;
+    uint64_t mediaSequence;
+    NSTimeInterval totalDuration;
+    NSUInteger segmentCount;
+    BOOL hasEndList;
+    NSMutableArray *variants;
+    NSMutableArray *discontinuities;
+}
+
+@property(nonatomic, readonly) NSTimeInterval targetDuration;
+@property(nonatomic, readonly) uint64_t mediaSequence;
+@property(nonatomic, readonly) NSTimeInterval totalDuration;
+@property(nonatomic, readonly) NSUInteger segmentCount;
+@property(nonatomic, readonly) BOOL hasEndList;
+@property(nonatomic, readonly) BOOL isMasterPlaylist;
+@property(nonatomic, readonly) NSArray *variants;
+@property(nonatomic, readonly) NSArray *discontinuities;
+
+- (id) initWithBytes:(const char *)bytes length:(NSUInteger)length;
+- (id) initWithData:(NSData *)data;
+- (id) initWithString:(NSString *)manifest;
+
+@end
+
+//
+// Follows the refreshes of a live media playlist. The tracker remembers the media sequence, the
+// duration of each segment in the window and the URI of the last segment, so a refresh removes the
+// segments which slid out of the window by the media sequence and appends the segments after the
+// last known URI, found by scanning the playlist from its end. A refresh costs the header and the
+// appended segments, not the DVR window. When the last known URI is gone, the window is rebuilt.
+// The edges are in seconds of playlist time since the tracking started.
+//
+@interface HLSLivePlaylistTracker : NSObject
+{
+@private
+    NSURL *url;
+    uint64_t mediaSequence;
+    NSTimeInterval targetDuration;
+    double *segmentDurations;
+    NSUInteger segmentCapacity;
+    NSUInteger firstSegment;
+    NSUInteger segmentCount;
+    NSTimeInterval windowDuration;
+    NSTimeInterval removedDuration;
+    NSData *lastSegmentURI;
+    BOOL hasEndList;
+    CFAbsoluteTime updateTime;
+    double leftDvrEdgeRate;
+    double livePositionRate;
+    uint32_t rebuildCount;
+    BOOL isCancelled;
+}
+
+@property(nonatomic, readonly) NSURL *url;
+@property(readonly) uint64_t mediaSequence;
+@property(readonly) NSTimeInterval targetDuration;
+@property(readonly) NSUInteger segmentCount;
+@property(readonly) NSTimeInterval leftDvrEdge;
+@property(readonly) NSTimeInterval livePosition;
+@property(readonly) double leftDvrEdgeRate;
+@property(readonly) double livePositionRate;
+@property(readonly) CFAbsoluteTime updateTime;
+@property(readonly) BOOL hasEndList;
+@property(readonly) uint32_t rebuildCount;
+@property(readonly) BOOL isCancelled;
+
+- (id) initWithURL:(NSURL *)anUrl;
+- (BOOL) updateWithBytes:(const char *)bytes length:(NSUInteger)length atTime:(CFAbsoluteTime)now;
+- (BOOL) updateWithString:(NSString *)manifest atTime:(CFAbsoluteTime)now;
+- (void) getLeftDvrEdge:(NSTimeInterval *)leftDvrEdge livePosition:(NSTimeInterval *)livePosition atTime:(CFAbsoluteTime)now;
+- (void) cancel;
+
+@end
@@ -0,0 +1,42 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+
+//
+// The JavaScript engine running the sequencer core scripts. The Sequencer, Scheduler, AdResolver,
+// VASTParser and VMAPParser make all their JavaScript calls through one engine host.
+//
+@protocol JavaScriptEngineHost <NSObject>
+
+// The number of scripts evaluated and the total time spent evaluating them, for profiling the calls
+@property(nonatomic, readonly) uint32_t evaluationCount;
+@property(nonatomic, readonly) NSTimeInterval evaluationTime;
+
+// YES if the engine can only be called on the main thread, NO if it can be called on any thread
+@property(nonatomic, readonly) BOOL requiresMainThread;
+
+//
+// evaluate a script in the engine
+//
+// Arguments:
+// [script]: the script to evaluate
+//
+// Returns: the result of the script converted to a string, an empty string if the result is
+// undefined or null or if the script threw an exception that was not caught.
+//
+- (NSString *) evaluateScript:(NSString *)script;
+
+@end
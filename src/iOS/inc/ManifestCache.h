@@ -0,0 +1,88 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+
+#define MANIFEST_CACHE_DEFAULT_MEMORY_BYTES (1024 * 1024)
+#define MANIFEST_CACHE_DEFAULT_DISK_BYTES (8 * 1024 * 1024)
+
+//
+// A cached manifest with the HTTP validators and the freshness of its response
+//
+@interface ManifestCacheEntry : NSObject
+{
+@private
+    NSString *manifest;
+    NSString *etag;
+    NSString *lastModified;
+    CFAbsoluteTime expirationTime;
+    NSString *contentHash;
+}
+
+@property(nonatomic, readonly) NSString *manifest;
+@property(nonatomic, readonly) NSString *etag;
+@property(nonatomic, readonly) NSString *lastModified;
+@property(nonatomic, readonly) CFAbsoluteTime expirationTime;
+@property(nonatomic, readonly) NSString *contentHash;
+@property(nonatomic, readonly) BOOL isFresh;
+@property(nonatomic, readonly) BOOL hasValidators;
+
+- (id) initWithManifest:(NSString *)aManifest etag:(NSString *)anEtag lastModified:(NSString *)aLastModified expirationTime:(CFAbsoluteTime)anExpirationTime contentHash:(NSString *)aContentHash;
+
+@end
+
+//
+// Two tier cache of downloaded manifests: the entries are kept in memory and in a size bounded
+// directory so they survive the session. Freshness follows the Cache-Control max-age and Expires
+// headers of the response; a stale entry with an ETag or Last-Modified validator is revalidated
+// with a conditional request. On disk, the metadata of a URL is named by the hash of the URL and
+// the manifest by the hash of its content, so identical manifests are stored once.
+// The least recently used entries are removed first when the directory is over its size.
+// All methods can be called from any thread.
+//
+@interface ManifestCache : NSObject
+{
+@private
+    NSCache *memoryCache;
+    NSString *directoryPath;
+    unsigned long long maxDiskBytes;
+    uint32_t hitCount;
+    uint32_t missCount;
+    uint32_t staleHitCount;
+    uint32_t revalidationCount;
+    uint32_t notModifiedCount;
+}
+
+@property(nonatomic, readonly) NSString *directoryPath;
+@property(nonatomic, assign) NSUInteger maxMemoryBytes;
+@property(nonatomic, assign) unsigned long long maxDiskBytes;
+@property(readonly) uint32_t hitCount;
+@property(readonly) uint32_t missCount;
+@property(readonly) uint32_t staleHitCount;
+@property(readonly) uint32_t revalidationCount;
+@property(readonly) uint32_t notModifiedCount;
+
+- (id) initWithDirectoryPath:(NSString *)aPath;
+- (ManifestCacheEntry *) entryForURL:(NSURL *)url;
+- (ManifestCacheEntry *) storeManifest:(NSString *)manifest forURL:(NSURL *)url withResponse:(NSHTTPURLResponse *)response;
+- (ManifestCacheEntry *) refreshEntry:(ManifestCacheEntry *)entry forURL:(NSURL *)url withResponse:(NSHTTPURLResponse *)response;
+- (void) countHit;
+- (void) countMiss;
+- (void) countStaleHit;
+- (void) countRevalidation;
+- (void) removeAllEntries;
+- (void) resetCounters;
+
+@end
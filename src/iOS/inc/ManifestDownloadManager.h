@@ -0,0 +1,114 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+#import "ManifestCache.h"
+
+#define MANIFEST_DOWNLOAD_DEFAULT_TIMEOUT 30.0
+#define MANIFEST_DOWNLOAD_DEFAULT_MAX_CONCURRENT 6
+#define MANIFEST_DOWNLOAD_DEFAULT_MAX_PER_HOST 2
+
+//
+// The priority of a download. Pending downloads are started in priority order and
+// in request order within a priority.
+//
+typedef enum
+{
+    ManifestDownloadPriority_Prefetch,      // a manifest which may be needed later
+    ManifestDownloadPriority_Normal,        // a manifest requested by the application
+    ManifestDownloadPriority_Imminent       // a manifest the playback is waiting for, e.g. for the next ad break
+} ManifestDownloadPriority;
+
+//
+// How a download uses the cache of the manager
+//
+typedef enum
+{
+    ManifestDownloadCacheUsage_Default,     // use a fresh entry, revalidate a stale one before it is used
+    ManifestDownloadCacheUsage_AllowStale,  // use a stale entry at once and revalidate it in the background
+    ManifestDownloadCacheUsage_Bypass       // neither read nor write the cache, e.g. for live playlists
+} ManifestDownloadCacheUsage;
+
+typedef void (^ManifestDownloadCompletionHandler)(NSString *manifest, NSError *error);
+
+@class ManifestDownloadManager;
+
+//
+// One download of the ManifestDownloadManager
+//
+@interface ManifestDownloadRequest : NSObject
+{
+@private
+    ManifestDownloadManager *manager;
+    NSURL *url;
+    ManifestDownloadPriority priority;
+    NSTimeInterval timeout;
+    CFAbsoluteTime deadline;
+    ManifestDownloadCacheUsage cacheUsage;
+    uint64_t order;
+    dispatch_queue_t completionQueue;
+    ManifestDownloadCompletionHandler completion;
+    NSURLConnection *connection;
+    NSMutableData *data;
+    NSInteger statusCode;
+    NSHTTPURLResponse *response;
+    ManifestCacheEntry *cachedEntry;
+    BOOL isFinished;
+}
+
+@property(nonatomic, readonly) NSURL *url;
+@property(nonatomic, readonly) ManifestDownloadPriority priority;
+@property(nonatomic, readonly) NSTimeInterval timeout;
+@property(nonatomic, readonly) CFAbsoluteTime deadline;
+@property(nonatomic, readonly) ManifestDownloadCacheUsage cacheUsage;
+@property(readonly) BOOL isFinished;
+
+- (void) cancel;
+
+@end
+
+//
+// Downloads manifests asynchronously with many requests in flight. At most maxConcurrentDownloads
+// connections are open, at most maxDownloadsPerHost of them to the same host so the keep-alive
+// connections of the URL loading system are reused instead of opening new ones. The completion
+// handler of a request is called exactly once: with the manifest, or with an error when the
+// download failed, returned an HTTP error status, passed its deadline or was cancelled.
+// With a cache, a fresh cached manifest is returned without a connection and a stale one is
+// revalidated with a conditional request.
+//
+@interface ManifestDownloadManager : NSObject
+{
+@private
+    NSOperationQueue *delegateQueue;
+    NSMutableArray *pendingRequests;
+    NSMutableArray *activeRequests;
+    NSMutableDictionary *activeCountByHost;
+    ManifestCache *cache;
+    NSUInteger maxConcurrentDownloads;
+    NSUInteger maxDownloadsPerHost;
+    uint64_t requestCount;
+}
+
+@property(nonatomic, assign) NSUInteger maxConcurrentDownloads;
+@property(nonatomic, assign) NSUInteger maxDownloadsPerHost;
+@property(retain) ManifestCache *cache;
+
+- (ManifestDownloadRequest *) downloadManifestWithURL:(NSURL *)url priority:(ManifestDownloadPriority)priority timeout:(NSTimeInterval)timeout deadline:(NSTimeInterval)deadline completionQueue:(dispatch_queue_t)queue completion:(ManifestDownloadCompletionHandler)completion;
+- (ManifestDownloadRequest *) downloadManifestWithURL:(NSURL *)url priority:(ManifestDownloadPriority)priority timeout:(NSTimeInterval)timeout deadline:(NSTimeInterval)deadline cacheUsage:(ManifestDownloadCacheUsage)usage completionQueue:(dispatch_queue_t)queue completion:(ManifestDownloadCompletionHandler)completion;
+- (BOOL) downloadManifest:(NSString **)manifest withURL:(NSURL *)url priority:(ManifestDownloadPriority)priority deadline:(NSTimeInterval)deadline error:(NSError **)error;
+- (BOOL) downloadManifest:(NSString **)manifest withURL:(NSURL *)url priority:(ManifestDownloadPriority)priority deadline:(NSTimeInterval)deadline cacheUsage:(ManifestDownloadCacheUsage)usage error:(NSError **)error;
+- (void) cancelAllDownloads;
+
+@end
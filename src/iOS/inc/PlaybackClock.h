@@ -0,0 +1,50 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+
+//
+// The media time of a player and one-shot observers of points in it. The framework arms the
+// segment boundaries through this protocol instead of calling AVPlayer directly, so the transition
+// timing can be driven by a simulated clock.
+//
+@protocol PlaybackClock <NSObject>
+
+// The current media time of the player in seconds
+@property(nonatomic, readonly) NSTimeInterval currentTime;
+
+//
+// call a block once when the media time crosses a point during normal playback
+//
+// Arguments:
+// [time]: the media time to observe
+// [queue]: the queue the block is called on
+// [block]: the block to call
+//
+// Returns: the observer, to be passed to removeBoundaryObserver:
+//
+- (id) addBoundaryObserverAtTime:(NSTimeInterval)time queue:(dispatch_queue_t)queue usingBlock:(dispatch_block_t)block;
+
+//
+// remove an observer before it is called. It does nothing for an observer that was already called.
+//
+// Arguments:
+// [observer]: the observer returned by addBoundaryObserverAtTime:queue:usingBlock:
+//
+// Returns: none
+//
+- (void) removeBoundaryObserver:(id)observer;
+
+@end
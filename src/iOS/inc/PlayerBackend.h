@@ -0,0 +1,54 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+
+//
+// Creates and loads the players of a player pool. The pool only talks to the players through
+// this protocol, so the pooling can be driven by mock players instead of AVPlayer.
+//
+@protocol PlayerBackend <NSObject>
+
+//
+// create a player without a media item
+//
+// Arguments: none
+//
+// Returns: the new player, retained by the caller
+//
+- (id) newPlayer;
+
+//
+// load a URL into a player, replacing the item it is playing
+//
+// Arguments:
+// [url]: the URL to load
+// [player]: the player created by newPlayer
+//
+// Returns: none
+//
+- (void) loadURL:(NSURL *)url intoPlayer:(id)player;
+
+//
+// stop a player and release its media item so it can be reused
+//
+// Arguments:
+// [player]: the player created by newPlayer
+//
+// Returns: none
+//
+- (void) clearPlayer:(id)player;
+
+@end
@@ -0,0 +1,37 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "JavaScriptEngineHost.h"
+
+//
+// Engine host which forwards the scripts to another engine host and records every script, its result,
+// the time it was called and its evaluation time to a trace file. The trace can be replayed against the
+// sequencer core with src/Core/Tools/TraceReplayer.js.
+//
+@interface RecordingEngineHost : NSObject <JavaScriptEngineHost>
+{
+@private
+    id<JavaScriptEngineHost> engineHost;
+    NSFileHandle *traceFile;
+    NSMutableData *traceBuffer;
+    CFAbsoluteTime startTime;
+}
+
+- (id) initWithEngineHost:(id<JavaScriptEngineHost>)anEngineHost tracePath:(NSString *)tracePath;
+- (void) flush;
+
+@end
@@ -16,6 +16,8 @@
 #import <Foundation/Foundation.h>
 #import <UIKit/UIkit.h>
 
+#import "JavaScriptEngineHost.h"
+
 #import "PlaylistEntry.h"
 #import "LinearTime.h"
 #import "AdInfo.h"
@@ -23,16 +25,21 @@
 @interface Scheduler : NSObject
 {
 @private
-    UIWebView *webView;
+    id<JavaScriptEngineHost> engineHost;
     NSError *lastError;
+    uint32_t javaScriptCallCount;
 }
 
 @property(nonatomic, retain) NSError *lastError;
 @property(nonatomic, readonly) BOOL isReady;
 
 - (BOOL) scheduleClip:(AdInfo *)ad atTime:(LinearTime *)linearTime forType:(PlaylistEntryType)type andGetClipId:(int32_t *)clipId;
+- (BOOL) scheduleClips:(NSArray *)ads atTimes:(NSArray *)linearTimes forType:(PlaylistEntryType)type andGetClipIds:(NSMutableArray *)clipIds;
 - (BOOL) appendContentClip:(NSURL *)clipURL withMediaTime:(MediaTime *)mediaTime andGetClipId:(int32_t *)clipId;
+- (BOOL) appendContentClips:(NSArray *)clipURLs withMediaTimes:(NSArray *)mediaTimes andGetClipIds:(NSMutableArray *)clipIds;
 - (BOOL) cancelClip:(int32_t)clipContext;
 - (BOOL) setSeekToStart;
+- (BOOL) getEntries:(NSArray **)entries ofType:(PlaylistEntryType)type inRangeFrom:(NSTimeInterval)startTime to:(NSTimeInterval)endTime;
+- (BOOL) getPlaylistChanges:(NSArray **)changes sinceVersion:(int32_t)sinceVersion currentVersion:(int32_t *)currentVersion isComplete:(BOOL *)isComplete;
 - (BOOL) setSeekToStartWithURL:(NSURL *)clipURI;
 @end
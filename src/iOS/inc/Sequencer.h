@@ -16,39 +16,63 @@
 #import <Foundation/Foundation.h>
 #import <UIKit/UIkit.h>
 
+#import "JavaScriptEngineHost.h"
+
 #import "SeekbarTime.h"
 #import "AdResolver.h"
 #import "Scheduler.h"
 
 @class PlaybackSegment;
+@class SeekbarMapping;
+
+// The error codes in SequencerErrorDomain. The expected conditions are returned by the
+// sequencer plugins as a result status, anything thrown by the JavaScript is unexpected.
+typedef enum
+{
+    SequencerErrorCode_Unexpected,      // A JavaScript exception or an empty JavaScript result
+    SequencerErrorCode_DvrTakeover,     // The current playback position was taken over by the left DVR edge
+    SequencerErrorCode_RangeExceeded,   // The seek position is outside the range of the current playback segment
+    SequencerErrorCode_OutsidePlaylist  // The seek position is outside the range of the sequential playlist
+} SequencerErrorCode;
 
 @interface Sequencer : NSObject
 {
 @private
-    UIWebView *webView;
+    id<JavaScriptEngineHost> engineHost;
     AdResolver *adResolver;
     Scheduler *scheduler;
     NSError *lastError;
+    uint32_t javaScriptCallCount;
+    SeekbarMapping *seekbarMapping;
 }
 
 @property(nonatomic, retain) AdResolver *adResolver;
 @property(nonatomic, retain) Scheduler *scheduler;
 @property(nonatomic, retain) NSError *lastError;
 @property(nonatomic, readonly) BOOL isReady;
+@property(nonatomic, readonly) id<JavaScriptEngineHost> engineHost;
+
++ (NSArray *) scriptNames;
 
 - (id)init;
+- (id)initWithEngineHost:(id<JavaScriptEngineHost>)anEngineHost;
 - (BOOL) getSeekbarTime:(SeekbarTime **)seekTime andPlaybackPolicy:(NSString **)policy withMediaTime:(MediaTime *)aMediaTime playbackRate:(double)aRate currentSegment:(PlaybackSegment *)aSegment playbackRangeExceeded:(BOOL *)rangeExceeded;
 - (BOOL) getSeekbarTime:(SeekbarTime **)seekTime andPlaybackPolicy:(NSString **)policy withMediaTime:(MediaTime *)aMediaTime playbackRate:(double)aRate currentSegment:(PlaybackSegment *)aSegment playbackRangeExceeded:(BOOL *)rangeExceeded leftDvrEdge:(NSTimeInterval)leftDvrEdge livePosition:(NSTimeInterval)livePosition liveEnded:(BOOL)liveEnded;
+- (BOOL) updateSeekbarTime:(SeekbarTime *)seekTime andPlaybackPolicy:(NSString **)policy withMediaTime:(MediaTime *)aMediaTime playbackRate:(double)aRate currentSegment:(PlaybackSegment *)aSegment playbackRangeExceeded:(BOOL *)rangeExceeded;
+- (BOOL) updateSeekbarTime:(SeekbarTime *)seekTime andPlaybackPolicy:(NSString **)policy withMediaTime:(MediaTime *)aMediaTime playbackRate:(double)aRate currentSegment:(PlaybackSegment *)aSegment playbackRangeExceeded:(BOOL *)rangeExceeded leftDvrEdge:(NSTimeInterval)leftDvrEdge livePosition:(NSTimeInterval)livePosition liveEnded:(BOOL)liveEnded;
 - (BOOL) getLinearTime:(NSTimeInterval *)linearTime withMediaTime:(MediaTime *)aMediaTime currentSegment:(PlaybackSegment *)aSegment;
 - (BOOL) getSegmentAfterSeek:(PlaybackSegment **)seekSegment withLinearPosition:(NSTimeInterval)linearSeekPosition;
 - (BOOL) getSegmentAfterSeek:(PlaybackSegment **)seekSegment withLinearPosition:(NSTimeInterval)linearSeekPosition leftDvrEdge:(NSTimeInterval)leftDvrEdge livePosition:(NSTimeInterval)livePosition;
 - (BOOL) getSegmentAfterSeek:(PlaybackSegment **)seekSegment withSeekbarPosition:(SeekbarTime *)seekbarPosition currentSegment:(PlaybackSegment *)aSegment;
 - (BOOL) getSegmentOnEndOfMedia:(PlaybackSegment **)nextSegment withCurrentSegment:(PlaybackSegment *)currentSegment mediaTime:(NSTimeInterval)playbackPosition currentPlaybackRate:(double)playbackRate isNotPlayed:(BOOL)isNotPlayed isEndOfSequence:(BOOL)isEndOfSequence;
 - (BOOL) getSegmentOnEndOfBuffering:(PlaybackSegment **)nextSegment withCurrentSegment:(PlaybackSegment *)currentSegment mediaTime:(NSTimeInterval)playbackPosition currentPlaybackRate:(double)playbackRate;
+- (BOOL) getUpcomingSegments:(NSArray **)segments withCurrentSegment:(PlaybackSegment *)currentSegment currentPlaybackRate:(double)playbackRate count:(int32_t)count;
 - (BOOL) getSegmentOnError:(PlaybackSegment **)nextSegment withCurrentSegment:(PlaybackSegment *)currentSegment mediaTime:(NSTimeInterval)playbackPosition currentPlaybackRate:(double)playbackRate error:(NSString *)error isNotPlayed:(BOOL)isNotPlayed isEndOfSequence:(BOOL)isEndOfSequence;
+- (BOOL) updateLiveWindowWithLeftDvrEdge:(NSTimeInterval)leftDvrEdge livePosition:(NSTimeInterval)livePosition leftDvrEdgeRate:(double)leftDvrEdgeRate livePositionRate:(double)livePositionRate;
 
 @end
 
+extern NSString * const SequencerErrorDomain;
 extern NSString * const PlayerSequencerErrorNotification;
 extern NSString * const PlayerSequencerErrorArgsUserInfoKey;
 
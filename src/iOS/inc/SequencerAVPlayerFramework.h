@@ -16,6 +16,8 @@
 #import <Foundation/Foundation.h>
 #import <UIKit/UIKit.h>
 #import "PlaylistEntry.h"
+#import "TransitionMetrics.h"
+#import "VASTWrapperResolver.h"
 
 #ifdef ENABLE_FRAMEWORK_TRACE
 #define FRAMEWORK_LOG(format, ...) NSLog(format, ## __VA_ARGS__)
@@ -35,6 +37,24 @@
 @class LinearTime;
 @class AdInfo;
 @class MediaFile;
+@class HLSLivePlaylistTracker;
+@class SegmentBoundaryObserver;
+@class PlayerPool;
+@class PreloadLeadTimeEstimator;
+
+//
+// Completion handler of the asynchronous framework methods. It is called on the main thread.
+// [clipId] is the clipId of the scheduled clip if the method schedules a clip and 0 otherwise.
+// [error] is nil on success.
+//
+typedef void (^SequencerCompletionHandler)(BOOL success, int32_t clipId, NSError *error);
+
+//
+// Completion handler of the asynchronous batch content append. It is called on the main thread.
+// [results] has a ContentClipProbeResult for each clip, in the order of the clips.
+// [error] is nil on success.
+//
+typedef void (^ContentClipsCompletionHandler)(BOOL success, NSArray *results, NSError *error);
 
 @protocol VASTAdSelection <NSObject>
 
@@ -43,6 +63,34 @@
 
 @end
 
+//
+// The seekbar state of one seekbar update. It is delivered by value so no object is allocated
+// for an update.
+//
+typedef struct
+{
+    NSTimeInterval currentSeekbarPosition;
+    NSTimeInterval minSeekbarPosition;
+    NSTimeInterval maxSeekbarPosition;
+    NSTimeInterval currentPlaybackTime;     // the playback position in media time
+    int32_t entryId;                        // the id of the playlist entry being played
+    BOOL isAdvertisement;
+    BOOL isLive;
+    BOOL playbackRangeExceeded;             // the playback reached the end of the seekbar range
+    uint32_t coalescedCount;                // the number of earlier updates this one replaced before they were delivered
+} SeekbarState;
+
+//
+// Receives the seekbar updates without the SeekbarTimeUpdatedNotification objects. The updates
+// are delivered on the main thread, an update which has not been delivered when the next one
+// comes is replaced by it.
+//
+@protocol SeekbarStateObserver <NSObject>
+
+- (void) seekbarStateUpdated:(SeekbarState)state;
+
+@end
+
 @interface SeekbarTimeUpdatedEventArgs : NSObject
 {
 @private
@@ -67,6 +115,64 @@
 
 @end;
 
+//
+// Read-only copy of the playback state taken at the last seekbar timer tick.
+// It can be read from any thread without calling into the sequencer.
+//
+@interface PlaybackSnapshot : NSObject
+{
+@private
+    PlaylistEntry *currentEntry;
+    PlaylistEntry *nextEntry;
+    SeekbarTime *seekbarTime;
+    NSTimeInterval currentPlaybackTime;
+    NSTimeInterval leftDvrEdge;
+    NSTimeInterval livePosition;
+    BOOL isLive;
+    BOOL isStopped;
+}
+
+@property (nonatomic, readonly) PlaylistEntry *currentEntry;
+@property (nonatomic, readonly) PlaylistEntry *nextEntry;
+@property (nonatomic, readonly) SeekbarTime *seekbarTime;
+@property (nonatomic, readonly) NSTimeInterval currentPlaybackTime;
+@property (nonatomic, readonly) NSTimeInterval leftDvrEdge;
+@property (nonatomic, readonly) NSTimeInterval livePosition;
+@property (nonatomic, readonly) BOOL isLive;
+@property (nonatomic, readonly) BOOL isStopped;
+
+- (id) initWithCurrentEntry:(PlaylistEntry *)aCurrentEntry nextEntry:(PlaylistEntry *)aNextEntry seekbarTime:(SeekbarTime *)aSeekbarTime currentPlaybackTime:(NSTimeInterval)aPlaybackTime leftDvrEdge:(NSTimeInterval)aLeftDvrEdge livePosition:(NSTimeInterval)aLivePosition isLive:(BOOL)live isStopped:(BOOL)stopped;
+
+@end;
+
+//
+// Result of one clip of a batch content append. The clips with an unknown duration
+// are probed by downloading their playlists, the others are appended as given.
+//
+@interface ContentClipProbeResult : NSObject
+{
+@private
+    NSURL *clipURL;
+    int32_t clipId;
+    NSTimeInterval duration;
+    BOOL isLive;
+    BOOL isProbed;
+    NSTimeInterval probeTime;
+    NSError *error;
+}
+
+@property (nonatomic, readonly) NSURL *clipURL;
+@property (nonatomic, readonly) int32_t clipId;
+@property (nonatomic, readonly) NSTimeInterval duration;
+@property (nonatomic, readonly) BOOL isLive;
+@property (nonatomic, readonly) BOOL isProbed;
+@property (nonatomic, readonly) NSTimeInterval probeTime;
+@property (nonatomic, readonly) NSError *error;
+
+- (id) initWithClipURL:(NSURL *)aClipURL clipId:(int32_t)aClipId duration:(NSTimeInterval)aDuration isLive:(BOOL)live isProbed:(BOOL)probed probeTime:(NSTimeInterval)aProbeTime error:(NSError *)anError;
+
+@end;
+
 @interface SequencerAVPlayerFramework : NSObject
 {
 @private
@@ -86,6 +192,7 @@
     BOOL hasStarted;
     BOOL hasStartedAfterStop;
     BOOL isSeekingAVPlayer;
+    BOOL isSeekPending;
     NSTimeInterval leftDvrEdge;
     NSTimeInterval livePosition;
     NSTimeInterval livePositionDelta;
@@ -93,6 +200,36 @@
     NSTimeInterval initialPlaybackPosition;
     NSError *lastError;
     id appDelegate;
+    dispatch_queue_t engineQueue;
+    volatile int32_t queuedOperationCount;
+    PlaybackSnapshot *snapshot;
+    PlaybackSnapshot *snapshotState;
+    BOOL isSnapshotChanged;
+    TransitionMetrics *transitionMetrics;
+    NSTimeInterval metricsNotificationInterval;
+    NSTimer *metricsTimer;
+    VASTWrapperResolver *wrapperResolver;
+    HLSLivePlaylistTracker *livePlaylistTracker;
+    NSMutableArray *lazyAdBreaks;
+    NSTimeInterval lazyAdBreakLinearTime;
+    BOOL resolvesAdBreaksLazily;
+    NSTimeInterval adBreakLookahead;
+    NSMutableDictionary *vastPrefetchEntries;
+    NSTimeInterval vastPrefetchLookahead;
+    BOOL usesBoundaryTransitions;
+    NSTimeInterval seekbarUpdateInterval;
+    SegmentBoundaryObserver *boundaryObserver;
+    PlayerPool *playerPool;
+    PreloadLeadTimeEstimator *preloadEstimator;
+    NSTimeInterval preloadLeadTime;
+    NSUInteger upcomingPreloadCount;
+    CFAbsoluteTime loadStartTime;
+    id<SeekbarStateObserver> seekbarObserver;
+    BOOL postsSeekbarNotifications;
+    BOOL isSeekbarStatePending;
+    SeekbarState pendingSeekbarState;
+    MediaTime *tickMediaTime;
+    SeekbarTime *tickSeekbarTime;
 }
 
 @property (nonatomic, retain) AVPlayer *player;
@@ -100,10 +237,27 @@
 @property (nonatomic, assign) float rate;
 @property (nonatomic, readonly) NSTimeInterval currentPlaybackTime;
 @property (nonatomic, readonly) NSTimeInterval currentLinearTime;
-@property (nonatomic, retain) NSError *lastError;
+@property (retain) NSError *lastError;
 @property (nonatomic, retain) id appDelegate;
+@property (readonly) PlaybackSnapshot *snapshot;
+@property (nonatomic, readonly) TransitionMetrics *transitionMetrics;
+@property (nonatomic, assign) NSTimeInterval metricsNotificationInterval;
+@property (nonatomic, readonly) VASTWrapperResolver *wrapperResolver;
+@property (readonly) HLSLivePlaylistTracker *livePlaylistTracker;
+@property (nonatomic, assign) BOOL resolvesAdBreaksLazily;
+@property (nonatomic, assign) NSTimeInterval adBreakLookahead;
+@property (nonatomic, assign) NSTimeInterval vastPrefetchLookahead;
+@property (nonatomic, assign) BOOL usesBoundaryTransitions;
+@property (nonatomic, assign) NSTimeInterval seekbarUpdateInterval;
+@property (nonatomic, readonly) PlayerPool *playerPool;
+@property (nonatomic, assign) NSUInteger warmPlayerCount;
+@property (nonatomic, assign) NSUInteger upcomingPreloadCount;
+@property (nonatomic, readonly) NSTimeInterval preloadLeadTime;
+@property (nonatomic, assign) id<SeekbarStateObserver> seekbarObserver;
+@property (nonatomic, assign) BOOL postsSeekbarNotifications;
 
 - (id) initWithView:(UIView *)videoView;
+- (id) initWithView:(UIView *)videoView bridgeTracePath:(NSString *)tracePath;
 - (BOOL) play;
 - (BOOL) playAtTime:(NSTimeInterval)linearTime;
 - (void) pause;
@@ -115,8 +269,16 @@
 - (BOOL) scheduleVASTClip:(AdInfo *)ad withManifest:(NSString *)vastManifest atTime:(LinearTime *)linearTime andGetClipId:(int32_t *)clipId;
 - (BOOL) scheduleVMAPWithManifest:(NSString *)vmapManifest;
 - (BOOL) appendContentClip:(NSURL *)clipURL withMediaTime:(MediaTime *)mediaTime andGetClipId:(int32_t *)clipId;
+- (BOOL) appendContentClips:(NSArray *)clipURLs withMediaTimes:(NSArray *)mediaTimes deadline:(NSTimeInterval)deadline andGetResults:(NSMutableArray *)results;
 - (BOOL) cancelClip:(int32_t)clipContext;
 
+- (void) seekToTime:(NSTimeInterval)seekTime completion:(SequencerCompletionHandler)completion;
+- (void) scheduleClip:(AdInfo *)ad atTime:(LinearTime *)linearTime forType:(PlaylistEntryType)type completion:(SequencerCompletionHandler)completion;
+- (void) scheduleVASTClip:(AdInfo *)ad withManifest:(NSString *)vastManifest atTime:(LinearTime *)linearTime completion:(SequencerCompletionHandler)completion;
+- (void) scheduleVMAPWithManifest:(NSString *)vmapManifest completion:(SequencerCompletionHandler)completion;
+- (void) appendContentClip:(NSURL *)clipURL withMediaTime:(MediaTime *)mediaTime completion:(SequencerCompletionHandler)completion;
+- (void) appendContentClips:(NSArray *)clipURLs withMediaTimes:(NSArray *)mediaTimes deadline:(NSTimeInterval)deadline completion:(ContentClipsCompletionHandler)completion;
+
 @end
 
 extern NSString * const SeekbarTimeUpdatedNotification;
@@ -129,3 +291,6 @@ extern NSString * const PlayerSequencerErrorNotification;
 extern NSString * const PlayerSequencerErrorArgsUserInfoKey;
 
 extern NSString * const PlayerSequencerReadyNotification;
+
+extern NSString * const TransitionMetricsUpdatedNotification;
+extern NSString * const TransitionMetricsArgsUserInfoKey;
@@ -18,3 +18,6 @@
 #else
 #define SEQUENCER_LOG(format, ...)
 #endif
+
+// Define ENABLE_SEQUENCER_PLAYLIST_DUMP as well to log the whole sequential playlist
+// after every segment transition (expensive for long playlists)
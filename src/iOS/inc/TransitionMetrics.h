@@ -0,0 +1,107 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+#import <pthread.h>
+
+#define TRANSITION_METRICS_WINDOW_SIZE 128
+#define TRANSITION_METRICS_BUCKET_COUNT 16
+
+//
+// The points of a playlist entry transition in the order they happen
+//
+typedef enum
+{
+    TransitionPoint_EndOfMedia,         // playerItemDidReachEnd or playback range exceeded in the seekbar timer
+    TransitionPoint_ContentFinished,    // the framework starts to switch to the next entry
+    TransitionPoint_PlayerReady,        // the player of the next entry is ready to play
+    TransitionPoint_FirstFrameShown     // the view of the next entry is shown
+} TransitionPoint;
+
+//
+// The measured intervals
+//
+typedef enum
+{
+    TransitionInterval_EndToFinished,       // end of media detected until contentFinished
+    TransitionInterval_FinishedToReady,     // contentFinished until the next player is ready, 0 if it was preloaded
+    TransitionInterval_ReadyToShown,        // next player ready (or contentFinished if later) until the view is shown
+    TransitionInterval_Gap,                 // the whole transition from the first point until the view is shown
+    TransitionInterval_SequencerBridge,     // the JavaScript evaluation time during a transition
+    TransitionInterval_ManifestDownload,    // one manifest download
+    TransitionInterval_AdBreakLeadTime,     // linear time left before a lazily resolved ad break when its ad pod was scheduled
+    TransitionInterval_VASTPrefetchLeadTime, // prefetched ad pod of a VAST entry ready until the playback reached the entry
+    TransitionInterval_Count
+} TransitionInterval;
+
+//
+// Histogram of the last TRANSITION_METRICS_WINDOW_SIZE samples of an interval in milliseconds.
+// Bucket 0 counts the samples under 1 ms and bucket i the samples in [2^(i-1), 2^i) ms,
+// the last bucket also counts everything above.
+//
+typedef struct
+{
+    uint32_t totalCount;
+    uint32_t sampleCount;
+    double minMs;
+    double maxMs;
+    double meanMs;
+    double p50Ms;
+    double p90Ms;
+    double p99Ms;
+    uint32_t buckets[TRANSITION_METRICS_BUCKET_COUNT];
+} TransitionHistogram;
+
+//
+// Quality of experience metrics of the transitions between playlist entries. The samples are kept
+// in fixed size ring buffers so recording does not allocate memory. All methods can be called
+// from any thread.
+//
+@interface TransitionMetrics : NSObject
+{
+@private
+    pthread_mutex_t lock;
+    double samples[TransitionInterval_Count][TRANSITION_METRICS_WINDOW_SIZE];
+    uint32_t totalCounts[TransitionInterval_Count];
+    uint32_t transitionCount;
+    uint32_t preloadHitCount;
+    uint32_t preloadMissCount;
+    uint32_t adBreakResolvedCount;
+    uint32_t adBreakLateCount;
+    uint32_t vastPrefetchHitCount;
+    uint32_t vastPrefetchMissCount;
+    CFAbsoluteTime endOfMediaTime;
+    CFAbsoluteTime contentFinishedTime;
+    CFAbsoluteTime playerReadyTime;
+    NSTimeInterval bridgeTimeAtStart;
+}
+
+@property(nonatomic, readonly) uint32_t transitionCount;
+@property(nonatomic, readonly) uint32_t preloadHitCount;
+@property(nonatomic, readonly) uint32_t preloadMissCount;
+@property(nonatomic, readonly) uint32_t adBreakResolvedCount;
+@property(nonatomic, readonly) uint32_t adBreakLateCount;
+@property(nonatomic, readonly) uint32_t vastPrefetchHitCount;
+@property(nonatomic, readonly) uint32_t vastPrefetchMissCount;
+
+- (void) markPoint:(TransitionPoint)point bridgeTime:(NSTimeInterval)bridgeTime;
+- (void) addSample:(NSTimeInterval)duration forInterval:(TransitionInterval)interval;
+- (void) countPreload:(BOOL)isHit;
+- (void) countAdBreakResolution:(BOOL)isInTime;
+- (void) countVASTPrefetch:(BOOL)isHit;
+- (TransitionHistogram) histogramForInterval:(TransitionInterval)interval;
+- (void) reset;
+
+@end
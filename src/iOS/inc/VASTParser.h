@@ -15,12 +15,14 @@
 
 #import <Foundation/Foundation.h>
 #import <UIKit/UIkit.h>
+
+#import "JavaScriptEngineHost.h"
 #import "Ad.h"
 
 @interface VASTParser : NSObject
 {
 @private
-    UIWebView *webView;    
+    id<JavaScriptEngineHost> engineHost;
     NSError *lastError;
 }
 
@@ -35,5 +37,6 @@
 - (BOOL) getMediaFileList:(NSArray **)mediaFileList withEntryId:(int32_t)entryId adOrdinal:(int32_t)ordinal creativeOrdinal:(int32_t)creativeOrdinal;
 - (BOOL) getCompanionAdsList:(NSArray **)adList withEntryId:(int32_t)entryId adOrdinal:(int32_t)ordinal creativeOrdinal:(int32_t)creativeOrdinal;
 - (BOOL) getNonLinearAdsList:(NSArray **)adList withEntryId:(int32_t)entryId adOrdinal:(int32_t)ordinal creativeOrdinal:(int32_t)creativeOrdinal;
+- (BOOL) resolveAllAds:(NSArray **)adList withEntryId:(int32_t)entryId;
 
 @end
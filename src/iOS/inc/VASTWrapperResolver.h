@@ -0,0 +1,48 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+
+#define VAST_WRAPPER_DEFAULT_MAX_DEPTH 5
+#define VAST_WRAPPER_DEFAULT_DEADLINE 3.0
+
+@class AdResolver;
+
+//
+// Resolves the Wrapper ads of a VAST ad pod by following their VASTAdTagURI chains.
+// The chains are followed one level at a time: the next documents of all the unresolved
+// chains are downloaded concurrently by the AdResolver download manager, with the imminent
+// priority, and then parsed on the calling thread, which must be the thread the AdResolver
+// is called from. A chain is given up when it is longer than maxDepth wrappers, a download
+// fails or the deadline for the whole pod has passed, so a slow ad server can not delay the
+// ad break by more than the deadline.
+//
+@interface VASTWrapperResolver : NSObject
+{
+@private
+    AdResolver *adResolver;
+    NSUInteger maxDepth;
+    NSTimeInterval deadline;
+    NSError *lastError;
+}
+
+@property(nonatomic, assign) NSUInteger maxDepth;
+@property(nonatomic, assign) NSTimeInterval deadline;
+@property(nonatomic, retain) NSError *lastError;
+
+- (id) initWithAdResolver:(AdResolver *)anAdResolver;
+- (BOOL) resolveAds:(NSArray **)resolvedAds fromAds:(NSArray *)ads;
+
+@end
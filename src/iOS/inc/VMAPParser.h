@@ -16,12 +16,14 @@
 #import <Foundation/Foundation.h>
 #import <UIKit/UIkit.h>
 
+#import "JavaScriptEngineHost.h"
+
 @class AdSource;
 
 @interface VMAPParser : NSObject
 {
 @private
-    UIWebView *webView;    
+    id<JavaScriptEngineHost> engineHost;
     NSError *lastError;
 }
 
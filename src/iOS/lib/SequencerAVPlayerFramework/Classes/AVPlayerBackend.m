@@ -0,0 +1,68 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <AVFoundation/AVFoundation.h>
+#import "AVPlayerBackend.h"
+
+@implementation AVPlayerBackend
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// create an AVPlayer without a player item
+//
+// Arguments: none
+//
+// Returns: the new player, retained by the caller
+//
+- (id) newPlayer
+{
+    return [[AVPlayer alloc] init];
+}
+
+//
+// load a URL into an AVPlayer by replacing its player item
+//
+// Arguments:
+// [url]: the URL to load
+// [player]: the AVPlayer
+//
+// Returns: none
+//
+- (void) loadURL:(NSURL *)url intoPlayer:(id)player
+{
+    AVPlayer *moviePlayer = (AVPlayer *)player;
+    
+    [moviePlayer replaceCurrentItemWithPlayerItem:[AVPlayerItem playerItemWithURL:url]];
+}
+
+//
+// pause an AVPlayer and release its player item
+//
+// Arguments:
+// [player]: the AVPlayer
+//
+// Returns: none
+//
+- (void) clearPlayer:(id)player
+{
+    AVPlayer *moviePlayer = (AVPlayer *)player;
+    
+    [moviePlayer pause];
+    [moviePlayer replaceCurrentItemWithPlayerItem:nil];
+}
+
+@end
@@ -0,0 +1,35 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+#import "PlaybackClock.h"
+
+@class AVPlayer;
+
+//
+// The playback clock of an AVPlayer. The AVPlayer boundary time observers are called every time
+// the time is crossed, they are removed after the first call to make them one-shot. The observers
+// which are not called have to be removed for the clock to be released.
+//
+@interface AVPlayerPlaybackClock : NSObject <PlaybackClock>
+{
+@private
+    AVPlayer *player;
+    NSMutableArray *observers;
+}
+
+- (id) initWithPlayer:(AVPlayer *)aPlayer;
+
+@end
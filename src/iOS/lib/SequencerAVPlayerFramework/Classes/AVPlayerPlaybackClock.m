@@ -0,0 +1,135 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <AVFoundation/AVFoundation.h>
+#import "AVPlayerPlaybackClock.h"
+
+@implementation AVPlayerPlaybackClock
+
+#pragma mark -
+#pragma mark Properties:
+
+- (NSTimeInterval) currentTime
+{
+    CMTime time = player.currentTime;
+    
+    return (0 == time.timescale) ? 0 : (double)time.value / time.timescale;
+}
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+// Remove an AVPlayer observer if it is still registered, it can only be removed once
+- (BOOL) removeObserverIfRegistered:(id)observer
+{
+    BOOL isRegistered = NO;
+    
+    @synchronized(self)
+    {
+        NSUInteger index = [observers indexOfObjectIdenticalTo:observer];
+        if (NSNotFound != index)
+        {
+            isRegistered = YES;
+            [player removeTimeObserver:observer];
+            [observers removeObjectAtIndex:index];
+        }
+    }
+    
+    return isRegistered;
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the AVPlayer playback clock
+//
+// Arguments:
+// [aPlayer]: the player
+//
+// Returns: The playback clock instance.
+//
+- (id) initWithPlayer:(AVPlayer *)aPlayer
+{
+    self = [super init];
+    
+    if (self){
+        player = [aPlayer retain];
+        observers = [[NSMutableArray alloc] init];
+    }
+    
+    return self;
+}
+
+//
+// call a block once when the media time of the player crosses a point during normal playback
+//
+// Arguments:
+// [time]: the media time to observe
+// [queue]: the queue the block is called on
+// [block]: the block to call
+//
+// Returns: the observer, to be passed to removeBoundaryObserver:
+//
+- (id) addBoundaryObserverAtTime:(NSTimeInterval)time queue:(dispatch_queue_t)queue usingBlock:(dispatch_block_t)block
+{
+    __block id observer = nil;
+    NSArray *times = [NSArray arrayWithObject:[NSValue valueWithCMTime:CMTimeMakeWithSeconds(time, NSEC_PER_SEC)]];
+    dispatch_block_t blockCopy = [[block copy] autorelease];
+    
+    @synchronized(self)
+    {
+        // The block keeps the clock alive until the observer is called or removed
+        observer = [player addBoundaryTimeObserverForTimes:times queue:queue usingBlock:^{
+            if ([self removeObserverIfRegistered:observer])
+            {
+                blockCopy();
+            }
+        }];
+        [observers addObject:observer];
+    }
+    
+    return observer;
+}
+
+//
+// remove an observer before it is called
+//
+// Arguments:
+// [observer]: the observer returned by addBoundaryObserverAtTime:queue:usingBlock:
+//
+// Returns: none
+//
+- (void) removeBoundaryObserver:(id)observer
+{
+    [self removeObserverIfRegistered:observer];
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    for (id observer in observers)
+    {
+        [player removeTimeObserver:observer];
+    }
+    [observers release];
+    [player release];
+    
+    [super dealloc];
+}
+
+@end
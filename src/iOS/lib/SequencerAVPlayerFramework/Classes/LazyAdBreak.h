@@ -0,0 +1,53 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+
+@class ManifestDownloadRequest;
+
+typedef enum
+{
+    LazyAdBreakState_Pending,       // waiting for the playback to come within the lookahead of the ad break
+    LazyAdBreakState_Resolving,     // the ad source is being downloaded
+    LazyAdBreakState_Scheduled,     // the ad pod is scheduled
+    LazyAdBreakState_Failed         // the ad source could not be downloaded or scheduled
+} LazyAdBreakState;
+
+//
+// Placeholder of a VMAP ad break whose VASTAdTagURI ad source is resolved just in time.
+// It is only used on the framework engine queue.
+//
+@interface LazyAdBreak : NSObject
+{
+@private
+    NSTimeInterval timeOffset;
+    NSURL *adTagURL;
+    LazyAdBreakState state;
+    ManifestDownloadRequest *request;
+    uint32_t resolveCount;
+}
+
+@property(nonatomic, readonly) NSTimeInterval timeOffset;
+@property(nonatomic, readonly) NSURL *adTagURL;
+@property(nonatomic, assign) LazyAdBreakState state;
+@property(nonatomic, retain) ManifestDownloadRequest *request;
+@property(nonatomic, readonly) uint32_t resolveCount;
+
+- (id) initWithTimeOffset:(NSTimeInterval)aTimeOffset adTagURL:(NSURL *)anAdTagURL;
+- (BOOL) isWithinLookahead:(NSTimeInterval)lookahead ofLinearTime:(NSTimeInterval)linearTime;
+- (uint32_t) beginResolving;
+- (void) cancel;
+
+@end
@@ -0,0 +1,117 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "LazyAdBreak.h"
+#import "ManifestDownloadManager.h"
+
+@implementation LazyAdBreak
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize timeOffset;
+@synthesize adTagURL;
+@synthesize state;
+@synthesize request;
+@synthesize resolveCount;
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the lazy ad break
+//
+// Arguments:
+// [aTimeOffset]: the linear time of the ad break
+// [anAdTagURL]: the URL of the VAST manifest of the ad break
+//
+// Returns: The lazy ad break instance.
+//
+- (id) initWithTimeOffset:(NSTimeInterval)aTimeOffset adTagURL:(NSURL *)anAdTagURL
+{
+    self = [super init];
+    
+    if (self){
+        timeOffset = aTimeOffset;
+        adTagURL = [anAdTagURL retain];
+        state = LazyAdBreakState_Pending;
+        request = nil;
+        resolveCount = 0;
+    }
+    
+    return self;
+}
+
+//
+// check if the playback is close enough to the ad break to resolve it
+//
+// Arguments:
+// [lookahead]: the linear time before the ad break the resolution starts at
+// [linearTime]: the current playback position in linear time
+//
+// Returns: YES if the ad break is ahead of the position by at most the lookahead and NO otherwise
+//
+- (BOOL) isWithinLookahead:(NSTimeInterval)lookahead ofLinearTime:(NSTimeInterval)linearTime
+{
+    return (linearTime <= timeOffset && timeOffset - linearTime <= lookahead);
+}
+
+//
+// mark the ad break as being resolved
+//
+// Arguments: none
+//
+// Returns: the number of the resolution, the download completion handlers compare it
+// with resolveCount to ignore the downloads of cancelled resolutions
+//
+- (uint32_t) beginResolving
+{
+    state = LazyAdBreakState_Resolving;
+    
+    return ++resolveCount;
+}
+
+//
+// cancel the resolution of the ad break, it is resolved again when the playback comes
+// within the lookahead
+//
+// Arguments: none
+//
+// Returns: none
+//
+- (void) cancel
+{
+    if (LazyAdBreakState_Resolving == state)
+    {
+        state = LazyAdBreakState_Pending;
+        resolveCount++;
+    }
+    [request cancel];
+    self.request = nil;
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [request cancel];
+    [request release];
+    [adTagURL release];
+    
+    [super dealloc];
+}
+
+@end
@@ -0,0 +1,61 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+#import "PlayerBackend.h"
+
+typedef enum
+{
+    PlayerPoolState_Warm,       // the player is idle in the pool without a media item
+    PlayerPoolState_Loading,    // the player is leased and loading its media item
+    PlayerPoolState_Ready,      // the player is leased and its media item is ready to play
+    PlayerPoolState_Failed      // the player is leased and its media item failed to load
+} PlayerPoolState;
+
+//
+// A pool of players which are reused by swapping their media item instead of creating a player
+// for every ad and content clip. The pool keeps warmCount idle players created ahead of time and
+// tracks the readiness of the leased players. It grows when all the players are leased.
+// Players can also be leased ahead of time to preload the segments after the next one.
+//
+@interface PlayerPool : NSObject
+{
+@private
+    id<PlayerBackend> backend;
+    NSMutableArray *pooledPlayers;
+    NSUInteger warmCount;
+    NSUInteger createdCount;
+    NSUInteger reusedCount;
+}
+
+@property(nonatomic, assign) NSUInteger warmCount;
+@property(readonly) NSUInteger createdCount;
+@property(readonly) NSUInteger reusedCount;
+@property(readonly) NSUInteger idleCount;
+@property(readonly) NSUInteger leasedCount;
+
+- (id) initWithBackend:(id<PlayerBackend>)aBackend warmCount:(NSUInteger)aWarmCount;
+- (id) acquirePlayerWithURL:(NSURL *)url;
+- (void) relinquishPlayer:(id)player;
+- (void) preloadURLs:(NSArray *)urls;
+- (id) takePreloadedPlayerForURL:(NSURL *)url;
+- (void) cancelPreloads;
+- (void) setState:(PlayerPoolState)state forPlayer:(id)player;
+- (PlayerPoolState) stateOfPlayer:(id)player;
+- (BOOL) isPlayerReady:(id)player;
+- (void) warmUp;
+- (void) drain;
+
+@end
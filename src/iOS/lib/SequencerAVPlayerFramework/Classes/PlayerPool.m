@@ -0,0 +1,434 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "PlayerPool.h"
+
+//
+// A player of the pool with its lease and readiness
+//
+@interface PooledPlayer : NSObject
+{
+@private
+    id player;
+    BOOL isLeased;
+    PlayerPoolState state;
+    NSURL *preloadURL;
+}
+
+- (id) initWithPlayer:(id)aPlayer;
+
+@property(nonatomic, readonly) id player;
+@property(nonatomic, assign) BOOL isLeased;
+@property(nonatomic, assign) PlayerPoolState state;
+@property(nonatomic, retain) NSURL *preloadURL;
+
+@end
+
+@implementation PooledPlayer
+
+@synthesize player;
+@synthesize isLeased;
+@synthesize state;
+@synthesize preloadURL;
+
+- (id) initWithPlayer:(id)aPlayer
+{
+    self = [super init];
+    
+    if (self){
+        player = [aPlayer retain];
+        isLeased = NO;
+        state = PlayerPoolState_Warm;
+        preloadURL = nil;
+    }
+    
+    return self;
+}
+
+- (void) dealloc
+{
+    [player release];
+    [preloadURL release];
+    
+    [super dealloc];
+}
+
+@end
+
+@implementation PlayerPool
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize createdCount;
+@synthesize reusedCount;
+
+- (NSUInteger) warmCount
+{
+    return warmCount;
+}
+
+- (void) setWarmCount:(NSUInteger)value
+{
+    @synchronized(self)
+    {
+        warmCount = value;
+    }
+    
+    [self drain];
+}
+
+- (NSUInteger) idleCount
+{
+    NSUInteger count = 0;
+    
+    @synchronized(self)
+    {
+        for (PooledPlayer *pooledPlayer in pooledPlayers)
+        {
+            if (!pooledPlayer.isLeased)
+            {
+                ++count;
+            }
+        }
+    }
+    
+    return count;
+}
+
+- (NSUInteger) leasedCount
+{
+    NSUInteger count = 0;
+    
+    @synchronized(self)
+    {
+        count = [pooledPlayers count];
+    }
+    
+    return count - self.idleCount;
+}
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+- (PooledPlayer *) pooledPlayerForPlayer:(id)player
+{
+    for (PooledPlayer *pooledPlayer in pooledPlayers)
+    {
+        if (pooledPlayer.player == player)
+        {
+            return pooledPlayer;
+        }
+    }
+    
+    return nil;
+}
+
+- (PooledPlayer *) addPooledPlayer
+{
+    id player = [backend newPlayer];
+    PooledPlayer *pooledPlayer = [[PooledPlayer alloc] initWithPlayer:player];
+    [pooledPlayers addObject:pooledPlayer];
+    [pooledPlayer release];
+    [player release];
+    ++createdCount;
+    
+    return pooledPlayer;
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the player pool
+//
+// Arguments:
+// [aBackend]: the backend which creates and loads the players
+// [aWarmCount]: the number of idle players to keep ahead of time
+//
+// Returns: The player pool instance.
+//
+- (id) initWithBackend:(id<PlayerBackend>)aBackend warmCount:(NSUInteger)aWarmCount
+{
+    self = [super init];
+    
+    if (self){
+        backend = [aBackend retain];
+        pooledPlayers = [[NSMutableArray alloc] init];
+        warmCount = aWarmCount;
+        createdCount = 0;
+        reusedCount = 0;
+    }
+    
+    return self;
+}
+
+//
+// lease a player and load a URL into it. An idle player is reused if there is one,
+// otherwise a new player is created so the pool never runs out.
+//
+// Arguments:
+// [url]: the URL to load
+//
+// Returns: the player, owned by the pool until it is relinquished
+//
+- (id) acquirePlayerWithURL:(NSURL *)url
+{
+    PooledPlayer *pooledPlayer = nil;
+    
+    @synchronized(self)
+    {
+        for (PooledPlayer *candidate in pooledPlayers)
+        {
+            if (!candidate.isLeased)
+            {
+                pooledPlayer = candidate;
+                ++reusedCount;
+                break;
+            }
+        }
+        
+        if (nil == pooledPlayer)
+        {
+            pooledPlayer = [self addPooledPlayer];
+        }
+        
+        pooledPlayer.isLeased = YES;
+        pooledPlayer.state = PlayerPoolState_Loading;
+    }
+    
+    [backend loadURL:url intoPlayer:pooledPlayer.player];
+    
+    return pooledPlayer.player;
+}
+
+//
+// return a leased player to the pool. The player is cleared and kept as an idle player,
+// or released if the pool already has warmCount idle players.
+//
+// Arguments:
+// [player]: the player returned by acquirePlayerWithURL:
+//
+// Returns: none
+//
+- (void) relinquishPlayer:(id)player
+{
+    if (nil == player)
+    {
+        return;
+    }
+    
+    [backend clearPlayer:player];
+    
+    @synchronized(self)
+    {
+        PooledPlayer *pooledPlayer = [self pooledPlayerForPlayer:player];
+        if (nil != pooledPlayer)
+        {
+            pooledPlayer.isLeased = NO;
+            pooledPlayer.state = PlayerPoolState_Warm;
+            pooledPlayer.preloadURL = nil;
+        }
+    }
+    
+    [self drain];
+}
+
+//
+// lease players which start loading URLs ahead of the segments they are for. The preloads
+// of URLs which are not in the list any more are cancelled.
+//
+// Arguments:
+// [urls]: the URLs to preload, nil to cancel all the preloads
+//
+// Returns: none
+//
+- (void) preloadURLs:(NSArray *)urls
+{
+    NSMutableArray *cancelledPlayers = [NSMutableArray array];
+    NSMutableArray *newURLs = [NSMutableArray arrayWithArray:urls];
+    
+    @synchronized(self)
+    {
+        for (PooledPlayer *pooledPlayer in pooledPlayers)
+        {
+            if (nil != pooledPlayer.preloadURL)
+            {
+                if ([newURLs containsObject:pooledPlayer.preloadURL])
+                {
+                    [newURLs removeObject:pooledPlayer.preloadURL];
+                }
+                else
+                {
+                    [cancelledPlayers addObject:pooledPlayer.player];
+                }
+            }
+        }
+    }
+    
+    for (id player in cancelledPlayers)
+    {
+        [self relinquishPlayer:player];
+    }
+    
+    for (NSURL *url in newURLs)
+    {
+        id player = [self acquirePlayerWithURL:url];
+        @synchronized(self)
+        {
+            [self pooledPlayerForPlayer:player].preloadURL = url;
+        }
+    }
+}
+
+//
+// take a preloaded player for a URL. The player stays leased by the caller.
+//
+// Arguments:
+// [url]: the URL the player was preloaded with
+//
+// Returns: the player, nil if the URL was not preloaded
+//
+- (id) takePreloadedPlayerForURL:(NSURL *)url
+{
+    id player = nil;
+    
+    @synchronized(self)
+    {
+        for (PooledPlayer *pooledPlayer in pooledPlayers)
+        {
+            if ([pooledPlayer.preloadURL isEqual:url])
+            {
+                pooledPlayer.preloadURL = nil;
+                player = pooledPlayer.player;
+                break;
+            }
+        }
+    }
+    
+    return player;
+}
+
+- (void) cancelPreloads
+{
+    [self preloadURLs:nil];
+}
+
+//
+// update the readiness of a leased player
+//
+// Arguments:
+// [state]: the new state of the player
+// [player]: the player returned by acquirePlayerWithURL:
+//
+// Returns: none
+//
+- (void) setState:(PlayerPoolState)state forPlayer:(id)player
+{
+    @synchronized(self)
+    {
+        PooledPlayer *pooledPlayer = [self pooledPlayerForPlayer:player];
+        if (nil != pooledPlayer && pooledPlayer.isLeased)
+        {
+            pooledPlayer.state = state;
+        }
+    }
+}
+
+//
+// get the readiness of a player
+//
+// Arguments:
+// [player]: the player
+//
+// Returns: the state of the player, PlayerPoolState_Warm for a player not in the pool
+//
+- (PlayerPoolState) stateOfPlayer:(id)player
+{
+    PlayerPoolState state = PlayerPoolState_Warm;
+    
+    @synchronized(self)
+    {
+        PooledPlayer *pooledPlayer = [self pooledPlayerForPlayer:player];
+        if (nil != pooledPlayer)
+        {
+            state = pooledPlayer.state;
+        }
+    }
+    
+    return state;
+}
+
+- (BOOL) isPlayerReady:(id)player
+{
+    return PlayerPoolState_Ready == [self stateOfPlayer:player];
+}
+
+//
+// create idle players until the pool has warmCount of them
+//
+// Arguments: none
+//
+// Returns: none
+//
+- (void) warmUp
+{
+    @synchronized(self)
+    {
+        NSUInteger idle = self.idleCount;
+        while (idle < warmCount)
+        {
+            [self addPooledPlayer];
+            ++idle;
+        }
+    }
+}
+
+//
+// release the idle players beyond warmCount
+//
+// Arguments: none
+//
+// Returns: none
+//
+- (void) drain
+{
+    @synchronized(self)
+    {
+        NSUInteger idle = self.idleCount;
+        for (NSInteger i = [pooledPlayers count] - 1; i >= 0 && idle > warmCount; --i)
+        {
+            PooledPlayer *pooledPlayer = [pooledPlayers objectAtIndex:i];
+            if (!pooledPlayer.isLeased)
+            {
+                [pooledPlayers removeObjectAtIndex:i];
+                --idle;
+            }
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [pooledPlayers release];
+    [backend release];
+    
+    [super dealloc];
+}
+
+@end
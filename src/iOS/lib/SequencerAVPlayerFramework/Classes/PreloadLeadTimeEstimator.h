@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+
+//
+// Chooses how long before the end of a segment the next one has to start loading, from the
+// load-to-ready latency measured for each host. Clips from a slow CDN start loading earlier
+// than the ones from a fast CDN, hosts without measurements get the minimum lead time.
+//
+@interface PreloadLeadTimeEstimator : NSObject
+{
+@private
+    NSMutableDictionary *hostLatencies;
+    NSTimeInterval minimumLeadTime;
+    NSTimeInterval maximumLeadTime;
+}
+
+@property(nonatomic, assign) NSTimeInterval minimumLeadTime;
+@property(nonatomic, assign) NSTimeInterval maximumLeadTime;
+
+- (id) initWithMinimumLeadTime:(NSTimeInterval)aMinimumLeadTime maximumLeadTime:(NSTimeInterval)aMaximumLeadTime;
+- (void) addLoadLatency:(NSTimeInterval)latency forURL:(NSURL *)url;
+- (NSTimeInterval) loadLatencyForURL:(NSURL *)url;
+- (NSTimeInterval) leadTimeForURL:(NSURL *)url;
+
+@end
@@ -0,0 +1,137 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "PreloadLeadTimeEstimator.h"
+
+// The weight of a new latency measurement in the moving average of a host
+#define LATENCY_SMOOTHING_FACTOR 0.3
+// The lead time covers this many times the average latency, for the variation of the latency
+#define LATENCY_SAFETY_FACTOR 2.0
+
+@implementation PreloadLeadTimeEstimator
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize minimumLeadTime;
+@synthesize maximumLeadTime;
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+- (NSString *) keyForURL:(NSURL *)url
+{
+    NSString *host = [url host];
+    
+    return (nil == host) ? @"" : [host lowercaseString];
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the preload lead time estimator
+//
+// Arguments:
+// [aMinimumLeadTime]: the lead time for hosts without measurements, and the shortest lead time
+// [aMaximumLeadTime]: the longest lead time
+//
+// Returns: The estimator instance.
+//
+- (id) initWithMinimumLeadTime:(NSTimeInterval)aMinimumLeadTime maximumLeadTime:(NSTimeInterval)aMaximumLeadTime
+{
+    self = [super init];
+    
+    if (self){
+        hostLatencies = [[NSMutableDictionary alloc] init];
+        minimumLeadTime = aMinimumLeadTime;
+        maximumLeadTime = aMaximumLeadTime;
+    }
+    
+    return self;
+}
+
+//
+// add a load-to-ready latency measurement to the moving average of the host of a URL
+//
+// Arguments:
+// [latency]: the time from loading the URL into a player to the player item being ready to play
+// [url]: the URL which was loaded
+//
+// Returns: none
+//
+- (void) addLoadLatency:(NSTimeInterval)latency forURL:(NSURL *)url
+{
+    if (0 > latency)
+    {
+        return;
+    }
+    
+    NSString *key = [self keyForURL:url];
+    
+    @synchronized(self)
+    {
+        NSNumber *average = [hostLatencies objectForKey:key];
+        NSTimeInterval value = (nil == average) ? latency : [average doubleValue] + LATENCY_SMOOTHING_FACTOR * (latency - [average doubleValue]);
+        [hostLatencies setObject:[NSNumber numberWithDouble:value] forKey:key];
+    }
+}
+
+//
+// get the average load-to-ready latency of the host of a URL
+//
+// Arguments:
+// [url]: the URL
+//
+// Returns: the average latency, 0 if the host has no measurements
+//
+- (NSTimeInterval) loadLatencyForURL:(NSURL *)url
+{
+    NSTimeInterval latency = 0;
+    
+    @synchronized(self)
+    {
+        latency = [[hostLatencies objectForKey:[self keyForURL:url]] doubleValue];
+    }
+    
+    return latency;
+}
+
+//
+// get how long before the previous segment ends a URL has to start loading
+//
+// Arguments:
+// [url]: the URL of the segment to preload
+//
+// Returns: the lead time, between minimumLeadTime and maximumLeadTime
+//
+- (NSTimeInterval) leadTimeForURL:(NSURL *)url
+{
+    NSTimeInterval leadTime = minimumLeadTime + LATENCY_SAFETY_FACTOR * [self loadLatencyForURL:url];
+    
+    return MAX(minimumLeadTime, MIN(maximumLeadTime, leadTime));
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [hostLatencies release];
+    
+    [super dealloc];
+}
+
+@end
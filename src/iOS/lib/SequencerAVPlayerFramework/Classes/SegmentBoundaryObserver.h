@@ -0,0 +1,40 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+#import "PlaybackClock.h"
+
+//
+// The one-shot boundaries of the playing segment in media time: the point the next segment is
+// preloaded at and the end of the segment. It only uses the PlaybackClock protocol, so the timing
+// of the transitions can be driven by a simulated clock. It has to be used on the queue the
+// blocks are called on.
+//
+@interface SegmentBoundaryObserver : NSObject
+{
+@private
+    id<PlaybackClock> clock;
+    dispatch_queue_t queue;
+    id preloadObserver;
+    id endObserver;
+}
+
+@property(nonatomic, readonly) id<PlaybackClock> clock;
+
+- (id) initWithClock:(id<PlaybackClock>)aClock queue:(dispatch_queue_t)aQueue;
+- (void) armWithEndTime:(NSTimeInterval)endTime preloadLeadTime:(NSTimeInterval)leadTime preloadBlock:(dispatch_block_t)preloadBlock endBlock:(dispatch_block_t)endBlock;
+- (void) disarm;
+
+@end
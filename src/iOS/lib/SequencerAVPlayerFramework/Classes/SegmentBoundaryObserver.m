@@ -0,0 +1,125 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "SegmentBoundaryObserver.h"
+
+@implementation SegmentBoundaryObserver
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize clock;
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the segment boundary observer
+//
+// Arguments:
+// [aClock]: the clock of the player of the segment
+// [aQueue]: the queue the boundary blocks are called on
+//
+// Returns: The segment boundary observer instance.
+//
+- (id) initWithClock:(id<PlaybackClock>)aClock queue:(dispatch_queue_t)aQueue
+{
+    self = [super init];
+    
+    if (self){
+        clock = [aClock retain];
+        queue = aQueue;
+        dispatch_retain(queue);
+        preloadObserver = nil;
+        endObserver = nil;
+    }
+    
+    return self;
+}
+
+//
+// arm the boundaries of a segment, replacing the ones armed before. A preload point the clock
+// already passed is reported at once, an end it already passed is left to the caller.
+//
+// Arguments:
+// [endTime]: the end of the segment in media time
+// [leadTime]: the time before the end the next segment is preloaded at
+// [preloadBlock]: the block called at the preload point, can be nil
+// [endBlock]: the block called at the end of the segment
+//
+// Returns: none
+//
+- (void) armWithEndTime:(NSTimeInterval)endTime preloadLeadTime:(NSTimeInterval)leadTime preloadBlock:(dispatch_block_t)preloadBlock endBlock:(dispatch_block_t)endBlock
+{
+    NSTimeInterval currentTime = clock.currentTime;
+    NSTimeInterval preloadTime = endTime - leadTime;
+    
+    [self disarm];
+    
+    if (nil != preloadBlock)
+    {
+        if (currentTime < preloadTime)
+        {
+            preloadObserver = [[clock addBoundaryObserverAtTime:preloadTime queue:queue usingBlock:preloadBlock] retain];
+        }
+        else
+        {
+            dispatch_async(queue, preloadBlock);
+        }
+    }
+    
+    if (currentTime < endTime)
+    {
+        endObserver = [[clock addBoundaryObserverAtTime:endTime queue:queue usingBlock:endBlock] retain];
+    }
+}
+
+//
+// remove the boundaries which were not reached yet
+//
+// Arguments: none
+//
+// Returns: none
+//
+- (void) disarm
+{
+    if (nil != preloadObserver)
+    {
+        [clock removeBoundaryObserver:preloadObserver];
+        [preloadObserver release];
+        preloadObserver = nil;
+    }
+    
+    if (nil != endObserver)
+    {
+        [clock removeBoundaryObserver:endObserver];
+        [endObserver release];
+        endObserver = nil;
+    }
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [self disarm];
+    [clock release];
+    dispatch_release(queue);
+    
+    [super dealloc];
+}
+
+@end
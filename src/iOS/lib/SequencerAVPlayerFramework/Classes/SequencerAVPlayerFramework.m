@@ -14,8 +14,22 @@
 //
 
 #import <AVFoundation/AVFoundation.h>
+#import <libkern/OSAtomic.h>
 #import "SequencerAVPlayerFramework_Internal.h"
 #import "Sequencer.h"
+#import "JSContextEngineHost.h"
+#import "WebViewEngineHost.h"
+#import "RecordingEngineHost.h"
+#import "TransitionMetrics.h"
+#import "VASTWrapperResolver.h"
+#import "HLSPlaylist.h"
+#import "LazyAdBreak.h"
+#import "VASTPrefetchEntry.h"
+#import "AVPlayerPlaybackClock.h"
+#import "SegmentBoundaryObserver.h"
+#import "PlayerPool.h"
+#import "AVPlayerBackend.h"
+#import "PreloadLeadTimeEstimator.h"
 #import "Scheduler.h"
 #import "AdResolver.h"
 #import "VASTParser.h"
@@ -35,6 +49,26 @@
 #define NUM_OF_VIEWS 3
 #define JAVASCRIPT_LOADING_POLLING_INTERVAL 0.05
 #define LIVE_POSITION_ERROR_MARGIN_IN_SEC 0.1
+#define LIVE_PLAYLIST_DEFAULT_REFRESH_INTERVAL 2.0
+#define AD_BREAK_DEFAULT_LOOKAHEAD 30.0
+#define VAST_PREFETCH_DEFAULT_LOOKAHEAD 20.0
+#define PLAYER_POOL_DEFAULT_WARM_COUNT 1
+#define PRELOAD_MAXIMUM_LEAD_TIME 30.0
+#define UPCOMING_PRELOAD_DEFAULT_COUNT 2
+
+static char EngineQueueKey;
+
+// The probe of a clip in a batch content append, filled in by the concurrent probe blocks
+typedef struct
+{
+    BOOL isProbed;
+    BOOL isLive;
+    NSTimeInterval duration;
+    NSTimeInterval probeTime;
+    NSURL *playlistURL;     // retained, the media playlist the duration was read from
+    NSString *manifest;     // retained, the media playlist
+    NSError *error;         // retained, nil if the probe succeeded
+} ContentClipProbe;
 
 NSString * const FrameworkErrorDomain = @"PLAYER_FRAMEWORK";
 NSString * const FrameworkUnexpectedError = @"PLAYER_FRAMEWORK:UnexpectedError";
@@ -50,6 +84,9 @@ NSString * const PlayerSequencerErrorArgsUserInfoKey = @"PlayerSequencerErrorArg
 
 NSString * const PlayerSequencerReadyNotification = @"PlayerSequencerReadyNotification";
 
+NSString * const TransitionMetricsUpdatedNotification = @"TransitionMetricsUpdatedNotification";
+NSString * const TransitionMetricsArgsUserInfoKey = @"TransitionMetricsArgs";
+
 @implementation SeekbarTimeUpdatedEventArgs
 
 #pragma mark -
@@ -91,6 +128,208 @@ NSString * const PlayerSequencerReadyNotification = @"PlayerSequencerReadyNotifi
 
 @end
 
+@implementation PlaybackSnapshot
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize currentEntry;
+@synthesize nextEntry;
+@synthesize seekbarTime;
+@synthesize currentPlaybackTime;
+@synthesize leftDvrEdge;
+@synthesize livePosition;
+@synthesize isLive;
+@synthesize isStopped;
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+- (id) initWithCurrentEntry:(PlaylistEntry *)aCurrentEntry nextEntry:(PlaylistEntry *)aNextEntry seekbarTime:(SeekbarTime *)aSeekbarTime currentPlaybackTime:(NSTimeInterval)aPlaybackTime leftDvrEdge:(NSTimeInterval)aLeftDvrEdge livePosition:(NSTimeInterval)aLivePosition isLive:(BOOL)live isStopped:(BOOL)stopped
+{
+    if (self = [super init])
+    {
+        currentEntry = [aCurrentEntry retain];
+        nextEntry = [aNextEntry retain];
+        seekbarTime = [aSeekbarTime retain];
+        currentPlaybackTime = aPlaybackTime;
+        leftDvrEdge = aLeftDvrEdge;
+        livePosition = aLivePosition;
+        isLive = live;
+        isStopped = stopped;
+    }
+    
+    return self;
+}
+
+//
+// update the snapshot in place with the current playback state. The seekbar time is
+// allocated once and its values are copied afterwards.
+//
+// Arguments:
+// [aCurrentEntry]: the entry playing
+// [aNextEntry]: the entry preloaded to play next
+// [aSeekbarTime]: the current seekbar time, nil if the playback is stopped
+// [aPlaybackTime]: the current playback time in media time
+// [aLeftDvrEdge]: the left edge of the DVR window in media time
+// [aLivePosition]: the live position in media time
+// [live]: YES if the main content is live
+// [stopped]: YES if the playback is stopped
+//
+// Returns: YES if any of the values changed and NO otherwise
+//
+- (BOOL) updateWithCurrentEntry:(PlaylistEntry *)aCurrentEntry nextEntry:(PlaylistEntry *)aNextEntry seekbarTime:(SeekbarTime *)aSeekbarTime currentPlaybackTime:(NSTimeInterval)aPlaybackTime leftDvrEdge:(NSTimeInterval)aLeftDvrEdge livePosition:(NSTimeInterval)aLivePosition isLive:(BOOL)live isStopped:(BOOL)stopped
+{
+    BOOL isChanged = NO;
+    
+    if (currentEntry != aCurrentEntry)
+    {
+        [currentEntry release];
+        currentEntry = [aCurrentEntry retain];
+        isChanged = YES;
+    }
+    
+    if (nextEntry != aNextEntry)
+    {
+        [nextEntry release];
+        nextEntry = [aNextEntry retain];
+        isChanged = YES;
+    }
+    
+    if (nil == aSeekbarTime)
+    {
+        if (nil != seekbarTime)
+        {
+            [seekbarTime release];
+            seekbarTime = nil;
+            isChanged = YES;
+        }
+    }
+    else
+    {
+        if (nil == seekbarTime)
+        {
+            seekbarTime = [[SeekbarTime alloc] init];
+            isChanged = YES;
+        }
+        
+        if (seekbarTime.currentSeekbarPosition != aSeekbarTime.currentSeekbarPosition ||
+            seekbarTime.minSeekbarPosition != aSeekbarTime.minSeekbarPosition ||
+            seekbarTime.maxSeekbarPosition != aSeekbarTime.maxSeekbarPosition)
+        {
+            seekbarTime.currentSeekbarPosition = aSeekbarTime.currentSeekbarPosition;
+            seekbarTime.minSeekbarPosition = aSeekbarTime.minSeekbarPosition;
+            seekbarTime.maxSeekbarPosition = aSeekbarTime.maxSeekbarPosition;
+            isChanged = YES;
+        }
+    }
+    
+    if (currentPlaybackTime != aPlaybackTime || leftDvrEdge != aLeftDvrEdge || livePosition != aLivePosition ||
+        isLive != live || isStopped != stopped)
+    {
+        currentPlaybackTime = aPlaybackTime;
+        leftDvrEdge = aLeftDvrEdge;
+        livePosition = aLivePosition;
+        isLive = live;
+        isStopped = stopped;
+        isChanged = YES;
+    }
+    
+    return isChanged;
+}
+
+//
+// copy the snapshot with its own seekbar time, so the copy does not change when this
+// snapshot is updated in place
+//
+// Arguments: none
+//
+// Returns: the copy, which is retained
+//
+- (PlaybackSnapshot *) copySnapshot
+{
+    SeekbarTime *seekbarTimeCopy = nil;
+    
+    if (nil != seekbarTime)
+    {
+        seekbarTimeCopy = [[SeekbarTime alloc] init];
+        seekbarTimeCopy.currentSeekbarPosition = seekbarTime.currentSeekbarPosition;
+        seekbarTimeCopy.minSeekbarPosition = seekbarTime.minSeekbarPosition;
+        seekbarTimeCopy.maxSeekbarPosition = seekbarTime.maxSeekbarPosition;
+    }
+    
+    PlaybackSnapshot *value = [[PlaybackSnapshot alloc] initWithCurrentEntry:currentEntry
+                                                                   nextEntry:nextEntry
+                                                                 seekbarTime:seekbarTimeCopy
+                                                         currentPlaybackTime:currentPlaybackTime
+                                                                 leftDvrEdge:leftDvrEdge
+                                                                livePosition:livePosition
+                                                                      isLive:isLive
+                                                                   isStopped:isStopped];
+    [seekbarTimeCopy release];
+    
+    return value;
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [currentEntry release];
+    [nextEntry release];
+    [seekbarTime release];
+    
+    [super dealloc];
+}
+
+@end
+
+@implementation ContentClipProbeResult
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize clipURL;
+@synthesize clipId;
+@synthesize duration;
+@synthesize isLive;
+@synthesize isProbed;
+@synthesize probeTime;
+@synthesize error;
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+- (id) initWithClipURL:(NSURL *)aClipURL clipId:(int32_t)aClipId duration:(NSTimeInterval)aDuration isLive:(BOOL)live isProbed:(BOOL)probed probeTime:(NSTimeInterval)aProbeTime error:(NSError *)anError
+{
+    if (self = [super init])
+    {
+        clipURL = [aClipURL retain];
+        clipId = aClipId;
+        duration = aDuration;
+        isLive = live;
+        isProbed = probed;
+        probeTime = aProbeTime;
+        error = [anError retain];
+    }
+    
+    return self;
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [clipURL release];
+    [error release];
+    
+    [super dealloc];
+}
+
+@end
+
 @implementation SequencerAVPlayerFramework
 
 NSString *kStatusKey = @"status";
@@ -102,10 +341,294 @@ NSString *kStatusKey = @"status";
 @synthesize rate;
 @synthesize lastError;
 @synthesize appDelegate;
+@synthesize transitionMetrics;
+@synthesize wrapperResolver;
+@synthesize resolvesAdBreaksLazily;
+@synthesize adBreakLookahead;
+@synthesize vastPrefetchLookahead;
+@synthesize usesBoundaryTransitions;
+@synthesize seekbarUpdateInterval;
+@synthesize playerPool;
+@synthesize upcomingPreloadCount;
+@synthesize preloadLeadTime;
+@synthesize seekbarObserver;
+@synthesize postsSeekbarNotifications;
+
+#pragma mark -
+#pragma mark Private class methods:
+
+//
+// refresh a live media playlist after its target duration and publish the tracked live window to
+// the sequencer plugins, repeating until the tracker is cancelled or the playlist ends. The blocks
+// hold the tracker, the download manager and the sequencer but not the framework, so the refreshes
+// do not keep the framework alive. The chain releases the queue when it ends.
+//
+// Arguments:
+// [tracker]: the live playlist tracker
+// [downloadManager]: the download manager for the refreshes
+// [aSequencer]: the sequencer to publish the live window to
+// [queue]: the engine queue, retained by the caller for the chain
+//
+// Returns: none
+//
++ (void) refreshLivePlaylist:(HLSLivePlaylistTracker *)tracker withDownloadManager:(ManifestDownloadManager *)downloadManager sequencer:(Sequencer *)aSequencer queue:(dispatch_queue_t)queue
+{
+    if (tracker.isCancelled || tracker.hasEndList)
+    {
+        dispatch_release(queue);
+        return;
+    }
+    
+    NSTimeInterval interval = (0 < tracker.targetDuration) ? tracker.targetDuration : LIVE_PLAYLIST_DEFAULT_REFRESH_INTERVAL;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(interval * NSEC_PER_SEC)), queue, ^{
+        ManifestDownloadRequest *request = nil;
+        
+        if (!tracker.isCancelled)
+        {
+            // The live playlist changes on every refresh, the cache would only store it
+            request = [downloadManager downloadManifestWithURL:tracker.url
+                                                      priority:ManifestDownloadPriority_Normal
+                                                       timeout:interval
+                                                      deadline:0
+                                                    cacheUsage:ManifestDownloadCacheUsage_Bypass
+                                               completionQueue:queue
+                                                    completion:^(NSString *manifest, NSError *error) {
+                                                        if (!tracker.isCancelled)
+                                                        {
+                                                            if ([tracker updateWithString:manifest atTime:CFAbsoluteTimeGetCurrent()])
+                                                            {
+                                                                [aSequencer updateLiveWindowWithLeftDvrEdge:tracker.leftDvrEdge
+                                                                                               livePosition:tracker.livePosition
+                                                                                            leftDvrEdgeRate:tracker.leftDvrEdgeRate
+                                                                                           livePositionRate:tracker.livePositionRate];
+                                                            }
+                                                            else
+                                                            {
+                                                                FRAMEWORK_LOG(@"Failed to refresh the live playlist %@: %@", tracker.url, error);
+                                                            }
+                                                        }
+                                                        [SequencerAVPlayerFramework refreshLivePlaylist:tracker withDownloadManager:downloadManager sequencer:aSequencer queue:queue];
+                                                    }];
+        }
+        
+        if (nil == request)
+        {
+            dispatch_release(queue);
+        }
+    });
+}
+
++ (NSError *) invalidPlaylistError
+{
+    NSMutableDictionary *userInfo = [[NSMutableDictionary alloc] init];
+    [userInfo setObject:FrameworkUnexpectedError forKey:NSLocalizedDescriptionKey];
+    [userInfo setObject:@"The manifest is not a valid m3u8 playlist" forKey:NSLocalizedFailureReasonErrorKey];
+    NSError *error = [NSError errorWithDomain:FrameworkErrorDomain code:0 userInfo:userInfo];
+    [userInfo release];
+    
+    return error;
+}
 
 #pragma mark -
 #pragma mark Private instance methods:
 
+//
+// record that the current transition between playlist entries reached a point
+//
+// Arguments:
+// [point]: the point reached
+//
+// Returns: none
+//
+- (void) markTransitionPoint:(TransitionPoint)point
+{
+    [transitionMetrics markPoint:point bridgeTime:sequencer.engineHost.evaluationTime];
+}
+
+//
+// download a manifest and record the download time in the transition metrics
+//
+// Arguments:
+// [manifest]: the output manifest
+// [url]: the URL of the manifest
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) downloadManifest:(NSString **)manifest withURL:(NSURL *)url
+{
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    BOOL success = [self.adResolver downloadManifest:manifest withURL:url];
+    
+    [transitionMetrics addSample:(CFAbsoluteTimeGetCurrent() - startTime) forInterval:TransitionInterval_ManifestDownload];
+    
+    return success;
+}
+
+//
+// download a manifest before a deadline and record the download time in the transition metrics.
+// It does not change the framework state, so it can be called from any thread.
+//
+// Arguments:
+// [manifest]: the output manifest, retained for the caller
+// [url]: the URL of the manifest
+// [deadline]: the absolute time the download has to be finished by, 0 for none
+// [error]: the error for failure
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) downloadManifest:(NSString **)manifest withURL:(NSURL *)url deadline:(CFAbsoluteTime)deadline error:(NSError **)error
+{
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    BOOL success = NO;
+    
+    if (0 < deadline && deadline <= startTime)
+    {
+        *manifest = nil;
+        *error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorTimedOut userInfo:nil];
+    }
+    else
+    {
+        success = [self.adResolver.downloadManager downloadManifest:manifest
+                                                            withURL:url
+                                                           priority:ManifestDownloadPriority_Imminent
+                                                           deadline:((0 < deadline) ? deadline - startTime : 0)
+                                                              error:error];
+        
+        [transitionMetrics addSample:(CFAbsoluteTimeGetCurrent() - startTime) forInterval:TransitionInterval_ManifestDownload];
+    }
+    
+    return success;
+}
+
+//
+// post the transition metrics notification. The metrics timer runs on the main thread so
+// the notification is posted at once, other callers queue it on the main queue.
+//
+// Arguments: none
+//
+// Returns: none
+//
+- (void) sendTransitionMetricsNotification
+{
+    NSDictionary *userInfo = [[NSDictionary alloc] initWithObjectsAndKeys:transitionMetrics, TransitionMetricsArgsUserInfoKey, nil];
+    NSNotification *notification = [[NSNotification notificationWithName:TransitionMetricsUpdatedNotification object:self userInfo:userInfo] retain];
+    [userInfo release];
+    
+    if ([NSThread isMainThread])
+    {
+        [[NSNotificationCenter defaultCenter] postNotification:notification];
+        [notification release];
+    }
+    else
+    {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [[NSNotificationCenter defaultCenter] postNotification:notification];
+            [notification release];
+        });
+    }
+}
+
+//
+// check if the caller is running on the engine queue
+//
+// Arguments: none
+//
+// Returns: YES if the caller is running on the engine queue and NO otherwise
+//
+- (BOOL) isOnEngineQueue
+{
+    if (dispatch_get_main_queue() == engineQueue)
+    {
+        return [NSThread isMainThread];
+    }
+    
+    return (self == dispatch_get_specific(&EngineQueueKey));
+}
+
+//
+// run an operation on the engine queue and wait for it to finish. The operations queued
+// by the asynchronous methods before it are finished first. The player calls every sequencer,
+// scheduler and ad resolver method through it, the operation may use the playback state of
+// the main thread since the main thread waits for it.
+//
+// Arguments:
+// [operation]: the operation to run
+//
+// Returns: none
+//
+- (void) performOnEngineQueueAndWait:(dispatch_block_t)operation
+{
+    if ([self isOnEngineQueue])
+    {
+        operation();
+    }
+    else
+    {
+        dispatch_sync(engineQueue, operation);
+    }
+}
+
+//
+// queue an operation on the engine queue and call the completion handler on the main thread
+// when the operation is finished
+//
+// Arguments:
+// [operation]: the operation to run, which returns YES for success and NO for failure
+// [completion]: the completion handler, can be nil
+//
+// Returns: none
+//
+- (void) performOnEngineQueue:(BOOL (^)(int32_t *clipId))operation completion:(SequencerCompletionHandler)completion
+{
+    OSAtomicIncrement32Barrier(&queuedOperationCount);
+    dispatch_async(engineQueue, ^{
+        NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+        
+        int32_t clipId = 0;
+        BOOL success = operation(&clipId);
+        NSError *error = success ? nil : self.lastError;
+        OSAtomicDecrement32Barrier(&queuedOperationCount);
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (nil != completion)
+            {
+                completion(success, clipId, error);
+            }
+        });
+        
+        [pool release];
+    });
+}
+
+//
+// update the playback state behind the snapshot property. The state is updated in place on
+// every seekbar timer tick, a new snapshot is only published when the snapshot property is
+// read after the state changed.
+//
+// Arguments:
+// [seekbarTime]: the current seekbar time, nil if the playback is stopped
+// [playbackTime]: the current playback time in media time
+//
+// Returns: none
+//
+- (void) updateSnapshotWithSeekbarTime:(SeekbarTime *)seekbarTime playbackTime:(NSTimeInterval)playbackTime
+{
+    @synchronized(self)
+    {
+        if ([snapshotState updateWithCurrentEntry:currentSegment.clip
+                                        nextEntry:nextSegment.clip
+                                      seekbarTime:seekbarTime
+                              currentPlaybackTime:playbackTime
+                                      leftDvrEdge:leftDvrEdge
+                                     livePosition:livePosition
+                                           isLive:isLive
+                                        isStopped:isStopped])
+        {
+            isSnapshotChanged = YES;
+        }
+    }
+}
+
 - (void) unregisterPlayer:(AVPlayer *) aPlayer
 {
     [[NSNotificationCenter defaultCenter] removeObserver:self
@@ -162,6 +685,61 @@ NSString *kStatusKey = @"status";
     [pool release];
 }
 
+//
+// Deliver the latest seekbar state to the seekbar observer. The state is read when the delivery
+// runs, so the updates published since it was scheduled are coalesced into one.
+//
+// Arguments: none
+//
+// Returns: none
+//
+- (void) deliverSeekbarState
+{
+    SeekbarState state = pendingSeekbarState;
+    
+    isSeekbarStatePending = NO;
+    pendingSeekbarState.coalescedCount = 0;
+    
+    [seekbarObserver seekbarStateUpdated:state];
+}
+
+// The dispatch_async_f function of the seekbar state delivery, the context is the retained framework
+static void DeliverSeekbarState(void *context)
+{
+    SequencerAVPlayerFramework *framework = (SequencerAVPlayerFramework *)context;
+    
+    [framework deliverSeekbarState];
+    [framework release];
+}
+
+//
+// Publish a seekbar state to the seekbar observer without allocating objects. Only one delivery
+// is queued at a time: the state of a delivery the observer has not received yet is replaced.
+// It is called on the main thread by the seekbar timer, as is the delivery.
+//
+// Arguments:
+// [state]: the seekbar state
+//
+// Returns: none
+//
+- (void) publishSeekbarState:(const SeekbarState *)state
+{
+    if (nil == seekbarObserver)
+    {
+        return;
+    }
+    
+    uint32_t coalescedCount = isSeekbarStatePending ? pendingSeekbarState.coalescedCount + 1 : 0;
+    pendingSeekbarState = *state;
+    pendingSeekbarState.coalescedCount = coalescedCount;
+    
+    if (!isSeekbarStatePending)
+    {
+        isSeekbarStatePending = YES;
+        dispatch_async_f(dispatch_get_main_queue(), [self retain], DeliverSeekbarState);
+    }
+}
+
 - (void) setNULLSequencerSchedulerError
 {
     NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
@@ -172,13 +750,74 @@ NSString *kStatusKey = @"status";
     self.lastError = [NSError errorWithDomain:@"PLAYER_SEQUENCER" code:0 userInfo:userInfo];
     [userInfo release];
     
-    [pool release];
+    [pool release];
+}
+
+
+- (void) disarmBoundaryObservers
+{
+    [boundaryObserver disarm];
+    [boundaryObserver release];
+    boundaryObserver = nil;
+}
+
+//
+// arm one-shot observers at the preload point and the end of the current segment in the player,
+// so the next segment is preloaded and the transition starts on time instead of at the next
+// seekbar timer tick. The seekbar timer still detects the ends the observers can not, e.g. for
+// reverse playback.
+//
+// Arguments:
+// [moviePlayer]: the player of the current segment
+//
+// Returns: none
+//
+- (void) armBoundaryObserversWithPlayer:(AVPlayer *)moviePlayer
+{
+    [self disarmBoundaryObservers];
+    
+    // The end of the live main content is not known
+    if (!usesBoundaryTransitions || nil == currentSegment || nil == moviePlayer ||
+        (isLive && !currentSegment.clip.isAdvertisement))
+    {
+        return;
+    }
+    
+    PlaybackSegment *segment = currentSegment;
+    AVPlayerPlaybackClock *clock = [[AVPlayerPlaybackClock alloc] initWithPlayer:moviePlayer];
+    boundaryObserver = [[SegmentBoundaryObserver alloc] initWithClock:clock queue:dispatch_get_main_queue()];
+    [clock release];
+    
+    // The blocks are ignored if the segment was replaced, e.g. by a seek, before the boundary was reached
+    dispatch_block_t preloadBlock = ^{
+        if (segment == currentSegment && nil == nextSegment && !isSeekPending)
+        {
+            // Should start to pre-load the next content
+            [self preloadContent];
+        }
+    };
+    dispatch_block_t endBlock = ^{
+        if (segment == currentSegment && PlayerStatus_Playing == currentSegment.status && !isSeekPending)
+        {
+            [self markTransitionPoint:TransitionPoint_EndOfMedia];
+            if (![self contentFinished:NO])
+            {
+                [self sendErrorNotification];
+            }
+        }
+    };
+    
+    [boundaryObserver armWithEndTime:segment.clip.mediaTime.clipEndMediaTime
+                     preloadLeadTime:preloadLeadTime
+                        preloadBlock:preloadBlock
+                            endBlock:endBlock];
 }
 
-
 - (void) reset:(AVPlayer *)moviePlayer
 {    
     [self unregisterPlayer:moviePlayer];
+    [self disarmBoundaryObservers];
+    [playerPool cancelPreloads];
     
     if (seekbarTimer)
     {
@@ -202,7 +841,7 @@ NSString *kStatusKey = @"status";
     
     for (AVPlayerLayerView *playerLayerView in avPlayerViews)
     {
-        playerLayerView.player = nil;
+        [self releasePlayerOfView:playerLayerView];
         playerLayerView.status = ViewStatus_Idle;
     }
     self.player = nil;
@@ -221,8 +860,9 @@ NSString *kStatusKey = @"status";
             break;
         }
 
-        NSMutableArray *adList = nil;
-        success = [self.adResolver.vastParser getAdList:&adList withEntryId:vastEntryId];
+        // Get all the ads with their creatives and media files in one call
+        NSArray *adList = nil;
+        success = [self.adResolver.vastParser resolveAllAds:&adList withEntryId:vastEntryId];
         if (!success)
         {
             FRAMEWORK_LOG(@"Failed to retrieve the Ad list from the VAST manifest");
@@ -230,36 +870,35 @@ NSString *kStatusKey = @"status";
             break;
         }
         
+        // Replace the Wrapper ads by the InLine ads their chains lead to. The wrapper resolver
+        // downloads the chains of the whole pod concurrently and gives up at its deadline.
+        NSArray *resolvedAdList = nil;
+        if ([wrapperResolver resolveAds:&resolvedAdList fromAds:adList])
+        {
+            adList = resolvedAdList;
+        }
+        
         *adInfos = [[NSMutableArray alloc] initWithCapacity:[adList count]];
         adBuffetAd = nil;
         
         for (int32_t adIndex = 0; adIndex < [adList count]; ++adIndex)
         {
             Ad *ad = [adList objectAtIndex:adIndex];
-            NSMutableArray *creativesList = nil;
-            NSMutableArray *mediaFileList = nil;
+            NSArray *creativesList = ad.creatives.elementList;
+            NSArray *mediaFileList = nil;
             switch (ad.type)
             {
                 case InLine:
-                    if (![self.adResolver.vastParser getCreativeList:&creativesList withEntryId:vastEntryId adOrdinal:adIndex adType:ad.type])
-                    {
-                        FRAMEWORK_LOG(@"Failed to retrieve the creative list for ad %d", adIndex);
-                        self.lastError = self.adResolver.vastParser.lastError;
-                        [self sendErrorNotification];
-                        continue;
-                    }
-                    
                     for (int32_t creativeIndex = 0; creativeIndex < [creativesList count]; ++creativeIndex)
                     {
                         // Only deal with Linear Creative
                         Creative *creative = [creativesList objectAtIndex:creativeIndex];
                         if (Linear == creative.type)
                         {
-                            if (![self.adResolver.vastParser getMediaFileList:&mediaFileList withEntryId:vastEntryId adOrdinal:adIndex creativeOrdinal:creativeIndex])
+                            mediaFileList = creative.mediaFiles.elementList;
+                            if (0 == [mediaFileList count])
                             {
-                                FRAMEWORK_LOG(@"Failed to retrieve the media file list for ad %d and creative %d", adIndex, creativeIndex);
-                                self.lastError = self.adResolver.vastParser.lastError;
-                                [self sendErrorNotification];
+                                FRAMEWORK_LOG(@"VAST Linear creative without MediaFile element! Ad %d Creative %d", adIndex, creativeIndex);
                                 continue;
                             }
                         }
@@ -311,7 +950,7 @@ NSString *kStatusKey = @"status";
                     break;
                     
                 case Wrapper:
-                    FRAMEWORK_LOG(@"VAST Wrapper manifest is not implemented!");
+                    FRAMEWORK_LOG(@"VAST Wrapper could not be resolved within %u levels and %f seconds! Ad %d", wrapperResolver.maxDepth, wrapperResolver.deadline, adIndex);
                     break;
                     
                 default:
@@ -400,13 +1039,14 @@ NSString *kStatusKey = @"status";
             }
         }];
         
-        int32_t entryId;
         AdInfo *ad = nil;
-        LinearTime *adLinearTime = [[[LinearTime alloc] init] autorelease];
-        adLinearTime.startTime = linearTime.startTime;
+        NSTimeInterval adStartTime = linearTime.startTime;
         NSTimeInterval totalLinearDuration = linearTime.duration;
+        NSMutableArray *podAds = [NSMutableArray arrayWithCapacity:[sortedArray count]];
+        NSMutableArray *podLinearTimes = [NSMutableArray arrayWithCapacity:[sortedArray count]];
+        NSMutableArray *clipIds = [NSMutableArray arrayWithCapacity:[sortedArray count]];
 
-        // Schedule all the ads in the pod
+        // Build up all the ads in the pod
         for (int32_t adIndex = 0; adIndex < [sortedArray count] && 0 < totalDuration; ++adIndex)
         {
             ad = (AdInfo *)[sortedArray objectAtIndex:adIndex];
@@ -425,6 +1065,8 @@ NSString *kStatusKey = @"status";
                 adDuration -= (adDuration - totalLinearDuration);
                 totalDuration = 0;
             }
+            LinearTime *adLinearTime = [[[LinearTime alloc] init] autorelease];
+            adLinearTime.startTime = adStartTime;
             if (linearTime.duration > 0)
             {
                 adLinearTime.duration = adDuration;
@@ -437,26 +1079,36 @@ NSString *kStatusKey = @"status";
             }
             else
             {
+                // appended to the ad before it in the batch
                 ad.type = AdType_Pod;
-                ad.appendTo = entryId;
+                ad.appendTo = -1;
             }
             
             ad.policy = baseAd.policy;
             ad.deleteAfterPlayed = baseAd.deleteAfterPlayed;
             
-            success = [sequencer.scheduler scheduleClip:ad atTime:adLinearTime forType:PlaylistEntryType_Media andGetClipId:&entryId];
-            if (!success)
-            {
-                self.lastError = sequencer.scheduler.lastError;
-                break;
-            }
-            
-            adLinearTime.startTime += adDuration;
+            [podAds addObject:ad];
+            [podLinearTimes addObject:adLinearTime];
             
-            if (nil != clipId && 0 == adIndex)
-            {
-                *clipId = entryId;
-            }
+            adStartTime += adDuration;
+        }
+        
+        if (0 == [podAds count])
+        {
+            break;
+        }
+        
+        // Schedule all the ads in the pod with one call
+        success = [sequencer.scheduler scheduleClips:podAds atTimes:podLinearTimes forType:PlaylistEntryType_Media andGetClipIds:clipIds];
+        if (!success)
+        {
+            self.lastError = sequencer.scheduler.lastError;
+            break;
+        }
+        
+        if (nil != clipId && 0 < [clipIds count])
+        {
+            *clipId = [(NSNumber *)[clipIds objectAtIndex:0] intValue];
         }
     }
     while (NO);
@@ -527,88 +1179,501 @@ NSString *kStatusKey = @"status";
     return [NSDate timeIntervalSinceReferenceDate];
 }
 
-- (BOOL) getHLSContentDuration:(NSTimeInterval *)duration andIsLiveStream:(BOOL *)isLiveStream fromURL:(NSURL *)clipURL
+- (void) stopLivePlaylistTracking
+{
+    @synchronized(self)
+    {
+        [livePlaylistTracker cancel];
+        [livePlaylistTracker release];
+        livePlaylistTracker = nil;
+    }
+}
+
+//
+// start following the refreshes of a live media playlist, replacing the playlist followed before
+//
+// Arguments:
+// [playlistURL]: the URL of the media playlist
+// [manifest]: the media playlist downloaded from the URL
+//
+// Returns: none
+//
+- (void) startLivePlaylistTrackingWithURL:(NSURL *)playlistURL manifest:(NSString *)manifest
+{
+    HLSLivePlaylistTracker *tracker = [[HLSLivePlaylistTracker alloc] initWithURL:playlistURL];
+    if ([tracker updateWithString:manifest atTime:CFAbsoluteTimeGetCurrent()])
+    {
+        [self stopLivePlaylistTracking];
+        @synchronized(self)
+        {
+            livePlaylistTracker = [tracker retain];
+        }
+        
+        dispatch_retain(engineQueue);
+        [SequencerAVPlayerFramework refreshLivePlaylist:tracker withDownloadManager:self.adResolver.downloadManager sequencer:sequencer queue:engineQueue];
+    }
+    [tracker release];
+}
+
+//
+// schedule the ad pod of a lazily resolved ad break from its downloaded VAST manifest. The ad pod
+// is not scheduled if the playback passed the ad break before the download finished.
+//
+// Arguments:
+// [adBreak]: the ad break
+// [manifest]: the VAST manifest of the ad break, nil if the download failed
+// [error]: the download error
+//
+// Returns: none
+//
+- (void) scheduleLazyAdBreak:(LazyAdBreak *)adBreak withManifest:(NSString *)manifest error:(NSError *)error
+{
+    NSMutableArray *adPodArray = nil;
+    NSTimeInterval leadTime = adBreak.timeOffset - lazyAdBreakLinearTime;
+    
+    do
+    {
+        if (nil == manifest)
+        {
+            FRAMEWORK_LOG(@"Failed to download the manifest with url:%@", adBreak.adTagURL);
+            adBreak.state = LazyAdBreakState_Failed;
+            self.lastError = error;
+            [self sendErrorNotification];
+            break;
+        }
+        
+        if (leadTime < 0)
+        {
+            // The ad break can be resolved again if the playback is moved before it
+            FRAMEWORK_LOG(@"The playback passed the ad break at %f before it was resolved", adBreak.timeOffset);
+            adBreak.state = LazyAdBreakState_Pending;
+            [transitionMetrics countAdBreakResolution:NO];
+            break;
+        }
+        
+        if (![self getAdInfos:&adPodArray fromVAST:manifest] || nil == adPodArray || 0 == [adPodArray count])
+        {
+            FRAMEWORK_LOG(@"Failed to parse the VAST manifest in the adBreak with url %@", adBreak.adTagURL);
+            adBreak.state = LazyAdBreakState_Failed;
+            [self sendErrorNotification];
+            break;
+        }
+        
+        LinearTime *adBreakTime = [[[LinearTime alloc] init] autorelease];
+        adBreakTime.startTime = adBreak.timeOffset;
+        AdInfo *baseAd = [[[AdInfo alloc] init] autorelease];
+        baseAd.type = AdType_Midroll;
+        NSTimeInterval totalDuration = 0;
+        for (AdInfo *ad in adPodArray)
+        {
+            totalDuration += (ad.mediaTime.clipEndMediaTime - ad.mediaTime.clipBeginMediaTime);
+        }
+        if (![self scheduleAds:adPodArray withTotalDuration:totalDuration atTime:adBreakTime basedOnAd:baseAd andGetClipId:nil])
+        {
+            FRAMEWORK_LOG(@"Failed to schedule the ad pod specified in the VAST manifest with url %@", adBreak.adTagURL);
+            adBreak.state = LazyAdBreakState_Failed;
+            [self sendErrorNotification];
+            break;
+        }
+        
+        adBreak.state = LazyAdBreakState_Scheduled;
+        [transitionMetrics addSample:leadTime forInterval:TransitionInterval_AdBreakLeadTime];
+        [transitionMetrics countAdBreakResolution:YES];
+    } while (NO);
+    
+    [adPodArray removeAllObjects];
+    [adPodArray release];
+}
+
+//
+// start downloading the VAST manifest of a lazy ad break. The download has to finish
+// before the playback reaches the ad break.
+//
+// Arguments:
+// [adBreak]: the ad break
+// [linearTime]: the current playback position in linear time
+//
+// Returns: none
+//
+- (void) resolveLazyAdBreak:(LazyAdBreak *)adBreak atLinearTime:(NSTimeInterval)linearTime
+{
+    uint32_t resolveCount = [adBreak beginResolving];
+    NSTimeInterval deadline = adBreak.timeOffset - linearTime;
+    
+    adBreak.request = [self.adResolver.downloadManager downloadManifestWithURL:adBreak.adTagURL
+                                                                      priority:ManifestDownloadPriority_Normal
+                                                                       timeout:MANIFEST_DOWNLOAD_DEFAULT_TIMEOUT
+                                                                      deadline:deadline
+                                                               completionQueue:engineQueue
+                                                                    completion:^(NSString *manifest, NSError *error) {
+                                                                        // The resolution may have been cancelled by a seek
+                                                                        if (resolveCount == adBreak.resolveCount)
+                                                                        {
+                                                                            adBreak.request = nil;
+                                                                            [self scheduleLazyAdBreak:adBreak withManifest:manifest error:error];
+                                                                        }
+                                                                    }];
+    if (nil == adBreak.request)
+    {
+        adBreak.state = LazyAdBreakState_Failed;
+    }
+}
+
+//
+// start resolving the lazy ad breaks the playback came within the lookahead of, and cancel the
+// resolutions of the ad breaks the playback moved away from, e.g. by a seek. It is called on the
+// engine queue by the seekbar timer and after a seek.
+//
+// Arguments:
+// [linearTime]: the current playback position in linear time
+//
+// Returns: none
+//
+- (void) updateLazyAdBreaksAtLinearTime:(NSTimeInterval)linearTime
+{
+    lazyAdBreakLinearTime = linearTime;
+    
+    for (LazyAdBreak *adBreak in lazyAdBreaks)
+    {
+        BOOL isNear = [adBreak isWithinLookahead:adBreakLookahead ofLinearTime:linearTime];
+        
+        if (LazyAdBreakState_Pending == adBreak.state && isNear)
+        {
+            [self resolveLazyAdBreak:adBreak atLinearTime:linearTime];
+        }
+        else if (LazyAdBreakState_Resolving == adBreak.state && !isNear)
+        {
+            FRAMEWORK_LOG(@"Cancelled the resolution of the ad break at %f", adBreak.timeOffset);
+            [adBreak cancel];
+        }
+    }
+}
+
+//
+// cancel the resolutions of all the lazy ad breaks, they are resolved again when the playback
+// comes near them
+//
+// Arguments: none
+//
+// Returns: none
+//
+- (void) cancelLazyAdBreakResolutions
+{
+    for (LazyAdBreak *adBreak in lazyAdBreaks)
+    {
+        [adBreak cancel];
+    }
+    lazyAdBreakLinearTime = 0;
+}
+
+//
+// parse the downloaded VAST manifest of a prefetched playlist entry into its ad pod. A failed prefetch
+// does not change lastError, the VAST entry is resolved again when the playback reaches it.
+//
+// Arguments:
+// [prefetchEntry]: the prefetched playlist entry
+// [manifest]: the VAST manifest, nil if the download failed
+//
+// Returns: none
+//
+- (void) finishVASTPrefetch:(VASTPrefetchEntry *)prefetchEntry withManifest:(NSString *)manifest
+{
+    NSNumber *entryId = [NSNumber numberWithInt:prefetchEntry.entryId];
+    NSMutableArray *adPodArray = nil;
+    
+    @synchronized(vastPrefetchEntries)
+    {
+        if (prefetchEntry != [vastPrefetchEntries objectForKey:entryId] || VASTPrefetchState_Downloading != prefetchEntry.state)
+        {
+            // The prefetch was cancelled or the playback already reached the entry
+            return;
+        }
+        prefetchEntry.request = nil;
+    }
+    
+    NSError *savedError = [self.lastError retain];
+    BOOL success = (nil != manifest && [self getAdInfos:&adPodArray fromVAST:manifest] && nil != adPodArray && 0 < [adPodArray count]);
+    self.lastError = savedError;
+    [savedError release];
+    
+    @synchronized(vastPrefetchEntries)
+    {
+        if (prefetchEntry == [vastPrefetchEntries objectForKey:entryId] && VASTPrefetchState_Downloading == prefetchEntry.state)
+        {
+            if (success)
+            {
+                [prefetchEntry setReadyWithAdInfos:adPodArray];
+            }
+            else
+            {
+                FRAMEWORK_LOG(@"Failed to prefetch the VAST manifest with url:%@", prefetchEntry.vastURL);
+                prefetchEntry.state = VASTPrefetchState_Failed;
+            }
+        }
+    }
+    
+    [adPodArray removeAllObjects];
+    [adPodArray release];
+}
+
+//
+// find the VAST playlist entries ahead of the playback and start downloading their manifests in
+// the background, so the ad pod is ready when the playback reaches the entry. The prefetches of
+// the entries the playback moved away from are dropped. It is called on the engine queue by the
+// seekbar timer.
+//
+// Arguments:
+// [linearTime]: the current playback position in linear time
+//
+// Returns: none
+//
+- (void) prefetchVASTEntriesAtLinearTime:(NSTimeInterval)linearTime
+{
+    NSArray *entries = nil;
+    
+    if (0 >= vastPrefetchLookahead || nil == sequencer.scheduler)
+    {
+        return;
+    }
+    
+    // The entries just behind the position are kept since the transition to them may not have happened yet
+    if (![sequencer.scheduler getEntries:&entries ofType:PlaylistEntryType_VAST inRangeFrom:(linearTime - vastPrefetchLookahead) to:(linearTime + vastPrefetchLookahead)])
+    {
+        return;
+    }
+    
+    NSMutableArray *newEntries = [NSMutableArray arrayWithCapacity:[entries count]];
+    
+    @synchronized(vastPrefetchEntries)
+    {
+        NSMutableSet *entryIds = [NSMutableSet setWithCapacity:[entries count]];
+        
+        for (NSDictionary *entry in entries)
+        {
+            NSNumber *entryId = [entry objectForKey:@"id"];
+            NSTimeInterval linearStartTime = [[entry objectForKey:@"linearStartTime"] doubleValue];
+            [entryIds addObject:entryId];
+            
+            if (nil == [vastPrefetchEntries objectForKey:entryId] && linearTime <= linearStartTime)
+            {
+                NSURL *vastURL = [NSURL URLWithString:[entry objectForKey:@"clipURI"]];
+                if (nil != vastURL)
+                {
+                    VASTPrefetchEntry *prefetchEntry = [[VASTPrefetchEntry alloc] initWithEntryId:[entryId intValue] vastURL:vastURL linearStartTime:linearStartTime];
+                    [vastPrefetchEntries setObject:prefetchEntry forKey:entryId];
+                    [newEntries addObject:prefetchEntry];
+                    [prefetchEntry release];
+                }
+            }
+        }
+        
+        for (NSNumber *entryId in [vastPrefetchEntries allKeys])
+        {
+            if (![entryIds containsObject:entryId])
+            {
+                [[vastPrefetchEntries objectForKey:entryId] cancel];
+                [vastPrefetchEntries removeObjectForKey:entryId];
+            }
+        }
+    }
+    
+    for (VASTPrefetchEntry *prefetchEntry in newEntries)
+    {
+        ManifestDownloadRequest *request = [self.adResolver.downloadManager downloadManifestWithURL:prefetchEntry.vastURL
+                                                                                           priority:ManifestDownloadPriority_Prefetch
+                                                                                            timeout:MANIFEST_DOWNLOAD_DEFAULT_TIMEOUT
+                                                                                           deadline:0
+                                                                                    completionQueue:engineQueue
+                                                                                         completion:^(NSString *manifest, NSError *error) {
+                                                                                             [self finishVASTPrefetch:prefetchEntry withManifest:manifest];
+                                                                                         }];
+        @synchronized(vastPrefetchEntries)
+        {
+            if (nil == request)
+            {
+                prefetchEntry.state = VASTPrefetchState_Failed;
+            }
+            else if (VASTPrefetchState_Downloading == prefetchEntry.state)
+            {
+                prefetchEntry.request = request;
+            }
+        }
+    }
+}
+
+//
+// take the prefetched ad pod of a VAST playlist entry the playback reached. The prefetch of
+// the entry is finished either way.
+//
+// Arguments:
+// [entryId]: the id of the VAST playlist entry
+//
+// Returns: the AdInfo objects of the ad pod, nil for a prefetch miss
+//
+- (NSArray *) takePrefetchedAdPodForEntry:(int32_t)entryId
+{
+    NSNumber *key = [NSNumber numberWithInt:entryId];
+    NSArray *adInfos = nil;
+    
+    @synchronized(vastPrefetchEntries)
+    {
+        VASTPrefetchEntry *prefetchEntry = [vastPrefetchEntries objectForKey:key];
+        
+        if (VASTPrefetchState_Ready == prefetchEntry.state)
+        {
+            adInfos = [[prefetchEntry.adInfos retain] autorelease];
+            [transitionMetrics addSample:(CFAbsoluteTimeGetCurrent() - prefetchEntry.readyTime) forInterval:TransitionInterval_VASTPrefetchLeadTime];
+        }
+        else
+        {
+            [prefetchEntry cancel];
+        }
+        [vastPrefetchEntries removeObjectForKey:key];
+    }
+    
+    if (0 < vastPrefetchLookahead)
+    {
+        [transitionMetrics countVASTPrefetch:(nil != adInfos)];
+    }
+    
+    return adInfos;
+}
+
+//
+// cancel all the VAST prefetches
+//
+// Arguments: none
+//
+// Returns: none
+//
+- (void) cancelVASTPrefetches
+{
+    @synchronized(vastPrefetchEntries)
+    {
+        for (VASTPrefetchEntry *prefetchEntry in [vastPrefetchEntries allValues])
+        {
+            [prefetchEntry cancel];
+        }
+        [vastPrefetchEntries removeAllObjects];
+    }
+}
+
+//
+// download the media playlist of a clip, following the first variant of a top level playlist.
+// It does not change the framework state, so the playlists of several clips can be downloaded
+// concurrently.
+//
+// Arguments:
+// [playlist]: the output media playlist, retained for the caller
+// [manifest]: the output media playlist in string format, retained for the caller
+// [playlistURL]: the output URL of the media playlist, retained for the caller
+// [clipURL]: the URL of the clip
+// [deadline]: the absolute time the downloads have to be finished by, 0 for none
+// [error]: the error for failure
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) getHLSPlaylist:(HLSPlaylist **)playlist manifest:(NSString **)manifest playlistURL:(NSURL **)playlistURL fromURL:(NSURL *)clipURL deadline:(CFAbsoluteTime)deadline error:(NSError **)error
 {
-    NSMutableString *manifest = nil;
+    NSString *aManifest = nil;
+    NSURL *aPlaylistURL = clipURL;
+    HLSPlaylist *aPlaylist = nil;
     BOOL success = NO;
-    *duration = 0;
-    *isLiveStream = NO;
-
+    
     do
     {
-        if (![self.adResolver downloadManifest:&manifest withURL:clipURL])
+        if (![self downloadManifest:&aManifest withURL:clipURL deadline:deadline error:error])
         {
-            self.lastError = self.adResolver.lastError;
             break;
         }
         
-        manifest = [NSMutableString stringWithString:[manifest stringByTrimmingCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@"\r\n "]]];
-        NSArray *components = [manifest componentsSeparatedByCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@" \r\n/"]];
-        if (0 == components.count || ![[components objectAtIndex:0] isEqualToString:@"#EXTM3U"])
+        aPlaylist = [[HLSPlaylist alloc] initWithString:aManifest];
+        if (nil == aPlaylist)
         {
-            NSMutableDictionary *userInfo = [[NSMutableDictionary alloc] init];
-            [userInfo setObject:FrameworkUnexpectedError forKey:NSLocalizedDescriptionKey];
-            [userInfo setObject:@"The manifest is not a valid m3u8 playlist" forKey:NSLocalizedFailureReasonErrorKey];
-            self.lastError = [NSError errorWithDomain:FrameworkErrorDomain code:0 userInfo:userInfo];
-            [userInfo release];
+            *error = [SequencerAVPlayerFramework invalidPlaylistError];
             break;
         }
         
-        NSString *qualityLevels = nil;
-        for (NSString *element in components)
+        if (aPlaylist.isMasterPlaylist)
         {
-            NSRange range = [element rangeOfString:@"QualityLevels("];
-            if (range.location == 0 && range.length == 14)
+            // This is a top level playlist, we need to download the individual playlist.
+            // The variant URI is relative to the top level playlist.
+            HLSVariant *variant = [aPlaylist.variants objectAtIndex:0];
+            aPlaylistURL = [NSURL URLWithString:variant.uri relativeToURL:clipURL];
+            [aPlaylist release];
+            aPlaylist = nil;
+            [aManifest release];
+            aManifest = nil;
+            
+            if (nil == aPlaylistURL)
             {
-                qualityLevels = element;
+                *error = [SequencerAVPlayerFramework invalidPlaylistError];
                 break;
             }
-        }
-        
-        if (nil != qualityLevels)
-        {
-            // This is a top level playlist, we need to download the individual playlist
-            NSString *lastComponent = [clipURL lastPathComponent];
-            NSURL *playlistURL = [[[clipURL URLByDeletingLastPathComponent] URLByAppendingPathComponent:qualityLevels] URLByAppendingPathComponent:lastComponent];
-            if (![self.adResolver downloadManifest:&manifest withURL:playlistURL])
+            
+            if (![self downloadManifest:&aManifest withURL:aPlaylistURL deadline:deadline error:error])
             {
-                self.lastError = self.adResolver.lastError;
                 break;
             }
             
-            components = [manifest componentsSeparatedByCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@" \r\n/"]];
-        }
-
-        // Adding all the durations of the segments in the playlist
-        // which has the form #EXTINF:<duration>
-        *isLiveStream = YES;
-        for (NSString *element in components)
-        {
-            NSRange range = [element rangeOfString:@"#EXTINF:"];
-            if (range.location != NSNotFound && range.length == 8)
-            {
-                NSTimeInterval segmentDuration = 0;
-                if ([[NSScanner scannerWithString:[element substringFromIndex:8]] scanDouble:&segmentDuration])
-                {
-                    *duration += segmentDuration;
-                }
-            }
-            else
+            aPlaylist = [[HLSPlaylist alloc] initWithString:aManifest];
+            if (nil == aPlaylist)
             {
-                range = [element rangeOfString:@"EXT-X-ENDLIST"];
-                if (range.location != NSNotFound && range.length == 13)
-                {
-                    *isLiveStream = NO;
-                }
+                *error = [SequencerAVPlayerFramework invalidPlaylistError];
+                break;
             }
         }
         
         success = YES;
     } while (NO);
     
+    if (success)
+    {
+        *playlist = aPlaylist;
+        *manifest = aManifest;
+        *playlistURL = [aPlaylistURL retain];
+    }
+    else
+    {
+        [aPlaylist release];
+        [aManifest release];
+    }
+    
     return success;
 }
 
+- (BOOL) getHLSContentDuration:(NSTimeInterval *)duration andIsLiveStream:(BOOL *)isLiveStream fromURL:(NSURL *)clipURL
+{
+    NSString *manifest = nil;
+    NSURL *playlistURL = nil;
+    HLSPlaylist *playlist = nil;
+    NSError *error = nil;
+    *duration = 0;
+    *isLiveStream = NO;
+    
+    if (![self getHLSPlaylist:&playlist manifest:&manifest playlistURL:&playlistURL fromURL:clipURL deadline:0 error:&error])
+    {
+        self.lastError = error;
+        return NO;
+    }
+    
+    // The duration is the sum of the #EXTINF:<duration> of the segments
+    *duration = playlist.totalDuration;
+    *isLiveStream = !playlist.hasEndList;
+    
+    if (*isLiveStream)
+    {
+        // Later refreshes only process the segments which left and joined the DVR window
+        [self startLivePlaylistTrackingWithURL:playlistURL manifest:manifest];
+    }
+    
+    [playlist release];
+    [manifest release];
+    [playlistURL release];
+    
+    return YES;
+}
+
 
 #pragma mark -
 #pragma mark Instance methods:
@@ -622,6 +1687,20 @@ NSString *kStatusKey = @"status";
 // Returns: The framework instance.
 //
 - (id) initWithView:(UIView *)videoView
+{
+    return [self initWithView:videoView bridgeTracePath:nil];
+}
+
+//
+// Constructor for the framework which records the JavaScript bridge traffic
+//
+// Arguments:
+// [videoView]    UIView for the video playback.
+// [tracePath]    The path of the trace file to record every sequencer JavaScript call to, nil for no recording.
+//
+// Returns: The framework instance.
+//
+- (id) initWithView:(UIView *)videoView bridgeTracePath:(NSString *)tracePath
 {
     if (self = [super init])
     {
@@ -647,8 +1726,66 @@ NSString *kStatusKey = @"status";
         AVPlayerLayerView *avPlayerView = [avPlayerViews objectAtIndex:0];
         avPlayerView.playerLayer.hidden = NO;
         
-        // Create the sequencer chain and get the head of the chain
-        sequencer = [[Sequencer alloc] init];
+        // Create the sequencer chain and get the head of the chain.
+        // The headless engine is used when it is available so the sequencer can be called
+        // from the engine queue instead of the main thread.
+        id<JavaScriptEngineHost> engineHost = [[[JSContextEngineHost alloc] initWithScripts:[Sequencer scriptNames]] autorelease];
+        if (nil == engineHost)
+        {
+            engineHost = [[[WebViewEngineHost alloc] initWithScripts:[Sequencer scriptNames]] autorelease];
+        }
+        if (nil != tracePath)
+        {
+            RecordingEngineHost *recordingHost = [[[RecordingEngineHost alloc] initWithEngineHost:engineHost tracePath:tracePath] autorelease];
+            if (nil != recordingHost)
+            {
+                engineHost = recordingHost;
+            }
+        }
+        sequencer = [[Sequencer alloc] initWithEngineHost:engineHost];
+        
+        // The web view engine can only be called from the main thread
+        if (sequencer.engineHost.requiresMainThread)
+        {
+            engineQueue = dispatch_get_main_queue();
+            dispatch_retain(engineQueue);
+        }
+        else
+        {
+            engineQueue = dispatch_queue_create("com.microsoft.sequencer.engine", DISPATCH_QUEUE_SERIAL);
+            dispatch_queue_set_specific(engineQueue, &EngineQueueKey, self, NULL);
+        }
+        queuedOperationCount = 0;
+        snapshot = nil;
+        snapshotState = [[PlaybackSnapshot alloc] initWithCurrentEntry:nil nextEntry:nil seekbarTime:nil currentPlaybackTime:0 leftDvrEdge:0 livePosition:0 isLive:NO isStopped:NO];
+        isSnapshotChanged = NO;
+        transitionMetrics = [[TransitionMetrics alloc] init];
+        metricsNotificationInterval = 0;
+        metricsTimer = nil;
+        wrapperResolver = [[VASTWrapperResolver alloc] initWithAdResolver:sequencer.adResolver];
+        livePlaylistTracker = nil;
+        lazyAdBreaks = [[NSMutableArray alloc] init];
+        lazyAdBreakLinearTime = 0;
+        resolvesAdBreaksLazily = NO;
+        adBreakLookahead = AD_BREAK_DEFAULT_LOOKAHEAD;
+        vastPrefetchEntries = [[NSMutableDictionary alloc] init];
+        vastPrefetchLookahead = VAST_PREFETCH_DEFAULT_LOOKAHEAD;
+        usesBoundaryTransitions = NO;
+        seekbarUpdateInterval = SEEKBAR_TIMER_INTERVAL * TIMER_INTERVALS_PER_NOTIFICATION;
+        boundaryObserver = nil;
+        AVPlayerBackend *playerBackend = [[[AVPlayerBackend alloc] init] autorelease];
+        playerPool = [[PlayerPool alloc] initWithBackend:playerBackend warmCount:PLAYER_POOL_DEFAULT_WARM_COUNT];
+        [playerPool warmUp];
+        preloadEstimator = [[PreloadLeadTimeEstimator alloc] initWithMinimumLeadTime:BUFFERING_COMPLETE_BEFORE_EOS_SEC maximumLeadTime:PRELOAD_MAXIMUM_LEAD_TIME];
+        preloadLeadTime = BUFFERING_COMPLETE_BEFORE_EOS_SEC;
+        upcomingPreloadCount = UPCOMING_PRELOAD_DEFAULT_COUNT;
+        loadStartTime = 0;
+        seekbarObserver = nil;
+        postsSeekbarNotifications = YES;
+        isSeekbarStatePending = NO;
+        memset(&pendingSeekbarState, 0, sizeof(pendingSeekbarState));
+        tickMediaTime = [[MediaTime alloc] init];
+        tickSeekbarTime = [[SeekbarTime alloc] init];
 
         isStopped = YES;
         resetView = NO;
@@ -656,6 +1793,7 @@ NSString *kStatusKey = @"status";
         hasStarted = NO;
         hasStartedAfterStop = NO;
         isSeekingAVPlayer = NO;
+        isSeekPending = NO;
         initialPlaybackPosition = 0;
         livePlayer = nil;
         loadingTimer = [[NSTimer scheduledTimerWithTimeInterval:JAVASCRIPT_LOADING_POLLING_INTERVAL target:self selector:@selector(loadTimer:) userInfo:NULL repeats:NO] retain];
@@ -679,20 +1817,40 @@ NSString *kStatusKey = @"status";
         if (nil == currentSegment)
         {
             // This is the first play
-            seekbarTimer = [[NSTimer scheduledTimerWithTimeInterval:SEEKBAR_TIMER_INTERVAL target:self selector:@selector(timer:) userInfo:NULL repeats:YES] retain];
+            // Let the clips queued by the asynchronous methods get scheduled first
+            [self performOnEngineQueueAndWait:^{}];
+            
+            // With the boundary observers the timer only updates the seekbar
+            NSTimeInterval timerInterval = usesBoundaryTransitions ? seekbarUpdateInterval : SEEKBAR_TIMER_INTERVAL;
+            seekbarTimer = [[NSTimer scheduledTimerWithTimeInterval:timerInterval target:self selector:@selector(timer:) userInfo:NULL repeats:YES] retain];
             timerCount = 0;
             
-            // Set the seek to start entry
-            if (![sequencer.scheduler setSeekToStart])
+            // Set the seek to start entry, then seek to 0 to trigger any preroll ad
+            __block BOOL isSeekToStartSet = NO;
+            __block BOOL found = NO;
+            self.nextSegment = nil;
+            [self performOnEngineQueueAndWait:^{
+                isSeekToStartSet = [sequencer.scheduler setSeekToStart];
+                if (!isSeekToStartSet)
+                {
+                    self.lastError = sequencer.scheduler.lastError;
+                }
+                else
+                {
+                    found = [sequencer getSegmentAfterSeek:&nextSegment withLinearPosition:0];
+                    if (!found)
+                    {
+                        self.lastError = sequencer.lastError;
+                    }
+                }
+            }];
+            if (!isSeekToStartSet)
             {
-                self.lastError = sequencer.scheduler.lastError;
                 break;
             }
             
-            // Seek to 0 to trigger any preroll ad
             // Check for SeekToStart segment
-            self.nextSegment = nil;
-            if ([sequencer getSegmentAfterSeek:&nextSegment withLinearPosition:0] && nil != nextSegment)
+            if (found && nil != nextSegment)
             {                
                 if (![self checkSeekToStart])
                 {
@@ -726,7 +1884,6 @@ NSString *kStatusKey = @"status";
             }
             else
             {
-                self.lastError = sequencer.lastError;
                 break;
             }
         }
@@ -791,6 +1948,8 @@ NSString *kStatusKey = @"status";
         initialPlaybackPosition = 0;
         livePlayer = nil;
         resetView = NO;
+        [self stopLivePlaylistTracking];
+        [self cancelVASTPrefetches];
         PlaybackSegment *segmentToRemove = nil;
         if (PlayerStatus_Playing != currentSegment.status)
         {
@@ -804,16 +1963,24 @@ NSString *kStatusKey = @"status";
         AVPlayer *moviePlayer = playerLayerView.player;
         
         // call onEndOfMedia to release the segment from the segment list
-        PlaybackSegment *segment = nil;
-        success = [sequencer getSegmentOnEndOfMedia:&segment withCurrentSegment:segmentToRemove mediaTime:currentSegment.clip.mediaTime.clipEndMediaTime currentPlaybackRate:1.0 isNotPlayed:YES isEndOfSequence:YES];
-        [segment release];
-        
-        if (!success)
-        {
-            self.lastError = sequencer.lastError;
-        }
+        NSTimeInterval endMediaTime = currentSegment.clip.mediaTime.clipEndMediaTime;
+        __block BOOL released = NO;
+        [self performOnEngineQueueAndWait:^{
+            [self cancelLazyAdBreakResolutions];
+            
+            PlaybackSegment *segment = nil;
+            released = [sequencer getSegmentOnEndOfMedia:&segment withCurrentSegment:segmentToRemove mediaTime:endMediaTime currentPlaybackRate:1.0 isNotPlayed:YES isEndOfSequence:YES];
+            [segment release];
+            
+            if (!released)
+            {
+                self.lastError = sequencer.lastError;
+            }
+        }];
+        success = released;
         
         [self reset:moviePlayer];
+        [self updateSnapshotWithSeekbarTime:nil playbackTime:0];
     }
     
     return success;
@@ -828,86 +1995,184 @@ NSString *kStatusKey = @"status";
 // Returns: YES for success and NO for failure
 //
 - (BOOL) seekToTime:(NSTimeInterval)seekTime
+{
+    __block BOOL success = YES;
+    __block PlaybackSegment *segment = nil;
+    PlaybackSegment *fromSegment = currentSegment;
+    
+    if (!isStopped)
+    {
+        [self performOnEngineQueueAndWait:^{
+            success = [self getSegment:&segment afterSeekToTime:seekTime fromSegment:fromSegment];
+        }];
+        
+        if (success)
+        {
+            success = [self seekToSegment:segment];
+        }
+        
+        [segment release];
+    }
+    
+    return success;
+}
+
+//
+// seek to a specific time in the linear timeline asynchronously. The segment to seek to is found
+// on the engine queue, then the players are updated on the main thread. The seekbar timer does not
+// call the sequencer until the seek is finished.
+//
+// Arguments:
+// [seekTime]: the time to seek to
+// [completion]: the completion handler called on the main thread, can be nil
+//
+// Returns: none
+//
+- (void) seekToTime:(NSTimeInterval)seekTime completion:(SequencerCompletionHandler)completion
+{
+    if (isStopped)
+    {
+        if (nil != completion)
+        {
+            completion(YES, 0, nil);
+        }
+        return;
+    }
+    
+    PlaybackSegment *fromSegment = currentSegment;
+    isSeekPending = YES;
+    
+    dispatch_async(engineQueue, ^{
+        NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+        
+        PlaybackSegment *segment = nil;
+        BOOL found = [self getSegment:&segment afterSeekToTime:seekTime fromSegment:fromSegment];
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            BOOL success = found;
+            
+            isSeekPending = NO;
+            if (success && !isStopped)
+            {
+                success = [self seekToSegment:segment];
+            }
+            [segment release];
+            
+            if (nil != completion)
+            {
+                completion(success, 0, success ? nil : self.lastError);
+            }
+        });
+        
+        [pool release];
+    });
+}
+
+//
+// find the segment to play after a seek. This is called on the engine queue since the VAST
+// manifest of the entry at the seek position may need to be downloaded.
+//
+// Arguments:
+// [segment]: the output segment to play after the seek, which is retained
+// [seekTime]: the time to seek to
+// [fromSegment]: the segment playing when the seek started
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) getSegment:(PlaybackSegment **)segment afterSeekToTime:(NSTimeInterval)seekTime fromSegment:(PlaybackSegment *)fromSegment
 {
     BOOL success = NO;
-    SeekbarTime *seekbarPosition = nil;
+    SeekbarTime *seekbarPosition = [[SeekbarTime alloc] init];
     
     do {
-        if (!isStopped)
+        *segment = nil;
+        seekbarPosition.currentSeekbarPosition = seekTime;
+        
+        // Start resolving the lazy ad breaks near the seek position and stop the ones the seek moved away from
+        [self updateLazyAdBreaksAtLinearTime:seekTime];
+        if (![sequencer getSegmentAfterSeek:segment withSeekbarPosition:seekbarPosition currentSegment:fromSegment] || nil == *segment)
         {
-            // save the originalId
-            int32_t currentId = currentSegment.clip.originalId;
-            
-            // do the actual seek
-            PlaybackSegment *segment = nil;
-            seekbarPosition = [[SeekbarTime alloc] init];
-            seekbarPosition.currentSeekbarPosition = seekTime;
-            if ([sequencer getSegmentAfterSeek:&segment withSeekbarPosition:seekbarPosition currentSegment:currentSegment] && nil != segment)
+            self.lastError = sequencer.lastError;
+            break;
+        }
+        
+        // Seek into another VAST entry needs the ad pod to be scheduled
+        if ((*segment).clip.originalId != fromSegment.clip.originalId && PlaylistEntryType_VAST == (*segment).clip.type)
+        {
+            if (![self getSegmentFromVASTSegment:segment whileBuffering:NO])
             {
-                if (segment.clip.originalId == currentId)
+                break;
+            }
+        }
+        
+        success = YES;
+    } while (NO);
+    
+    [seekbarPosition release];
+    
+    return success;
+}
+
+//
+// play the segment found by a seek
+//
+// Arguments:
+// [segment]: the segment to play after the seek
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) seekToSegment:(PlaybackSegment *)segment
+{
+    BOOL success = NO;
+    
+    do {
+        if (segment.clip.originalId == currentSegment.clip.originalId)
+        {
+            // Seek is within the same entry.
+            // Update the segment info and do the seek in the current player
+            segment.status = PlayerStatus_Waiting;
+            segment.viewIndex = currentSegment.viewIndex;
+            self.currentSegment = segment;
+            [self.player seekToTime:CMTimeMakeWithSeconds(segment.initialPlaybackTime, NSEC_PER_SEC) completionHandler:^(BOOL finished) {
+                if (finished)
                 {
-                    // Seek is within the same entry.
-                    // Update the segment info and do the seek in the current player
-                    segment.status = PlayerStatus_Waiting;
-                    segment.viewIndex = currentSegment.viewIndex;
-                    self.currentSegment = segment;
-                    [self.player seekToTime:CMTimeMakeWithSeconds(segment.initialPlaybackTime, NSEC_PER_SEC) completionHandler:^(BOOL finished) {
-                        if (finished)
-                        {
-                            self.currentSegment.status = PlayerStatus_Playing;
-                        }
-                        else
-                        {
-                            FRAMEWORK_LOG(@"There is an error when seeking into seekTime %f", seekTime);
-                        }
-                    }
-                     ];
-                    
-                    // Seek should invalidate any buffering of the next content since the content may change
-                    nextSegment = nil;
+                    self.currentSegment.status = PlayerStatus_Playing;
+                    [self armBoundaryObserversWithPlayer:self.player];
                 }
                 else
                 {
-                    // Seek is into another entry
-                    // We need to load and play another content in a separate player
-                    if (PlaylistEntryType_VAST == segment.clip.type)
-                    {
-                        success = [self getSegmentFromVASTSegment:&segment whileBuffering:NO];
-                        if (!success)
-                        {
-                            break;
-                        }
-                    }
-                    segment.status = PlayerStatus_Stopped;
-                    // always reset the current view unless it is live content transition from main to ad.
-                    resetView = !(isLive && !(currentSegment.clip.isAdvertisement) && segment.clip.isAdvertisement);
-                    self.nextSegment = segment;
-                    if (![self contentFinished:YES])
-                    {
-                        break;
-                    }
-                    
-                    if(nil == currentSegment || PlayerStatus_Playing != currentSegment.status)
-                    {
-                        // The playback hasn't started yet
-                        // Start it if possible
-                        [self playMovie:[nextSegment.clip.clipURI absoluteString]];
-                    }
+                    FRAMEWORK_LOG(@"There is an error when seeking into media time %f", segment.initialPlaybackTime);
                 }
-                
-                [segment release];
             }
-            else
+             ];
+            
+            // Seek should invalidate any buffering of the next content since the content may change
+            nextSegment = nil;
+        }
+        else
+        {
+            // Seek is into another entry
+            // We need to load and play another content in a separate player
+            segment.status = PlayerStatus_Stopped;
+            // always reset the current view unless it is live content transition from main to ad.
+            resetView = !(isLive && !(currentSegment.clip.isAdvertisement) && segment.clip.isAdvertisement);
+            self.nextSegment = segment;
+            if (![self contentFinished:YES])
             {
-                self.lastError = sequencer.lastError;
                 break;
             }
+            
+            if(nil == currentSegment || PlayerStatus_Playing != currentSegment.status)
+            {
+                // The playback hasn't started yet
+                // Start it if possible
+                [self playMovie:[nextSegment.clip.clipURI absoluteString]];
+            }
         }
+        
         success = YES;
     } while (NO);
-
-    [seekbarPosition release];
-
+    
     return success;
 }
 
@@ -935,6 +2200,46 @@ NSString *kStatusKey = @"status";
 // Returns: YES for success and NO for failure
 //
 - (BOOL) scheduleClip:(AdInfo *)ad atTime:(LinearTime *)linearTime forType:(PlaylistEntryType)type andGetClipId:(int32_t *)clipId
+{
+    __block BOOL success = NO;
+    
+    [self performOnEngineQueueAndWait:^{
+        success = [self doScheduleClip:ad atTime:linearTime forType:type andGetClipId:clipId];
+    }];
+    
+    return success;
+}
+
+//
+// schedule an ad clip in the framework asynchronously
+//
+// Arguments:
+// [ad]: The ad clip to be scheduled
+// [linearTime]: The time when the ad should be played in the linear timeline. Note that this is an upper bound if content duration is not specified.
+// [type]: The type of the ad
+// [completion]: The completion handler called on the main thread with the clipId of the scheduled clip, can be nil
+//
+// Returns: none
+//
+- (void) scheduleClip:(AdInfo *)ad atTime:(LinearTime *)linearTime forType:(PlaylistEntryType)type completion:(SequencerCompletionHandler)completion
+{
+    [self performOnEngineQueue:^BOOL(int32_t *clipId) {
+        return [self doScheduleClip:ad atTime:linearTime forType:type andGetClipId:clipId];
+    } completion:completion];
+}
+
+//
+// schedule an ad clip in the framework on the engine queue
+//
+// Arguments:
+// [ad]: The ad clip to be scheduled
+// [linearTime]: The time when the ad should be played in the linear timeline
+// [type]: The type of the ad
+// [clipId]: The output clipId for the scheduled clip
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) doScheduleClip:(AdInfo *)ad atTime:(LinearTime *)linearTime forType:(PlaylistEntryType)type andGetClipId:(int32_t *)clipId
 {
     BOOL success = NO;
     
@@ -999,17 +2304,57 @@ NSString *kStatusKey = @"status";
 }
 
 //
-// schedule ad or ad pod based on the VAST manifest provided
+// schedule ad or ad pod based on the VAST manifest provided
+//
+// Arguments:
+// [ad] The ad clip to be scheduled (with URL and media time missing and to be filled from the VAST manifest)
+// [vastManifest]: The VAST manifest
+// [linearTime]: The time when the ad should be played in the linear timeline
+// [clipId]: The output clipId for the scheduled clip. In case of an ad pod, this is the entryId for the first clip.
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) scheduleVASTClip:(AdInfo *)ad withManifest:(NSString *)vastManifest atTime:(LinearTime *)linearTime andGetClipId:(int32_t *)clipId
+{
+    __block BOOL success = NO;
+    
+    [self performOnEngineQueueAndWait:^{
+        success = [self doScheduleVASTClip:ad withManifest:vastManifest atTime:linearTime andGetClipId:clipId];
+    }];
+    
+    return success;
+}
+
+//
+// schedule ad or ad pod based on the VAST manifest provided asynchronously
 //
 // Arguments:
 // [ad] The ad clip to be scheduled (with URL and media time missing and to be filled from the VAST manifest)
 // [vastManifest]: The VAST manifest
 // [linearTime]: The time when the ad should be played in the linear timeline
-// [clipId]: The output clipId for the scheduled clip. In case of an ad pod, this is the entryId for the first clip.
+// [completion]: The completion handler called on the main thread with the clipId of the scheduled clip, can be nil
+//
+// Returns: none
+//
+- (void) scheduleVASTClip:(AdInfo *)ad withManifest:(NSString *)vastManifest atTime:(LinearTime *)linearTime completion:(SequencerCompletionHandler)completion
+{
+    [self performOnEngineQueue:^BOOL(int32_t *clipId) {
+        return [self doScheduleVASTClip:ad withManifest:vastManifest atTime:linearTime andGetClipId:clipId];
+    } completion:completion];
+}
+
+//
+// schedule ad or ad pod based on the VAST manifest provided on the engine queue
+//
+// Arguments:
+// [ad] The ad clip to be scheduled
+// [vastManifest]: The VAST manifest
+// [linearTime]: The time when the ad should be played in the linear timeline
+// [clipId]: The output clipId for the scheduled clip
 //
 // Returns: YES for success and NO for failure
 //
-- (BOOL) scheduleVASTClip:(AdInfo *)ad withManifest:(NSString *)vastManifest atTime:(LinearTime *)linearTime andGetClipId:(int32_t *)clipId
+- (BOOL) doScheduleVASTClip:(AdInfo *)ad withManifest:(NSString *)vastManifest atTime:(LinearTime *)linearTime andGetClipId:(int32_t *)clipId
 {
     BOOL success = NO;
     NSMutableArray *adPodArray = nil;
@@ -1052,7 +2397,9 @@ NSString *kStatusKey = @"status";
 }
 
 //
-// schedule ad list based on VMAP manifest
+// schedule ad list based on VMAP manifest. If resolvesAdBreaksLazily is set, the midroll ad breaks
+// with a VASTAdTagURI ad source are only downloaded and scheduled when the playback comes within
+// adBreakLookahead seconds of them, or a seek lands near them.
 //
 // Arguments:
 // [vmapManifest]: The VMAP manifest
@@ -1060,6 +2407,42 @@ NSString *kStatusKey = @"status";
 // Returns: YES for success and NO for failure
 //
 - (BOOL) scheduleVMAPWithManifest:(NSString *)vmapManifest
+{
+    __block BOOL success = NO;
+    
+    [self performOnEngineQueueAndWait:^{
+        success = [self doScheduleVMAPWithManifest:vmapManifest];
+    }];
+    
+    return success;
+}
+
+//
+// schedule ad list based on VMAP manifest asynchronously. The ad manifests referenced
+// by the VMAP manifest are downloaded on the engine queue.
+//
+// Arguments:
+// [vmapManifest]: The VMAP manifest
+// [completion]: The completion handler called on the main thread, can be nil
+//
+// Returns: none
+//
+- (void) scheduleVMAPWithManifest:(NSString *)vmapManifest completion:(SequencerCompletionHandler)completion
+{
+    [self performOnEngineQueue:^BOOL(int32_t *clipId) {
+        return [self doScheduleVMAPWithManifest:vmapManifest];
+    } completion:completion];
+}
+
+//
+// schedule ad list based on VMAP manifest on the engine queue
+//
+// Arguments:
+// [vmapManifest]: The VMAP manifest
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) doScheduleVMAPWithManifest:(NSString *)vmapManifest
 {
     BOOL success = NO;
     
@@ -1165,8 +2548,26 @@ NSString *kStatusKey = @"status";
                             break;
                             
                         case AdTagURI:
+                            if (resolvesAdBreaksLazily && 0 < adBreak.timeOffset)
+                            {
+                                // Only a placeholder is kept for a midroll, the vast manifest is downloaded
+                                // when the playback comes within the lookahead of the ad break
+                                NSURL *adTagURL = [NSURL URLWithString:adSource.value];
+                                if (nil == adTagURL)
+                                {
+                                    FRAMEWORK_LOG(@"Invalid ad tag url:%@", adSource.value);
+                                    success = NO;
+                                    break;
+                                }
+                                
+                                LazyAdBreak *lazyAdBreak = [[LazyAdBreak alloc] initWithTimeOffset:adBreak.timeOffset adTagURL:adTagURL];
+                                [lazyAdBreaks addObject:lazyAdBreak];
+                                [lazyAdBreak release];
+                                break;
+                            }
+                            
                             // Download the vast manifest, has to be a blocking call
-                            success = [self.adResolver downloadManifest:&manifest withURL:[NSURL URLWithString:adSource.value]];
+                            success = [self downloadManifest:&manifest withURL:[NSURL URLWithString:adSource.value]];
                             if (!success)
                             {
                                 FRAMEWORK_LOG(@"Failed to download the manifest with url:%@", adSource.value);
@@ -1262,6 +2663,9 @@ NSString *kStatusKey = @"status";
 
         // Ignore error when release the entry
         [self.adResolver releaseEntry:vmapEntryId];
+        
+        // Resolve the lazy ad breaks which are already within the lookahead
+        [self updateLazyAdBreaksAtLinearTime:lazyAdBreakLinearTime];
     }
     while (NO);
 
@@ -1293,11 +2697,16 @@ NSString *kStatusKey = @"status";
         
         if (success)
         {
-            success = [sequencer.scheduler cancelClip:clipId];
-            if (!success)
-            {
-                self.lastError = sequencer.scheduler.lastError;
-            }
+            // The clip may have been scheduled by an asynchronous method
+            __block BOOL cancelled = NO;
+            [self performOnEngineQueueAndWait:^{
+                cancelled = [sequencer.scheduler cancelClip:clipId];
+                if (!cancelled)
+                {
+                    self.lastError = sequencer.scheduler.lastError;
+                }
+            }];
+            success = cancelled;
         }
         else
         {
@@ -1319,6 +2728,45 @@ NSString *kStatusKey = @"status";
 // Returns: YES for success and NO for failure
 //
 - (BOOL) appendContentClip:(NSURL *)clipURL withMediaTime:(MediaTime *)mediaTime andGetClipId:(int32_t *)clipId
+{
+    __block BOOL success = NO;
+    
+    [self performOnEngineQueueAndWait:^{
+        success = [self doAppendContentClip:clipURL withMediaTime:mediaTime andGetClipId:clipId];
+    }];
+    
+    return success;
+}
+
+//
+// append main content to the playlist in the framework asynchronously. The playlist is
+// downloaded on the engine queue if the clip duration is unknown.
+//
+// Arguments:
+// [clipURL]: The URL of the clip to be appended
+// [mediaTime]: The minimum and maximum rendering time in the media time. Set mediaTime.clipEndMediaTime to negative if the clip duration is unknown.
+// [completion]: The completion handler called on the main thread with the clipId of the appended content, can be nil
+//
+// Returns: none
+//
+- (void) appendContentClip:(NSURL *)clipURL withMediaTime:(MediaTime *)mediaTime completion:(SequencerCompletionHandler)completion
+{
+    [self performOnEngineQueue:^BOOL(int32_t *clipId) {
+        return [self doAppendContentClip:clipURL withMediaTime:mediaTime andGetClipId:clipId];
+    } completion:completion];
+}
+
+//
+// append main content to the playlist in the framework on the engine queue
+//
+// Arguments:
+// [clipURL]: The URL of the clip to be appended
+// [mediaTime]: The minimum and maximum rendering time in the media time
+// [clipId]: The output clipId for the content that is appended
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) doAppendContentClip:(NSURL *)clipURL withMediaTime:(MediaTime *)mediaTime andGetClipId:(int32_t *)clipId
 {
     BOOL success = NO;
     
@@ -1364,6 +2812,352 @@ NSString *kStatusKey = @"status";
     return success;
 }
 
+//
+// append a set of main content clips to the playlist in the framework. The playlists of the clips
+// with an unknown duration are downloaded concurrently and the clips are appended in order with
+// a single scheduler call. Nothing is appended if any of the playlists fails to download before
+// the deadline.
+//
+// Arguments:
+// [clipURLs]: The URLs of the clips to be appended, in playback order
+// [mediaTimes]: The MediaTime objects for the clips, in the same order as clipURLs. Set clipEndMediaTime to negative if the clip duration is unknown.
+// [deadline]: The time in seconds from now all the playlists have to be downloaded in, 0 for none
+// [results]: The output array a ContentClipProbeResult is added to for each clip, in the order of the clips
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) appendContentClips:(NSArray *)clipURLs withMediaTimes:(NSArray *)mediaTimes deadline:(NSTimeInterval)deadline andGetResults:(NSMutableArray *)results
+{
+    __block BOOL success = NO;
+    
+    [self performOnEngineQueueAndWait:^{
+        success = [self doAppendContentClips:clipURLs withMediaTimes:mediaTimes deadline:deadline andGetResults:results];
+    }];
+    
+    return success;
+}
+
+//
+// append a set of main content clips to the playlist in the framework asynchronously
+//
+// Arguments:
+// [clipURLs]: The URLs of the clips to be appended, in playback order
+// [mediaTimes]: The MediaTime objects for the clips, in the same order as clipURLs. Set clipEndMediaTime to negative if the clip duration is unknown.
+// [deadline]: The time in seconds from now all the playlists have to be downloaded in, 0 for none
+// [completion]: The completion handler called on the main thread with the results of the clips, can be nil
+//
+// Returns: none
+//
+- (void) appendContentClips:(NSArray *)clipURLs withMediaTimes:(NSArray *)mediaTimes deadline:(NSTimeInterval)deadline completion:(ContentClipsCompletionHandler)completion
+{
+    OSAtomicIncrement32Barrier(&queuedOperationCount);
+    dispatch_async(engineQueue, ^{
+        NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+        
+        NSMutableArray *results = [[NSMutableArray alloc] initWithCapacity:[clipURLs count]];
+        BOOL success = [self doAppendContentClips:clipURLs withMediaTimes:mediaTimes deadline:deadline andGetResults:results];
+        NSError *error = success ? nil : self.lastError;
+        OSAtomicDecrement32Barrier(&queuedOperationCount);
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            if (nil != completion)
+            {
+                completion(success, results, error);
+            }
+            [results release];
+        });
+        
+        [pool release];
+    });
+}
+
+//
+// append a set of main content clips to the playlist in the framework on the engine queue
+//
+// Arguments:
+// [clipURLs]: The URLs of the clips to be appended
+// [mediaTimes]: The MediaTime objects for the clips
+// [deadline]: The time in seconds from now all the playlists have to be downloaded in, 0 for none
+// [results]: The output array the ContentClipProbeResult objects are added to
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) doAppendContentClips:(NSArray *)clipURLs withMediaTimes:(NSArray *)mediaTimes deadline:(NSTimeInterval)deadline andGetResults:(NSMutableArray *)results
+{
+    assert ([clipURLs count] == [mediaTimes count]);
+    BOOL success = NO;
+    NSUInteger count = [clipURLs count];
+    
+    if (nil == sequencer || nil == sequencer.scheduler)
+    {
+        [self setNULLSequencerSchedulerError];
+        return NO;
+    }
+    
+    ContentClipProbe *probes = (ContentClipProbe *)calloc(count, sizeof(ContentClipProbe));
+    NSMutableArray *clipIds = [[NSMutableArray alloc] initWithCapacity:count];
+    CFAbsoluteTime absoluteDeadline = (0 < deadline) ? CFAbsoluteTimeGetCurrent() + deadline : 0;
+    dispatch_group_t group = dispatch_group_create();
+    NSUInteger liveIndex = count;
+    
+    // The duration of the content is unknown. Download the playlists of all the clips at the same time,
+    // each probe only writes its own entry.
+    for (NSUInteger i = 0; i < count; ++i)
+    {
+        if (((MediaTime *)[mediaTimes objectAtIndex:i]).clipEndMediaTime < 0)
+        {
+            ContentClipProbe *probe = &probes[i];
+            NSURL *clipURL = (NSURL *)[clipURLs objectAtIndex:i];
+            probe->isProbed = YES;
+            
+            dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+                
+                CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+                HLSPlaylist *playlist = nil;
+                NSError *error = nil;
+                
+                if ([self getHLSPlaylist:&playlist manifest:&probe->manifest playlistURL:&probe->playlistURL fromURL:clipURL deadline:absoluteDeadline error:&error])
+                {
+                    probe->duration = playlist.totalDuration;
+                    probe->isLive = !playlist.hasEndList;
+                    [playlist release];
+                }
+                else
+                {
+                    probe->error = [error retain];
+                }
+                probe->probeTime = CFAbsoluteTimeGetCurrent() - startTime;
+                
+                [pool release];
+            });
+        }
+    }
+    dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+    dispatch_release(group);
+    
+    do
+    {
+        NSError *probeError = nil;
+        for (NSUInteger i = 0; i < count && nil == probeError; ++i)
+        {
+            probeError = probes[i].error;
+        }
+        
+        if (nil != probeError)
+        {
+            self.lastError = probeError;
+            break;
+        }
+        
+        for (NSUInteger i = 0; i < count; ++i)
+        {
+            if (probes[i].isProbed)
+            {
+                MediaTime *mediaTime = (MediaTime *)[mediaTimes objectAtIndex:i];
+                isLive = probes[i].isLive;
+                
+                if (isLive)
+                {
+                    mediaTime.clipEndMediaTime = LIVE_END;
+                    liveIndex = i;
+                }
+                else
+                {
+                    mediaTime.clipEndMediaTime = probes[i].duration;
+                }
+            }
+        }
+        
+        success = [sequencer.scheduler appendContentClips:clipURLs withMediaTimes:mediaTimes andGetClipIds:clipIds];
+        if (!success)
+        {
+            self.lastError = sequencer.scheduler.lastError;
+            break;
+        }
+        
+        if (liveIndex < count)
+        {
+            // Later refreshes only process the segments which left and joined the DVR window
+            [self startLivePlaylistTrackingWithURL:probes[liveIndex].playlistURL manifest:probes[liveIndex].manifest];
+        }
+    } while (NO);
+    
+    for (NSUInteger i = 0; i < count; ++i)
+    {
+        ContentClipProbeResult *result = [[ContentClipProbeResult alloc] initWithClipURL:(NSURL *)[clipURLs objectAtIndex:i]
+                                                                                  clipId:(success ? [[clipIds objectAtIndex:i] intValue] : 0)
+                                                                                duration:probes[i].duration
+                                                                                  isLive:probes[i].isLive
+                                                                                isProbed:probes[i].isProbed
+                                                                               probeTime:probes[i].probeTime
+                                                                                   error:probes[i].error];
+        [results addObject:result];
+        [result release];
+        
+        [probes[i].playlistURL release];
+        [probes[i].manifest release];
+        [probes[i].error release];
+    }
+    
+    [clipIds release];
+    free(probes);
+    
+    return success;
+}
+
+//
+// Return the player of a view to the player pool
+//
+// Arguments:
+// [playerLayerView]: the view
+//
+// Returns: none.
+//
+- (void) releasePlayerOfView:(AVPlayerLayerView *)playerLayerView
+{
+    AVPlayer *viewPlayer = [playerLayerView.player retain];
+    
+    if (nil != viewPlayer)
+    {
+        playerLayerView.player = nil;
+        [playerPool relinquishPlayer:viewPlayer];
+        [viewPlayer release];
+    }
+}
+
+//
+// Load a Url into a view with a player from the player pool
+//
+// Arguments:
+// [playerLayerView]: the view
+// [url]: the Url to load
+//
+// Returns: none.
+//
+- (void) loadView:(AVPlayerLayerView *)playerLayerView withURL:(NSURL *)url
+{
+    [self releasePlayerOfView:playerLayerView];
+    
+    AVPlayer *preloadedPlayer = [playerPool takePreloadedPlayerForURL:url];
+    if (nil != preloadedPlayer)
+    {
+        FRAMEWORK_LOG(@"Using the preloaded player for %@", url);
+        playerLayerView.player = preloadedPlayer;
+        loadStartTime = 0;
+    }
+    else
+    {
+        playerLayerView.player = [playerPool acquirePlayerWithURL:url];
+        loadStartTime = CFAbsoluteTimeGetCurrent();
+    }
+}
+
+//
+// Look ahead of the segment which just started. The lead time to preload the next segment is
+// chosen from the load latency of its host, and the segments after it start loading in players
+// of the pool when they are so short that they would be due before their own lead time.
+//
+// Arguments: none.
+//
+// Returns: none.
+//
+- (void) preloadUpcomingSegments
+{
+    __block NSArray *upcomingSegments = nil;
+    __block BOOL found = NO;
+    NSMutableArray *preloadURLs = [NSMutableArray array];
+    NSURL *pausedURL = nil;
+    
+    preloadLeadTime = preloadEstimator.minimumLeadTime;
+    
+    [self performOnEngineQueueAndWait:^{
+        found = [sequencer getUpcomingSegments:&upcomingSegments withCurrentSegment:currentSegment currentPlaybackRate:rate count:(int32_t)(1 + upcomingPreloadCount)];
+        if (!found)
+        {
+            FRAMEWORK_LOG(@"Failed to look ahead of the current segment: %@", sequencer.lastError);
+        }
+        [upcomingSegments retain];
+    }];
+    [upcomingSegments autorelease];
+    if (!found)
+    {
+        return;
+    }
+    
+    // The main content paused for an ad resumes in its own player
+    for (AVPlayerLayerView *playerLayerView in avPlayerViews)
+    {
+        if (ViewStatus_Paused == playerLayerView.status && [playerLayerView.player.currentItem.asset isKindOfClass:[AVURLAsset class]])
+        {
+            pausedURL = ((AVURLAsset *)playerLayerView.player.currentItem.asset).URL;
+        }
+    }
+    
+    // The time until each upcoming segment is due, assuming it plays from the start
+    NSTimeInterval timeUntilDue = currentSegment.clip.mediaTime.clipEndMediaTime - currentSegment.initialPlaybackTime;
+    for (NSUInteger i = 0; i < [upcomingSegments count]; ++i)
+    {
+        PlaybackSegment *segment = [upcomingSegments objectAtIndex:i];
+        
+        // The URL and duration of the segments after a VAST or SeekToStart entry are not known
+        if (PlaylistEntryType_VAST == segment.clip.type || PlaylistEntryType_SeekToStart == segment.clip.type)
+        {
+            break;
+        }
+        
+        NSTimeInterval leadTime = [preloadEstimator leadTimeForURL:segment.clip.clipURI];
+        if (0 == i)
+        {
+            // The next segment is preloaded by preloadContent
+            preloadLeadTime = leadTime;
+        }
+        else if (timeUntilDue < leadTime && nil != segment.clip.clipURI && ![segment.clip.clipURI isEqual:pausedURL])
+        {
+            [preloadURLs addObject:segment.clip.clipURI];
+        }
+        
+        timeUntilDue += segment.clip.mediaTime.clipEndMediaTime - segment.clip.mediaTime.clipBeginMediaTime;
+    }
+    
+    [playerPool preloadURLs:preloadURLs];
+}
+
+//
+// Find an idle view for the next segment. A view is added when all the views are in use
+// so the transition can still happen.
+//
+// Arguments: none.
+//
+// Returns: the idle view.
+//
+- (AVPlayerLayerView *) idlePlayerLayerView
+{
+    for (AVPlayerLayerView *playerLayerView in avPlayerViews)
+    {
+        if (ViewStatus_Idle == playerLayerView.status)
+        {
+            return playerLayerView;
+        }
+    }
+    
+    AVPlayerLayerView *firstView = [avPlayerViews objectAtIndex:0];
+    FRAMEWORK_LOG(@"All %u player views are in use, adding a view", (unsigned int)[avPlayerViews count]);
+    
+    AVPlayerLayerView *playerLayerView = [[AVPlayerLayerView alloc] initWithFrame:firstView.frame];
+    [firstView.superview addSubview:playerLayerView];
+    
+    playerLayerView.playerLayer.hidden = YES;
+    playerLayerView.player = nil;
+    playerLayerView.status = ViewStatus_Idle;
+    
+    [avPlayerViews addObject:playerLayerView];
+    
+    [playerLayerView release];
+    
+    return playerLayerView;
+}
+
 //
 // Initialize the moviePlayer instance with a Url to be played.
 //
@@ -1386,36 +3180,25 @@ NSString *kStatusKey = @"status";
             AVPlayerLayerView *playerLayerView = [avPlayerViews objectAtIndex:nextSegment.viewIndex];
             playerLayerView.status = ViewStatus_Idle;
             nextSegment.status = PlayerStatus_Waiting;
-            playerLayerView.player = [AVPlayer playerWithURL:theUrl];
+            [self loadView:playerLayerView withURL:theUrl];
         }
         else
         {
             // This is either an ad pod or transition from main to ad.
             // We need to start a new ad player.
             // Pick an idle view from the list, but avoid the main view that has been paused
-            BOOL foundIdleView = NO;
-            for (AVPlayerLayerView *playerLayerView in avPlayerViews)
+            AVPlayerLayerView *playerLayerView = [self idlePlayerLayerView];
+            nextSegment.viewIndex = [avPlayerViews indexOfObject:playerLayerView];
+            [self loadView:playerLayerView withURL:theUrl];
+            
+            if (PlayerStatus_Stopped == nextSegment.status)
+            {
+                nextSegment.status = PlayerStatus_Loading;
+            }
+            else
             {
-                if (ViewStatus_Idle == playerLayerView.status)
-                {
-                    nextSegment.viewIndex = [avPlayerViews indexOfObject:playerLayerView];
-                    playerLayerView.player = [AVPlayer playerWithURL:theUrl];
-                    
-                    if (PlayerStatus_Stopped == nextSegment.status)
-                    {
-                        nextSegment.status = PlayerStatus_Loading;
-                    }
-                    else
-                    {
-                        nextSegment.status = PlayerStatus_Waiting;
-                    }
-                    
-                    foundIdleView = YES;
-                    break;
-                }
+                nextSegment.status = PlayerStatus_Waiting;
             }
-            
-            assert(foundIdleView);
         }
     }
     else
@@ -1426,29 +3209,23 @@ NSString *kStatusKey = @"status";
             // Delay the resumption until the view switches
             // One exception is for preroll ad we need to create the player for the main content
             // Also pauseTimeLine false ad requires a seek
-            BOOL foundMainView = NO;
             AVPlayerLayerView *mainView = nil;
             for (AVPlayerLayerView *playerLayerView in avPlayerViews)
             {
                 if (ViewStatus_Paused == playerLayerView.status)
                 {
                     mainView = playerLayerView;
-                    foundMainView = YES;
                     break;
                 }
-                else if (ViewStatus_Idle == playerLayerView.status)
-                {
-                    mainView = playerLayerView;
-                }
             }
             
-            nextSegment.viewIndex = [avPlayerViews indexOfObject:mainView];
-            if (!foundMainView)
+            if (nil == mainView)
             {
                 // either preroll ad ends, or seeking into a different main clip. In either case
                 // we need to create the main player. Note that the player may not be preloaded.
-                mainView.status = ViewStatus_Idle;
-                mainView.player = [AVPlayer playerWithURL:theUrl];
+                mainView = [self idlePlayerLayerView];
+                nextSegment.viewIndex = [avPlayerViews indexOfObject:mainView];
+                [self loadView:mainView withURL:theUrl];
                 if (PlayerStatus_Stopped == nextSegment.status)
                 {
                     nextSegment.status = PlayerStatus_Loading;
@@ -1456,11 +3233,12 @@ NSString *kStatusKey = @"status";
             }
             else
             {
+                nextSegment.viewIndex = [avPlayerViews indexOfObject:mainView];
+                
                 // for pause timeline false ad we need to do a seek here
                 if (currentSegment.clip.linearTime.duration > 0)
                 {
-                    AVPlayerLayerView *nextView = [avPlayerViews objectAtIndex:nextSegment.viewIndex];
-                    AVPlayer *moviePlayer = nextView.player;
+                    AVPlayer *moviePlayer = mainView.player;
 
                     NSTimeInterval resumeTime = nextSegment.initialPlaybackTime;
                     CMTime targetTime = CMTimeMakeWithSeconds(resumeTime, NSEC_PER_SEC);
@@ -1478,7 +3256,7 @@ NSString *kStatusKey = @"status";
             {
                 // This is the first playback
                 AVPlayerLayerView *playerLayerView = [avPlayerViews objectAtIndex:nextSegment.viewIndex];
-                playerLayerView.player =[AVPlayer playerWithURL:theUrl];
+                [self loadView:playerLayerView withURL:theUrl];
                 playerLayerView.status = ViewStatus_Idle;
                 nextSegment.status = PlayerStatus_Waiting;
             }
@@ -1487,28 +3265,17 @@ NSString *kStatusKey = @"status";
                 // This is an RCE. Start another main content.
                 // We need to switch between the two players.
                 // Pick an idle view from the list
-                BOOL foundIdleView = NO;
-                for (AVPlayerLayerView *playerLayerView in avPlayerViews)
+                AVPlayerLayerView *playerLayerView = [self idlePlayerLayerView];
+                nextSegment.viewIndex = [avPlayerViews indexOfObject:playerLayerView];
+                [self loadView:playerLayerView withURL:theUrl];
+                if (PlayerStatus_Stopped == nextSegment.status)
                 {
-                    if (ViewStatus_Idle == playerLayerView.status)
-                    {
-                        nextSegment.viewIndex = [avPlayerViews indexOfObject:playerLayerView];
-                        playerLayerView.player = [AVPlayer playerWithURL:theUrl];
-                        if (PlayerStatus_Stopped == nextSegment.status)
-                        {
-                            nextSegment.status = PlayerStatus_Loading;
-                        }
-                        else
-                        {
-                            nextSegment.status = PlayerStatus_Waiting;
-                        }
-                        
-                        foundIdleView = YES;
-                        break;
-                    }
+                    nextSegment.status = PlayerStatus_Loading;
+                }
+                else
+                {
+                    nextSegment.status = PlayerStatus_Waiting;
                 }
-                
-                assert(foundIdleView);
             }
         }
     }
@@ -1574,6 +3341,15 @@ NSString *kStatusKey = @"status";
                   forKeyPath:kStatusKey
                      options:0
                      context:nil];
+    
+    // The item of a preloaded player can be ready or failed before it is observed
+    AVPlayerItem *playerItem = moviePlayer.currentItem;
+    if (AVPlayerItemStatusUnknown != playerItem.status)
+    {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self observeValueForKeyPath:kStatusKey ofObject:playerItem change:nil context:nil];
+        });
+    }
 }
 
 //
@@ -1640,7 +3416,7 @@ NSString *kStatusKey = @"status";
         }
         else
         {
-            viewToHide.player = nil;
+            [self releasePlayerOfView:viewToHide];
             viewToHide.status = ViewStatus_Idle;
         }
     }
@@ -1651,6 +3427,14 @@ NSString *kStatusKey = @"status";
 
     viewToShow.status = ViewStatus_Active;    
     currentSegment.status = PlayerStatus_Playing;
+    if (playbackShouldStart)
+    {
+        [self preloadUpcomingSegments];
+    }
+    [self armBoundaryObserversWithPlayer:moviePlayer];
+    
+    // Replace the idle player taken by this transition for the next one
+    [playerPool warmUp];
     
     if (!playbackShouldStart)
     {
@@ -1671,6 +3455,7 @@ NSString *kStatusKey = @"status";
 {
     FRAMEWORK_LOG(@"Inside playback finished notification callback...");
     
+    [self markTransitionPoint:TransitionPoint_EndOfMedia];
     [self contentFinished:NO];
 }
 
@@ -1707,10 +3492,17 @@ NSString *kStatusKey = @"status";
                 {
                     FRAMEWORK_LOG(@"Status update: AVPlayerItemStatusReadyToPlay");
                     FRAMEWORK_LOG(@"Clip change rebuffering: clip url: %@\n is ready to play", nextSegment.clip.clipURI);
+                    [self markTransitionPoint:TransitionPoint_PlayerReady];
 
                     // Seek the player to the correct start position
                     AVPlayerLayerView *nextView = [avPlayerViews objectAtIndex:nextSegment.viewIndex];
                     AVPlayer *moviePlayer = nextView.player;
+                    [playerPool setState:PlayerPoolState_Ready forPlayer:moviePlayer];
+                    if (0 < loadStartTime)
+                    {
+                        [preloadEstimator addLoadLatency:(CFAbsoluteTimeGetCurrent() - loadStartTime) forURL:nextSegment.clip.clipURI];
+                        loadStartTime = 0;
+                    }
                     
                     NSTimeInterval seconds = nextSegment.initialPlaybackTime;
                     if (0 != seconds)
@@ -1744,6 +3536,7 @@ NSString *kStatusKey = @"status";
                 {
                     FRAMEWORK_LOG(@"Status update: AVPlayerItemStatusFailed");
                     
+                    [playerPool setState:PlayerPoolState_Failed forPlayer:moviePlayer];
                     self.lastError = nextItem.error;
                     [self sendErrorNotification];
                     nextSegment.error = (nil != nextItem.error.localizedFailureReason) ? nextItem.error.localizedFailureReason : nextItem.error.localizedDescription;
@@ -1791,6 +3584,7 @@ NSString *kStatusKey = @"status";
                 {
                     FRAMEWORK_LOG(@"Status update: AVPlayerItemStatusFailed");
 
+                    [playerPool setState:PlayerPoolState_Failed forPlayer:currentMoviePlayer];
                     self.lastError = currentItem.error;
                     [self sendErrorNotification];
                     currentSegment.error = (nil != currentItem.error.localizedFailureReason) ? currentItem.error.localizedFailureReason : currentItem.error.localizedDescription;
@@ -1829,25 +3623,39 @@ NSString *kStatusKey = @"status";
         return YES;
     }
     
+    [self markTransitionPoint:TransitionPoint_ContentFinished];
+    
     do {
         if (!isSeeking)
         {
-            PlaybackSegment *segment = nil;
-            if (nil != currentSegment.error)
-            {
-                success = [sequencer getSegmentOnError:&segment withCurrentSegment:currentSegment mediaTime:currentPlaylistEntryPosition currentPlaybackRate:rate error:currentSegment.error isNotPlayed:NO isEndOfSequence:NO];
-            }
-            else
-            {
-                success = [sequencer getSegmentOnEndOfMedia:&segment withCurrentSegment:currentSegment mediaTime:currentPlaylistEntryPosition currentPlaybackRate:rate isNotPlayed:NO isEndOfSequence:NO];
-            }
+            __block PlaybackSegment *segment = nil;
+            __block BOOL found = NO;
+            [self performOnEngineQueueAndWait:^{
+                if (nil != currentSegment.error)
+                {
+                    found = [sequencer getSegmentOnError:&segment withCurrentSegment:currentSegment mediaTime:currentPlaylistEntryPosition currentPlaybackRate:rate error:currentSegment.error isNotPlayed:NO isEndOfSequence:NO];
+                }
+                else
+                {
+                    found = [sequencer getSegmentOnEndOfMedia:&segment withCurrentSegment:currentSegment mediaTime:currentPlaylistEntryPosition currentPlaybackRate:rate isNotPlayed:NO isEndOfSequence:NO];
+                }
+                if (!found)
+                {
+                    self.lastError = sequencer.lastError;
+                }
+            }];
+            success = found;
             if (!success)
             {
-                self.lastError = sequencer.lastError;
                 break;
             }
-            if (nil == nextSegment ||
-                (nextSegment.clip.entryId != segment.clip.entryId && PlaylistEntryType_VAST != segment.clip.type))
+            BOOL isPreloadMiss = (nil == nextSegment ||
+                                  (nextSegment.clip.entryId != segment.clip.entryId && PlaylistEntryType_VAST != segment.clip.type));
+            if (nil != segment)
+            {
+                [transitionMetrics countPreload:!isPreloadMiss];
+            }
+            if (isPreloadMiss)
             {
                 // Before releasing the preloaded segment
                 // we need to make sure that we remove observations and clear the state
@@ -1916,7 +3724,7 @@ NSString *kStatusKey = @"status";
 - (void) preloadContent
 {
     NSString *nextURL = nil;
-    PlaybackSegment *segment = nil;
+    __block PlaybackSegment *segment = nil;
     AVPlayerLayerView *playerLayerView = [avPlayerViews objectAtIndex:currentSegment.viewIndex];
     AVPlayer *moviePlayer = playerLayerView.player;
     
@@ -1925,27 +3733,31 @@ NSString *kStatusKey = @"status";
     
     do
     {
-        if (![sequencer getSegmentOnEndOfBuffering:&segment withCurrentSegment:currentSegment mediaTime:currTime currentPlaybackRate:rate])
-        {
-            self.lastError = sequencer.lastError;
-            [self sendErrorNotification];
-            break;
-        }
-        
-        if (PlaylistEntryType_SeekToStart == segment.clip.type)
-        {
-            FRAMEWORK_LOG(@"Clip change prebuffering: SeekToStart detected");
-            
-            // Try to get the next segment
-            PlaybackSegment *newSegment = nil;
-            if (![sequencer getSegmentOnEndOfBuffering:&newSegment withCurrentSegment:segment mediaTime:currTime currentPlaybackRate:rate])
+        __block BOOL found = NO;
+        [self performOnEngineQueueAndWait:^{
+            found = [sequencer getSegmentOnEndOfBuffering:&segment withCurrentSegment:currentSegment mediaTime:currTime currentPlaybackRate:rate];
+            if (found && PlaylistEntryType_SeekToStart == segment.clip.type)
+            {
+                FRAMEWORK_LOG(@"Clip change prebuffering: SeekToStart detected");
+                
+                // Try to get the next segment
+                PlaybackSegment *newSegment = nil;
+                found = [sequencer getSegmentOnEndOfBuffering:&newSegment withCurrentSegment:segment mediaTime:currTime currentPlaybackRate:rate];
+                if (found)
+                {
+                    [segment release];
+                    segment = newSegment;
+                }
+            }
+            if (!found)
             {
                 self.lastError = sequencer.lastError;
-                [self sendErrorNotification];
-                break;
             }
-            [segment release];
-            segment = newSegment;
+        }];
+        if (!found)
+        {
+            [self sendErrorNotification];
+            break;
         }
         
         if (PlaylistEntryType_VAST == segment.clip.type)
@@ -1986,6 +3798,7 @@ NSString *kStatusKey = @"status";
 - (void) showView:(AVPlayerLayerView *)viewToShow
 {
     viewToShow.playerLayer.hidden = NO;
+    [self markTransitionPoint:TransitionPoint_FirstFrameShown];
     
     /* Specifies that the player should preserve the video?s aspect ratio and
      fit the video within the layer?s bounds. */
@@ -2018,31 +3831,34 @@ NSString *kStatusKey = @"status";
 //
 - (BOOL) checkSeekToStart
 {
-    BOOL success = YES;
+    __block BOOL success = YES;
     
-    if (PlaylistEntryType_SeekToStart == nextSegment.clip.type)
-    {
-        FRAMEWORK_LOG(@"Clip change: SeekToStart detected");
-        
-        // Try to get the next segment
-        PlaybackSegment *segment = nil;
-        success = [sequencer getSegmentOnEndOfMedia:&segment withCurrentSegment:nextSegment mediaTime:0 currentPlaybackRate:rate isNotPlayed:NO isEndOfSequence:NO];
-        if (!success)
-        {
-            self.lastError = sequencer.lastError;
-        }
-        
-        if (nil == segment)
-        {
-            // nothing to play
-            FRAMEWORK_LOG(@"End of playback");
-        }
-        else
+    // The sequencer is called on the engine queue
+    [self performOnEngineQueueAndWait:^{
+        if (PlaylistEntryType_SeekToStart == nextSegment.clip.type)
         {
-            self.nextSegment = segment;
-            [segment release];
+            FRAMEWORK_LOG(@"Clip change: SeekToStart detected");
+            
+            // Try to get the next segment
+            PlaybackSegment *segment = nil;
+            success = [sequencer getSegmentOnEndOfMedia:&segment withCurrentSegment:nextSegment mediaTime:0 currentPlaybackRate:rate isNotPlayed:NO isEndOfSequence:NO];
+            if (!success)
+            {
+                self.lastError = sequencer.lastError;
+            }
+            
+            if (nil == segment)
+            {
+                // nothing to play
+                FRAMEWORK_LOG(@"End of playback");
+            }
+            else
+            {
+                self.nextSegment = segment;
+                [segment release];
+            }
         }
-    }
+    }];
     
     return success;
 }
@@ -2058,72 +3874,85 @@ NSString *kStatusKey = @"status";
 //
 - (BOOL) getSegmentFromVASTSegment:(PlaybackSegment **)segment whileBuffering:(BOOL)isBuffering
 {
-    BOOL success = YES;
-    NSMutableArray *adPodArray = nil;
-    NSString *vastURL = [(*segment).clip.clipURI absoluteString];
-    NSTimeInterval totalDuration = (*segment).clip.mediaTime.clipEndMediaTime - (*segment).clip.mediaTime.clipBeginMediaTime;
+    __block BOOL success = YES;
+    
+    // The ad pod is resolved and scheduled on the engine queue
+    [self performOnEngineQueueAndWait:^{
+        NSMutableArray *adPodArray = nil;
+        NSString *vastURL = [(*segment).clip.clipURI absoluteString];
+        NSTimeInterval totalDuration = (*segment).clip.mediaTime.clipEndMediaTime - (*segment).clip.mediaTime.clipBeginMediaTime;
 
-    do {
-        // Download the vast manifest, has to be a blocking call
-        NSString *manifest = nil;
-        success = [self.adResolver downloadManifest:&manifest withURL:[NSURL URLWithString:vastURL]];
+        do {
+            NSArray *prefetchedAdPod = [self takePrefetchedAdPodForEntry:(*segment).clip.entryId];
+            if (nil != prefetchedAdPod)
+            {
+                // The ad pod was resolved ahead of the transition, only the scheduling is left
+                adPodArray = [prefetchedAdPod mutableCopy];
+            }
+            else
+            {
+                // Download the vast manifest, has to be a blocking call
+                NSString *manifest = nil;
+                success = [self downloadManifest:&manifest withURL:[NSURL URLWithString:vastURL]];
+                if (!success)
+                {
+                    FRAMEWORK_LOG(@"Failed to download the manifest with url:%@", vastURL);
+                    self.lastError = self.adResolver.lastError;
+                    break;
+                }
+                
+                success = [self getAdInfos:&adPodArray fromVAST:manifest];
+                if (!success || nil == adPodArray || 0 == [adPodArray count])
+                {
+                    FRAMEWORK_LOG(@"Failed to parse the VAST manifest");
+                    break;
+                }
+            }
+            
+            AdInfo *baseAd = [[[AdInfo alloc] init] autorelease];
+            baseAd.type = AdType_Pod;
+            baseAd.appendTo = (*segment).clip.entryId;
+            baseAd.mediaTime = (*segment).clip.mediaTime;
+            baseAd.policy = (*segment).clip.playbackPolicy;
+            baseAd.clipURL = (*segment).clip.clipURI;
+            baseAd.deleteAfterPlayed = YES;
+            
+            success = [self scheduleAds:adPodArray withTotalDuration:(NSTimeInterval)totalDuration atTime:(*segment).clip.linearTime basedOnAd:baseAd andGetClipId:nil];
+            if (!success)
+            {
+                FRAMEWORK_LOG(@"Failed to schedule all the ads in ad pod specified in the VAST manifest");
+                break;
+            }
+        } while (NO);
+        [adPodArray removeAllObjects];
+        [adPodArray release];
+        
+        // if there is error scheduling the VAST ad, send error notification but moves on to the next segment anyway
         if (!success)
         {
-            FRAMEWORK_LOG(@"Failed to download the manifest with url:%@", vastURL);
-            self.lastError = self.adResolver.lastError;
-            break;
+            [self sendErrorNotification];
         }
-        
-        success = [self getAdInfos:&adPodArray fromVAST:manifest];
-        if (!success || nil == adPodArray || 0 == [adPodArray count])
+
+        // Try to get the next segment
+        PlaybackSegment *newSegment = nil;
+        if (isBuffering)
         {
-            FRAMEWORK_LOG(@"Failed to parse the VAST manifest");
-            break;
+            success = [sequencer getSegmentOnEndOfBuffering:&newSegment withCurrentSegment:(*segment) mediaTime:0 currentPlaybackRate:rate];
         }
-        
-        AdInfo *baseAd = [[[AdInfo alloc] init] autorelease];
-        baseAd.type = AdType_Pod;
-        baseAd.appendTo = (*segment).clip.entryId;
-        baseAd.mediaTime = (*segment).clip.mediaTime;
-        baseAd.policy = (*segment).clip.playbackPolicy;
-        baseAd.clipURL = (*segment).clip.clipURI;
-        baseAd.deleteAfterPlayed = YES;
-        
-        success = [self scheduleAds:adPodArray withTotalDuration:(NSTimeInterval)totalDuration atTime:(*segment).clip.linearTime basedOnAd:baseAd andGetClipId:nil];
+        else
+        {
+            success = [sequencer getSegmentOnEndOfMedia:&newSegment withCurrentSegment:(*segment) mediaTime:0 currentPlaybackRate:rate isNotPlayed:NO isEndOfSequence:NO];
+        }
+          
         if (!success)
         {
-            FRAMEWORK_LOG(@"Failed to schedule all the ads in ad pod specified in the VAST manifest");
-            break;
+            self.lastError = sequencer.lastError;
         }
-    } while (NO);
-    [adPodArray removeAllObjects];
-    [adPodArray release];
-    
-    // if there is error scheduling the VAST ad, send error notification but moves on to the next segment anyway
-    if (!success)
-    {
-        [self sendErrorNotification];
-    }
-
-    // Try to get the next segment
-    PlaybackSegment *newSegment = nil;
-    if (isBuffering)
-    {
-        success = [sequencer getSegmentOnEndOfBuffering:&newSegment withCurrentSegment:(*segment) mediaTime:0 currentPlaybackRate:rate];
-    }
-    else
-    {
-        success = [sequencer getSegmentOnEndOfMedia:&newSegment withCurrentSegment:(*segment) mediaTime:0 currentPlaybackRate:rate isNotPlayed:NO isEndOfSequence:NO];
-    }
-      
-    if (!success)
-    {
-        self.lastError = sequencer.lastError;
-    }
-    else
-    {
-        *segment = newSegment;
-    }
+        else
+        {
+            *segment = newSegment;
+        }
+    }];
     
     return success;
 }
@@ -2146,12 +3975,14 @@ NSString *kStatusKey = @"status";
 
 - (NSTimeInterval) currentLinearTime
 {
-    NSTimeInterval currentTime = 0;
+    __block NSTimeInterval currentTime = 0;
     MediaTime *mediaTime = [[MediaTime alloc] init];
     mediaTime.currentPlaybackPosition = self.currentPlaybackTime;
     if (nil != sequencer)
     {
-        [sequencer getLinearTime:&currentTime withMediaTime:(MediaTime *)mediaTime currentSegment:currentSegment];
+        [self performOnEngineQueueAndWait:^{
+            [sequencer getLinearTime:&currentTime withMediaTime:(MediaTime *)mediaTime currentSegment:currentSegment];
+        }];
     }
     [mediaTime release];
     
@@ -2163,6 +3994,69 @@ NSString *kStatusKey = @"status";
     return sequencer.adResolver;
 }
 
+- (NSTimeInterval) metricsNotificationInterval
+{
+    return metricsNotificationInterval;
+}
+
+- (NSUInteger) warmPlayerCount
+{
+    return playerPool.warmCount;
+}
+
+- (void) setWarmPlayerCount:(NSUInteger)value
+{
+    playerPool.warmCount = value;
+    [playerPool warmUp];
+}
+
+- (void) setMetricsNotificationInterval:(NSTimeInterval)value
+{
+    metricsNotificationInterval = value;
+    
+    if (metricsTimer)
+    {
+        [metricsTimer invalidate];
+        [metricsTimer release];
+        metricsTimer = nil;
+    }
+    
+    if (0 < metricsNotificationInterval)
+    {
+        metricsTimer = [[NSTimer scheduledTimerWithTimeInterval:metricsNotificationInterval target:self selector:@selector(metricsTimer:) userInfo:NULL repeats:YES] retain];
+    }
+}
+
+- (PlaybackSnapshot *) snapshot
+{
+    PlaybackSnapshot *value = nil;
+    
+    @synchronized(self)
+    {
+        if (isSnapshotChanged)
+        {
+            [snapshot release];
+            snapshot = [snapshotState copySnapshot];
+            isSnapshotChanged = NO;
+        }
+        value = [[snapshot retain] autorelease];
+    }
+    
+    return value;
+}
+
+- (HLSLivePlaylistTracker *) livePlaylistTracker
+{
+    HLSLivePlaylistTracker *value = nil;
+    
+    @synchronized(self)
+    {
+        value = [[livePlaylistTracker retain] autorelease];
+    }
+    
+    return value;
+}
+
 #pragma mark -
 #pragma mark internal properties:
 
@@ -2213,9 +4107,12 @@ NSString *kStatusKey = @"status";
 //
 - (void) timer:(NSTimer *)timer
 {
-    if (nil != currentSegment && PlayerStatus_Playing == currentSegment.status)
+    // The sequencer is called from the engine queue while an asynchronous seek or operation is pending,
+    // the tick is skipped instead of waiting for it
+    if (!isSeekPending && 0 == queuedOperationCount && nil != currentSegment && PlayerStatus_Playing == currentSegment.status)
     {
-        SeekbarTime * seekbarTime = nil;
+        // The seekbar time and the media time are reused across the timer ticks
+        SeekbarTime *seekbarTime = tickSeekbarTime;
         AVPlayerLayerView *playerLayerView = [avPlayerViews objectAtIndex:currentSegment.viewIndex];
         AVPlayer *moviePlayer = playerLayerView.player;
         CMTime cmCurrPlaybackTime = moviePlayer.currentTime;
@@ -2223,12 +4120,12 @@ NSString *kStatusKey = @"status";
         NSTimeInterval currPlaybackTime = (0 == cmCurrPlaybackTime.timescale) ? 0 : (double)cmCurrPlaybackTime.value / cmCurrPlaybackTime.timescale;
         
         // Get seekbar time from the sequencer
-        NSString *playbackPolicy = nil;
-        MediaTime *currentMediaTime = [[MediaTime alloc] init];
+        __block NSString *playbackPolicy = nil;
+        MediaTime *currentMediaTime = tickMediaTime;
         currentMediaTime.currentPlaybackPosition = currPlaybackTime;
         currentMediaTime.clipBeginMediaTime = currentSegment.clip.mediaTime.clipBeginMediaTime;
         currentMediaTime.clipEndMediaTime = currentSegment.clip.mediaTime.clipEndMediaTime;
-        BOOL segmentEnded = NO;
+        __block BOOL segmentEnded = NO;
         
         [self updateLiveInfo];
         if (!hasStartedAfterStop && !(currentSegment.clip.isAdvertisement && currentSegment.clip.linearTime.duration == 0))
@@ -2244,13 +4141,13 @@ NSString *kStatusKey = @"status";
                 [self seekToTime:currentMediaTime.currentPlaybackPosition];
             }
         }
-        if (isLive && !(currentSegment.clip.isAdvertisement && currentSegment.clip.linearTime.duration == 0))
-        {
-            // The main content is live, we need to call again with live parameters
-            [seekbarTime release]; 
-            if (![sequencer getSeekbarTime:&seekbarTime andPlaybackPolicy:&playbackPolicy withMediaTime:currentMediaTime playbackRate:rate currentSegment:self.currentSegment playbackRangeExceeded:&segmentEnded leftDvrEdge:leftDvrEdge livePosition:livePosition liveEnded:NO])
+        __block BOOL updated = NO;
+        [self performOnEngineQueueAndWait:^{
+            if (isLive && !(currentSegment.clip.isAdvertisement && currentSegment.clip.linearTime.duration == 0))
             {
-                if ([[sequencer.lastError.userInfo valueForKey:NSLocalizedFailureReasonErrorKey] rangeOfString:@"taken over by left DVR edge"].location != NSNotFound)
+                // The main content is live, we need to call again with live parameters
+                updated = [sequencer updateSeekbarTime:seekbarTime andPlaybackPolicy:&playbackPolicy withMediaTime:currentMediaTime playbackRate:rate currentSegment:self.currentSegment playbackRangeExceeded:&segmentEnded leftDvrEdge:leftDvrEdge livePosition:livePosition liveEnded:NO];
+                if (!updated && [sequencer.lastError.domain isEqualToString:SequencerErrorDomain] && SequencerErrorCode_DvrTakeover == sequencer.lastError.code)
                 {
                     // left DVR edge take over the current position
                     // In this case the playback position will be automatically snapped to the left edge by AVPlayer
@@ -2259,61 +4156,91 @@ NSString *kStatusKey = @"status";
                     self.lastError = sequencer.lastError;
                     [self sendErrorNotification];
                     currentMediaTime.currentPlaybackPosition = leftDvrEdge - (currentSegment.clip.linearTime.startTime - currentSegment.clip.mediaTime.clipBeginMediaTime);
-                    if (![sequencer getSeekbarTime:&seekbarTime andPlaybackPolicy:&playbackPolicy withMediaTime:currentMediaTime playbackRate:rate currentSegment:self.currentSegment playbackRangeExceeded:&segmentEnded leftDvrEdge:leftDvrEdge livePosition:livePosition liveEnded:NO])
-                    {
-                        self.lastError = sequencer.lastError;
-                        [self sendErrorNotification];
-                        [currentMediaTime release];
-                        return;                        
-                    }
-                }
-                else
-                {
-                    self.lastError = sequencer.lastError;
-                    [self sendErrorNotification];
-                    [currentMediaTime release];
-                    return;
+                    updated = [sequencer updateSeekbarTime:seekbarTime andPlaybackPolicy:&playbackPolicy withMediaTime:currentMediaTime playbackRate:rate currentSegment:self.currentSegment playbackRangeExceeded:&segmentEnded leftDvrEdge:leftDvrEdge livePosition:livePosition liveEnded:NO];
                 }
             }
-        }
-        else if (![sequencer getSeekbarTime:&seekbarTime andPlaybackPolicy:&playbackPolicy withMediaTime:currentMediaTime playbackRate:rate currentSegment:self.currentSegment playbackRangeExceeded:&segmentEnded])
+            else
+            {
+                updated = [sequencer updateSeekbarTime:seekbarTime andPlaybackPolicy:&playbackPolicy withMediaTime:currentMediaTime playbackRate:rate currentSegment:self.currentSegment playbackRangeExceeded:&segmentEnded];
+            }
+            if (!updated)
+            {
+                self.lastError = sequencer.lastError;
+            }
+        }];
+        if (!updated)
         {
-            self.lastError = sequencer.lastError;
             [self sendErrorNotification];
-            [currentMediaTime release];
             return;
         }
         
         if (0 == timerCount || segmentEnded)
         {
-            // Send notification for seek bar time update
-            SeekbarTimeUpdatedEventArgs *eventArgs = [[SeekbarTimeUpdatedEventArgs alloc] init];
-            eventArgs.seekbarTime = seekbarTime;
+            SeekbarState state;
+            state.currentSeekbarPosition = seekbarTime.currentSeekbarPosition;
+            state.minSeekbarPosition = seekbarTime.minSeekbarPosition;
+            state.maxSeekbarPosition = seekbarTime.maxSeekbarPosition;
+            state.currentPlaybackTime = currPlaybackTime;
+            state.entryId = currentSegment.clip.entryId;
+            state.isAdvertisement = currentSegment.clip.isAdvertisement;
+            state.isLive = isLive;
+            state.playbackRangeExceeded = segmentEnded;
+            state.coalescedCount = 0;
+            [self publishSeekbarState:&state];
             
-            NSMutableDictionary *userInfo = [[NSMutableDictionary alloc] init];
-            [userInfo setObject:eventArgs forKey:SeekbarTimeUpdatedArgsUserInfoKey];
-            
-            [eventArgs release];
-            
-            NSNotification *notification = [NSNotification notificationWithName:SeekbarTimeUpdatedNotification object:self userInfo:userInfo];
-            [[NSNotificationCenter defaultCenter] performSelectorOnMainThread:@selector(postNotification:) withObject:notification waitUntilDone:NO];
-            
-            [userInfo release];
+            if (postsSeekbarNotifications)
+            {
+                // Send notification for seek bar time update
+                // The notification keeps its own seekbar time since the one of the timer is reused
+                SeekbarTime *notifiedTime = [[SeekbarTime alloc] init];
+                notifiedTime.currentSeekbarPosition = seekbarTime.currentSeekbarPosition;
+                notifiedTime.minSeekbarPosition = seekbarTime.minSeekbarPosition;
+                notifiedTime.maxSeekbarPosition = seekbarTime.maxSeekbarPosition;
+                SeekbarTimeUpdatedEventArgs *eventArgs = [[SeekbarTimeUpdatedEventArgs alloc] init];
+                eventArgs.seekbarTime = notifiedTime;
+                [notifiedTime release];
+                
+                NSMutableDictionary *userInfo = [[NSMutableDictionary alloc] init];
+                [userInfo setObject:eventArgs forKey:SeekbarTimeUpdatedArgsUserInfoKey];
+                
+                [eventArgs release];
+                
+                // The timer runs on the main thread, so the notification is queued on it instead of being bounced
+                // to it. A notification which was not posted yet is replaced by the latest one.
+                NSNotification *notification = [NSNotification notificationWithName:SeekbarTimeUpdatedNotification object:self userInfo:userInfo];
+                NSNotificationQueue *notificationQueue = [NSNotificationQueue defaultQueue];
+                [notificationQueue dequeueNotificationsMatching:notification coalesceMask:(NSNotificationCoalescingOnName | NSNotificationCoalescingOnSender)];
+                [notificationQueue enqueueNotification:notification postingStyle:NSPostASAP coalesceMask:NSNotificationNoCoalescing forModes:nil];
+                
+                [userInfo release];
+            }
+        }
+        [self updateSnapshotWithSeekbarTime:seekbarTime playbackTime:currPlaybackTime];
+        
+        if (0 == timerCount && !currentSegment.clip.isAdvertisement)
+        {
+            // Let the lazy ad breaks and the VAST entries the playback comes near get resolved
+            NSTimeInterval linearTime = currentSegment.clip.linearTime.startTime + currPlaybackTime - currentSegment.clip.mediaTime.clipBeginMediaTime;
+            dispatch_async(engineQueue, ^{
+                [self updateLazyAdBreaksAtLinearTime:linearTime];
+                [self prefetchVASTEntriesAtLinearTime:linearTime];
+            });
         }
-        [seekbarTime release];
 
-        // Reset the timerCount to 0 when segment is ended so there is no delay in notification for the new segment
-        timerCount = segmentEnded ? 0 : (timerCount + 1) % TIMER_INTERVALS_PER_NOTIFICATION;
+        // Reset the timerCount to 0 when segment is ended so there is no delay in notification for the new segment.
+        // The timer runs at the seekbar update interval with the boundary observers, every tick is notified.
+        timerCount = segmentEnded ? 0 : (timerCount + 1) % (usesBoundaryTransitions ? 1 : TIMER_INTERVALS_PER_NOTIFICATION);
 
         if (segmentEnded)
         {
             // Playback should end
+            [self markTransitionPoint:TransitionPoint_EndOfMedia];
             if(![self contentFinished:NO])
             {
                 [self sendErrorNotification];
             }
         }
-        else if ((currentSegment.clip.mediaTime.clipEndMediaTime - currentMediaTime.currentPlaybackPosition < BUFFERING_COMPLETE_BEFORE_EOS_SEC) &&
+        else if ((currentSegment.clip.mediaTime.clipEndMediaTime - currentMediaTime.currentPlaybackPosition < preloadLeadTime) &&
                  (nil == nextSegment))
         {
             // Should start to pre-load the next content
@@ -2323,11 +4250,22 @@ NSString *kStatusKey = @"status";
         {
             // the framework won't enforce playback policy
         }
-        
-        [currentMediaTime release];
     }
 }
 
+//
+// Timer method that sends the periodic transition metrics notification.
+//
+// Arguments:
+// [timer]  NSTimer object.
+//
+// Returns: none.
+//
+- (void) metricsTimer:(NSTimer *)timer
+{
+    [self sendTransitionMetricsNotification];
+}
+
 //
 // Timer method that monitors when the loading of the JavaScript files finishes.
 //
@@ -2340,7 +4278,12 @@ NSString *kStatusKey = @"status";
 {
     if (nil != sequencer && nil != sequencer.scheduler)
     {
-        if (sequencer.isReady)
+        __block BOOL isReady = NO;
+        [self performOnEngineQueueAndWait:^{
+            isReady = sequencer.isReady;
+        }];
+        
+        if (isReady)
         {
             [self sendReadyNotification];
         }
@@ -2364,6 +4307,26 @@ NSString *kStatusKey = @"status";
     [nextSegment release];
     [lastError release];
     [appDelegate release];
+    [snapshot release];
+    [snapshotState release];
+    [transitionMetrics release];
+    [wrapperResolver release];
+    [livePlaylistTracker cancel];
+    [livePlaylistTracker release];
+    [lazyAdBreaks release];
+    [self cancelVASTPrefetches];
+    [vastPrefetchEntries release];
+    [boundaryObserver release];
+    dispatch_release(engineQueue);
+
+    for (AVPlayerLayerView *playerView in avPlayerViews)
+    {
+        [self releasePlayerOfView:playerView];
+    }
+    [playerPool release];
+    [preloadEstimator release];
+    [tickMediaTime release];
+    [tickSeekbarTime release];
 
     for (AVPlayerLayerView *playerView in avPlayerViews)
     {
@@ -2389,6 +4352,13 @@ NSString *kStatusKey = @"status";
         loadingTimer = nil;
     }
     
+    if (metricsTimer)
+    {
+        [metricsTimer invalidate];
+        [metricsTimer release];
+        metricsTimer = nil;
+    }
+    
     [super dealloc];
 }
 
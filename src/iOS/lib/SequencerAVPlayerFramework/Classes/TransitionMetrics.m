@@ -0,0 +1,303 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "TransitionMetrics.h"
+
+static int compareSamples(const void *first, const void *second)
+{
+    double a = *(const double *)first;
+    double b = *(const double *)second;
+    
+    return (a < b) ? -1 : ((a > b) ? 1 : 0);
+}
+
+@implementation TransitionMetrics
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize transitionCount;
+@synthesize preloadHitCount;
+@synthesize preloadMissCount;
+@synthesize adBreakResolvedCount;
+@synthesize adBreakLateCount;
+@synthesize vastPrefetchHitCount;
+@synthesize vastPrefetchMissCount;
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+// The caller holds the lock
+- (void) recordSample:(double)milliseconds forInterval:(TransitionInterval)interval
+{
+    samples[interval][totalCounts[interval] % TRANSITION_METRICS_WINDOW_SIZE] = milliseconds;
+    totalCounts[interval]++;
+}
+
+// The caller holds the lock
+- (void) clearTransition
+{
+    endOfMediaTime = 0;
+    contentFinishedTime = 0;
+    playerReadyTime = 0;
+    bridgeTimeAtStart = 0;
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the transition metrics
+//
+// Arguments: none
+//
+// Returns: The transition metrics instance.
+//
+- (id) init
+{
+    self = [super init];
+    
+    if (self){
+        pthread_mutex_init(&lock, NULL);
+        [self reset];
+    }
+    
+    return self;
+}
+
+//
+// record that a transition reached a point
+//
+// Arguments:
+// [point]: the point reached
+// [bridgeTime]: the total JavaScript evaluation time of the sequencer engine so far
+//
+// Returns: none
+//
+- (void) markPoint:(TransitionPoint)point bridgeTime:(NSTimeInterval)bridgeTime
+{
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    
+    pthread_mutex_lock(&lock);
+    switch (point)
+    {
+        case TransitionPoint_EndOfMedia:
+            if (0 == endOfMediaTime && 0 == contentFinishedTime)
+            {
+                endOfMediaTime = now;
+                bridgeTimeAtStart = bridgeTime;
+            }
+            break;
+            
+        case TransitionPoint_ContentFinished:
+            if (0 == contentFinishedTime)
+            {
+                contentFinishedTime = now;
+                if (0 == endOfMediaTime)
+                {
+                    // The transition is started by a seek or skip
+                    bridgeTimeAtStart = bridgeTime;
+                }
+            }
+            break;
+            
+        case TransitionPoint_PlayerReady:
+            // The next player can be ready before the transition starts if it was preloaded
+            playerReadyTime = now;
+            break;
+            
+        case TransitionPoint_FirstFrameShown:
+            if (0 != contentFinishedTime)
+            {
+                CFAbsoluteTime startTime = (0 != endOfMediaTime) ? endOfMediaTime : contentFinishedTime;
+                CFAbsoluteTime readyTime = (playerReadyTime > contentFinishedTime) ? playerReadyTime : contentFinishedTime;
+                
+                if (0 != endOfMediaTime)
+                {
+                    [self recordSample:(contentFinishedTime - endOfMediaTime) * 1000 forInterval:TransitionInterval_EndToFinished];
+                }
+                [self recordSample:(readyTime - contentFinishedTime) * 1000 forInterval:TransitionInterval_FinishedToReady];
+                [self recordSample:(now - readyTime) * 1000 forInterval:TransitionInterval_ReadyToShown];
+                [self recordSample:(now - startTime) * 1000 forInterval:TransitionInterval_Gap];
+                [self recordSample:(bridgeTime - bridgeTimeAtStart) * 1000 forInterval:TransitionInterval_SequencerBridge];
+                transitionCount++;
+            }
+            [self clearTransition];
+            break;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+//
+// add a sample which is measured outside of the transition points
+//
+// Arguments:
+// [duration]: the duration in seconds
+// [interval]: the interval measured
+//
+// Returns: none
+//
+- (void) addSample:(NSTimeInterval)duration forInterval:(TransitionInterval)interval
+{
+    pthread_mutex_lock(&lock);
+    [self recordSample:duration * 1000 forInterval:interval];
+    pthread_mutex_unlock(&lock);
+}
+
+//
+// count if the next entry was preloaded when the current entry finished
+//
+// Arguments:
+// [isHit]: YES if the preloaded entry was played and NO if the next entry had to be loaded
+//
+// Returns: none
+//
+- (void) countPreload:(BOOL)isHit
+{
+    pthread_mutex_lock(&lock);
+    if (isHit)
+    {
+        preloadHitCount++;
+    }
+    else
+    {
+        preloadMissCount++;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+//
+// count if a lazily resolved ad break was resolved before the playback reached it
+//
+// Arguments:
+// [isInTime]: YES if the ad pod was scheduled before the ad break and NO if the playback passed the ad break first
+//
+// Returns: none
+//
+- (void) countAdBreakResolution:(BOOL)isInTime
+{
+    pthread_mutex_lock(&lock);
+    if (isInTime)
+    {
+        adBreakResolvedCount++;
+    }
+    else
+    {
+        adBreakLateCount++;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+//
+// count if the ad pod of a VAST entry was prefetched when the playback reached the entry
+//
+// Arguments:
+// [isHit]: YES if the prefetched ad pod was scheduled and NO if the VAST manifest had to be downloaded
+//
+// Returns: none
+//
+- (void) countVASTPrefetch:(BOOL)isHit
+{
+    pthread_mutex_lock(&lock);
+    if (isHit)
+    {
+        vastPrefetchHitCount++;
+    }
+    else
+    {
+        vastPrefetchMissCount++;
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+//
+// get the histogram of the recent samples of an interval
+//
+// Arguments:
+// [interval]: the interval
+//
+// Returns: the histogram, with all zero values if there is no sample
+//
+- (TransitionHistogram) histogramForInterval:(TransitionInterval)interval
+{
+    TransitionHistogram histogram;
+    double window[TRANSITION_METRICS_WINDOW_SIZE];
+    double sum = 0;
+    
+    memset(&histogram, 0, sizeof(histogram));
+    
+    pthread_mutex_lock(&lock);
+    histogram.totalCount = totalCounts[interval];
+    histogram.sampleCount = MIN(totalCounts[interval], TRANSITION_METRICS_WINDOW_SIZE);
+    memcpy(window, samples[interval], histogram.sampleCount * sizeof(double));
+    pthread_mutex_unlock(&lock);
+    
+    if (0 < histogram.sampleCount)
+    {
+        qsort(window, histogram.sampleCount, sizeof(double), compareSamples);
+        
+        for (uint32_t i = 0; i < histogram.sampleCount; ++i)
+        {
+            uint32_t bucket = 0;
+            while (bucket < TRANSITION_METRICS_BUCKET_COUNT - 1 && (double)(1 << bucket) <= window[i])
+            {
+                bucket++;
+            }
+            histogram.buckets[bucket]++;
+            sum += window[i];
+        }
+        
+        histogram.minMs = window[0];
+        histogram.maxMs = window[histogram.sampleCount - 1];
+        histogram.meanMs = sum / histogram.sampleCount;
+        histogram.p50Ms = window[(histogram.sampleCount * 50) / 100];
+        histogram.p90Ms = window[(histogram.sampleCount * 90) / 100];
+        histogram.p99Ms = window[(histogram.sampleCount * 99) / 100];
+    }
+    
+    return histogram;
+}
+
+//
+// clear all the samples and counters
+//
+// Arguments: none
+//
+// Returns: none
+//
+- (void) reset
+{
+    pthread_mutex_lock(&lock);
+    memset(samples, 0, sizeof(samples));
+    memset(totalCounts, 0, sizeof(totalCounts));
+    transitionCount = 0;
+    preloadHitCount = 0;
+    preloadMissCount = 0;
+    adBreakResolvedCount = 0;
+    adBreakLateCount = 0;
+    vastPrefetchHitCount = 0;
+    vastPrefetchMissCount = 0;
+    [self clearTransition];
+    pthread_mutex_unlock(&lock);
+}
+
+- (void) dealloc
+{
+    pthread_mutex_destroy(&lock);
+    
+    [super dealloc];
+}
+
+@end
@@ -0,0 +1,55 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+
+@class ManifestDownloadRequest;
+
+typedef enum
+{
+    VASTPrefetchState_Downloading,  // the VAST manifest is being downloaded and parsed
+    VASTPrefetchState_Ready,        // the ad pod is ready to be scheduled
+    VASTPrefetchState_Failed        // the VAST manifest could not be downloaded or parsed
+} VASTPrefetchState;
+
+//
+// The ad pod of a VAST playlist entry resolved ahead of the playback. The framework keeps it
+// until the playback reaches the entry, then schedules the ad pod without waiting for the ad server.
+//
+@interface VASTPrefetchEntry : NSObject
+{
+@private
+    int32_t entryId;
+    NSURL *vastURL;
+    NSTimeInterval linearStartTime;
+    VASTPrefetchState state;
+    ManifestDownloadRequest *request;
+    NSArray *adInfos;
+    CFAbsoluteTime readyTime;
+}
+
+@property(nonatomic, readonly) int32_t entryId;
+@property(nonatomic, readonly) NSURL *vastURL;
+@property(nonatomic, readonly) NSTimeInterval linearStartTime;
+@property(nonatomic, assign) VASTPrefetchState state;
+@property(nonatomic, retain) ManifestDownloadRequest *request;
+@property(nonatomic, readonly) NSArray *adInfos;
+@property(nonatomic, readonly) CFAbsoluteTime readyTime;
+
+- (id) initWithEntryId:(int32_t)anEntryId vastURL:(NSURL *)aVastURL linearStartTime:(NSTimeInterval)aLinearStartTime;
+- (void) setReadyWithAdInfos:(NSArray *)anAdInfos;
+- (void) cancel;
+
+@end
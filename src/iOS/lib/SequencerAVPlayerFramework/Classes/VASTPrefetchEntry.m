@@ -0,0 +1,109 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "VASTPrefetchEntry.h"
+#import "ManifestDownloadManager.h"
+
+@implementation VASTPrefetchEntry
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize entryId;
+@synthesize vastURL;
+@synthesize linearStartTime;
+@synthesize state;
+@synthesize request;
+@synthesize adInfos;
+@synthesize readyTime;
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the VAST prefetch entry
+//
+// Arguments:
+// [anEntryId]: the id of the VAST playlist entry
+// [aVastURL]: the URL of the VAST manifest
+// [aLinearStartTime]: the linear start time of the playlist entry
+//
+// Returns: The VAST prefetch entry instance.
+//
+- (id) initWithEntryId:(int32_t)anEntryId vastURL:(NSURL *)aVastURL linearStartTime:(NSTimeInterval)aLinearStartTime
+{
+    self = [super init];
+    
+    if (self){
+        entryId = anEntryId;
+        vastURL = [aVastURL retain];
+        linearStartTime = aLinearStartTime;
+        state = VASTPrefetchState_Downloading;
+        request = nil;
+        adInfos = nil;
+        readyTime = 0;
+    }
+    
+    return self;
+}
+
+//
+// store the resolved ad pod
+//
+// Arguments:
+// [anAdInfos]: the AdInfo objects of the ad pod
+//
+// Returns: none
+//
+- (void) setReadyWithAdInfos:(NSArray *)anAdInfos
+{
+    [adInfos release];
+    adInfos = [anAdInfos copy];
+    readyTime = CFAbsoluteTimeGetCurrent();
+    state = VASTPrefetchState_Ready;
+    self.request = nil;
+}
+
+//
+// cancel the download of the VAST manifest
+//
+// Arguments: none
+//
+// Returns: none
+//
+- (void) cancel
+{
+    [request cancel];
+    self.request = nil;
+    if (VASTPrefetchState_Downloading == state)
+    {
+        state = VASTPrefetchState_Failed;
+    }
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [request cancel];
+    [request release];
+    [vastURL release];
+    [adInfos release];
+    
+    [super dealloc];
+}
+
+@end
@@ -0,0 +1,411 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "VASTWrapperResolver.h"
+#import "AdResolver.h"
+#import "VASTParser.h"
+#import "Ad.h"
+#import "Creative.h"
+#import "CompositeElement.h"
+#import "Trace.h"
+
+//
+// The documents of one level of the wrapper chains. The download completion handlers
+// retain the batch, so it stays valid for downloads which finish after the deadline.
+//
+@interface VASTWrapperDownloadBatch : NSObject
+{
+@private
+    dispatch_group_t group;
+    NSMutableArray *manifests;
+}
+
+- (id) initWithCount:(NSUInteger)count;
+- (void) setManifest:(NSString *)manifest atIndex:(NSUInteger)index;
+- (NSArray *) waitUntilTime:(CFAbsoluteTime)endTime;
+
+@property(nonatomic, readonly) dispatch_group_t group;
+
+@end
+
+@implementation VASTWrapperDownloadBatch
+
+@synthesize group;
+
+- (id) initWithCount:(NSUInteger)count
+{
+    self = [super init];
+    
+    if (self){
+        group = dispatch_group_create();
+        manifests = [[NSMutableArray alloc] initWithCapacity:count];
+        for (NSUInteger i = 0; i < count; ++i)
+        {
+            [manifests addObject:[NSNull null]];
+        }
+    }
+    
+    return self;
+}
+
+- (void) setManifest:(NSString *)manifest atIndex:(NSUInteger)index
+{
+    @synchronized(self)
+    {
+        [manifests replaceObjectAtIndex:index withObject:manifest];
+    }
+}
+
+//
+// wait until all the downloads are finished or the end time has passed
+//
+// Arguments:
+// [endTime]: the absolute time to stop waiting at
+//
+// Returns: The manifests downloaded so far, NSNull for the others.
+//
+- (NSArray *) waitUntilTime:(CFAbsoluteTime)endTime
+{
+    NSTimeInterval remaining = endTime - CFAbsoluteTimeGetCurrent();
+    if (0 < remaining)
+    {
+        dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(remaining * NSEC_PER_SEC)));
+    }
+    
+    NSArray *result = nil;
+    @synchronized(self)
+    {
+        result = [[manifests copy] autorelease];
+    }
+    
+    return result;
+}
+
+- (void) dealloc
+{
+    dispatch_release(group);
+    [manifests release];
+    
+    [super dealloc];
+}
+
+@end
+
+//
+// A wrapper chain which is not resolved yet
+//
+@interface VASTWrapperChain : NSObject
+{
+@private
+    NSUInteger adIndex;
+    NSMutableArray *wrappers;
+}
+
+@property(nonatomic, assign) NSUInteger adIndex;
+@property(nonatomic, readonly) NSMutableArray *wrappers;
+
+@end
+
+@implementation VASTWrapperChain
+
+@synthesize adIndex;
+@synthesize wrappers;
+
+- (id) init
+{
+    self = [super init];
+    
+    if (self){
+        wrappers = [[NSMutableArray alloc] init];
+    }
+    
+    return self;
+}
+
+- (void) dealloc
+{
+    [wrappers release];
+    
+    [super dealloc];
+}
+
+@end
+
+@implementation VASTWrapperResolver
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize maxDepth;
+@synthesize deadline;
+@synthesize lastError;
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+- (void) startDownloadWithURL:(NSURL *)url timeout:(NSTimeInterval)timeout intoBatch:(VASTWrapperDownloadBatch *)batch atIndex:(NSUInteger)index
+{
+    SEQUENCER_LOG(@"start downloading VAST wrapper target %@", url);
+    dispatch_group_enter(batch.group);
+    ManifestDownloadRequest *request = [adResolver.downloadManager downloadManifestWithURL:url
+                                                                                  priority:ManifestDownloadPriority_Imminent
+                                                                                   timeout:timeout
+                                                                                  deadline:timeout
+                                                                           completionQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0)
+                                                                                completion:^(NSString *manifest, NSError *error) {
+                                                                                    if (nil != manifest)
+                                                                                    {
+                                                                                        [batch setManifest:manifest atIndex:index];
+                                                                                    }
+                                                                                    else
+                                                                                    {
+                                                                                        SEQUENCER_LOG(@"VAST wrapper target download failed for %@: %@", url, error);
+                                                                                    }
+                                                                                    dispatch_group_leave(batch.group);
+                                                                                }];
+    if (nil == request)
+    {
+        dispatch_group_leave(batch.group);
+    }
+}
+
+//
+// parse a downloaded wrapper target and get its first ad
+//
+// Arguments:
+// [ad]: the output ad
+// [manifest]: the downloaded VAST manifest
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) getFirstAd:(Ad **)ad fromManifest:(NSString *)manifest
+{
+    BOOL success = NO;
+    int32_t entryId = 0;
+    
+    do
+    {
+        success = [adResolver.vastParser createEntry:&entryId withManifest:manifest];
+        if (!success)
+        {
+            self.lastError = adResolver.vastParser.lastError;
+            break;
+        }
+        
+        NSArray *adList = nil;
+        success = [adResolver.vastParser resolveAllAds:&adList withEntryId:entryId];
+        if (!success || 0 == [adList count])
+        {
+            self.lastError = adResolver.vastParser.lastError;
+            success = NO;
+        }
+        else
+        {
+            *ad = [adList objectAtIndex:0];
+        }
+        
+        // Ignore error when release the entry
+        [adResolver releaseEntry:entryId];
+    }
+    while (NO);
+    
+    return success;
+}
+
+//
+// merge the Linear tracking events of the wrappers into the Linear creatives of the ad they resolved to
+//
+// Arguments:
+// [ad]: the InLine ad the chain resolved to
+// [wrappers]: the wrapper ads of the chain, outermost first
+//
+// Returns: nothing
+//
+- (void) mergeTrackingEventsIntoAd:(Ad *)ad fromWrappers:(NSArray *)wrappers
+{
+    NSMutableArray *wrapperEvents = [NSMutableArray array];
+    for (Ad *wrapper in wrappers)
+    {
+        for (Creative *creative in wrapper.creatives.elementList)
+        {
+            if (Linear == creative.type && nil != creative.trackingEvents.elementList)
+            {
+                [wrapperEvents addObjectsFromArray:creative.trackingEvents.elementList];
+            }
+        }
+    }
+    
+    if (0 == [wrapperEvents count])
+    {
+        return;
+    }
+    
+    for (Creative *creative in ad.creatives.elementList)
+    {
+        if (Linear == creative.type)
+        {
+            if (nil == creative.trackingEvents)
+            {
+                creative.trackingEvents = [[[CompositeElement alloc] init] autorelease];
+                creative.trackingEvents.name = @"TrackingEvents";
+                creative.trackingEvents.expanded = YES;
+            }
+            NSMutableArray *events = [NSMutableArray arrayWithArray:creative.trackingEvents.elementList];
+            [events addObjectsFromArray:wrapperEvents];
+            creative.trackingEvents.elementList = events;
+            creative.trackingEvents.elementCount = [events count];
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the wrapper resolver
+//
+// Arguments:
+// [anAdResolver]: the AdResolver to parse the downloaded documents with
+//
+// Returns: The wrapper resolver instance.
+//
+- (id) initWithAdResolver:(AdResolver *)anAdResolver
+{
+    self = [super init];
+    
+    if (self){
+        adResolver = [anAdResolver retain];
+        maxDepth = VAST_WRAPPER_DEFAULT_MAX_DEPTH;
+        deadline = VAST_WRAPPER_DEFAULT_DEADLINE;
+        lastError = nil;
+    }
+    
+    return self;
+}
+
+//
+// resolve the Wrapper ads of an ad pod
+//
+// Arguments:
+// [resolvedAds]: the output ads in the order of ads. InLine ads are kept and each Wrapper ad
+// is replaced by the first ad of the last document of its chain. That ad gets the sequence of
+// the outermost wrapper and the Linear tracking events of all the wrappers added to its Linear
+// creatives. A Wrapper ad which could not be resolved is kept as it is.
+// [ads]: the ads of the pod as given by the VASTParser
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) resolveAds:(NSArray **)resolvedAds fromAds:(NSArray *)ads
+{
+    assert(nil != resolvedAds);
+    CFAbsoluteTime endTime = CFAbsoluteTimeGetCurrent() + deadline;
+    NSMutableArray *result = [NSMutableArray arrayWithArray:ads];
+    NSMutableArray *chains = [NSMutableArray array];
+    
+    for (NSUInteger adIndex = 0; adIndex < [ads count]; ++adIndex)
+    {
+        Ad *ad = [ads objectAtIndex:adIndex];
+        if (Wrapper == ad.type)
+        {
+            VASTWrapperChain *chain = [[VASTWrapperChain alloc] init];
+            chain.adIndex = adIndex;
+            [chain.wrappers addObject:ad];
+            [chains addObject:chain];
+            [chain release];
+        }
+    }
+    
+    for (NSUInteger depth = 1; 0 < [chains count] && depth <= maxDepth; ++depth)
+    {
+        NSTimeInterval remaining = endTime - CFAbsoluteTimeGetCurrent();
+        if (remaining <= 0)
+        {
+            break;
+        }
+        
+        // Download the next document of every chain at the same time
+        VASTWrapperDownloadBatch *batch = [[[VASTWrapperDownloadBatch alloc] initWithCount:[chains count]] autorelease];
+        for (NSUInteger chainIndex = 0; chainIndex < [chains count]; ++chainIndex)
+        {
+            Ad *wrapper = [[[chains objectAtIndex:chainIndex] wrappers] lastObject];
+            NSURL *url = (nil == wrapper.adTagURI) ? nil : [NSURL URLWithString:[wrapper.adTagURI stringByTrimmingCharactersInSet:[NSCharacterSet whitespaceAndNewlineCharacterSet]]];
+            if (nil != url)
+            {
+                [self startDownloadWithURL:url timeout:remaining intoBatch:batch atIndex:chainIndex];
+            }
+            else
+            {
+                SEQUENCER_LOG(@"VAST Wrapper without a valid VASTAdTagURI! Ad %u", [[chains objectAtIndex:chainIndex] adIndex]);
+            }
+        }
+        NSArray *manifests = [batch waitUntilTime:endTime];
+        
+        // Parse the documents which arrived in time, the chains of the others are given up
+        NSMutableArray *nextChains = [NSMutableArray array];
+        for (NSUInteger chainIndex = 0; chainIndex < [chains count]; ++chainIndex)
+        {
+            VASTWrapperChain *chain = [chains objectAtIndex:chainIndex];
+            NSString *manifest = [manifests objectAtIndex:chainIndex];
+            Ad *ad = nil;
+            
+            if ([NSNull null] == (id)manifest)
+            {
+                SEQUENCER_LOG(@"VAST Wrapper of Ad %u not resolved at depth %u", chain.adIndex, depth);
+                continue;
+            }
+            if (![self getFirstAd:&ad fromManifest:manifest])
+            {
+                SEQUENCER_LOG(@"VAST Wrapper of Ad %u has an invalid target at depth %u", chain.adIndex, depth);
+                continue;
+            }
+            
+            if (InLine == ad.type)
+            {
+                Ad *outerWrapper = [chain.wrappers objectAtIndex:0];
+                ad.sequence = outerWrapper.sequence;
+                [self mergeTrackingEventsIntoAd:ad fromWrappers:chain.wrappers];
+                [result replaceObjectAtIndex:chain.adIndex withObject:ad];
+            }
+            else
+            {
+                [chain.wrappers addObject:ad];
+                [nextChains addObject:chain];
+            }
+        }
+        chains = nextChains;
+    }
+    
+    for (VASTWrapperChain *chain in chains)
+    {
+        SEQUENCER_LOG(@"VAST Wrapper of Ad %u not resolved within depth %u and deadline %f", chain.adIndex, maxDepth, deadline);
+    }
+    
+    *resolvedAds = result;
+    
+    return YES;
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [adResolver release];
+    [lastError release];
+    
+    [super dealloc];
+}
+
+@end
@@ -0,0 +1,162 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <SenTestingKit/SenTestingKit.h>
+#import "HLSPlaylist.h"
+
+#define SYNTHETIC_SEGMENT_COUNT 50000
+#define SYNTHETIC_DISCONTINUITY_INTERVAL 5000
+#define SYNTHETIC_SEGMENT_DURATION 2.0
+#define THROUGHPUT_ITERATIONS 10
+
+//
+// Throughput benchmark of the HLSPlaylist parser on a synthetic media playlist of 50k segments,
+// as long DVR and event playlists have. The parse is compared with the token scan which
+// getHLSContentDuration did before, and the results are logged with NSLog.
+//
+@interface HLSPlaylistThroughputTests : SenTestCase
+{
+@private
+    NSData *playlistData;
+}
+
+@end
+
+@implementation HLSPlaylistThroughputTests
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+- (NSData *) createPlaylistWithSegmentCount:(NSUInteger)count
+{
+    NSMutableData *data = [NSMutableData dataWithCapacity:(count * 80)];
+    char line[160];
+    int length = 0;
+    
+    length = snprintf(line, sizeof(line), "#EXTM3U\n#EXT-X-VERSION:3\n#EXT-X-TARGETDURATION:2\n#EXT-X-MEDIA-SEQUENCE:1000\n");
+    [data appendBytes:line length:length];
+    for (NSUInteger i = 0; i < count; ++i)
+    {
+        if (0 < i && 0 == i % SYNTHETIC_DISCONTINUITY_INTERVAL)
+        {
+            [data appendBytes:"#EXT-X-DISCONTINUITY\n" length:21];
+        }
+        length = snprintf(line, sizeof(line), "#EXTINF:%.3f,\nQualityLevels(1500000)/Fragments(video=%llu,format=m3u8-aapl)\n",
+                          SYNTHETIC_SEGMENT_DURATION, (unsigned long long)i * 20000000ULL);
+        [data appendBytes:line length:length];
+    }
+    [data appendBytes:"#EXT-X-ENDLIST\n" length:15];
+    
+    return data;
+}
+
+// the duration as getHLSContentDuration computed it before the HLSPlaylist parser
+- (NSTimeInterval) durationFromTokensOfManifest:(NSString *)manifest
+{
+    NSTimeInterval duration = 0;
+    NSArray *components = [manifest componentsSeparatedByCharactersInSet:[NSCharacterSet characterSetWithCharactersInString:@" \r\n/"]];
+    
+    for (NSString *element in components)
+    {
+        NSRange range = [element rangeOfString:@"#EXTINF:"];
+        if (range.location != NSNotFound && range.length == 8)
+        {
+            NSTimeInterval segmentDuration = 0;
+            if ([[NSScanner scannerWithString:[element substringFromIndex:8]] scanDouble:&segmentDuration])
+            {
+                duration += segmentDuration;
+            }
+        }
+    }
+    
+    return duration;
+}
+
+#pragma mark -
+#pragma mark Test setup:
+
+- (void) setUp
+{
+    [super setUp];
+    
+    playlistData = [[self createPlaylistWithSegmentCount:SYNTHETIC_SEGMENT_COUNT] retain];
+}
+
+- (void) tearDown
+{
+    [playlistData release];
+    
+    [super tearDown];
+}
+
+#pragma mark -
+#pragma mark Tests:
+
+- (void) testSyntheticPlaylistIsParsed
+{
+    HLSPlaylist *playlist = [[HLSPlaylist alloc] initWithData:playlistData];
+    
+    STAssertNotNil(playlist, @"playlist not parsed");
+    STAssertFalse(playlist.isMasterPlaylist, @"media playlist parsed as master playlist");
+    STAssertEquals(playlist.segmentCount, (NSUInteger)SYNTHETIC_SEGMENT_COUNT, @"wrong segment count");
+    STAssertEqualsWithAccuracy(playlist.totalDuration, SYNTHETIC_SEGMENT_COUNT * SYNTHETIC_SEGMENT_DURATION, 0.001, @"wrong total duration");
+    STAssertEqualsWithAccuracy(playlist.targetDuration, 2.0, 0.001, @"wrong target duration");
+    STAssertEquals(playlist.mediaSequence, (uint64_t)1000, @"wrong media sequence");
+    STAssertTrue(playlist.hasEndList, @"end list not found");
+    STAssertEquals([playlist.discontinuities count], (NSUInteger)(SYNTHETIC_SEGMENT_COUNT / SYNTHETIC_DISCONTINUITY_INTERVAL - 1), @"wrong discontinuity count");
+    STAssertEqualsWithAccuracy([[playlist.discontinuities objectAtIndex:0] doubleValue], SYNTHETIC_DISCONTINUITY_INTERVAL * SYNTHETIC_SEGMENT_DURATION, 0.001, @"wrong discontinuity time");
+    
+    [playlist release];
+}
+
+- (void) testParseThroughput
+{
+    NSTimeInterval parseTime = 0;
+    NSTimeInterval tokenScanTime = 0;
+    NSTimeInterval tokenScanDuration = 0;
+    CFAbsoluteTime startTime = 0;
+    
+    for (int i = 0; i < THROUGHPUT_ITERATIONS; ++i)
+    {
+        NSAutoreleasePool *pool = [[NSAutoreleasePool alloc] init];
+        
+        startTime = CFAbsoluteTimeGetCurrent();
+        HLSPlaylist *playlist = [[HLSPlaylist alloc] initWithData:playlistData];
+        parseTime += CFAbsoluteTimeGetCurrent() - startTime;
+        STAssertEquals(playlist.segmentCount, (NSUInteger)SYNTHETIC_SEGMENT_COUNT, @"wrong segment count");
+        [playlist release];
+        
+        // the token scan gets the manifest as a string, as it was downloaded before
+        NSString *manifest = [[NSString alloc] initWithData:playlistData encoding:NSASCIIStringEncoding];
+        startTime = CFAbsoluteTimeGetCurrent();
+        tokenScanDuration = [self durationFromTokensOfManifest:manifest];
+        tokenScanTime += CFAbsoluteTimeGetCurrent() - startTime;
+        [manifest release];
+        
+        [pool release];
+    }
+    
+    double megabytes = (double)[playlistData length] * THROUGHPUT_ITERATIONS / (1024 * 1024);
+    NSLog(@"HLSPlaylist: %u segments, %u bytes, %.3f ms per parse, %.1f MB/s, %.0f segments/s",
+          SYNTHETIC_SEGMENT_COUNT, [playlistData length], parseTime * 1000 / THROUGHPUT_ITERATIONS,
+          megabytes / parseTime, SYNTHETIC_SEGMENT_COUNT * THROUGHPUT_ITERATIONS / parseTime);
+    NSLog(@"Token scan: %.3f ms per parse, %.1f MB/s, %.1f times the HLSPlaylist parse time",
+          tokenScanTime * 1000 / THROUGHPUT_ITERATIONS, megabytes / tokenScanTime, tokenScanTime / parseTime);
+    
+    STAssertEqualsWithAccuracy(tokenScanDuration, SYNTHETIC_SEGMENT_COUNT * SYNTHETIC_SEGMENT_DURATION, 0.001, @"token scan gave another duration");
+    STAssertTrue(parseTime < tokenScanTime, @"HLSPlaylist parse slower than the token scan");
+}
+
+@end
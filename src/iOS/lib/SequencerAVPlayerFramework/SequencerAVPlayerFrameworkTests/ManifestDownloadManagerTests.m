@@ -0,0 +1,235 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <SenTestingKit/SenTestingKit.h>
+#import "ManifestDownloadManager.h"
+#import "StubURLProtocol.h"
+
+//
+// Tests of the ManifestDownloadManager against the StubURLProtocol, which injects the latency
+// of each response. The manager has no cache, so every request reaches the stub.
+//
+@interface ManifestDownloadManagerTests : SenTestCase
+{
+@private
+    ManifestDownloadManager *manager;
+    dispatch_queue_t completionQueue;
+    dispatch_group_t group;
+    NSMutableDictionary *errorsByURL;
+    NSMutableDictionary *manifestsByURL;
+}
+
+@end
+
+@implementation ManifestDownloadManagerTests
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+- (void) serveURL:(NSString *)url delay:(NSTimeInterval)delay
+{
+    [StubURLProtocol setResponseWithStatusCode:200 body:[NSString stringWithFormat:@"#EXTM3U %@", url] delay:delay forURL:url];
+}
+
+- (ManifestDownloadRequest *) startDownloadWithURL:(NSString *)url priority:(ManifestDownloadPriority)priority deadline:(NSTimeInterval)deadline
+{
+    dispatch_group_enter(group);
+    return [manager downloadManifestWithURL:[NSURL URLWithString:url]
+                                   priority:priority
+                                    timeout:MANIFEST_DOWNLOAD_DEFAULT_TIMEOUT
+                                   deadline:deadline
+                            completionQueue:completionQueue
+                                 completion:^(NSString *manifest, NSError *error) {
+                                     if (nil != manifest)
+                                     {
+                                         [manifestsByURL setObject:manifest forKey:url];
+                                     }
+                                     if (nil != error)
+                                     {
+                                         [errorsByURL setObject:error forKey:url];
+                                     }
+                                     dispatch_group_leave(group);
+                                 }];
+}
+
+- (BOOL) waitForDownloads:(NSTimeInterval)timeout
+{
+    return 0 == dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(timeout * NSEC_PER_SEC)));
+}
+
+#pragma mark -
+#pragma mark Test setup:
+
+- (void) setUp
+{
+    [super setUp];
+    
+    [StubURLProtocol reset];
+    [NSURLProtocol registerClass:[StubURLProtocol class]];
+    
+    manager = [[ManifestDownloadManager alloc] init];
+    // the completion handlers run on a serial queue, so they can record the results without a lock
+    completionQueue = dispatch_queue_create("ManifestDownloadManagerTests", DISPATCH_QUEUE_SERIAL);
+    group = dispatch_group_create();
+    errorsByURL = [[NSMutableDictionary alloc] init];
+    manifestsByURL = [[NSMutableDictionary alloc] init];
+}
+
+- (void) tearDown
+{
+    [manager cancelAllDownloads];
+    [self waitForDownloads:5.0];
+    [manager release];
+    dispatch_release(completionQueue);
+    dispatch_release(group);
+    [errorsByURL release];
+    [manifestsByURL release];
+    [NSURLProtocol unregisterClass:[StubURLProtocol class]];
+    
+    [super tearDown];
+}
+
+#pragma mark -
+#pragma mark Tests:
+
+- (void) testManifestIsDownloaded
+{
+    NSString *url = @"http://cdn.test/main.m3u8";
+    [self serveURL:url delay:0.1];
+    
+    [self startDownloadWithURL:url priority:ManifestDownloadPriority_Normal deadline:0];
+    
+    STAssertTrue([self waitForDownloads:5.0], @"completion not called");
+    STAssertEqualObjects([manifestsByURL objectForKey:url], @"#EXTM3U http://cdn.test/main.m3u8", @"wrong manifest");
+    STAssertNil([errorsByURL objectForKey:url], @"unexpected error");
+}
+
+- (void) testPendingDownloadsStartInPriorityOrder
+{
+    manager.maxConcurrentDownloads = 1;
+    NSArray *urls = [NSArray arrayWithObjects:@"http://first.test/a", @"http://prefetch.test/a", @"http://normal1.test/a",
+                     @"http://imminent.test/a", @"http://normal2.test/a", nil];
+    for (NSString *url in urls)
+    {
+        [self serveURL:url delay:0.1];
+    }
+    
+    // the first download takes the only connection, the others wait for it in priority order
+    [self startDownloadWithURL:[urls objectAtIndex:0] priority:ManifestDownloadPriority_Prefetch deadline:0];
+    [self startDownloadWithURL:[urls objectAtIndex:1] priority:ManifestDownloadPriority_Prefetch deadline:0];
+    [self startDownloadWithURL:[urls objectAtIndex:2] priority:ManifestDownloadPriority_Normal deadline:0];
+    [self startDownloadWithURL:[urls objectAtIndex:3] priority:ManifestDownloadPriority_Imminent deadline:0];
+    [self startDownloadWithURL:[urls objectAtIndex:4] priority:ManifestDownloadPriority_Normal deadline:0];
+    
+    STAssertTrue([self waitForDownloads:5.0], @"completion not called");
+    NSArray *expectedOrder = [NSArray arrayWithObjects:@"http://first.test/a", @"http://imminent.test/a", @"http://normal1.test/a",
+                              @"http://normal2.test/a", @"http://prefetch.test/a", nil];
+    STAssertEqualObjects([StubURLProtocol startedURLs], expectedOrder, @"downloads not started in priority order");
+    STAssertEquals([manifestsByURL count], (NSUInteger)5, @"not all manifests downloaded");
+}
+
+- (void) testDownloadsPerHostAreLimited
+{
+    manager.maxDownloadsPerHost = 2;
+    for (int i = 0; i < 6; ++i)
+    {
+        NSString *url = [NSString stringWithFormat:@"http://cdn.test/segment%d.m3u8", i];
+        [self serveURL:url delay:0.2];
+        [self startDownloadWithURL:url priority:ManifestDownloadPriority_Normal deadline:0];
+    }
+    NSString *otherHostURL = @"http://other.test/main.m3u8";
+    [self serveURL:otherHostURL delay:0.2];
+    [self startDownloadWithURL:otherHostURL priority:ManifestDownloadPriority_Normal deadline:0];
+    
+    STAssertTrue([self waitForDownloads:5.0], @"completion not called");
+    STAssertEquals([StubURLProtocol maxConcurrentRequestsForHost:@"cdn.test"], (NSUInteger)2, @"per host limit not kept");
+    STAssertEquals([manifestsByURL count], (NSUInteger)7, @"not all manifests downloaded");
+    
+    // the other host does not wait for the connections to the busy host
+    NSUInteger otherHostIndex = [[StubURLProtocol startedURLs] indexOfObject:otherHostURL];
+    STAssertTrue(otherHostIndex < 3, @"other host waited for the busy host");
+}
+
+- (void) testSlowDownloadIsCancelledAtDeadline
+{
+    NSString *url = @"http://slow.test/main.m3u8";
+    [self serveURL:url delay:3.0];
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    
+    [self startDownloadWithURL:url priority:ManifestDownloadPriority_Imminent deadline:0.3];
+    
+    STAssertTrue([self waitForDownloads:2.0], @"completion not called at the deadline");
+    STAssertTrue(CFAbsoluteTimeGetCurrent() - startTime < 1.0, @"download not cancelled at the deadline");
+    STAssertNil([manifestsByURL objectForKey:url], @"manifest after the deadline");
+    STAssertEquals([[errorsByURL objectForKey:url] code], (NSInteger)NSURLErrorTimedOut, @"wrong error for the deadline");
+}
+
+- (void) testPendingDownloadIsCancelledAtDeadline
+{
+    manager.maxConcurrentDownloads = 1;
+    NSString *blockingURL = @"http://blocking.test/main.m3u8";
+    NSString *url = @"http://waiting.test/main.m3u8";
+    [self serveURL:blockingURL delay:1.0];
+    [self serveURL:url delay:0];
+    
+    [self startDownloadWithURL:blockingURL priority:ManifestDownloadPriority_Normal deadline:0];
+    [self startDownloadWithURL:url priority:ManifestDownloadPriority_Normal deadline:0.3];
+    
+    STAssertTrue([self waitForDownloads:5.0], @"completion not called");
+    STAssertEquals([[errorsByURL objectForKey:url] code], (NSInteger)NSURLErrorTimedOut, @"wrong error for the deadline");
+    STAssertEquals([StubURLProtocol countOfRequestsForURL:url], (NSUInteger)0, @"download started after its deadline");
+    STAssertNotNil([manifestsByURL objectForKey:blockingURL], @"blocking download failed");
+}
+
+- (void) testHTTPErrorStatusIsAnError
+{
+    NSString *notFoundURL = @"http://cdn.test/missing.m3u8";
+    NSString *unavailableURL = @"http://cdn.test/unavailable.m3u8";
+    [StubURLProtocol setResponseWithStatusCode:404 body:@"<html>not found</html>" delay:0 forURL:notFoundURL];
+    [StubURLProtocol setResponseWithStatusCode:503 body:@"<html>unavailable</html>" delay:0 forURL:unavailableURL];
+    
+    [self startDownloadWithURL:notFoundURL priority:ManifestDownloadPriority_Normal deadline:0];
+    [self startDownloadWithURL:unavailableURL priority:ManifestDownloadPriority_Normal deadline:0];
+    
+    STAssertTrue([self waitForDownloads:5.0], @"completion not called");
+    STAssertNil([manifestsByURL objectForKey:notFoundURL], @"error page returned as a manifest");
+    STAssertNil([manifestsByURL objectForKey:unavailableURL], @"error page returned as a manifest");
+    STAssertEquals([[errorsByURL objectForKey:notFoundURL] code], (NSInteger)404, @"wrong error code");
+    STAssertEquals([[errorsByURL objectForKey:unavailableURL] code], (NSInteger)503, @"wrong error code");
+}
+
+- (void) testSynchronousDownloadReturnsHTTPError
+{
+    NSString *manifest = nil;
+    NSError *error = nil;
+    
+    STAssertFalse([manager downloadManifest:&manifest withURL:[NSURL URLWithString:@"http://cdn.test/unknown.m3u8"] priority:ManifestDownloadPriority_Normal deadline:2.0 error:&error], @"404 returned as success");
+    STAssertNil(manifest, @"error page returned as a manifest");
+    STAssertEquals([error code], (NSInteger)404, @"wrong error code");
+}
+
+- (void) testCancelledDownloadGetsCancelledError
+{
+    NSString *url = @"http://slow.test/main.m3u8";
+    [self serveURL:url delay:3.0];
+    
+    ManifestDownloadRequest *request = [self startDownloadWithURL:url priority:ManifestDownloadPriority_Normal deadline:0];
+    [request cancel];
+    
+    STAssertTrue([self waitForDownloads:2.0], @"completion not called after cancel");
+    STAssertEquals([[errorsByURL objectForKey:url] code], (NSInteger)NSURLErrorCancelled, @"wrong error for cancel");
+}
+
+@end
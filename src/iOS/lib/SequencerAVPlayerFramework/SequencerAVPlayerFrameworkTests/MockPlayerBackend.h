@@ -0,0 +1,52 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+#import "PlayerBackend.h"
+
+//
+// Player of the MockPlayerBackend which only remembers the URL loaded into it
+//
+@interface MockPlayer : NSObject
+{
+@private
+    NSURL *url;
+    NSUInteger loadCount;
+    NSUInteger clearCount;
+}
+
+@property(nonatomic, retain) NSURL *url;
+@property(nonatomic, assign) NSUInteger loadCount;
+@property(nonatomic, assign) NSUInteger clearCount;
+
+@end
+
+//
+// Player backend for the tests which creates mock players instead of AVPlayers and counts
+// the calls of the pool.
+//
+@interface MockPlayerBackend : NSObject <PlayerBackend>
+{
+@private
+    NSMutableArray *players;
+    NSMutableArray *loadedURLs;
+    NSUInteger clearCount;
+}
+
+@property(nonatomic, readonly) NSArray *players;
+@property(nonatomic, readonly) NSArray *loadedURLs;
+@property(nonatomic, readonly) NSUInteger clearCount;
+
+@end
@@ -0,0 +1,101 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "MockPlayerBackend.h"
+
+@implementation MockPlayer
+
+@synthesize url;
+@synthesize loadCount;
+@synthesize clearCount;
+
+- (void) dealloc
+{
+    [url release];
+    
+    [super dealloc];
+}
+
+@end
+
+@implementation MockPlayerBackend
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize clearCount;
+
+- (NSArray *) players
+{
+    return players;
+}
+
+- (NSArray *) loadedURLs
+{
+    return loadedURLs;
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+- (id) init
+{
+    self = [super init];
+    
+    if (self){
+        players = [[NSMutableArray alloc] init];
+        loadedURLs = [[NSMutableArray alloc] init];
+        clearCount = 0;
+    }
+    
+    return self;
+}
+
+- (id) newPlayer
+{
+    MockPlayer *player = [[MockPlayer alloc] init];
+    [players addObject:player];
+    
+    return player;
+}
+
+- (void) loadURL:(NSURL *)url intoPlayer:(id)player
+{
+    MockPlayer *mockPlayer = (MockPlayer *)player;
+    mockPlayer.url = url;
+    ++mockPlayer.loadCount;
+    [loadedURLs addObject:url];
+}
+
+- (void) clearPlayer:(id)player
+{
+    MockPlayer *mockPlayer = (MockPlayer *)player;
+    mockPlayer.url = nil;
+    ++mockPlayer.clearCount;
+    ++clearCount;
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [players release];
+    [loadedURLs release];
+    
+    [super dealloc];
+}
+
+@end
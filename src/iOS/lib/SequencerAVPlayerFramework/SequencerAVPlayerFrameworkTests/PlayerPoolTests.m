@@ -0,0 +1,208 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <SenTestingKit/SenTestingKit.h>
+#import "PlayerPool.h"
+#import "MockPlayerBackend.h"
+
+//
+// Tests of the leasing, reuse, readiness and preloading of the PlayerPool against a mock
+// backend. The backend keeps every player it created, so the tests can check which players
+// the pool reused.
+//
+@interface PlayerPoolTests : SenTestCase
+{
+@private
+    MockPlayerBackend *backend;
+    PlayerPool *pool;
+}
+
+@end
+
+@implementation PlayerPoolTests
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+- (NSURL *) clipURL:(NSString *)name
+{
+    return [NSURL URLWithString:[NSString stringWithFormat:@"http://media.test/%@.m3u8", name]];
+}
+
+#pragma mark -
+#pragma mark Test setup:
+
+- (void) setUp
+{
+    [super setUp];
+    
+    backend = [[MockPlayerBackend alloc] init];
+    pool = [[PlayerPool alloc] initWithBackend:backend warmCount:1];
+}
+
+- (void) tearDown
+{
+    [pool release];
+    pool = nil;
+    [backend release];
+    backend = nil;
+    
+    [super tearDown];
+}
+
+#pragma mark -
+#pragma mark Tests:
+
+- (void) testWarmUpCreatesWarmCountIdlePlayers
+{
+    pool.warmCount = 2;
+    [pool warmUp];
+    
+    STAssertEquals([backend.players count], (NSUInteger)2, @"the backend should create warmCount players");
+    STAssertEquals(pool.createdCount, (NSUInteger)2, @"the pool should count the players it created");
+    STAssertEquals(pool.idleCount, (NSUInteger)2, @"the warm players should be idle");
+    STAssertEquals([backend.loadedURLs count], (NSUInteger)0, @"the warm players should not load anything");
+    
+    [pool warmUp];
+    STAssertEquals(pool.createdCount, (NSUInteger)2, @"warming up a warm pool should not create players");
+}
+
+- (void) testAcquireReusesAWarmPlayer
+{
+    [pool warmUp];
+    MockPlayer *warmPlayer = [backend.players objectAtIndex:0];
+    
+    id player = [pool acquirePlayerWithURL:[self clipURL:@"ad1"]];
+    
+    STAssertTrue(player == warmPlayer, @"the warm player should be leased");
+    STAssertEquals(pool.createdCount, (NSUInteger)1, @"no player should be created");
+    STAssertEquals(pool.reusedCount, (NSUInteger)1, @"the lease should count as a reuse");
+    STAssertEqualObjects(warmPlayer.url, [self clipURL:@"ad1"], @"the URL should be loaded into the warm player");
+    STAssertEquals(pool.leasedCount, (NSUInteger)1, @"the player should be leased");
+    STAssertEquals(pool.idleCount, (NSUInteger)0, @"no player should be idle");
+    STAssertEquals([pool stateOfPlayer:player], PlayerPoolState_Loading, @"a leased player should be loading");
+}
+
+- (void) testAcquireGrowsThePoolWhenAllPlayersAreLeased
+{
+    [pool warmUp];
+    
+    id first = [pool acquirePlayerWithURL:[self clipURL:@"ad1"]];
+    id second = [pool acquirePlayerWithURL:[self clipURL:@"content"]];
+    
+    STAssertTrue(first != second, @"a leased player should not be leased twice");
+    STAssertEquals(pool.createdCount, (NSUInteger)2, @"the pool should grow by one player");
+    STAssertEquals(pool.leasedCount, (NSUInteger)2, @"both players should be leased");
+}
+
+- (void) testRelinquishedPlayersAreClearedAndReused
+{
+    id first = [pool acquirePlayerWithURL:[self clipURL:@"ad1"]];
+    [pool relinquishPlayer:first];
+    
+    STAssertEquals(backend.clearCount, (NSUInteger)1, @"the relinquished player should be cleared");
+    STAssertNil(((MockPlayer *)first).url, @"the relinquished player should not keep its item");
+    STAssertEquals(pool.idleCount, (NSUInteger)1, @"the relinquished player should be kept idle");
+    
+    id second = [pool acquirePlayerWithURL:[self clipURL:@"content"]];
+    
+    STAssertTrue(first == second, @"the relinquished player should be reused");
+    STAssertEquals(pool.createdCount, (NSUInteger)1, @"no player should be created for the second clip");
+    STAssertEquals(((MockPlayer *)second).loadCount, (NSUInteger)2, @"the player should load both clips");
+    STAssertEqualObjects(((MockPlayer *)second).url, [self clipURL:@"content"], @"the player should play the second clip");
+}
+
+- (void) testRelinquishKeepsOnlyWarmCountIdlePlayers
+{
+    NSMutableArray *players = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 3; ++i)
+    {
+        [players addObject:[pool acquirePlayerWithURL:[self clipURL:[NSString stringWithFormat:@"ad%u", (unsigned)i]]]];
+    }
+    STAssertEquals(pool.createdCount, (NSUInteger)3, @"a player should be created for each lease");
+    
+    for (id player in players)
+    {
+        [pool relinquishPlayer:player];
+    }
+    
+    STAssertEquals(backend.clearCount, (NSUInteger)3, @"every relinquished player should be cleared");
+    STAssertEquals(pool.idleCount, (NSUInteger)1, @"only warmCount idle players should be kept");
+    STAssertEquals(pool.leasedCount, (NSUInteger)0, @"no player should be leased");
+    
+    pool.warmCount = 0;
+    STAssertEquals(pool.idleCount, (NSUInteger)0, @"lowering warmCount should drain the idle players");
+}
+
+- (void) testReadinessIsTrackedForLeasedPlayers
+{
+    id player = [pool acquirePlayerWithURL:[self clipURL:@"ad1"]];
+    STAssertFalse([pool isPlayerReady:player], @"a loading player should not be ready");
+    
+    [pool setState:PlayerPoolState_Ready forPlayer:player];
+    STAssertTrue([pool isPlayerReady:player], @"the player should be ready");
+    
+    [pool setState:PlayerPoolState_Failed forPlayer:player];
+    STAssertEquals([pool stateOfPlayer:player], PlayerPoolState_Failed, @"the player should have failed");
+    
+    [pool relinquishPlayer:player];
+    STAssertEquals([pool stateOfPlayer:player], PlayerPoolState_Warm, @"a relinquished player should be warm");
+    
+    [pool setState:PlayerPoolState_Ready forPlayer:player];
+    STAssertEquals([pool stateOfPlayer:player], PlayerPoolState_Warm, @"the state of an idle player should not change");
+    
+    MockPlayer *stranger = [[[MockPlayer alloc] init] autorelease];
+    STAssertEquals([pool stateOfPlayer:stranger], PlayerPoolState_Warm, @"a player not in the pool should be warm");
+    STAssertFalse([pool isPlayerReady:stranger], @"a player not in the pool should not be ready");
+}
+
+- (void) testPreloadsFollowTheListOfURLs
+{
+    [pool preloadURLs:[NSArray arrayWithObjects:[self clipURL:@"ad1"], [self clipURL:@"ad2"], nil]];
+    
+    STAssertEquals(pool.leasedCount, (NSUInteger)2, @"a player should be leased for each preload");
+    STAssertEquals([backend.loadedURLs count], (NSUInteger)2, @"both URLs should start loading");
+    
+    MockPlayer *ad2Player = nil;
+    for (MockPlayer *player in backend.players)
+    {
+        if ([player.url isEqual:[self clipURL:@"ad2"]])
+        {
+            ad2Player = player;
+        }
+    }
+    STAssertNotNil(ad2Player, @"ad2 should be preloaded");
+    
+    [pool preloadURLs:[NSArray arrayWithObjects:[self clipURL:@"ad2"], [self clipURL:@"content"], nil]];
+    
+    STAssertEquals(backend.clearCount, (NSUInteger)1, @"the preload of ad1 should be cancelled");
+    STAssertEquals(ad2Player.loadCount, (NSUInteger)1, @"ad2 should not be loaded again");
+    STAssertEquals([backend.loadedURLs count], (NSUInteger)3, @"only the new URL should start loading");
+    STAssertEquals(pool.createdCount, (NSUInteger)2, @"the cancelled player should load the new URL");
+    STAssertEquals(pool.leasedCount, (NSUInteger)2, @"two preloads should be leased");
+    
+    id taken = [pool takePreloadedPlayerForURL:[self clipURL:@"ad2"]];
+    STAssertTrue(taken == ad2Player, @"the preloaded player should be taken");
+    STAssertNil([pool takePreloadedPlayerForURL:[self clipURL:@"ad2"]], @"a preloaded player should be taken once");
+    STAssertNil([pool takePreloadedPlayerForURL:[self clipURL:@"ad1"]], @"a cancelled preload should not be taken");
+    
+    [pool cancelPreloads];
+    
+    STAssertEquals(pool.leasedCount, (NSUInteger)1, @"the taken player should stay leased");
+    STAssertEqualObjects(ad2Player.url, [self clipURL:@"ad2"], @"the taken player should keep its item");
+    STAssertEquals(backend.clearCount, (NSUInteger)2, @"the remaining preload should be cancelled");
+}
+
+@end
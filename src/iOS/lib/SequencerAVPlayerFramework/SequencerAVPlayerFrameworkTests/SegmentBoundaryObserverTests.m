@@ -0,0 +1,214 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <SenTestingKit/SenTestingKit.h>
+#import "SegmentBoundaryObserver.h"
+#import "SimulatedPlaybackClock.h"
+
+//
+// Tests of the transition timing of the SegmentBoundaryObserver against a simulated clock.
+// The blocks run on a serial queue and record the boundaries they were called for with the
+// time of the clock. The clock waits for the blocks it fires, and the tests wait for the queue
+// before checking the blocks the observer dispatches itself.
+//
+@interface SegmentBoundaryObserverTests : SenTestCase
+{
+@private
+    SimulatedPlaybackClock *clock;
+    dispatch_queue_t queue;
+    SegmentBoundaryObserver *boundaryObserver;
+    NSMutableArray *events;
+}
+
+@end
+
+@implementation SegmentBoundaryObserverTests
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+- (dispatch_block_t) blockRecordingEvent:(NSString *)name
+{
+    NSMutableArray *recordedEvents = events;
+    SimulatedPlaybackClock *recordingClock = clock;
+    
+    return [[^{
+        [recordedEvents addObject:[NSString stringWithFormat:@"%@@%.1f", name, recordingClock.currentTime]];
+    } copy] autorelease];
+}
+
+- (void) armWithEndTime:(NSTimeInterval)endTime preloadLeadTime:(NSTimeInterval)leadTime
+{
+    [boundaryObserver armWithEndTime:endTime
+                     preloadLeadTime:leadTime
+                        preloadBlock:[self blockRecordingEvent:@"preload"]
+                            endBlock:[self blockRecordingEvent:@"end"]];
+}
+
+- (void) advanceToTime:(NSTimeInterval)time
+{
+    [clock advanceToTime:time];
+    dispatch_sync(queue, ^{});
+}
+
+#pragma mark -
+#pragma mark Test setup:
+
+- (void) setUp
+{
+    [super setUp];
+    
+    clock = [[SimulatedPlaybackClock alloc] init];
+    queue = dispatch_queue_create("SegmentBoundaryObserverTests", DISPATCH_QUEUE_SERIAL);
+    boundaryObserver = [[SegmentBoundaryObserver alloc] initWithClock:clock queue:queue];
+    events = [[NSMutableArray alloc] init];
+}
+
+- (void) tearDown
+{
+    [boundaryObserver release];
+    boundaryObserver = nil;
+    dispatch_sync(queue, ^{});
+    dispatch_release(queue);
+    queue = NULL;
+    [clock release];
+    clock = nil;
+    [events release];
+    events = nil;
+    
+    [super tearDown];
+}
+
+#pragma mark -
+#pragma mark Tests:
+
+- (void) testBoundariesFireWhenTheClockReachesThem
+{
+    [self armWithEndTime:30.0 preloadLeadTime:5.0];
+    
+    STAssertEquals(clock.pendingCount, (NSUInteger)2, @"the preload point and the end should be armed");
+    STAssertEqualsWithAccuracy([clock timeOfPendingObserverAtIndex:0], 25.0, 0.0001, @"the preload point should be leadTime before the end");
+    STAssertEqualsWithAccuracy([clock timeOfPendingObserverAtIndex:1], 30.0, 0.0001, @"the end should be armed at the end time");
+    
+    [self advanceToTime:24.9];
+    STAssertEquals([events count], (NSUInteger)0, @"no boundary should fire before the preload point");
+    
+    [self advanceToTime:25.0];
+    STAssertEqualObjects(events, [NSArray arrayWithObject:@"preload@25.0"], @"the preload should fire at the preload point");
+    
+    [self advanceToTime:29.9];
+    STAssertEquals([events count], (NSUInteger)1, @"the end should not fire before the end time");
+    
+    [self advanceToTime:30.0];
+    NSArray *expected = [NSArray arrayWithObjects:@"preload@25.0", @"end@30.0", nil];
+    STAssertEqualObjects(events, expected, @"the end should fire at the end time");
+    STAssertEquals(clock.pendingCount, (NSUInteger)0, @"the boundaries should fire once");
+    
+    [self advanceToTime:60.0];
+    STAssertEqualObjects(events, expected, @"the boundaries should not fire again");
+}
+
+- (void) testBoundariesPassedInOneStepFireInOrder
+{
+    clock.currentTime = 10.0;
+    [self armWithEndTime:30.0 preloadLeadTime:5.0];
+    
+    // a seek or a stall can carry the clock past both boundaries at once
+    [self advanceToTime:45.0];
+    
+    NSArray *expected = [NSArray arrayWithObjects:@"preload@25.0", @"end@30.0", nil];
+    STAssertEqualObjects(events, expected, @"the preload should fire before the end");
+    STAssertEqualsWithAccuracy(clock.currentTime, 45.0, 0.0001, @"the clock should end at the time it was advanced to");
+}
+
+- (void) testPassedPreloadPointIsReportedAtOnce
+{
+    clock.currentTime = 27.0;
+    [self armWithEndTime:30.0 preloadLeadTime:5.0];
+    dispatch_sync(queue, ^{});
+    
+    STAssertEqualObjects(events, [NSArray arrayWithObject:@"preload@27.0"], @"a passed preload point should be reported without advancing the clock");
+    STAssertEquals(clock.pendingCount, (NSUInteger)1, @"only the end should be armed");
+    
+    [self advanceToTime:30.0];
+    NSArray *expected = [NSArray arrayWithObjects:@"preload@27.0", @"end@30.0", nil];
+    STAssertEqualObjects(events, expected, @"the end should still fire at the end time");
+}
+
+- (void) testPassedEndIsLeftToTheCaller
+{
+    clock.currentTime = 31.0;
+    [boundaryObserver armWithEndTime:30.0 preloadLeadTime:5.0 preloadBlock:nil endBlock:[self blockRecordingEvent:@"end"]];
+    
+    STAssertEquals(clock.addedCount, (NSUInteger)0, @"no boundary should be armed for a passed end");
+    
+    [self advanceToTime:60.0];
+    STAssertEquals([events count], (NSUInteger)0, @"the end block should not be called for a passed end");
+}
+
+- (void) testNilPreloadBlockArmsOnlyTheEnd
+{
+    [boundaryObserver armWithEndTime:30.0 preloadLeadTime:5.0 preloadBlock:nil endBlock:[self blockRecordingEvent:@"end"]];
+    
+    STAssertEquals(clock.pendingCount, (NSUInteger)1, @"only the end should be armed");
+    
+    [self advanceToTime:30.0];
+    STAssertEqualObjects(events, [NSArray arrayWithObject:@"end@30.0"], @"only the end should fire");
+}
+
+- (void) testArmingReplacesTheBoundariesOfThePreviousSegment
+{
+    [self armWithEndTime:30.0 preloadLeadTime:5.0];
+    [boundaryObserver armWithEndTime:50.0
+                     preloadLeadTime:2.0
+                        preloadBlock:[self blockRecordingEvent:@"next preload"]
+                            endBlock:[self blockRecordingEvent:@"next end"]];
+    
+    STAssertEquals(clock.removedCount, (NSUInteger)2, @"the boundaries of the previous segment should be removed");
+    STAssertEquals(clock.pendingCount, (NSUInteger)2, @"only the boundaries of the new segment should be armed");
+    
+    [self advanceToTime:50.0];
+    NSArray *expected = [NSArray arrayWithObjects:@"next preload@48.0", @"next end@50.0", nil];
+    STAssertEqualObjects(events, expected, @"only the boundaries of the new segment should fire");
+}
+
+- (void) testDisarmRemovesThePendingBoundaries
+{
+    [self armWithEndTime:30.0 preloadLeadTime:5.0];
+    [self advanceToTime:26.0];
+    [boundaryObserver disarm];
+    
+    STAssertEquals(clock.pendingCount, (NSUInteger)0, @"the end should be removed");
+    
+    [self advanceToTime:60.0];
+    STAssertEqualObjects(events, [NSArray arrayWithObject:@"preload@25.0"], @"the end should not fire after disarm");
+    
+    [boundaryObserver disarm];
+    STAssertEquals(clock.removedCount, (NSUInteger)2, @"disarming twice should not remove the boundaries again");
+}
+
+- (void) testReleasingTheObserverDisarmsIt
+{
+    [self armWithEndTime:30.0 preloadLeadTime:5.0];
+    [boundaryObserver release];
+    boundaryObserver = nil;
+    
+    STAssertEquals(clock.pendingCount, (NSUInteger)0, @"the boundaries should be removed when the observer is released");
+    
+    [self advanceToTime:60.0];
+    STAssertEquals([events count], (NSUInteger)0, @"no boundary should fire after the observer is released");
+}
+
+@end
@@ -0,0 +1,207 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <SenTestingKit/SenTestingKit.h>
+#import "Sequencer.h"
+#import "Scheduler.h"
+#import "SeekbarTime.h"
+#import "MediaTime.h"
+#import "PlaybackSegment.h"
+#import "StubEngineHost.h"
+
+static NSString * const MediaToSeekbarTimeResult = @"{\"currentSeekbarPosition\": 10, \"minSeekbarPosition\": 0, \"maxSeekbarPosition\": 100, "
+                                                    "\"playbackPolicy\": \"policy\", \"playbackRangeExceeded\": false, \"status\": \"ok\"}";
+static NSString * const SeekbarMappingResult = @"{\"seekbarOffset\": 5, \"minSeekbarPosition\": 0, \"maxSeekbarPosition\": 100, \"isClampedToRange\": true, "
+                                                "\"playbackPolicy\": \"policy\", \"clipBeginMediaTime\": 0, \"clipEndMediaTime\": 90, \"isLiveWindowApplied\": false}";
+
+//
+// Tests of the native seekbar mapping of the Sequencer. The engine host is stubbed, so the tests
+// count the mediaToSeekbarTime calls to see when the mapping is used instead of JavaScript.
+//
+@interface SequencerSeekbarMappingTests : SenTestCase
+{
+@private
+    StubEngineHost *engineHost;
+    Sequencer *sequencer;
+    PlaybackSegment *segment;
+    MediaTime *mediaTime;
+    SeekbarTime *seekbarTime;
+}
+
+@end
+
+@implementation SequencerSeekbarMappingTests
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+- (BOOL) getSeekbarTimeAtPosition:(NSTimeInterval)position
+{
+    NSString *policy = nil;
+    BOOL rangeExceeded = NO;
+    
+    mediaTime.currentPlaybackPosition = position;
+    return [sequencer updateSeekbarTime:seekbarTime andPlaybackPolicy:&policy withMediaTime:mediaTime playbackRate:1.0 currentSegment:segment playbackRangeExceeded:&rangeExceeded];
+}
+
+#pragma mark -
+#pragma mark Test setup:
+
+- (void) setUp
+{
+    [super setUp];
+    
+    engineHost = [[StubEngineHost alloc] init];
+    [engineHost setResult:@"false" forScriptContaining:@"isClipChanged"];
+    [engineHost setResult:MediaToSeekbarTimeResult forScriptContaining:@"mediaToSeekbarTime"];
+    [engineHost setResult:SeekbarMappingResult forScriptContaining:@"getSeekbarMapping"];
+    [engineHost setResult:@"{\"entries\": []}" forScriptContaining:@"getEntriesInRange"];
+    [engineHost setResult:@"{\"version\": 3, \"isComplete\": true, \"changes\": []}" forScriptContaining:@"getPlaylistChanges"];
+    [engineHost setResult:@"true" forScriptContaining:@"removeClip"];
+    
+    sequencer = [[Sequencer alloc] initWithEngineHost:engineHost];
+    segment = [[PlaybackSegment alloc] init];
+    segment.segmentId = 1;
+    mediaTime = [[MediaTime alloc] init];
+    mediaTime.clipBeginMediaTime = 0;
+    mediaTime.clipEndMediaTime = 90;
+    seekbarTime = [[SeekbarTime alloc] init];
+}
+
+- (void) tearDown
+{
+    [seekbarTime release];
+    [mediaTime release];
+    [segment release];
+    [sequencer release];
+    [engineHost release];
+    
+    [super tearDown];
+}
+
+#pragma mark -
+#pragma mark Tests:
+
+- (void) testFirstCallExportsMapping
+{
+    STAssertTrue([self getSeekbarTimeAtPosition:5], @"getSeekbarTime failed");
+    STAssertEquals([engineHost countOfScriptsContaining:@"mediaToSeekbarTime"], (NSUInteger)1, @"mediaToSeekbarTime not called");
+    STAssertEquals([engineHost countOfScriptsContaining:@"getSeekbarMapping"], (NSUInteger)1, @"mapping not exported");
+    STAssertEqualsWithAccuracy(seekbarTime.currentSeekbarPosition, 10.0, 0.001, @"wrong seekbar position");
+}
+
+- (void) testMappingIsUsedForLaterCalls
+{
+    STAssertTrue([self getSeekbarTimeAtPosition:5], @"getSeekbarTime failed");
+    
+    for (int i = 0; i < 10; ++i)
+    {
+        STAssertTrue([self getSeekbarTimeAtPosition:(10 + i)], @"getSeekbarTime failed");
+        STAssertEqualsWithAccuracy(seekbarTime.currentSeekbarPosition, 15.0 + i, 0.001, @"mapping offset not applied");
+        STAssertEqualsWithAccuracy(seekbarTime.maxSeekbarPosition, 100.0, 0.001, @"wrong seekbar range");
+    }
+    STAssertEquals([engineHost countOfScriptsContaining:@"mediaToSeekbarTime"], (NSUInteger)1, @"mapping not used");
+}
+
+- (void) testMappingIsClampedToRange
+{
+    [engineHost setResult:[SeekbarMappingResult stringByReplacingOccurrencesOfString:@"\"seekbarOffset\": 5" withString:@"\"seekbarOffset\": 50"]
+      forScriptContaining:@"getSeekbarMapping"];
+    
+    STAssertTrue([self getSeekbarTimeAtPosition:5], @"getSeekbarTime failed");
+    STAssertTrue([self getSeekbarTimeAtPosition:80], @"getSeekbarTime failed");
+    STAssertEqualsWithAccuracy(seekbarTime.currentSeekbarPosition, 100.0, 0.001, @"position not clamped");
+    STAssertEquals([engineHost countOfScriptsContaining:@"mediaToSeekbarTime"], (NSUInteger)1, @"mapping not used");
+}
+
+- (void) testPositionOutsideClipCallsSequencer
+{
+    STAssertTrue([self getSeekbarTimeAtPosition:5], @"getSeekbarTime failed");
+    STAssertTrue([self getSeekbarTimeAtPosition:95], @"getSeekbarTime failed");
+    STAssertEquals([engineHost countOfScriptsContaining:@"mediaToSeekbarTime"], (NSUInteger)2, @"range exceeded not left to the sequencer");
+}
+
+- (void) testSegmentChangeInvalidatesMapping
+{
+    STAssertTrue([self getSeekbarTimeAtPosition:5], @"getSeekbarTime failed");
+    segment.segmentId = 2;
+    STAssertTrue([self getSeekbarTimeAtPosition:6], @"getSeekbarTime failed");
+    STAssertEquals([engineHost countOfScriptsContaining:@"mediaToSeekbarTime"], (NSUInteger)2, @"mapping of another segment used");
+}
+
+- (void) testSchedulerChangeInvalidatesMapping
+{
+    STAssertTrue([self getSeekbarTimeAtPosition:5], @"getSeekbarTime failed");
+    STAssertTrue([sequencer.scheduler cancelClip:7], @"cancelClip failed");
+    STAssertTrue([self getSeekbarTimeAtPosition:6], @"getSeekbarTime failed");
+    STAssertEquals([engineHost countOfScriptsContaining:@"mediaToSeekbarTime"], (NSUInteger)2, @"mapping kept after a playlist change");
+}
+
+- (void) testSchedulerQueriesKeepMapping
+{
+    NSArray *entries = nil;
+    NSArray *changes = nil;
+    int32_t version = 0;
+    BOOL isComplete = NO;
+    
+    STAssertTrue([self getSeekbarTimeAtPosition:5], @"getSeekbarTime failed");
+    STAssertTrue([sequencer.scheduler getEntries:&entries ofType:PlaylistEntryType_VAST inRangeFrom:0 to:30], @"getEntries failed");
+    STAssertTrue([sequencer.scheduler getPlaylistChanges:&changes sinceVersion:0 currentVersion:&version isComplete:&isComplete], @"getPlaylistChanges failed");
+    STAssertTrue([self getSeekbarTimeAtPosition:6], @"getSeekbarTime failed");
+    STAssertEquals([engineHost countOfScriptsContaining:@"mediaToSeekbarTime"], (NSUInteger)1, @"mapping dropped after a read-only query");
+}
+
+- (void) testFailedCallDoesNotExportMapping
+{
+    [engineHost setResult:@"" forScriptContaining:@"mediaToSeekbarTime"];
+    
+    STAssertFalse([self getSeekbarTimeAtPosition:5], @"empty result not reported");
+    STAssertEquals([engineHost countOfScriptsContaining:@"getSeekbarMapping"], (NSUInteger)0, @"mapping exported after a failure");
+    STAssertEquals((NSInteger)sequencer.lastError.code, (NSInteger)SequencerErrorCode_Unexpected, @"wrong error");
+}
+
+- (void) testDvrTakeoverReturnsSharedError
+{
+    NSString *policy = nil;
+    BOOL rangeExceeded = NO;
+    
+    [engineHost setResult:[MediaToSeekbarTimeResult stringByReplacingOccurrencesOfString:@"\"ok\"" withString:@"\"dvrTakeover\""]
+      forScriptContaining:@"mediaToSeekbarTime"];
+    
+    STAssertFalse([sequencer updateSeekbarTime:seekbarTime andPlaybackPolicy:&policy withMediaTime:mediaTime playbackRate:1.0 currentSegment:segment playbackRangeExceeded:&rangeExceeded leftDvrEdge:20 livePosition:80 liveEnded:NO], @"DVR takeover not reported");
+    NSError *firstError = [[sequencer.lastError retain] autorelease];
+    STAssertFalse([sequencer updateSeekbarTime:seekbarTime andPlaybackPolicy:&policy withMediaTime:mediaTime playbackRate:1.0 currentSegment:segment playbackRangeExceeded:&rangeExceeded leftDvrEdge:20 livePosition:80 liveEnded:NO], @"DVR takeover not reported");
+    
+    STAssertEqualObjects(firstError.domain, SequencerErrorDomain, @"wrong error domain");
+    STAssertEquals((NSInteger)firstError.code, (NSInteger)SequencerErrorCode_DvrTakeover, @"wrong error code");
+    STAssertTrue(firstError == sequencer.lastError, @"DVR takeover error created for each call");
+    STAssertEquals([engineHost countOfScriptsContaining:@"getSeekbarMapping"], (NSUInteger)0, @"mapping exported for a DVR takeover");
+}
+
+- (void) testGetSeekbarTimeReturnsRetainedCopy
+{
+    SeekbarTime *value = nil;
+    NSString *policy = nil;
+    BOOL rangeExceeded = NO;
+    
+    mediaTime.currentPlaybackPosition = 5;
+    STAssertTrue([sequencer getSeekbarTime:&value andPlaybackPolicy:&policy withMediaTime:mediaTime playbackRate:1.0 currentSegment:segment playbackRangeExceeded:&rangeExceeded], @"getSeekbarTime failed");
+    STAssertNotNil(value, @"no seekbar time");
+    STAssertEqualsWithAccuracy(value.currentSeekbarPosition, 10.0, 0.001, @"wrong seekbar position");
+    STAssertEqualObjects(policy, @"policy", @"wrong playback policy");
+    [value release];
+}
+
+@end
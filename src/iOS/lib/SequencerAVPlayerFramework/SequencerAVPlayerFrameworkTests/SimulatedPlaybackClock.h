@@ -0,0 +1,41 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+#import "PlaybackClock.h"
+
+//
+// Playback clock for the tests which only moves when it is advanced. Advancing it calls the
+// boundary observers it passes in time order on their queues, each one once like the boundary
+// observers of AVPlayer, and waits for them to return.
+//
+@interface SimulatedPlaybackClock : NSObject <PlaybackClock>
+{
+@private
+    NSTimeInterval currentTime;
+    NSMutableArray *pendingObservers;
+    NSUInteger addedCount;
+    NSUInteger removedCount;
+}
+
+@property(nonatomic, assign) NSTimeInterval currentTime;
+@property(nonatomic, readonly) NSUInteger pendingCount;
+@property(nonatomic, readonly) NSUInteger addedCount;
+@property(nonatomic, readonly) NSUInteger removedCount;
+
+- (void) advanceToTime:(NSTimeInterval)time;
+- (NSTimeInterval) timeOfPendingObserverAtIndex:(NSUInteger)index;
+
+@end
@@ -0,0 +1,175 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "SimulatedPlaybackClock.h"
+
+//
+// A boundary observer of the simulated clock
+//
+@interface SimulatedBoundaryObserver : NSObject
+{
+@private
+    NSTimeInterval time;
+    dispatch_queue_t queue;
+    dispatch_block_t block;
+}
+
+- (id) initWithTime:(NSTimeInterval)aTime queue:(dispatch_queue_t)aQueue block:(dispatch_block_t)aBlock;
+- (void) fire;
+
+@property(nonatomic, readonly) NSTimeInterval time;
+
+@end
+
+@implementation SimulatedBoundaryObserver
+
+@synthesize time;
+
+- (id) initWithTime:(NSTimeInterval)aTime queue:(dispatch_queue_t)aQueue block:(dispatch_block_t)aBlock
+{
+    self = [super init];
+    
+    if (self){
+        time = aTime;
+        queue = aQueue;
+        dispatch_retain(queue);
+        block = [aBlock copy];
+    }
+    
+    return self;
+}
+
+- (void) fire
+{
+    dispatch_sync(queue, block);
+}
+
+- (void) dealloc
+{
+    dispatch_release(queue);
+    [block release];
+    
+    [super dealloc];
+}
+
+@end
+
+@implementation SimulatedPlaybackClock
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize currentTime;
+@synthesize addedCount;
+@synthesize removedCount;
+
+- (NSUInteger) pendingCount
+{
+    return [pendingObservers count];
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+- (id) init
+{
+    self = [super init];
+    
+    if (self){
+        currentTime = 0;
+        pendingObservers = [[NSMutableArray alloc] init];
+        addedCount = 0;
+        removedCount = 0;
+    }
+    
+    return self;
+}
+
+- (id) addBoundaryObserverAtTime:(NSTimeInterval)time queue:(dispatch_queue_t)queue usingBlock:(dispatch_block_t)block
+{
+    SimulatedBoundaryObserver *observer = [[SimulatedBoundaryObserver alloc] initWithTime:time queue:queue block:block];
+    [pendingObservers addObject:observer];
+    [observer release];
+    ++addedCount;
+    
+    return observer;
+}
+
+- (void) removeBoundaryObserver:(id)observer
+{
+    // like AVPlayer, removing an observer which already fired is allowed
+    [pendingObservers removeObjectIdenticalTo:observer];
+    ++removedCount;
+}
+
+//
+// move the clock forward, firing the observers of the times it passes in time order. Each
+// observer is called with the clock at its time and waited for, so this must not be called
+// on the queue of an observer.
+//
+// Arguments:
+// [time]: the new current time, the clock does not move back
+//
+// Returns: none
+//
+- (void) advanceToTime:(NSTimeInterval)time
+{
+    while (YES)
+    {
+        SimulatedBoundaryObserver *next = nil;
+        for (SimulatedBoundaryObserver *observer in pendingObservers)
+        {
+            if (observer.time <= time && (nil == next || observer.time < next.time))
+            {
+                next = observer;
+            }
+        }
+        
+        if (nil == next)
+        {
+            break;
+        }
+        
+        [[next retain] autorelease];
+        [pendingObservers removeObjectIdenticalTo:next];
+        if (currentTime < next.time)
+        {
+            currentTime = next.time;
+        }
+        [next fire];
+    }
+    
+    if (currentTime < time)
+    {
+        currentTime = time;
+    }
+}
+
+- (NSTimeInterval) timeOfPendingObserverAtIndex:(NSUInteger)index
+{
+    return [(SimulatedBoundaryObserver *)[pendingObservers objectAtIndex:index] time];
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [pendingObservers release];
+    
+    [super dealloc];
+}
+
+@end
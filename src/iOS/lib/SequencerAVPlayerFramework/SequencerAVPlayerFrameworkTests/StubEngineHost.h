@@ -0,0 +1,39 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+#import "JavaScriptEngineHost.h"
+
+//
+// Engine host for the tests which returns canned results instead of running the core scripts.
+// A script gets the result of the first fragment it contains, and an empty string, which the
+// Sequencer treats as an unexpected JavaScript error, if it contains none of them.
+//
+@interface StubEngineHost : NSObject <JavaScriptEngineHost>
+{
+@private
+    NSMutableArray *fragments;
+    NSMutableArray *results;
+    NSMutableArray *scripts;
+    uint32_t evaluationCount;
+    NSTimeInterval evaluationTime;
+}
+
+@property(nonatomic, readonly) NSArray *scripts;
+
+- (void) setResult:(NSString *)result forScriptContaining:(NSString *)fragment;
+- (NSUInteger) countOfScriptsContaining:(NSString *)fragment;
+
+@end
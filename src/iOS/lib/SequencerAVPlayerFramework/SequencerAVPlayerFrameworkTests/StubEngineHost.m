@@ -0,0 +1,132 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "StubEngineHost.h"
+
+@implementation StubEngineHost
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize evaluationCount;
+@synthesize evaluationTime;
+
+- (BOOL) requiresMainThread
+{
+    return NO;
+}
+
+- (NSArray *) scripts
+{
+    return scripts;
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+- (id) init
+{
+    self = [super init];
+    
+    if (self){
+        fragments = [[NSMutableArray alloc] init];
+        results = [[NSMutableArray alloc] init];
+        scripts = [[NSMutableArray alloc] init];
+        evaluationCount = 0;
+        evaluationTime = 0;
+    }
+    
+    return self;
+}
+
+//
+// set the result of the scripts containing a fragment, replacing the result set before
+//
+// Arguments:
+// [result]: the result to return
+// [fragment]: the fragment of the script
+//
+// Returns: none
+//
+- (void) setResult:(NSString *)result forScriptContaining:(NSString *)fragment
+{
+    NSUInteger index = [fragments indexOfObject:fragment];
+    
+    if (NSNotFound == index)
+    {
+        [fragments addObject:fragment];
+        [results addObject:result];
+    }
+    else
+    {
+        [results replaceObjectAtIndex:index withObject:result];
+    }
+}
+
+//
+// count the evaluated scripts containing a fragment
+//
+// Arguments:
+// [fragment]: the fragment of the script
+//
+// Returns: the number of scripts
+//
+- (NSUInteger) countOfScriptsContaining:(NSString *)fragment
+{
+    NSUInteger count = 0;
+    
+    for (NSString *script in scripts)
+    {
+        if (NSNotFound != [script rangeOfString:fragment].location)
+        {
+            count++;
+        }
+    }
+    
+    return count;
+}
+
+- (NSString *) evaluateScript:(NSString *)script
+{
+    NSString *result = @"";
+    
+    [scripts addObject:script];
+    evaluationCount++;
+    
+    for (NSUInteger i = 0; i < [fragments count]; ++i)
+    {
+        if (NSNotFound != [script rangeOfString:[fragments objectAtIndex:i]].location)
+        {
+            result = [results objectAtIndex:i];
+            break;
+        }
+    }
+    
+    return result;
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [fragments release];
+    [results release];
+    [scripts release];
+    
+    [super dealloc];
+}
+
+@end
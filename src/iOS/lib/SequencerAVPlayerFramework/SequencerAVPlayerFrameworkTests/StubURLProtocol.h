@@ -0,0 +1,36 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+
+//
+// Local stand-in for an HTTP server in the tests. Once registered with NSURLProtocol it answers
+// every http request with the response set for its URL, after the delay set for it, and with
+// a 404 status for a URL without a response. It records the order the requests are started in
+// and the highest number of requests to a host loading at the same time.
+//
+@interface StubURLProtocol : NSURLProtocol
+{
+@private
+    BOOL isLoading;
+}
+
++ (void) reset;
++ (void) setResponseWithStatusCode:(NSInteger)statusCode body:(NSString *)body delay:(NSTimeInterval)delay forURL:(NSString *)url;
++ (NSArray *) startedURLs;
++ (NSUInteger) countOfRequestsForURL:(NSString *)url;
++ (NSUInteger) maxConcurrentRequestsForHost:(NSString *)host;
+
+@end
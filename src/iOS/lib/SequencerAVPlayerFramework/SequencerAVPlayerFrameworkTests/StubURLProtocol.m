@@ -0,0 +1,229 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "StubURLProtocol.h"
+
+// The stub state is shared by the loading threads of the URL loading system and the test
+static NSMutableDictionary *responsesByURL = nil;
+static NSMutableArray *startedURLs = nil;
+static NSMutableDictionary *loadingCountByHost = nil;
+static NSMutableDictionary *maxLoadingCountByHost = nil;
+
+//
+// The canned response for a URL
+//
+@interface StubURLResponse : NSObject
+{
+@private
+    NSInteger statusCode;
+    NSString *body;
+    NSTimeInterval delay;
+}
+
+@property(nonatomic, assign) NSInteger statusCode;
+@property(nonatomic, retain) NSString *body;
+@property(nonatomic, assign) NSTimeInterval delay;
+
+@end
+
+@implementation StubURLResponse
+
+@synthesize statusCode;
+@synthesize body;
+@synthesize delay;
+
+- (void) dealloc
+{
+    [body release];
+    
+    [super dealloc];
+}
+
+@end
+
+@implementation StubURLProtocol
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+- (void) stopCounting
+{
+    @synchronized([StubURLProtocol class])
+    {
+        if (isLoading)
+        {
+            isLoading = NO;
+            NSString *host = [[[[self request] URL] host] lowercaseString];
+            NSUInteger count = [[loadingCountByHost objectForKey:host] unsignedIntegerValue];
+            [loadingCountByHost setObject:[NSNumber numberWithUnsignedInteger:(0 < count) ? count - 1 : 0] forKey:host];
+        }
+    }
+}
+
+- (void) finishLoadingWithResponse:(StubURLResponse *)stubResponse
+{
+    [self stopCounting];
+    
+    NSHTTPURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:[[self request] URL]
+                                                              statusCode:stubResponse.statusCode
+                                                             HTTPVersion:@"HTTP/1.1"
+                                                            headerFields:[NSDictionary dictionaryWithObject:@"text/xml" forKey:@"Content-Type"]];
+    [[self client] URLProtocol:self didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+    [[self client] URLProtocol:self didLoadData:[stubResponse.body dataUsingEncoding:NSUTF8StringEncoding]];
+    [[self client] URLProtocolDidFinishLoading:self];
+    [response release];
+}
+
+#pragma mark -
+#pragma mark Public class methods:
+
++ (BOOL) canInitWithRequest:(NSURLRequest *)request
+{
+    NSString *scheme = [[[request URL] scheme] lowercaseString];
+    
+    return [scheme isEqualToString:@"http"] || [scheme isEqualToString:@"https"];
+}
+
++ (NSURLRequest *) canonicalRequestForRequest:(NSURLRequest *)request
+{
+    return request;
+}
+
+//
+// remove the responses and the recorded requests of the previous test
+//
+// Arguments: none
+//
+// Returns: none
+//
++ (void) reset
+{
+    @synchronized(self)
+    {
+        [responsesByURL release];
+        responsesByURL = [[NSMutableDictionary alloc] init];
+        [startedURLs release];
+        startedURLs = [[NSMutableArray alloc] init];
+        [loadingCountByHost release];
+        loadingCountByHost = [[NSMutableDictionary alloc] init];
+        [maxLoadingCountByHost release];
+        maxLoadingCountByHost = [[NSMutableDictionary alloc] init];
+    }
+}
+
+//
+// set the response for a URL
+//
+// Arguments:
+// [statusCode]: the HTTP status code of the response
+// [body]: the body of the response
+// [delay]: the time in seconds from the start of the request to the response
+// [url]: the URL as a string
+//
+// Returns: none
+//
++ (void) setResponseWithStatusCode:(NSInteger)statusCode body:(NSString *)body delay:(NSTimeInterval)delay forURL:(NSString *)url
+{
+    StubURLResponse *response = [[StubURLResponse alloc] init];
+    response.statusCode = statusCode;
+    response.body = body;
+    response.delay = delay;
+    
+    @synchronized(self)
+    {
+        [responsesByURL setObject:response forKey:url];
+    }
+    [response release];
+}
+
++ (NSArray *) startedURLs
+{
+    @synchronized(self)
+    {
+        return [[startedURLs copy] autorelease];
+    }
+}
+
++ (NSUInteger) countOfRequestsForURL:(NSString *)url
+{
+    NSUInteger count = 0;
+    
+    @synchronized(self)
+    {
+        for (NSString *startedURL in startedURLs)
+        {
+            if ([startedURL isEqualToString:url])
+            {
+                count++;
+            }
+        }
+    }
+    
+    return count;
+}
+
++ (NSUInteger) maxConcurrentRequestsForHost:(NSString *)host
+{
+    @synchronized(self)
+    {
+        return [[maxLoadingCountByHost objectForKey:[host lowercaseString]] unsignedIntegerValue];
+    }
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+- (void) startLoading
+{
+    NSString *url = [[[self request] URL] absoluteString];
+    NSString *host = [[[[self request] URL] host] lowercaseString];
+    StubURLResponse *response = nil;
+    
+    @synchronized([StubURLProtocol class])
+    {
+        response = [[responsesByURL objectForKey:url] retain];
+        [startedURLs addObject:url];
+        
+        NSUInteger count = [[loadingCountByHost objectForKey:host] unsignedIntegerValue] + 1;
+        [loadingCountByHost setObject:[NSNumber numberWithUnsignedInteger:count] forKey:host];
+        if ([[maxLoadingCountByHost objectForKey:host] unsignedIntegerValue] < count)
+        {
+            [maxLoadingCountByHost setObject:[NSNumber numberWithUnsignedInteger:count] forKey:host];
+        }
+        isLoading = YES;
+    }
+    
+    if (nil == response)
+    {
+        response = [[StubURLResponse alloc] init];
+        response.statusCode = 404;
+        response.body = @"";
+    }
+    
+    // The client has to be called on the loading thread, which runs its run loop while the request loads
+    [self performSelector:@selector(finishLoadingWithResponse:)
+               withObject:response
+               afterDelay:response.delay
+                  inModes:[NSArray arrayWithObject:NSRunLoopCommonModes]];
+    [response release];
+}
+
+- (void) stopLoading
+{
+    [NSObject cancelPreviousPerformRequestsWithTarget:self];
+    [self stopCounting];
+}
+
+@end
@@ -0,0 +1,233 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <SenTestingKit/SenTestingKit.h>
+#import "AdResolver.h"
+#import "AdResolver_Internal.h"
+#import "VASTWrapperResolver.h"
+#import "Ad.h"
+#import "StubEngineHost.h"
+#import "StubURLProtocol.h"
+
+static NSString * const WrapperAdFormat = @"[{\"type\": \"Wrapper\", \"parentAttrs\": {\"id\": \"%@\", \"sequence\": \"7\"}, "
+                                           "\"elements\": [{\"name\": \"VASTAdTagURI\", \"value\": \"%@\"}], \"creatives\": []}]";
+static NSString * const InLineAdFormat = @"[{\"type\": \"InLine\", \"parentAttrs\": {\"id\": \"%@\", \"sequence\": \"1\"}, "
+                                          "\"elements\": [{\"name\": \"AdTitle\", \"value\": \"%@\"}], \"creatives\": []}]";
+
+//
+// Tests of the VASTWrapperResolver against the StubURLProtocol. Each served document is a
+// marker comment the StubEngineHost recognizes, so the tests do not need the core scripts.
+//
+@interface VASTWrapperResolverTests : SenTestCase
+{
+@private
+    StubEngineHost *engineHost;
+    AdResolver *adResolver;
+    VASTWrapperResolver *wrapperResolver;
+    int32_t lastEntryId;
+}
+
+@end
+
+@implementation VASTWrapperResolverTests
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+// every document has its own host, so the per host limit of the download manager does not delay any
+- (NSString *) urlForName:(NSString *)name
+{
+    return [NSString stringWithFormat:@"http://%@.ads.test/vast.xml", name];
+}
+
+- (void) serveDocumentNamed:(NSString *)name withAdList:(NSString *)adList delay:(NSTimeInterval)delay
+{
+    NSString *marker = [NSString stringWithFormat:@"doc:%@ ", name];
+    int32_t entryId = ++lastEntryId;
+    
+    [StubURLProtocol setResponseWithStatusCode:200
+                                          body:[NSString stringWithFormat:@"<VAST version=\"3.0\"><!-- %@--></VAST>", marker]
+                                         delay:delay
+                                        forURL:[self urlForName:name]];
+    [engineHost setResult:[NSString stringWithFormat:@"%d", entryId] forScriptContaining:marker];
+    [engineHost setResult:adList forScriptContaining:[NSString stringWithFormat:@"vast.resolveAll\\\", \\\"params\\\": { \\\"entryId\\\": %d }", entryId]];
+}
+
+- (void) serveWrapperNamed:(NSString *)name target:(NSString *)targetName delay:(NSTimeInterval)delay
+{
+    [self serveDocumentNamed:name withAdList:[NSString stringWithFormat:WrapperAdFormat, name, [self urlForName:targetName]] delay:delay];
+}
+
+- (void) serveInLineNamed:(NSString *)name delay:(NSTimeInterval)delay
+{
+    [self serveDocumentNamed:name withAdList:[NSString stringWithFormat:InLineAdFormat, name, name] delay:delay];
+}
+
+- (Ad *) wrapperAdWithTarget:(NSString *)targetName
+{
+    Ad *ad = [[[Ad alloc] init] autorelease];
+    ad.type = Wrapper;
+    ad.idString = @"outer";
+    ad.sequence = 3;
+    ad.adTagURI = [self urlForName:targetName];
+    
+    return ad;
+}
+
+- (NSUInteger) countOfParsedDocumentsNamed:(NSString *)name
+{
+    return [engineHost countOfScriptsContaining:[NSString stringWithFormat:@"doc:%@ ", name]];
+}
+
+#pragma mark -
+#pragma mark Test setup:
+
+- (void) setUp
+{
+    [super setUp];
+    
+    [StubURLProtocol reset];
+    [NSURLProtocol registerClass:[StubURLProtocol class]];
+    
+    engineHost = [[StubEngineHost alloc] init];
+    [engineHost setResult:@"true" forScriptContaining:@"releaseEntry"];
+    adResolver = [[AdResolver alloc] initWithEngineHost:engineHost];
+    wrapperResolver = [[VASTWrapperResolver alloc] initWithAdResolver:adResolver];
+    lastEntryId = 0;
+}
+
+- (void) tearDown
+{
+    [wrapperResolver release];
+    [adResolver release];
+    [engineHost release];
+    [NSURLProtocol unregisterClass:[StubURLProtocol class]];
+    
+    [super tearDown];
+}
+
+#pragma mark -
+#pragma mark Tests:
+
+- (void) testInLineAdsAreKept
+{
+    Ad *inLine = [[[Ad alloc] init] autorelease];
+    inLine.type = InLine;
+    NSArray *resolvedAds = nil;
+    
+    STAssertTrue([wrapperResolver resolveAds:&resolvedAds fromAds:[NSArray arrayWithObject:inLine]], @"resolveAds failed");
+    STAssertEquals([resolvedAds count], (NSUInteger)1, @"wrong ad count");
+    STAssertEquals([resolvedAds objectAtIndex:0], inLine, @"InLine ad replaced");
+    STAssertEquals([[StubURLProtocol startedURLs] count], (NSUInteger)0, @"download without a wrapper");
+}
+
+- (void) testWrapperChainIsResolved
+{
+    [self serveWrapperNamed:@"w1" target:@"w2" delay:0];
+    [self serveWrapperNamed:@"w2" target:@"inline" delay:0];
+    [self serveInLineNamed:@"inline" delay:0];
+    NSArray *resolvedAds = nil;
+    
+    STAssertTrue([wrapperResolver resolveAds:&resolvedAds fromAds:[NSArray arrayWithObject:[self wrapperAdWithTarget:@"w1"]]], @"resolveAds failed");
+    STAssertEquals([resolvedAds count], (NSUInteger)1, @"wrong ad count");
+    
+    Ad *ad = [resolvedAds objectAtIndex:0];
+    STAssertEquals(ad.type, InLine, @"chain not resolved");
+    STAssertEqualObjects(ad.adTitle, @"inline", @"wrong ad at the end of the chain");
+    STAssertEquals(ad.sequence, 3, @"sequence of the outer wrapper not kept");
+    STAssertEquals([self countOfParsedDocumentsNamed:@"inline"], (NSUInteger)1, @"end of the chain not parsed once");
+}
+
+- (void) testChainsAreDownloadedConcurrently
+{
+    NSMutableArray *ads = [NSMutableArray array];
+    for (int i = 0; i < 3; ++i)
+    {
+        NSString *name = [NSString stringWithFormat:@"inline%d", i];
+        [self serveInLineNamed:name delay:0.5];
+        [ads addObject:[self wrapperAdWithTarget:name]];
+    }
+    wrapperResolver.deadline = 3.0;
+    NSArray *resolvedAds = nil;
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    
+    STAssertTrue([wrapperResolver resolveAds:&resolvedAds fromAds:ads], @"resolveAds failed");
+    
+    // one after the other the three downloads would take 1.5 seconds
+    STAssertTrue(CFAbsoluteTimeGetCurrent() - startTime < 1.0, @"chains not downloaded concurrently");
+    for (Ad *ad in resolvedAds)
+    {
+        STAssertEquals(ad.type, InLine, @"chain not resolved");
+    }
+}
+
+- (void) testChainLongerThanMaxDepthIsGivenUp
+{
+    wrapperResolver.maxDepth = 3;
+    for (int i = 1; i <= 4; ++i)
+    {
+        [self serveWrapperNamed:[NSString stringWithFormat:@"w%d", i] target:[NSString stringWithFormat:@"w%d", i + 1] delay:0];
+    }
+    [self serveInLineNamed:@"w5" delay:0];
+    Ad *outer = [self wrapperAdWithTarget:@"w1"];
+    NSArray *resolvedAds = nil;
+    
+    STAssertTrue([wrapperResolver resolveAds:&resolvedAds fromAds:[NSArray arrayWithObject:outer]], @"resolveAds failed");
+    STAssertEquals([resolvedAds objectAtIndex:0], outer, @"wrapper beyond the depth limit not kept");
+    STAssertEquals([self countOfParsedDocumentsNamed:@"w3"], (NSUInteger)1, @"chain not followed to the depth limit");
+    STAssertEquals([self countOfParsedDocumentsNamed:@"w4"], (NSUInteger)0, @"chain followed beyond the depth limit");
+}
+
+- (void) testLoopIsStoppedByMaxDepth
+{
+    wrapperResolver.maxDepth = 4;
+    [self serveWrapperNamed:@"a" target:@"b" delay:0];
+    [self serveWrapperNamed:@"b" target:@"a" delay:0];
+    Ad *outer = [self wrapperAdWithTarget:@"a"];
+    NSArray *resolvedAds = nil;
+    
+    STAssertTrue([wrapperResolver resolveAds:&resolvedAds fromAds:[NSArray arrayWithObject:outer]], @"resolveAds failed");
+    STAssertEquals([resolvedAds objectAtIndex:0], outer, @"looping wrapper not kept");
+    STAssertEquals([self countOfParsedDocumentsNamed:@"a"] + [self countOfParsedDocumentsNamed:@"b"], (NSUInteger)4, @"loop not stopped at the depth limit");
+}
+
+- (void) testSlowDownloadIsGivenUpAtDeadline
+{
+    [self serveInLineNamed:@"slow" delay:3.0];
+    [self serveInLineNamed:@"fast" delay:0];
+    wrapperResolver.deadline = 0.5;
+    NSArray *ads = [NSArray arrayWithObjects:[self wrapperAdWithTarget:@"slow"], [self wrapperAdWithTarget:@"fast"], nil];
+    NSArray *resolvedAds = nil;
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    
+    STAssertTrue([wrapperResolver resolveAds:&resolvedAds fromAds:ads], @"resolveAds failed");
+    STAssertTrue(CFAbsoluteTimeGetCurrent() - startTime < 1.0, @"deadline not kept");
+    STAssertEquals([resolvedAds objectAtIndex:0], [ads objectAtIndex:0], @"slow wrapper not kept");
+    STAssertEquals([(Ad *)[resolvedAds objectAtIndex:1] type], InLine, @"fast wrapper not resolved");
+    STAssertEquals([self countOfParsedDocumentsNamed:@"slow"], (NSUInteger)0, @"document after the deadline parsed");
+}
+
+- (void) testFailedDownloadKeepsWrapper
+{
+    [StubURLProtocol setResponseWithStatusCode:500 body:@"" delay:0 forURL:[self urlForName:@"broken"]];
+    Ad *outer = [self wrapperAdWithTarget:@"broken"];
+    NSArray *resolvedAds = nil;
+    
+    STAssertTrue([wrapperResolver resolveAds:&resolvedAds fromAds:[NSArray arrayWithObject:outer]], @"resolveAds failed");
+    STAssertEquals([resolvedAds objectAtIndex:0], outer, @"wrapper with a failed target not kept");
+    STAssertEquals([StubURLProtocol countOfRequestsForURL:[self urlForName:@"broken"]], (NSUInteger)1, @"target not requested");
+}
+
+@end
@@ -22,3 +22,10 @@
 @property (nonatomic, retain) NSMutableArray *avPlayerViews;
 
 @end
+
+@interface PlaybackSnapshot(_Internal)
+
+- (BOOL) updateWithCurrentEntry:(PlaylistEntry *)aCurrentEntry nextEntry:(PlaylistEntry *)aNextEntry seekbarTime:(SeekbarTime *)aSeekbarTime currentPlaybackTime:(NSTimeInterval)aPlaybackTime leftDvrEdge:(NSTimeInterval)aLeftDvrEdge livePosition:(NSTimeInterval)aLivePosition isLive:(BOOL)live isStopped:(BOOL)stopped;
+- (PlaybackSnapshot *) copySnapshot;
+
+@end
@@ -17,7 +17,7 @@
 
 @interface AdResolver(_internal)
 
-- (id) initWithUIWebView:(UIWebView *)aWebView;
+- (id) initWithEngineHost:(id<JavaScriptEngineHost>)anEngineHost;
 
 @end
 
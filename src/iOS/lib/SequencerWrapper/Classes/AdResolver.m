@@ -56,6 +56,7 @@ NSString * const ManifestDownloadedArgsUserInfoKey = @"ManifestDownloadedArgs";
 @synthesize lastError;
 @synthesize vastParser;
 @synthesize vmapParser;
+@synthesize downloadManager;
 
 #pragma mark -
 #pragma mark Internal class methods:
@@ -66,7 +67,7 @@ NSString * const ManifestDownloadedArgsUserInfoKey = @"ManifestDownloadedArgs";
 - (NSString *) callJavaScriptWithString:(NSString *)aString
 {
     SEQUENCER_LOG(@"JavaScript call: %s", [aString cStringUsingEncoding:NSUTF8StringEncoding]);
-    NSString *result = [webView stringByEvaluatingJavaScriptFromString:aString];
+    NSString *result = [engineHost evaluateScript:aString];
     
     SEQUENCER_LOG(@"JavaScript result is %@", result);
     
@@ -114,67 +115,30 @@ NSString * const ManifestDownloadedArgsUserInfoKey = @"ManifestDownloadedArgs";
     [pool release];
 }
 
-#pragma mark -
-#pragma mark Notification callbacks:
-
-- (void) connection:(NSURLConnection *)connection didReceiveData:(NSData *)data
-{
-    if (connection == downloadConnection)
-    {
-        [downloadData appendData:data];
-    }
-}
-
-- (void) connectionDidFinishLoading:(NSURLConnection *)connection
-{
-    if (connection == downloadConnection)
-    {
-        [downloadConnection release];
-        downloadConnection = nil;
-        
-        NSString *result = [[NSString alloc] initWithData:downloadData encoding:NSASCIIStringEncoding];
-        [self sendManifestDownloadedNotification:result withError:nil];
-        [result release];
-        
-        [downloadData release];
-        downloadData = nil;
-    }
-}
-
-- (void) connection:(NSURLConnection *)connection didFailWithError:(NSError *)error
-{
-    if (connection == downloadConnection)
-    {
-        self.lastError = error;
-        [self sendManifestDownloadedNotification:nil withError:error];
-        
-        [downloadConnection release];
-        downloadConnection = nil;
-        [downloadData release];
-        downloadData = nil;
-    }
-}
-
 #pragma mark -
 #pragma mark Public instance methods:
 
-- (id) initWithUIWebView:(UIWebView *)aWebView
+- (id) initWithEngineHost:(id<JavaScriptEngineHost>)anEngineHost
 {
     self = [super init];
     
     if (self){
-        webView = aWebView;
-        vastParser = [[VASTParser alloc] initWithUIWebView:aWebView];
-        vmapParser = [[VMAPParser alloc] initWithUIWebView:aWebView];
-        downloadData = nil;
-        downloadConnection = nil;
+        engineHost = anEngineHost;
+        vastParser = [[VASTParser alloc] initWithEngineHost:anEngineHost];
+        vmapParser = [[VMAPParser alloc] initWithEngineHost:anEngineHost];
+        downloadManager = [[ManifestDownloadManager alloc] init];
+        
+        ManifestCache *cache = [[ManifestCache alloc] initWithDirectoryPath:nil];
+        downloadManager.cache = cache;
+        [cache release];
     }
         
     return self;
 }
 
 //
-// download a manifest (VAST/VMAP/others) asynchronously
+// download a manifest (VAST/VMAP/others) asynchronously. Any number of downloads can be
+// in flight, each one sends a ManifestDownloadedNotification when it is finished.
 //
 // Arguments:
 // [aUrl]: the download url
@@ -184,14 +148,22 @@ NSString * const ManifestDownloadedArgsUserInfoKey = @"ManifestDownloadedArgs";
 - (BOOL) downloadManifestAsyncWithURL:(NSURL *)aUrl
 {
     BOOL success = NO;
-    downloadData = [[NSMutableData alloc] init];
     
-    NSURLRequest *request = [NSURLRequest requestWithURL:aUrl];
-    downloadConnection = [[NSURLConnection alloc] initWithRequest:request delegate:self];
+    ManifestDownloadRequest *request = [downloadManager downloadManifestWithURL:aUrl
+                                                                       priority:ManifestDownloadPriority_Normal
+                                                                        timeout:MANIFEST_DOWNLOAD_DEFAULT_TIMEOUT
+                                                                       deadline:0
+                                                                completionQueue:NULL
+                                                                     completion:^(NSString *manifest, NSError *error) {
+                                                                         if (nil != error)
+                                                                         {
+                                                                             self.lastError = error;
+                                                                         }
+                                                                         [self sendManifestDownloadedNotification:manifest withError:error];
+                                                                     }];
     
-    if (nil != downloadConnection)
+    if (nil != request)
     {
-        SEQUENCER_LOG(@"start downloading for url %@", aUrl);
         success = YES;
     }
     else
@@ -203,7 +175,8 @@ NSString * const ManifestDownloadedArgsUserInfoKey = @"ManifestDownloadedArgs";
 }
 
 //
-// download a manifest (VAST/VMAP/others) synchronously
+// download a manifest (VAST/VMAP/others) and wait for it. The download has the imminent
+// priority, so it starts before the prefetches waiting for a connection.
 //
 // Arguments:
 // [manifest]: the downloaded manifest in string format
@@ -213,28 +186,35 @@ NSString * const ManifestDownloadedArgsUserInfoKey = @"ManifestDownloadedArgs";
 //
 - (BOOL) downloadManifest:(NSString **)manifest withURL:(NSURL *)aUrl
 {
-    BOOL success = YES;
-    
-    NSURLResponse *response = nil;
-    NSError *error = nil;
-    NSURLRequest *request = [NSURLRequest requestWithURL:aUrl];
+    return [self downloadManifest:manifest withURL:aUrl allowStale:NO];
+}
 
-    SEQUENCER_LOG(@"start downloading for url %@", aUrl);
-    
-    downloadData = (NSMutableData *)[NSURLConnection sendSynchronousRequest:request returningResponse:&response error:&error];
+//
+// download a manifest and wait for it, optionally accepting a stale cached copy. A stale copy
+// is returned at once and revalidated in the background, which suits manifests that rarely
+// change such as VOD master playlists.
+//
+// Arguments:
+// [manifest]: the downloaded manifest in string format
+// [aUrl]: the download url
+// [allowStale]: YES to accept a stale cached manifest
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) downloadManifest:(NSString **)manifest withURL:(NSURL *)aUrl allowStale:(BOOL)allowStale
+{
+    NSError *error = nil;
+    BOOL success = [downloadManager downloadManifest:manifest
+                                             withURL:aUrl
+                                            priority:ManifestDownloadPriority_Imminent
+                                            deadline:0
+                                          cacheUsage:(allowStale ? ManifestDownloadCacheUsage_AllowStale : ManifestDownloadCacheUsage_Default)
+                                               error:&error];
     
-    if (nil == error)
-    {        
-        *manifest = [[NSString alloc] initWithData:downloadData encoding:NSASCIIStringEncoding];
-    }
-    else
+    if (!success)
     {
         self.lastError = error;
-        success = NO;
     }
-
-    // downloadData is an autorelease object, setting it to nil is enough
-    downloadData = nil;
     
     return success;
 }
@@ -292,7 +272,7 @@ NSString * const ManifestDownloadedArgsUserInfoKey = @"ManifestDownloadedArgs";
     
     function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.theAdResolverEntryPool.testProbe_toJSON()"] autorelease];
     SEQUENCER_LOG(@"JavaScript call: %s", [function cStringUsingEncoding:NSUTF8StringEncoding]);
-    result = [webView stringByEvaluatingJavaScriptFromString:function];
+    result = [engineHost evaluateScript:function];
     
     SEQUENCER_LOG(@"JavaScript result is %@", result);
     
@@ -309,14 +289,8 @@ NSString * const ManifestDownloadedArgsUserInfoKey = @"ManifestDownloadedArgs";
     [lastError release];
     [vastParser release];
     [vmapParser release];
-    if (nil != downloadData)
-    {
-        [downloadData release];
-    }
-    if (nil != downloadConnection)
-    {
-        [downloadConnection release];
-    }
+    [downloadManager cancelAllDownloads];
+    [downloadManager release];
     
     [super dealloc];
 }
@@ -0,0 +1,782 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "HLSPlaylist.h"
+
+#define TAG_LENGTH(tag) (sizeof(tag) - 1)
+#define LIVE_RATE_SMOOTHING 0.5
+#define LIVE_INITIAL_SEGMENT_CAPACITY 64
+
+static BOOL HasPrefix(const char *line, const char *end, const char *prefix, size_t prefixLength)
+{
+    return ((size_t)(end - line) >= prefixLength && 0 == memcmp(line, prefix, prefixLength));
+}
+
+// Parses a decimal number like "10", "9.009" or "-1" without requiring a terminating NUL
+static double ParseDecimal(const char *p, const char *end, const char **next)
+{
+    double value = 0;
+    double scale = 1;
+    BOOL isNegative = NO;
+    
+    if (p < end && '-' == *p)
+    {
+        isNegative = YES;
+        ++p;
+    }
+    for (; p < end && '0' <= *p && *p <= '9'; ++p)
+    {
+        value = value * 10 + (*p - '0');
+    }
+    if (p < end && '.' == *p)
+    {
+        for (++p; p < end && '0' <= *p && *p <= '9'; ++p)
+        {
+            scale /= 10;
+            value += (*p - '0') * scale;
+        }
+    }
+    if (NULL != next)
+    {
+        *next = p;
+    }
+    
+    return isNegative ? -value : value;
+}
+
+// Returns the next non empty line without its surrounding white space, NULL at the end of the playlist
+static const char *NextLine(const char **p, const char *end, const char **lineEnd)
+{
+    const char *line = *p;
+    
+    while (line < end && (' ' == *line || '\t' == *line || '\r' == *line || '\n' == *line))
+    {
+        ++line;
+    }
+    if (line == end)
+    {
+        *p = end;
+        return NULL;
+    }
+    
+    const char *next = line;
+    while (next < end && '\n' != *next && '\r' != *next)
+    {
+        ++next;
+    }
+    *p = next;
+    
+    while (' ' == next[-1] || '\t' == next[-1])
+    {
+        --next;
+    }
+    *lineEnd = next;
+    
+    return line;
+}
+
+// Finds the last line equal to the given text by scanning backwards, returns the end of that line or NULL
+static const char *FindLastLine(const char *start, const char *end, const char *text, size_t textLength)
+{
+    const char *lineEnd = end;
+    
+    while (start < lineEnd)
+    {
+        while (start < lineEnd && (' ' == lineEnd[-1] || '\t' == lineEnd[-1] || '\r' == lineEnd[-1] || '\n' == lineEnd[-1]))
+        {
+            --lineEnd;
+        }
+        const char *lineStart = lineEnd;
+        while (start < lineStart && '\n' != lineStart[-1] && '\r' != lineStart[-1])
+        {
+            --lineStart;
+        }
+        const char *line = lineStart;
+        while (line < lineEnd && (' ' == *line || '\t' == *line))
+        {
+            ++line;
+        }
+        
+        if ((size_t)(lineEnd - line) == textLength && 0 == memcmp(line, text, textLength))
+        {
+            return lineEnd;
+        }
+        lineEnd = lineStart;
+    }
+    
+    return NULL;
+}
+
+// Returns the characters of the string in place when it stores them as ASCII or UTF-8, otherwise an autoreleased copy
+static const char *BytesOfString(NSString *string, NSUInteger *length)
+{
+    const char *bytes = CFStringGetCStringPtr((CFStringRef)string, kCFStringEncodingASCII);
+    if (NULL == bytes)
+    {
+        bytes = CFStringGetCStringPtr((CFStringRef)string, kCFStringEncodingUTF8);
+    }
+    if (NULL != bytes)
+    {
+        *length = strlen(bytes);
+        return bytes;
+    }
+    
+    NSData *data = [string dataUsingEncoding:NSUTF8StringEncoding allowLossyConversion:YES];
+    *length = [data length];
+    return (const char *)[data bytes];
+}
+
+static uint64_t ParseInteger(const char *p, const char *end, const char **next)
+{
+    uint64_t value = 0;
+    
+    for (; p < end && '0' <= *p && *p <= '9'; ++p)
+    {
+        value = value * 10 + (uint64_t)(*p - '0');
+    }
+    if (NULL != next)
+    {
+        *next = p;
+    }
+    
+    return value;
+}
+
+@implementation HLSVariant
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize uri;
+@synthesize bandwidth;
+@synthesize width;
+@synthesize height;
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+- (id) initWithURI:(NSString *)anUri bandwidth:(uint64_t)aBandwidth width:(NSUInteger)aWidth height:(NSUInteger)aHeight
+{
+    self = [super init];
+    
+    if (self){
+        uri = [anUri retain];
+        bandwidth = aBandwidth;
+        width = aWidth;
+        height = aHeight;
+    }
+    
+    return self;
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [uri release];
+    
+    [super dealloc];
+}
+
+@end
+
+@implementation HLSPlaylist
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize targetDuration;
+@synthesize mediaSequence;
+@synthesize totalDuration;
+@synthesize segmentCount;
+@synthesize hasEndList;
+@synthesize variants;
+@synthesize discontinuities;
+
+- (BOOL) isMasterPlaylist
+{
+    return (0 < [variants count]);
+}
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+//
+// parse the attribute list of an #EXT-X-STREAM-INF tag, e.g. BANDWIDTH=1280000,RESOLUTION=640x360,CODECS="a,b"
+//
+// Arguments:
+// [p]: the first character of the attribute list
+// [end]: the end of the line
+// [aBandwidth]: the BANDWIDTH attribute
+// [aWidth]: the width of the RESOLUTION attribute
+// [aHeight]: the height of the RESOLUTION attribute
+//
+// Returns: nothing
+//
+- (void) parseStreamAttributes:(const char *)p end:(const char *)end bandwidth:(uint64_t *)aBandwidth width:(NSUInteger *)aWidth height:(NSUInteger *)aHeight
+{
+    while (p < end)
+    {
+        const char *name = p;
+        while (p < end && '=' != *p && ',' != *p)
+        {
+            ++p;
+        }
+        const char *nameEnd = p;
+        
+        if (p < end && '=' == *p)
+        {
+            ++p;
+            if (HasPrefix(name, nameEnd, "BANDWIDTH", TAG_LENGTH("BANDWIDTH")) && TAG_LENGTH("BANDWIDTH") == (size_t)(nameEnd - name))
+            {
+                *aBandwidth = ParseInteger(p, end, &p);
+            }
+            else if (HasPrefix(name, nameEnd, "RESOLUTION", TAG_LENGTH("RESOLUTION")) && TAG_LENGTH("RESOLUTION") == (size_t)(nameEnd - name))
+            {
+                *aWidth = (NSUInteger)ParseInteger(p, end, &p);
+                if (p < end && ('x' == *p || 'X' == *p))
+                {
+                    *aHeight = (NSUInteger)ParseInteger(p + 1, end, &p);
+                }
+            }
+            
+            // skip the rest of the value, a quoted string can contain commas
+            if (p < end && '"' == *p)
+            {
+                for (++p; p < end && '"' != *p; ++p);
+            }
+            while (p < end && ',' != *p)
+            {
+                ++p;
+            }
+        }
+        
+        if (p < end)
+        {
+            // skip the comma
+            ++p;
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the playlist, tokenizing the playlist in a single pass over its bytes
+//
+// Arguments:
+// [bytes]: the playlist in UTF-8 or ASCII, it does not need to be NUL terminated
+// [length]: the length of the playlist in bytes
+//
+// Returns: The playlist instance, nil if the bytes are not an m3u8 playlist.
+//
+- (id) initWithBytes:(const char *)bytes length:(NSUInteger)length
+{
+    self = [super init];
+    
+    if (self){
+        targetDuration = 0;
+        mediaSequence = 0;
+        totalDuration = 0;
+        segmentCount = 0;
+        hasEndList = NO;
+        variants = [[NSMutableArray alloc] init];
+        discontinuities = [[NSMutableArray alloc] init];
+        
+        const char *p = bytes;
+        const char *end = bytes + length;
+        BOOL isFirstLine = YES;
+        BOOL isVariantPending = NO;
+        uint64_t variantBandwidth = 0;
+        NSUInteger variantWidth = 0;
+        NSUInteger variantHeight = 0;
+        
+        // UTF-8 byte order mark
+        if (HasPrefix(p, end, "\xEF\xBB\xBF", 3))
+        {
+            p += 3;
+        }
+        
+        const char *line = NULL;
+        const char *lineEnd = NULL;
+        
+        // lines end with LF or CR LF
+        while (NULL != (line = NextLine(&p, end, &lineEnd)))
+        {
+            if (isFirstLine)
+            {
+                if (!HasPrefix(line, lineEnd, "#EXTM3U", TAG_LENGTH("#EXTM3U")))
+                {
+                    [self release];
+                    return nil;
+                }
+                isFirstLine = NO;
+                continue;
+            }
+            
+            if ('#' != *line)
+            {
+                // a URI line, the segment URIs are not needed
+                if (isVariantPending)
+                {
+                    NSString *uri = [[NSString alloc] initWithBytes:line length:(lineEnd - line) encoding:NSUTF8StringEncoding];
+                    if (nil != uri)
+                    {
+                        HLSVariant *variant = [[HLSVariant alloc] initWithURI:uri bandwidth:variantBandwidth width:variantWidth height:variantHeight];
+                        [variants addObject:variant];
+                        [variant release];
+                        [uri release];
+                    }
+                    isVariantPending = NO;
+                }
+            }
+            else if (HasPrefix(line, lineEnd, "#EXTINF:", TAG_LENGTH("#EXTINF:")))
+            {
+                totalDuration += ParseDecimal(line + TAG_LENGTH("#EXTINF:"), lineEnd, NULL);
+                ++segmentCount;
+            }
+            else if (HasPrefix(line, lineEnd, "#EXT-X-", TAG_LENGTH("#EXT-X-")))
+            {
+                const char *tag = line + TAG_LENGTH("#EXT-X-");
+                
+                if (HasPrefix(tag, lineEnd, "TARGETDURATION:", TAG_LENGTH("TARGETDURATION:")))
+                {
+                    targetDuration = ParseDecimal(tag + TAG_LENGTH("TARGETDURATION:"), lineEnd, NULL);
+                }
+                else if (HasPrefix(tag, lineEnd, "MEDIA-SEQUENCE:", TAG_LENGTH("MEDIA-SEQUENCE:")))
+                {
+                    mediaSequence = ParseInteger(tag + TAG_LENGTH("MEDIA-SEQUENCE:"), lineEnd, NULL);
+                }
+                else if (HasPrefix(tag, lineEnd, "ENDLIST", TAG_LENGTH("ENDLIST")))
+                {
+                    hasEndList = YES;
+                }
+                else if (HasPrefix(tag, lineEnd, "DISCONTINUITY", TAG_LENGTH("DISCONTINUITY")) &&
+                         TAG_LENGTH("DISCONTINUITY") == (size_t)(lineEnd - tag))
+                {
+                    // the playlist time of the segment after the discontinuity
+                    [discontinuities addObject:[NSNumber numberWithDouble:totalDuration]];
+                }
+                else if (HasPrefix(tag, lineEnd, "STREAM-INF:", TAG_LENGTH("STREAM-INF:")))
+                {
+                    variantBandwidth = 0;
+                    variantWidth = 0;
+                    variantHeight = 0;
+                    [self parseStreamAttributes:(tag + TAG_LENGTH("STREAM-INF:")) end:lineEnd bandwidth:&variantBandwidth width:&variantWidth height:&variantHeight];
+                    isVariantPending = YES;
+                }
+            }
+            // comments and the other tags are skipped
+        }
+        
+        if (isFirstLine)
+        {
+            [self release];
+            return nil;
+        }
+    }
+    
+    return self;
+}
+
+- (id) initWithData:(NSData *)data
+{
+    return [self initWithBytes:(const char *)[data bytes] length:[data length]];
+}
+
+//
+// Constructor for the playlist from a downloaded manifest. The characters of the string are
+// used in place when the string stores them as ASCII or UTF-8.
+//
+// Arguments:
+// [manifest]: the playlist
+//
+// Returns: The playlist instance, nil if the manifest is not an m3u8 playlist.
+//
+- (id) initWithString:(NSString *)manifest
+{
+    if (nil == manifest)
+    {
+        [self release];
+        return nil;
+    }
+    
+    NSUInteger length = 0;
+    const char *bytes = BytesOfString(manifest, &length);
+    
+    return [self initWithBytes:bytes length:length];
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [variants release];
+    [discontinuities release];
+    
+    [super dealloc];
+}
+
+@end
+
+@implementation HLSLivePlaylistTracker
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize url;
+@synthesize mediaSequence;
+@synthesize targetDuration;
+@synthesize segmentCount;
+@synthesize leftDvrEdgeRate;
+@synthesize livePositionRate;
+@synthesize updateTime;
+@synthesize hasEndList;
+@synthesize rebuildCount;
+@synthesize isCancelled;
+
+- (NSTimeInterval) leftDvrEdge
+{
+    @synchronized(self)
+    {
+        return removedDuration;
+    }
+}
+
+- (NSTimeInterval) livePosition
+{
+    @synchronized(self)
+    {
+        return removedDuration + windowDuration;
+    }
+}
+
+#pragma mark -
+#pragma mark Private class methods:
+
+//
+// parse the tags before the first segment of a media playlist
+//
+// Arguments:
+// [bytes]: the playlist
+// [end]: the end of the playlist
+// [aMediaSequence]: the EXT-X-MEDIA-SEQUENCE, 0 when it is missing
+// [aTargetDuration]: the EXT-X-TARGETDURATION, 0 when it is missing
+// [segments]: the start of the first segment
+//
+// Returns: YES for success and NO if the bytes are not an m3u8 playlist
+//
++ (BOOL) parseHeader:(const char *)bytes end:(const char *)end mediaSequence:(uint64_t *)aMediaSequence targetDuration:(NSTimeInterval *)aTargetDuration segments:(const char **)segments
+{
+    const char *p = bytes;
+    const char *line = NULL;
+    const char *lineEnd = NULL;
+    
+    if (HasPrefix(p, end, "\xEF\xBB\xBF", 3))
+    {
+        p += 3;
+    }
+    line = NextLine(&p, end, &lineEnd);
+    if (NULL == line || !HasPrefix(line, lineEnd, "#EXTM3U", TAG_LENGTH("#EXTM3U")))
+    {
+        return NO;
+    }
+    
+    *aMediaSequence = 0;
+    *aTargetDuration = 0;
+    *segments = end;
+    while (NULL != (line = NextLine(&p, end, &lineEnd)))
+    {
+        if ('#' != *line || HasPrefix(line, lineEnd, "#EXTINF:", TAG_LENGTH("#EXTINF:")))
+        {
+            *segments = line;
+            break;
+        }
+        if (HasPrefix(line, lineEnd, "#EXT-X-MEDIA-SEQUENCE:", TAG_LENGTH("#EXT-X-MEDIA-SEQUENCE:")))
+        {
+            *aMediaSequence = ParseInteger(line + TAG_LENGTH("#EXT-X-MEDIA-SEQUENCE:"), lineEnd, NULL);
+        }
+        else if (HasPrefix(line, lineEnd, "#EXT-X-TARGETDURATION:", TAG_LENGTH("#EXT-X-TARGETDURATION:")))
+        {
+            *aTargetDuration = ParseDecimal(line + TAG_LENGTH("#EXT-X-TARGETDURATION:"), lineEnd, NULL);
+        }
+    }
+    
+    return YES;
+}
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+// The caller holds the lock
+- (void) appendSegmentDuration:(double)duration
+{
+    if (segmentCount == segmentCapacity)
+    {
+        NSUInteger capacity = (0 == segmentCapacity) ? LIVE_INITIAL_SEGMENT_CAPACITY : 2 * segmentCapacity;
+        double *durations = malloc(capacity * sizeof(double));
+        for (NSUInteger i = 0; i < segmentCount; ++i)
+        {
+            durations[i] = segmentDurations[(firstSegment + i) % segmentCapacity];
+        }
+        free(segmentDurations);
+        segmentDurations = durations;
+        segmentCapacity = capacity;
+        firstSegment = 0;
+    }
+    
+    segmentDurations[(firstSegment + segmentCount) % segmentCapacity] = duration;
+    ++segmentCount;
+    windowDuration += duration;
+}
+
+// The caller holds the lock
+- (void) removeFirstSegments:(uint64_t)count
+{
+    for (; 0 < count && 0 < segmentCount; --count)
+    {
+        double duration = segmentDurations[firstSegment];
+        firstSegment = (firstSegment + 1) % segmentCapacity;
+        --segmentCount;
+        windowDuration -= duration;
+        removedDuration += duration;
+    }
+    
+    if (0 == segmentCount)
+    {
+        windowDuration = 0;
+    }
+    
+    // Segments which came and went between two refreshes were never seen, estimate them by the target duration
+    removedDuration += count * targetDuration;
+}
+
+// The caller holds the lock
+- (void) appendSegmentsFrom:(const char *)p end:(const char *)end
+{
+    const char *line = NULL;
+    const char *lineEnd = NULL;
+    const char *lastURI = NULL;
+    const char *lastURIEnd = NULL;
+    double duration = 0;
+    BOOL isSegmentPending = NO;
+    
+    while (NULL != (line = NextLine(&p, end, &lineEnd)))
+    {
+        if ('#' != *line)
+        {
+            if (isSegmentPending)
+            {
+                [self appendSegmentDuration:duration];
+                lastURI = line;
+                lastURIEnd = lineEnd;
+                isSegmentPending = NO;
+            }
+        }
+        else if (HasPrefix(line, lineEnd, "#EXTINF:", TAG_LENGTH("#EXTINF:")))
+        {
+            duration = ParseDecimal(line + TAG_LENGTH("#EXTINF:"), lineEnd, NULL);
+            isSegmentPending = YES;
+        }
+        else if (HasPrefix(line, lineEnd, "#EXT-X-ENDLIST", TAG_LENGTH("#EXT-X-ENDLIST")))
+        {
+            hasEndList = YES;
+        }
+    }
+    
+    if (NULL != lastURI)
+    {
+        [lastSegmentURI release];
+        lastSegmentURI = [[NSData alloc] initWithBytes:lastURI length:(lastURIEnd - lastURI)];
+    }
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the live playlist tracker
+//
+// Arguments:
+// [anUrl]: the URL of the media playlist
+//
+// Returns: The tracker instance.
+//
+- (id) initWithURL:(NSURL *)anUrl
+{
+    self = [super init];
+    
+    if (self){
+        url = [anUrl retain];
+        mediaSequence = 0;
+        targetDuration = 0;
+        segmentDurations = NULL;
+        segmentCapacity = 0;
+        firstSegment = 0;
+        segmentCount = 0;
+        windowDuration = 0;
+        removedDuration = 0;
+        lastSegmentURI = nil;
+        hasEndList = NO;
+        updateTime = 0;
+        leftDvrEdgeRate = 0;
+        livePositionRate = 0;
+        rebuildCount = 0;
+        isCancelled = NO;
+    }
+    
+    return self;
+}
+
+//
+// apply a refresh of the media playlist
+//
+// Arguments:
+// [bytes]: the refreshed playlist, it does not need to be NUL terminated
+// [length]: the length of the playlist in bytes
+// [now]: the time of the refresh
+//
+// Returns: YES for success and NO if the bytes are not an m3u8 playlist
+//
+- (BOOL) updateWithBytes:(const char *)bytes length:(NSUInteger)length atTime:(CFAbsoluteTime)now
+{
+    const char *end = bytes + length;
+    const char *segments = NULL;
+    uint64_t newMediaSequence = 0;
+    NSTimeInterval newTargetDuration = 0;
+    
+    if (![HLSLivePlaylistTracker parseHeader:bytes end:end mediaSequence:&newMediaSequence targetDuration:&newTargetDuration segments:&segments])
+    {
+        return NO;
+    }
+    
+    @synchronized(self)
+    {
+        NSTimeInterval previousLeftDvrEdge = removedDuration;
+        NSTimeInterval previousLivePosition = removedDuration + windowDuration;
+        BOOL isFirstUpdate = (0 == updateTime);
+        const char *appendedSegments = NULL;
+        
+        if (0 < newTargetDuration)
+        {
+            targetDuration = newTargetDuration;
+        }
+        
+        if (!isFirstUpdate)
+        {
+            if (mediaSequence <= newMediaSequence)
+            {
+                [self removeFirstSegments:(newMediaSequence - mediaSequence)];
+                if (0 < segmentCount && nil != lastSegmentURI)
+                {
+                    appendedSegments = FindLastLine(segments, end, (const char *)[lastSegmentURI bytes], [lastSegmentURI length]);
+                }
+            }
+            else
+            {
+                // The media sequence went back, the stream restarted
+                [self removeFirstSegments:segmentCount];
+            }
+        }
+        
+        if (NULL == appendedSegments)
+        {
+            // Rebuild the window from all the segments of the playlist
+            if (!isFirstUpdate)
+            {
+                rebuildCount++;
+            }
+            firstSegment = 0;
+            segmentCount = 0;
+            windowDuration = 0;
+            appendedSegments = segments;
+        }
+        
+        mediaSequence = newMediaSequence;
+        [self appendSegmentsFrom:appendedSegments end:end];
+        
+        if (!isFirstUpdate && updateTime < now)
+        {
+            double elapsed = now - updateTime;
+            double leftRate = (removedDuration - previousLeftDvrEdge) / elapsed;
+            double liveRate = (removedDuration + windowDuration - previousLivePosition) / elapsed;
+            
+            leftDvrEdgeRate = LIVE_RATE_SMOOTHING * leftRate + (1 - LIVE_RATE_SMOOTHING) * leftDvrEdgeRate;
+            livePositionRate = LIVE_RATE_SMOOTHING * liveRate + (1 - LIVE_RATE_SMOOTHING) * livePositionRate;
+        }
+        updateTime = now;
+    }
+    
+    return YES;
+}
+
+- (BOOL) updateWithString:(NSString *)manifest atTime:(CFAbsoluteTime)now
+{
+    if (nil == manifest)
+    {
+        return NO;
+    }
+    
+    NSUInteger length = 0;
+    const char *bytes = BytesOfString(manifest, &length);
+    
+    return [self updateWithBytes:bytes length:length atTime:now];
+}
+
+//
+// get the edges of the DVR window extrapolated from the last refresh with their rates of change
+//
+// Arguments:
+// [leftDvrEdge]: the left edge of the DVR window
+// [livePosition]: the live position
+// [now]: the time to get the edges for
+//
+// Returns: nothing
+//
+- (void) getLeftDvrEdge:(NSTimeInterval *)leftDvrEdge livePosition:(NSTimeInterval *)livePosition atTime:(CFAbsoluteTime)now
+{
+    @synchronized(self)
+    {
+        double elapsed = (hasEndList || now < updateTime) ? 0 : now - updateTime;
+        
+        *leftDvrEdge = removedDuration + leftDvrEdgeRate * elapsed;
+        *livePosition = removedDuration + windowDuration + livePositionRate * elapsed;
+    }
+}
+
+- (void) cancel
+{
+    @synchronized(self)
+    {
+        isCancelled = YES;
+    }
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [url release];
+    [lastSegmentURI release];
+    free(segmentDurations);
+    
+    [super dealloc];
+}
+
+@end
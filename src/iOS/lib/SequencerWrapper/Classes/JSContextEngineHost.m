@@ -0,0 +1,157 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <JavaScriptCore/JavaScriptCore.h>
+#import "JSContextEngineHost.h"
+#import "Trace.h"
+
+@implementation JSContextEngineHost
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize evaluationCount;
+@synthesize evaluationTime;
+
+- (BOOL) requiresMainThread
+{
+    return NO;
+}
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+- (BOOL) loadScript:(NSString *)scriptName
+{
+    NSString *path = [[NSBundle mainBundle] pathForResource:[scriptName stringByDeletingPathExtension] ofType:[scriptName pathExtension]];
+    NSError *error = nil;
+    NSString *script = (nil == path) ? nil : [NSString stringWithContentsOfFile:path encoding:NSUTF8StringEncoding error:&error];
+    if (nil == script)
+    {
+        NSLog(@"Failed to read the script %@", scriptName);
+        return NO;
+    }
+    
+    [context evaluateScript:script];
+    if (nil != context.exception)
+    {
+        NSLog(@"Failed to load the script %@: %@", scriptName, [context.exception toString]);
+        context.exception = nil;
+        return NO;
+    }
+    
+    return YES;
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the JavaScriptCore engine host. The scripts run headless: HeadlessDOM.js is
+// loaded first to provide a DOMParser for scripts which parse XML documents themselves.
+//
+// Arguments:
+// [scriptNames]: the names of the script files in the main bundle to load, in loading order
+//
+// Returns: The engine host instance, nil if JavaScriptCore is not available (before iOS 7)
+// or a script failed to load.
+//
+- (id) initWithScripts:(NSArray *)scriptNames
+{
+    self = [super init];
+    
+    if (self){
+        evaluationCount = 0;
+        evaluationTime = 0;
+        context = nil;
+        
+        // JavaScriptCore is weak linked
+        if (Nil == NSClassFromString(@"JSContext"))
+        {
+            [self release];
+            return nil;
+        }
+        
+        context = [[JSContext alloc] init];
+        if (![self loadScript:@"HeadlessDOM.js"])
+        {
+            [self release];
+            return nil;
+        }
+        for (NSString *scriptName in scriptNames)
+        {
+            if (![self loadScript:scriptName])
+            {
+                [self release];
+                return nil;
+            }
+        }
+    }
+    
+    return self;
+}
+
+//
+// evaluate a script in the JavaScript context
+//
+// Arguments:
+// [script]: the script to evaluate
+//
+// Returns: the result of the script converted to a string, an empty string for undefined,
+// null or an uncaught exception the same as UIWebView
+//
+- (NSString *) evaluateScript:(NSString *)script
+{
+    NSString *result = @"";
+    
+    // The host can be called from the main thread and the framework engine queue at the same time,
+    // the exception has to be checked before another script runs
+    @synchronized(self)
+    {
+        CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+        JSValue *value = [context evaluateScript:script];
+        NSTimeInterval elapsed = CFAbsoluteTimeGetCurrent() - startTime;
+        
+        evaluationCount++;
+        evaluationTime += elapsed;
+        SEQUENCER_LOG(@"JavaScript evaluation took %f ms", elapsed * 1000);
+        
+        if (nil != context.exception)
+        {
+            SEQUENCER_LOG(@"JavaScript exception %@", [context.exception toString]);
+            context.exception = nil;
+        }
+        else if (![value isUndefined] && ![value isNull])
+        {
+            result = [value toString];
+        }
+    }
+    
+    return result;
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    SEQUENCER_LOG(@"JSContextEngineHost dealloc called.");
+    
+    [context release];
+    
+    [super dealloc];
+}
+
+@end
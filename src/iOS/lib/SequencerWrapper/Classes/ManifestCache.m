@@ -0,0 +1,558 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <CommonCrypto/CommonDigest.h>
+#import "ManifestCache.h"
+#import "Trace.h"
+
+static NSString * const MetadataURLKey = @"url";
+static NSString * const MetadataETagKey = @"etag";
+static NSString * const MetadataLastModifiedKey = @"lastModified";
+static NSString * const MetadataExpirationTimeKey = @"expirationTime";
+static NSString * const MetadataContentHashKey = @"contentHash";
+static NSString * const MetadataExtension = @"plist";
+static NSString * const ManifestExtension = @"manifest";
+
+@implementation ManifestCacheEntry
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize manifest;
+@synthesize etag;
+@synthesize lastModified;
+@synthesize expirationTime;
+@synthesize contentHash;
+
+- (BOOL) isFresh
+{
+    return (CFAbsoluteTimeGetCurrent() < expirationTime);
+}
+
+- (BOOL) hasValidators
+{
+    return (nil != etag || nil != lastModified);
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+- (id) initWithManifest:(NSString *)aManifest etag:(NSString *)anEtag lastModified:(NSString *)aLastModified expirationTime:(CFAbsoluteTime)anExpirationTime contentHash:(NSString *)aContentHash
+{
+    self = [super init];
+    
+    if (self){
+        manifest = [aManifest retain];
+        etag = [anEtag retain];
+        lastModified = [aLastModified retain];
+        expirationTime = anExpirationTime;
+        contentHash = [aContentHash retain];
+    }
+    
+    return self;
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [manifest release];
+    [etag release];
+    [lastModified release];
+    [contentHash release];
+    
+    [super dealloc];
+}
+
+@end
+
+@implementation ManifestCache
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize directoryPath;
+@synthesize maxDiskBytes;
+@synthesize hitCount;
+@synthesize missCount;
+@synthesize staleHitCount;
+@synthesize revalidationCount;
+@synthesize notModifiedCount;
+
+- (NSUInteger) maxMemoryBytes
+{
+    return [memoryCache totalCostLimit];
+}
+
+- (void) setMaxMemoryBytes:(NSUInteger)value
+{
+    [memoryCache setTotalCostLimit:value];
+}
+
+#pragma mark -
+#pragma mark Private class methods:
+
++ (NSString *) hashOfData:(NSData *)data
+{
+    unsigned char digest[CC_SHA1_DIGEST_LENGTH];
+    CC_SHA1([data bytes], (CC_LONG)[data length], digest);
+    
+    NSMutableString *hash = [NSMutableString stringWithCapacity:2 * CC_SHA1_DIGEST_LENGTH];
+    for (int i = 0; i < CC_SHA1_DIGEST_LENGTH; ++i)
+    {
+        [hash appendFormat:@"%02x", digest[i]];
+    }
+    
+    return hash;
+}
+
++ (NSString *) headerValue:(NSString *)name inResponse:(NSHTTPURLResponse *)response
+{
+    NSDictionary *headers = [response allHeaderFields];
+    for (NSString *key in headers)
+    {
+        if (NSOrderedSame == [key caseInsensitiveCompare:name])
+        {
+            return [headers objectForKey:key];
+        }
+    }
+    
+    return nil;
+}
+
++ (NSDate *) dateFromHTTPDate:(NSString *)httpDate
+{
+    if (nil == httpDate)
+    {
+        return nil;
+    }
+    
+    NSDateFormatter *formatter = [[NSDateFormatter alloc] init];
+    [formatter setLocale:[[[NSLocale alloc] initWithLocaleIdentifier:@"en_US_POSIX"] autorelease]];
+    [formatter setTimeZone:[NSTimeZone timeZoneWithAbbreviation:@"GMT"]];
+    [formatter setDateFormat:@"EEE, dd MMM yyyy HH:mm:ss zzz"];
+    NSDate *date = [formatter dateFromString:httpDate];
+    [formatter release];
+    
+    return date;
+}
+
+//
+// get the time a response stays fresh until
+//
+// Arguments:
+// [response]: the HTTP response
+// [isStorable]: set to NO if the response must not be stored
+//
+// Returns: The absolute expiration time, the current time if the response has to be revalidated on every use
+//
++ (CFAbsoluteTime) expirationTimeForResponse:(NSHTTPURLResponse *)response isStorable:(BOOL *)isStorable
+{
+    CFAbsoluteTime now = CFAbsoluteTimeGetCurrent();
+    NSString *cacheControl = [[self headerValue:@"Cache-Control" inResponse:response] lowercaseString];
+    
+    *isStorable = YES;
+    if (nil != cacheControl)
+    {
+        if (NSNotFound != [cacheControl rangeOfString:@"no-store"].location)
+        {
+            *isStorable = NO;
+            return now;
+        }
+        if (NSNotFound != [cacheControl rangeOfString:@"no-cache"].location)
+        {
+            return now;
+        }
+        
+        NSRange maxAgeRange = [cacheControl rangeOfString:@"max-age="];
+        if (NSNotFound != maxAgeRange.location)
+        {
+            NSScanner *scanner = [NSScanner scannerWithString:[cacheControl substringFromIndex:NSMaxRange(maxAgeRange)]];
+            NSInteger maxAge = 0;
+            if ([scanner scanInteger:&maxAge])
+            {
+                NSInteger age = [[self headerValue:@"Age" inResponse:response] integerValue];
+                return now + MAX(0, maxAge - age);
+            }
+        }
+    }
+    
+    NSDate *expires = [self dateFromHTTPDate:[self headerValue:@"Expires" inResponse:response]];
+    if (nil != expires)
+    {
+        return MAX(now, [expires timeIntervalSinceReferenceDate]);
+    }
+    
+    // No freshness information, the validators decide on every use
+    return now;
+}
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+- (NSString *) pathForName:(NSString *)name extension:(NSString *)extension
+{
+    return [directoryPath stringByAppendingPathComponent:[name stringByAppendingPathExtension:extension]];
+}
+
+- (NSString *) keyForURL:(NSURL *)url
+{
+    return [ManifestCache hashOfData:[[url absoluteString] dataUsingEncoding:NSUTF8StringEncoding]];
+}
+
+// The caller holds the lock
+- (ManifestCacheEntry *) diskEntryForKey:(NSString *)key
+{
+    NSString *metadataPath = [self pathForName:key extension:MetadataExtension];
+    NSDictionary *metadata = [NSDictionary dictionaryWithContentsOfFile:metadataPath];
+    NSString *contentHash = [metadata objectForKey:MetadataContentHashKey];
+    if (nil == contentHash)
+    {
+        return nil;
+    }
+    
+    NSData *data = [NSData dataWithContentsOfFile:[self pathForName:contentHash extension:ManifestExtension]];
+    if (nil == data)
+    {
+        return nil;
+    }
+    
+    // The modification date of the metadata is the last use for the disk trimming
+    [[NSFileManager defaultManager] setAttributes:[NSDictionary dictionaryWithObject:[NSDate date] forKey:NSFileModificationDate]
+                                     ofItemAtPath:metadataPath
+                                            error:nil];
+    
+    NSString *manifest = [[[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] autorelease];
+    return [[[ManifestCacheEntry alloc] initWithManifest:manifest
+                                                    etag:[metadata objectForKey:MetadataETagKey]
+                                            lastModified:[metadata objectForKey:MetadataLastModifiedKey]
+                                          expirationTime:[[metadata objectForKey:MetadataExpirationTimeKey] doubleValue]
+                                             contentHash:contentHash] autorelease];
+}
+
+// The caller holds the lock
+- (void) writeEntry:(ManifestCacheEntry *)entry forURL:(NSURL *)url key:(NSString *)key
+{
+    NSString *manifestPath = [self pathForName:entry.contentHash extension:ManifestExtension];
+    if (![[NSFileManager defaultManager] fileExistsAtPath:manifestPath])
+    {
+        [[entry.manifest dataUsingEncoding:NSUTF8StringEncoding] writeToFile:manifestPath atomically:YES];
+    }
+    
+    NSMutableDictionary *metadata = [NSMutableDictionary dictionaryWithCapacity:5];
+    [metadata setObject:[url absoluteString] forKey:MetadataURLKey];
+    [metadata setObject:entry.contentHash forKey:MetadataContentHashKey];
+    [metadata setObject:[NSNumber numberWithDouble:entry.expirationTime] forKey:MetadataExpirationTimeKey];
+    if (nil != entry.etag)
+    {
+        [metadata setObject:entry.etag forKey:MetadataETagKey];
+    }
+    if (nil != entry.lastModified)
+    {
+        [metadata setObject:entry.lastModified forKey:MetadataLastModifiedKey];
+    }
+    [metadata writeToFile:[self pathForName:key extension:MetadataExtension] atomically:YES];
+}
+
+// The caller holds the lock
+- (void) trimDisk
+{
+    NSFileManager *fileManager = [NSFileManager defaultManager];
+    NSArray *fileNames = [fileManager contentsOfDirectoryAtPath:directoryPath error:nil];
+    NSMutableArray *metadataPaths = [NSMutableArray array];
+    NSMutableDictionary *manifestSizes = [NSMutableDictionary dictionary];
+    unsigned long long totalBytes = 0;
+    
+    for (NSString *fileName in fileNames)
+    {
+        NSString *path = [directoryPath stringByAppendingPathComponent:fileName];
+        if ([[fileName pathExtension] isEqualToString:MetadataExtension])
+        {
+            [metadataPaths addObject:path];
+        }
+        else if ([[fileName pathExtension] isEqualToString:ManifestExtension])
+        {
+            unsigned long long size = [[fileManager attributesOfItemAtPath:path error:nil] fileSize];
+            [manifestSizes setObject:[NSNumber numberWithUnsignedLongLong:size] forKey:[fileName stringByDeletingPathExtension]];
+            totalBytes += size;
+        }
+    }
+    
+    if (totalBytes <= maxDiskBytes)
+    {
+        return;
+    }
+    
+    // Remove the least recently used URLs first
+    [metadataPaths sortUsingComparator:^NSComparisonResult(id a, id b) {
+        NSDate *first = [[fileManager attributesOfItemAtPath:a error:nil] fileModificationDate];
+        NSDate *second = [[fileManager attributesOfItemAtPath:b error:nil] fileModificationDate];
+        return [first compare:second];
+    }];
+    
+    NSMutableDictionary *referenceCounts = [NSMutableDictionary dictionary];
+    NSMutableArray *contentHashes = [NSMutableArray arrayWithCapacity:[metadataPaths count]];
+    for (NSString *path in metadataPaths)
+    {
+        NSString *contentHash = [[NSDictionary dictionaryWithContentsOfFile:path] objectForKey:MetadataContentHashKey];
+        if (nil == contentHash)
+        {
+            contentHash = @"";
+        }
+        [contentHashes addObject:contentHash];
+        [referenceCounts setObject:[NSNumber numberWithInt:[[referenceCounts objectForKey:contentHash] intValue] + 1] forKey:contentHash];
+    }
+    
+    // Manifests no URL refers to any more
+    for (NSString *contentHash in [manifestSizes allKeys])
+    {
+        if (nil == [referenceCounts objectForKey:contentHash])
+        {
+            [fileManager removeItemAtPath:[self pathForName:contentHash extension:ManifestExtension] error:nil];
+            totalBytes -= [[manifestSizes objectForKey:contentHash] unsignedLongLongValue];
+        }
+    }
+    
+    for (NSUInteger i = 0; i < [metadataPaths count] && maxDiskBytes < totalBytes; ++i)
+    {
+        NSString *contentHash = [contentHashes objectAtIndex:i];
+        int references = [[referenceCounts objectForKey:contentHash] intValue] - 1;
+        
+        [fileManager removeItemAtPath:[metadataPaths objectAtIndex:i] error:nil];
+        [memoryCache removeObjectForKey:[[[metadataPaths objectAtIndex:i] lastPathComponent] stringByDeletingPathExtension]];
+        [referenceCounts setObject:[NSNumber numberWithInt:references] forKey:contentHash];
+        if (0 == references && nil != [manifestSizes objectForKey:contentHash])
+        {
+            [fileManager removeItemAtPath:[self pathForName:contentHash extension:ManifestExtension] error:nil];
+            totalBytes -= [[manifestSizes objectForKey:contentHash] unsignedLongLongValue];
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the manifest cache
+//
+// Arguments:
+// [aPath]: the directory of the disk tier, nil for SequencerManifestCache in the caches directory
+//
+// Returns: The manifest cache instance.
+//
+- (id) initWithDirectoryPath:(NSString *)aPath
+{
+    self = [super init];
+    
+    if (self){
+        if (nil == aPath)
+        {
+            NSArray *cachesPaths = NSSearchPathForDirectoriesInDomains(NSCachesDirectory, NSUserDomainMask, YES);
+            aPath = [[cachesPaths objectAtIndex:0] stringByAppendingPathComponent:@"SequencerManifestCache"];
+        }
+        directoryPath = [aPath retain];
+        [[NSFileManager defaultManager] createDirectoryAtPath:directoryPath withIntermediateDirectories:YES attributes:nil error:nil];
+        
+        memoryCache = [[NSCache alloc] init];
+        [memoryCache setTotalCostLimit:MANIFEST_CACHE_DEFAULT_MEMORY_BYTES];
+        maxDiskBytes = MANIFEST_CACHE_DEFAULT_DISK_BYTES;
+        [self resetCounters];
+    }
+    
+    return self;
+}
+
+//
+// look up the cached manifest of a URL, in memory first and then on disk
+//
+// Arguments:
+// [url]: the manifest URL
+//
+// Returns: The entry, which may be stale, or nil if the URL is not cached
+//
+- (ManifestCacheEntry *) entryForURL:(NSURL *)url
+{
+    NSString *key = [self keyForURL:url];
+    ManifestCacheEntry *entry = nil;
+    
+    @synchronized(self)
+    {
+        entry = [[[memoryCache objectForKey:key] retain] autorelease];
+        if (nil == entry)
+        {
+            entry = [self diskEntryForKey:key];
+            if (nil != entry)
+            {
+                [memoryCache setObject:entry forKey:key cost:[entry.manifest length]];
+            }
+        }
+    }
+    
+    return entry;
+}
+
+//
+// store a downloaded manifest
+//
+// Arguments:
+// [manifest]: the manifest
+// [url]: the manifest URL
+// [response]: the HTTP response of the download with the caching headers
+//
+// Returns: The new entry, or nil if the response must not or can not be cached
+//
+- (ManifestCacheEntry *) storeManifest:(NSString *)manifest forURL:(NSURL *)url withResponse:(NSHTTPURLResponse *)response
+{
+    BOOL isStorable = NO;
+    CFAbsoluteTime expirationTime = [ManifestCache expirationTimeForResponse:response isStorable:&isStorable];
+    NSString *etag = [ManifestCache headerValue:@"ETag" inResponse:response];
+    NSString *lastModified = [ManifestCache headerValue:@"Last-Modified" inResponse:response];
+    NSString *key = [self keyForURL:url];
+    
+    if (nil == manifest || !isStorable || (expirationTime <= CFAbsoluteTimeGetCurrent() && nil == etag && nil == lastModified))
+    {
+        @synchronized(self)
+        {
+            [memoryCache removeObjectForKey:key];
+            [[NSFileManager defaultManager] removeItemAtPath:[self pathForName:key extension:MetadataExtension] error:nil];
+        }
+        return nil;
+    }
+    
+    ManifestCacheEntry *entry = [[[ManifestCacheEntry alloc] initWithManifest:manifest
+                                                                          etag:etag
+                                                                  lastModified:lastModified
+                                                                expirationTime:expirationTime
+                                                                   contentHash:[ManifestCache hashOfData:[manifest dataUsingEncoding:NSUTF8StringEncoding]]] autorelease];
+    @synchronized(self)
+    {
+        [memoryCache setObject:entry forKey:key cost:[manifest length]];
+        [self writeEntry:entry forURL:url key:key];
+        [self trimDisk];
+    }
+    
+    return entry;
+}
+
+//
+// update the freshness of an entry after a 304 Not Modified response
+//
+// Arguments:
+// [entry]: the revalidated entry
+// [url]: the manifest URL
+// [response]: the 304 response
+//
+// Returns: The updated entry
+//
+- (ManifestCacheEntry *) refreshEntry:(ManifestCacheEntry *)entry forURL:(NSURL *)url withResponse:(NSHTTPURLResponse *)response
+{
+    BOOL isStorable = NO;
+    CFAbsoluteTime expirationTime = [ManifestCache expirationTimeForResponse:response isStorable:&isStorable];
+    NSString *etag = [ManifestCache headerValue:@"ETag" inResponse:response];
+    NSString *lastModified = [ManifestCache headerValue:@"Last-Modified" inResponse:response];
+    NSString *key = [self keyForURL:url];
+    
+    ManifestCacheEntry *refreshedEntry = [[[ManifestCacheEntry alloc] initWithManifest:entry.manifest
+                                                                                  etag:((nil != etag) ? etag : entry.etag)
+                                                                          lastModified:((nil != lastModified) ? lastModified : entry.lastModified)
+                                                                        expirationTime:expirationTime
+                                                                           contentHash:entry.contentHash] autorelease];
+    @synchronized(self)
+    {
+        notModifiedCount++;
+        [memoryCache setObject:refreshedEntry forKey:key cost:[refreshedEntry.manifest length]];
+        [self writeEntry:refreshedEntry forURL:url key:key];
+    }
+    
+    return refreshedEntry;
+}
+
+- (void) countHit
+{
+    @synchronized(self)
+    {
+        hitCount++;
+    }
+}
+
+- (void) countMiss
+{
+    @synchronized(self)
+    {
+        missCount++;
+    }
+}
+
+- (void) countStaleHit
+{
+    @synchronized(self)
+    {
+        staleHitCount++;
+    }
+}
+
+- (void) countRevalidation
+{
+    @synchronized(self)
+    {
+        revalidationCount++;
+    }
+}
+
+//
+// remove all the entries from memory and disk
+//
+// Arguments: none
+//
+// Returns: nothing
+//
+- (void) removeAllEntries
+{
+    @synchronized(self)
+    {
+        [memoryCache removeAllObjects];
+        NSFileManager *fileManager = [NSFileManager defaultManager];
+        for (NSString *fileName in [fileManager contentsOfDirectoryAtPath:directoryPath error:nil])
+        {
+            [fileManager removeItemAtPath:[directoryPath stringByAppendingPathComponent:fileName] error:nil];
+        }
+    }
+}
+
+- (void) resetCounters
+{
+    @synchronized(self)
+    {
+        hitCount = 0;
+        missCount = 0;
+        staleHitCount = 0;
+        revalidationCount = 0;
+        notModifiedCount = 0;
+    }
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [memoryCache release];
+    [directoryPath release];
+    
+    [super dealloc];
+}
+
+@end
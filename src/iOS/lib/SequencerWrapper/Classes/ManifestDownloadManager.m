@@ -0,0 +1,688 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "ManifestDownloadManager_Internal.h"
+#import "Trace.h"
+
+@implementation ManifestDownloadRequest
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize url;
+@synthesize priority;
+@synthesize timeout;
+@synthesize deadline;
+@synthesize cacheUsage;
+@synthesize isFinished;
+
+#pragma mark -
+#pragma mark Internal instance methods:
+
+//
+// Constructor for a download request, called by the ManifestDownloadManager
+//
+// Arguments:
+// [aManager]: the manager of the download, not retained since it keeps the request until it is finished
+// [aUrl]: the manifest URL
+// [aPriority]: the priority of the download
+// [aTimeout]: the timeout of the connection
+// [aDeadline]: the absolute time the download has to be finished by, 0 for none
+// [aCacheUsage]: how the download uses the cache of the manager
+// [anOrder]: the request order to start downloads of the same priority in
+// [aQueue]: the queue to call the completion handler on
+// [aCompletion]: the completion handler
+//
+// Returns: The request instance.
+//
+- (id) initWithManager:(ManifestDownloadManager *)aManager url:(NSURL *)aUrl priority:(ManifestDownloadPriority)aPriority timeout:(NSTimeInterval)aTimeout deadline:(CFAbsoluteTime)aDeadline cacheUsage:(ManifestDownloadCacheUsage)aCacheUsage order:(uint64_t)anOrder completionQueue:(dispatch_queue_t)aQueue completion:(ManifestDownloadCompletionHandler)aCompletion
+{
+    self = [super init];
+    
+    if (self){
+        manager = aManager;
+        url = [aUrl retain];
+        priority = aPriority;
+        timeout = aTimeout;
+        deadline = aDeadline;
+        cacheUsage = aCacheUsage;
+        order = anOrder;
+        completionQueue = aQueue;
+        dispatch_retain(completionQueue);
+        completion = [aCompletion copy];
+        connection = nil;
+        data = nil;
+        statusCode = 0;
+        response = nil;
+        cachedEntry = nil;
+        isFinished = NO;
+    }
+    
+    return self;
+}
+
+- (NSString *) hostKey
+{
+    NSString *host = [url host];
+    
+    return (nil == host) ? @"" : [host lowercaseString];
+}
+
+- (NSComparisonResult) compareForStart:(ManifestDownloadRequest *)other
+{
+    if (priority != other->priority)
+    {
+        return (priority > other->priority) ? NSOrderedAscending : NSOrderedDescending;
+    }
+    
+    return (order < other->order) ? NSOrderedAscending : NSOrderedDescending;
+}
+
+- (void) setCachedEntry:(ManifestCacheEntry *)entry
+{
+    [entry retain];
+    [cachedEntry release];
+    cachedEntry = entry;
+}
+
+//
+// open the connection of the download, called on the manager delegate queue
+//
+// Arguments:
+// [queue]: the manager delegate queue to receive the connection callbacks on
+//
+// Returns: YES for success and NO if the deadline has passed or the connection could not be created
+//
+- (BOOL) startWithDelegateQueue:(NSOperationQueue *)queue
+{
+    NSTimeInterval requestTimeout = timeout;
+    
+    if (0 < deadline && deadline - CFAbsoluteTimeGetCurrent() < requestTimeout)
+    {
+        requestTimeout = deadline - CFAbsoluteTimeGetCurrent();
+    }
+    if (requestTimeout <= 0)
+    {
+        return NO;
+    }
+    
+    NSMutableURLRequest *request = nil;
+    if (ManifestDownloadCacheUsage_Bypass == cacheUsage || nil == [manager cache])
+    {
+        request = [NSMutableURLRequest requestWithURL:url cachePolicy:NSURLRequestUseProtocolCachePolicy timeoutInterval:requestTimeout];
+    }
+    else
+    {
+        // The manager cache does the revalidation, a 304 response has to reach the delegate
+        request = [NSMutableURLRequest requestWithURL:url cachePolicy:NSURLRequestReloadIgnoringLocalCacheData timeoutInterval:requestTimeout];
+        if (cachedEntry.hasValidators)
+        {
+            if (nil != cachedEntry.etag)
+            {
+                [request setValue:cachedEntry.etag forHTTPHeaderField:@"If-None-Match"];
+            }
+            if (nil != cachedEntry.lastModified)
+            {
+                [request setValue:cachedEntry.lastModified forHTTPHeaderField:@"If-Modified-Since"];
+            }
+            [[manager cache] countRevalidation];
+        }
+    }
+    connection = [[NSURLConnection alloc] initWithRequest:request delegate:self startImmediately:NO];
+    if (nil == connection)
+    {
+        return NO;
+    }
+    
+    SEQUENCER_LOG(@"start downloading for url %@", url);
+    data = [[NSMutableData alloc] init];
+    [connection setDelegateQueue:queue];
+    [connection start];
+    
+    return YES;
+}
+
+//
+// call the completion handler unless it has been called already, called on the manager delegate queue.
+// A stale cached manifest is delivered before the download finishes revalidating it.
+//
+// Arguments:
+// [manifest]: the manifest, nil for failure
+// [error]: the error for failure
+//
+// Returns: nothing
+//
+- (void) deliverManifest:(NSString *)manifest error:(NSError *)error
+{
+    if (nil == completion)
+    {
+        return;
+    }
+    
+    ManifestDownloadCompletionHandler handler = completion;
+    completion = nil;
+    dispatch_async(completionQueue, ^{
+        handler(manifest, error);
+        [handler release];
+    });
+}
+
+//
+// finish the download and call the completion handler, called on the manager delegate queue
+//
+// Arguments:
+// [manifest]: the downloaded manifest, nil for failure
+// [error]: the error for failure
+//
+// Returns: nothing
+//
+- (void) finishWithManifest:(NSString *)manifest error:(NSError *)error
+{
+    if (isFinished)
+    {
+        return;
+    }
+    isFinished = YES;
+    manager = nil;
+    
+    [connection cancel];
+    [connection release];
+    connection = nil;
+    [data release];
+    data = nil;
+    [response release];
+    response = nil;
+    [cachedEntry release];
+    cachedEntry = nil;
+    
+    [self deliverManifest:manifest error:error];
+}
+
+#pragma mark -
+#pragma mark Notification callbacks:
+
+- (void) connection:(NSURLConnection *)aConnection didReceiveResponse:(NSURLResponse *)aResponse
+{
+    if (aConnection == connection)
+    {
+        if ([aResponse isKindOfClass:[NSHTTPURLResponse class]])
+        {
+            [response release];
+            response = (NSHTTPURLResponse *)[aResponse retain];
+            statusCode = [response statusCode];
+        }
+        [data setLength:0];
+    }
+}
+
+- (void) connection:(NSURLConnection *)aConnection didReceiveData:(NSData *)someData
+{
+    if (aConnection == connection)
+    {
+        [data appendData:someData];
+    }
+}
+
+- (void) connectionDidFinishLoading:(NSURLConnection *)aConnection
+{
+    if (aConnection == connection)
+    {
+        NSString *manifest = nil;
+        NSError *error = nil;
+        ManifestCache *cache = (ManifestDownloadCacheUsage_Bypass == cacheUsage) ? nil : [manager cache];
+        
+        if (304 == statusCode && nil != cachedEntry)
+        {
+            manifest = [cache refreshEntry:cachedEntry forURL:url withResponse:response].manifest;
+            if (nil == manifest)
+            {
+                manifest = cachedEntry.manifest;
+            }
+        }
+        else if (400 <= statusCode)
+        {
+            NSMutableDictionary *userInfo = [[NSMutableDictionary alloc] init];
+            [userInfo setObject:@"PLAYER_SEQUENCER:DownloadError" forKey:NSLocalizedDescriptionKey];
+            [userInfo setObject:[NSString stringWithFormat:@"HTTP status %d for %@", statusCode, url] forKey:NSLocalizedFailureReasonErrorKey];
+            error = [NSError errorWithDomain:@"PLAYER_SEQUENCER" code:statusCode userInfo:userInfo];
+            [userInfo release];
+        }
+        else
+        {
+            manifest = [[[NSString alloc] initWithData:data encoding:NSASCIIStringEncoding] autorelease];
+            if (200 <= statusCode && statusCode < 300)
+            {
+                [cache storeManifest:manifest forURL:url withResponse:response];
+            }
+        }
+        
+        [manager requestDidFinish:self withManifest:manifest error:error];
+    }
+}
+
+- (void) connection:(NSURLConnection *)aConnection didFailWithError:(NSError *)error
+{
+    if (aConnection == connection)
+    {
+        [manager requestDidFinish:self withManifest:nil error:error];
+    }
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// cancel the download. The completion handler is called with an NSURLErrorCancelled error
+// unless the download has finished already.
+//
+// Arguments: none
+//
+// Returns: nothing
+//
+- (void) cancel
+{
+    [manager cancelRequest:self withErrorCode:NSURLErrorCancelled];
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [url release];
+    dispatch_release(completionQueue);
+    [completion release];
+    [connection release];
+    [data release];
+    [response release];
+    [cachedEntry release];
+    
+    [super dealloc];
+}
+
+@end
+
+@implementation ManifestDownloadManager
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize maxConcurrentDownloads;
+@synthesize maxDownloadsPerHost;
+@synthesize cache;
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+// Called on the delegate queue
+- (void) startPendingRequests
+{
+    NSUInteger index = 0;
+    
+    while (index < [pendingRequests count] && [activeRequests count] < maxConcurrentDownloads)
+    {
+        ManifestDownloadRequest *request = [[pendingRequests objectAtIndex:index] retain];
+        NSString *host = [request hostKey];
+        NSUInteger hostCount = [[activeCountByHost objectForKey:host] unsignedIntegerValue];
+        
+        if (maxDownloadsPerHost <= hostCount)
+        {
+            // keep the request waiting for a connection to its host
+            [request release];
+            ++index;
+            continue;
+        }
+        
+        [pendingRequests removeObjectAtIndex:index];
+        if ([request startWithDelegateQueue:delegateQueue])
+        {
+            [activeRequests addObject:request];
+            [activeCountByHost setObject:[NSNumber numberWithUnsignedInteger:hostCount + 1] forKey:host];
+        }
+        else
+        {
+            BOOL isExpired = (0 < request.deadline && request.deadline <= CFAbsoluteTimeGetCurrent());
+            [request finishWithManifest:nil error:[NSError errorWithDomain:NSURLErrorDomain
+                                                                      code:(isExpired ? NSURLErrorTimedOut : NSURLErrorBadURL)
+                                                                  userInfo:[NSDictionary dictionaryWithObject:request.url forKey:NSURLErrorFailingURLErrorKey]]];
+        }
+        [request release];
+    }
+}
+
+// Called on the delegate queue
+- (void) removeRequest:(ManifestDownloadRequest *)request
+{
+    NSUInteger index = [activeRequests indexOfObjectIdenticalTo:request];
+    
+    if (NSNotFound != index)
+    {
+        NSString *host = [request hostKey];
+        NSUInteger hostCount = [[activeCountByHost objectForKey:host] unsignedIntegerValue];
+        if (1 < hostCount)
+        {
+            [activeCountByHost setObject:[NSNumber numberWithUnsignedInteger:hostCount - 1] forKey:host];
+        }
+        else
+        {
+            [activeCountByHost removeObjectForKey:host];
+        }
+        [activeRequests removeObjectAtIndex:index];
+    }
+    else
+    {
+        [pendingRequests removeObjectIdenticalTo:request];
+    }
+}
+
+// Called on the delegate queue
+- (void) enqueueRequest:(ManifestDownloadRequest *)request
+{
+    ManifestCache *requestCache = (ManifestDownloadCacheUsage_Bypass == request.cacheUsage) ? nil : self.cache;
+    ManifestCacheEntry *entry = [requestCache entryForURL:request.url];
+    
+    if (nil != entry)
+    {
+        if (entry.isFresh)
+        {
+            [requestCache countHit];
+            [request finishWithManifest:entry.manifest error:nil];
+            return;
+        }
+        
+        [request setCachedEntry:entry];
+        if (ManifestDownloadCacheUsage_AllowStale == request.cacheUsage)
+        {
+            // Stale while revalidate: the download still runs to refresh the cache
+            [requestCache countStaleHit];
+            [request deliverManifest:entry.manifest error:nil];
+        }
+    }
+    else
+    {
+        [requestCache countMiss];
+    }
+    
+    NSUInteger index = [pendingRequests indexOfObject:request
+                                        inSortedRange:NSMakeRange(0, [pendingRequests count])
+                                              options:NSBinarySearchingInsertionIndex
+                                      usingComparator:^NSComparisonResult(id a, id b) {
+                                          return [(ManifestDownloadRequest *)a compareForStart:(ManifestDownloadRequest *)b];
+                                      }];
+    [pendingRequests insertObject:request atIndex:index];
+    [self startPendingRequests];
+}
+
+#pragma mark -
+#pragma mark Internal instance methods:
+
+// Called on the delegate queue
+- (void) requestDidFinish:(ManifestDownloadRequest *)request withManifest:(NSString *)manifest error:(NSError *)error
+{
+    [request retain];
+    [self removeRequest:request];
+    [request finishWithManifest:manifest error:error];
+    [request release];
+    
+    [self startPendingRequests];
+}
+
+- (void) cancelRequest:(ManifestDownloadRequest *)request withErrorCode:(NSInteger)code
+{
+    [delegateQueue addOperationWithBlock:^{
+        if (!request.isFinished)
+        {
+            [self requestDidFinish:request withManifest:nil error:[NSError errorWithDomain:NSURLErrorDomain
+                                                                                      code:code
+                                                                                  userInfo:[NSDictionary dictionaryWithObject:request.url forKey:NSURLErrorFailingURLErrorKey]]];
+        }
+    }];
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the download manager
+//
+// Arguments: none
+//
+// Returns: The download manager instance.
+//
+- (id) init
+{
+    self = [super init];
+    
+    if (self){
+        // The serial delegate queue receives the connection callbacks and owns the request lists
+        delegateQueue = [[NSOperationQueue alloc] init];
+        [delegateQueue setMaxConcurrentOperationCount:1];
+        pendingRequests = [[NSMutableArray alloc] init];
+        activeRequests = [[NSMutableArray alloc] init];
+        activeCountByHost = [[NSMutableDictionary alloc] init];
+        maxConcurrentDownloads = MANIFEST_DOWNLOAD_DEFAULT_MAX_CONCURRENT;
+        maxDownloadsPerHost = MANIFEST_DOWNLOAD_DEFAULT_MAX_PER_HOST;
+        requestCount = 0;
+        cache = nil;
+    }
+    
+    return self;
+}
+
+//
+// download a manifest asynchronously
+//
+// Arguments:
+// [url]: the download url
+// [priority]: the priority of the download
+// [timeout]: the timeout of the connection in seconds
+// [deadline]: the time in seconds from now the download has to be finished in, including the
+// time waiting for a connection, 0 for none
+// [queue]: the queue to call the completion handler on, NULL for the main queue
+// [completion]: the completion handler, called once with the manifest or an error
+//
+// Returns: The request to cancel the download with, nil if the url or the completion handler is missing
+//
+- (ManifestDownloadRequest *) downloadManifestWithURL:(NSURL *)url priority:(ManifestDownloadPriority)priority timeout:(NSTimeInterval)timeout deadline:(NSTimeInterval)deadline completionQueue:(dispatch_queue_t)queue completion:(ManifestDownloadCompletionHandler)completion
+{
+    return [self downloadManifestWithURL:url priority:priority timeout:timeout deadline:deadline cacheUsage:ManifestDownloadCacheUsage_Default completionQueue:queue completion:completion];
+}
+
+//
+// download a manifest asynchronously with the given use of the cache
+//
+// Arguments:
+// [url]: the download url
+// [priority]: the priority of the download
+// [timeout]: the timeout of the connection in seconds
+// [deadline]: the time in seconds from now the download has to be finished in, 0 for none
+// [usage]: how the download uses the cache of the manager
+// [queue]: the queue to call the completion handler on, NULL for the main queue
+// [completion]: the completion handler, called once with the manifest or an error
+//
+// Returns: The request to cancel the download with, nil if the url or the completion handler is missing
+//
+- (ManifestDownloadRequest *) downloadManifestWithURL:(NSURL *)url priority:(ManifestDownloadPriority)priority timeout:(NSTimeInterval)timeout deadline:(NSTimeInterval)deadline cacheUsage:(ManifestDownloadCacheUsage)usage completionQueue:(dispatch_queue_t)queue completion:(ManifestDownloadCompletionHandler)completion
+{
+    if (nil == url || nil == completion)
+    {
+        return nil;
+    }
+    
+    uint64_t order = 0;
+    @synchronized(self)
+    {
+        order = ++requestCount;
+    }
+    
+    ManifestDownloadRequest *request = [[[ManifestDownloadRequest alloc] initWithManager:self
+                                                                                     url:url
+                                                                                priority:priority
+                                                                                 timeout:timeout
+                                                                                deadline:((0 < deadline) ? CFAbsoluteTimeGetCurrent() + deadline : 0)
+                                                                              cacheUsage:usage
+                                                                                   order:order
+                                                                         completionQueue:((NULL == queue) ? dispatch_get_main_queue() : queue)
+                                                                              completion:completion] autorelease];
+    
+    [delegateQueue addOperationWithBlock:^{
+        [self enqueueRequest:request];
+    }];
+    
+    if (0 < deadline)
+    {
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(deadline * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [self cancelRequest:request withErrorCode:NSURLErrorTimedOut];
+        });
+    }
+    
+    return request;
+}
+
+//
+// download a manifest and wait for it. This must not be called from a completion handler
+// of the manager.
+//
+// Arguments:
+// [manifest]: the downloaded manifest, retained for the caller
+// [url]: the download url
+// [priority]: the priority of the download
+// [deadline]: the time in seconds from now the download has to be finished in, 0 for none
+// [error]: the error for failure, may be nil
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) downloadManifest:(NSString **)manifest withURL:(NSURL *)url priority:(ManifestDownloadPriority)priority deadline:(NSTimeInterval)deadline error:(NSError **)error
+{
+    return [self downloadManifest:manifest withURL:url priority:priority deadline:deadline cacheUsage:ManifestDownloadCacheUsage_Default error:error];
+}
+
+//
+// download a manifest with the given use of the cache and wait for it
+//
+// Arguments:
+// [manifest]: the downloaded manifest, retained for the caller
+// [url]: the download url
+// [priority]: the priority of the download
+// [deadline]: the time in seconds from now the download has to be finished in, 0 for none
+// [usage]: how the download uses the cache of the manager
+// [error]: the error for failure, may be nil
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) downloadManifest:(NSString **)manifest withURL:(NSURL *)url priority:(ManifestDownloadPriority)priority deadline:(NSTimeInterval)deadline cacheUsage:(ManifestDownloadCacheUsage)usage error:(NSError **)error
+{
+    assert(nil != manifest);
+    __block NSString *result = nil;
+    __block NSError *resultError = nil;
+    dispatch_semaphore_t finished = dispatch_semaphore_create(0);
+    
+    ManifestDownloadRequest *request = [self downloadManifestWithURL:url
+                                                            priority:priority
+                                                             timeout:MANIFEST_DOWNLOAD_DEFAULT_TIMEOUT
+                                                            deadline:deadline
+                                                          cacheUsage:usage
+                                                     completionQueue:dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_HIGH, 0)
+                                                          completion:^(NSString *aManifest, NSError *anError) {
+                                                              result = [aManifest retain];
+                                                              resultError = [anError retain];
+                                                              dispatch_semaphore_signal(finished);
+                                                          }];
+    if (nil != request)
+    {
+        dispatch_semaphore_wait(finished, DISPATCH_TIME_FOREVER);
+    }
+    else
+    {
+        resultError = [[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorBadURL userInfo:nil] retain];
+    }
+    dispatch_release(finished);
+    
+    *manifest = result;
+    if (nil != error)
+    {
+        *error = [resultError autorelease];
+    }
+    else
+    {
+        [resultError release];
+    }
+    
+    return (nil != result);
+}
+
+//
+// cancel all the downloads. Their completion handlers are called with an NSURLErrorCancelled error.
+//
+// Arguments: none
+//
+// Returns: nothing
+//
+- (void) cancelAllDownloads
+{
+    [delegateQueue addOperationWithBlock:^{
+        NSArray *requests = [activeRequests arrayByAddingObjectsFromArray:pendingRequests];
+        [activeRequests removeAllObjects];
+        [pendingRequests removeAllObjects];
+        [activeCountByHost removeAllObjects];
+        
+        for (ManifestDownloadRequest *request in requests)
+        {
+            [request finishWithManifest:nil error:[NSError errorWithDomain:NSURLErrorDomain
+                                                                      code:NSURLErrorCancelled
+                                                                  userInfo:[NSDictionary dictionaryWithObject:request.url forKey:NSURLErrorFailingURLErrorKey]]];
+        }
+    }];
+}
+
+- (void) setMaxConcurrentDownloads:(NSUInteger)value
+{
+    [delegateQueue addOperationWithBlock:^{
+        maxConcurrentDownloads = value;
+        [self startPendingRequests];
+    }];
+}
+
+- (void) setMaxDownloadsPerHost:(NSUInteger)value
+{
+    [delegateQueue addOperationWithBlock:^{
+        maxDownloadsPerHost = value;
+        [self startPendingRequests];
+    }];
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    // No block refers to the manager any more, so only connection callbacks can still be queued
+    [delegateQueue cancelAllOperations];
+    [delegateQueue waitUntilAllOperationsAreFinished];
+    
+    for (ManifestDownloadRequest *request in [activeRequests arrayByAddingObjectsFromArray:pendingRequests])
+    {
+        [request finishWithManifest:nil error:[NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorCancelled userInfo:nil]];
+    }
+    [activeRequests release];
+    [pendingRequests release];
+    [activeCountByHost release];
+    [delegateQueue release];
+    [cache release];
+    
+    [super dealloc];
+}
+
+@end
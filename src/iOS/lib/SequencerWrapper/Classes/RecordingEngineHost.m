@@ -0,0 +1,170 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "RecordingEngineHost.h"
+#import "Trace.h"
+
+#define TRACE_FORMAT_VERSION 1
+#define TRACE_BUFFER_FLUSH_SIZE (64 * 1024)
+
+@implementation RecordingEngineHost
+
+#pragma mark -
+#pragma mark Properties:
+
+- (uint32_t) evaluationCount
+{
+    return engineHost.evaluationCount;
+}
+
+- (NSTimeInterval) evaluationTime
+{
+    return engineHost.evaluationTime;
+}
+
+- (BOOL) requiresMainThread
+{
+    return engineHost.requiresMainThread;
+}
+
+#pragma mark -
+#pragma mark Private instance methods:
+
+- (void) appendTraceRecord:(id)record
+{
+    NSError *error = nil;
+    NSData *data = [NSJSONSerialization dataWithJSONObject:record options:0 error:&error];
+    if (nil == data)
+    {
+        NSLog(@"Failed to serialize the trace record: %@", error);
+        return;
+    }
+    
+    [traceBuffer appendData:data];
+    [traceBuffer appendBytes:"\n" length:1];
+    if (TRACE_BUFFER_FLUSH_SIZE <= [traceBuffer length])
+    {
+        [self flush];
+    }
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the recording engine host
+//
+// Arguments:
+// [anEngineHost]: the engine host which evaluates the scripts
+// [tracePath]: the path of the trace file, which is overwritten
+//
+// Returns: The engine host instance, nil if the trace file cannot be created.
+//
+- (id) initWithEngineHost:(id<JavaScriptEngineHost>)anEngineHost tracePath:(NSString *)tracePath
+{
+    self = [super init];
+    
+    if (self){
+        engineHost = [anEngineHost retain];
+        traceBuffer = [[NSMutableData alloc] init];
+        startTime = CFAbsoluteTimeGetCurrent();
+        traceFile = nil;
+        
+        if (![[NSFileManager defaultManager] createFileAtPath:tracePath contents:nil attributes:nil])
+        {
+            NSLog(@"Failed to create the trace file %@", tracePath);
+            [self release];
+            return nil;
+        }
+        traceFile = [[NSFileHandle fileHandleForWritingAtPath:tracePath] retain];
+        
+        // The first line is the trace header, each following line is one
+        // [time in ms, script, result, evaluation time in ms] record
+        [self appendTraceRecord:[NSDictionary dictionaryWithObjectsAndKeys:
+                                 @"SequencerBridgeTrace", @"format",
+                                 [NSNumber numberWithInt:TRACE_FORMAT_VERSION], @"version",
+                                 nil]];
+    }
+    
+    return self;
+}
+
+//
+// evaluate a script in the wrapped engine host and record it
+//
+// Arguments:
+// [script]: the script to evaluate
+//
+// Returns: the result of the script from the wrapped engine host
+//
+- (NSString *) evaluateScript:(NSString *)script
+{
+    CFAbsoluteTime callTime = CFAbsoluteTimeGetCurrent();
+    NSString *result = [engineHost evaluateScript:script];
+    NSTimeInterval elapsed = CFAbsoluteTimeGetCurrent() - callTime;
+    
+    // The host can be called from the main thread and the framework engine queue
+    @synchronized(self)
+    {
+        [self appendTraceRecord:[NSArray arrayWithObjects:
+                                 [NSNumber numberWithDouble:(callTime - startTime) * 1000],
+                                 script,
+                                 (nil == result) ? @"" : result,
+                                 [NSNumber numberWithDouble:elapsed * 1000],
+                                 nil]];
+    }
+    
+    return result;
+}
+
+//
+// write the buffered trace records to the trace file
+//
+// Arguments: none
+//
+// Returns: none
+//
+- (void) flush
+{
+    @synchronized(self)
+    {
+        if (0 < [traceBuffer length])
+        {
+            [traceFile writeData:traceBuffer];
+            [traceBuffer setLength:0];
+        }
+    }
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    SEQUENCER_LOG(@"RecordingEngineHost dealloc called.");
+    
+    if (nil != traceFile)
+    {
+        [self flush];
+        [traceFile closeFile];
+    }
+    [traceFile release];
+    [traceBuffer release];
+    [engineHost release];
+    
+    [super dealloc];
+}
+
+@end
@@ -26,14 +26,67 @@
 #pragma mark -
 #pragma mark Internal class methods:
 
++ (NSString *) rollTypeFromAdType:(AdType)adType
+{
+    NSString *eRollType = nil;
+    switch (adType) {
+        case AdType_Preroll:
+            eRollType = @"Pre";
+            break;
+            
+        case AdType_Midroll:
+            eRollType = @"Mid";
+            break;
+            
+        case AdType_Postroll:
+            eRollType = @"Post";
+            break;
+            
+        case AdType_Pod:
+            eRollType = @"Pod";
+            break;
+            
+        default:
+            eRollType = @"Mid";
+            break;
+    }
+    
+    return eRollType;
+}
+
++ (NSString *) clipTypeFromPlaylistEntryType:(PlaylistEntryType)type
+{
+    NSString *eClipType = nil;
+    switch (type) {
+        case PlaylistEntryType_Media:
+            eClipType = @"Media";
+            break;
+        
+        case PlaylistEntryType_VAST:
+            eClipType = @"VAST";
+            break;
+            
+        case PlaylistEntryType_SeekToStart:
+            eClipType = @"SeekToStart";
+            break;
+            
+        default:
+            eClipType = @"Static";
+            break;
+    }
+    
+    return eClipType;
+}
 
 #pragma mark -
 #pragma mark Private instance methods:
 
-- (NSString *) callJavaScriptWithString:(NSString *)aString
+// Read-only queries of the sequential playlist, such as the periodic range queries of the
+// lazy ad breaks and the VAST prefetch, do not invalidate the seekbar mapping
+- (NSString *) queryJavaScriptWithString:(NSString *)aString
 {
     SEQUENCER_LOG(@"JavaScript call: %s", [aString cStringUsingEncoding:NSUTF8StringEncoding]);
-    NSString *result = [webView stringByEvaluatingJavaScriptFromString:aString];
+    NSString *result = [engineHost evaluateScript:aString];
     
     SEQUENCER_LOG(@"JavaScript result is %@", result);
 
@@ -47,6 +100,15 @@
     return result;
 }
 
+- (NSString *) callJavaScriptWithString:(NSString *)aString
+{
+    // Any scheduler call may change the sequential playlist, the Sequencer uses the count to
+    // invalidate its seekbar mapping
+    javaScriptCallCount++;
+    
+    return [self queryJavaScriptWithString:aString];
+}
+
 #pragma mark -
 #pragma mark Notification callbacks:
 
@@ -59,17 +121,18 @@
 // Constructor for the sequencer
 //
 // Arguments:
-// [aWebView]    UIWebView used for JavaScript calls
+// [anEngineHost]    JavaScript engine host used for JavaScript calls
 //
 // Returns: The scheduler instance.
 //
-- (id) initWithUIWebView:(UIWebView *)aWebView;
+- (id) initWithEngineHost:(id<JavaScriptEngineHost>)anEngineHost;
 {
     self = [super init];
     
     if (self){
-        webView = aWebView;
+        engineHost = anEngineHost;
         lastError = nil;
+        javaScriptCallCount = 0;
     }
     
     return self;
@@ -92,47 +155,8 @@
     NSString *result = nil;
 
     // playback policy object is ignored for now. The app is responsible to set and enforce playback policy
-    NSString *eRollType = nil;
-    switch (ad.type) {
-        case AdType_Preroll:
-            eRollType = @"Pre";
-            break;
-            
-        case AdType_Midroll:
-            eRollType = @"Mid";
-            break;
-            
-        case AdType_Postroll:
-            eRollType = @"Post";
-            break;
-            
-        case AdType_Pod:
-            eRollType = @"Pod";
-            break;
-            
-        default:
-            eRollType = @"Mid";
-            break;
-    }
-    
-    NSString *eClipType = nil;
-    switch (type) {
-        case PlaylistEntryType_Media:
-            eClipType = @"Media";
-            break;
-        
-        case PlaylistEntryType_VAST:
-            eClipType = @"VAST";
-            break;
-            
-        case PlaylistEntryType_SeekToStart:
-            eClipType = @"SeekToStart";
-            break;
-            
-        default:
-            eClipType = @"Static";
-            break;
-    }
+    NSString *eRollType = [Scheduler rollTypeFromAdType:ad.type];
+    NSString *eClipType = [Scheduler clipTypeFromPlaylistEntryType:type];
     
     NSString *function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.scheduler.runJSON("
                           "\"{\\\"func\\\": \\\"scheduleClip\\\","
@@ -172,6 +196,74 @@
     return (nil != result);
 }
 
+//
+// schedule a set of ad clips in the framework with a single call. The clips are
+// validated as a set and nothing is scheduled if any of them fails.
+//
+// Arguments:
+// [ads]: The AdInfo objects for the ad clips to be scheduled. An ad of type AdType_Pod
+//        with appendTo of -1 is appended to the ad before it in the array
+// [linearTimes]: The LinearTime objects for the ads, in the same order as ads
+// [type]: The type of the ads
+// [clipIds]: The output array the clipIds (NSNumber) for the scheduled clips are added to
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) scheduleClips:(NSArray *)ads atTimes:(NSArray *)linearTimes forType:(PlaylistEntryType)type andGetClipIds:(NSMutableArray *)clipIds
+{
+    assert (nil != clipIds);
+    assert ([ads count] == [linearTimes count]);
+    NSString *result = nil;
+    
+    NSString *eClipType = [Scheduler clipTypeFromPlaylistEntryType:type];
+    NSMutableString *function = [NSMutableString stringWithString:@"PLAYER_SEQUENCER.scheduler.runJSON("
+                                 "\"{\\\"func\\\": \\\"scheduleClips\\\","
+                                 "\\\"params\\\": "
+                                 "{ \\\"clips\\\": ["];
+    
+    for (NSUInteger i = 0; i < [ads count]; ++i)
+    {
+        AdInfo *ad = (AdInfo *)[ads objectAtIndex:i];
+        LinearTime *linearTime = (LinearTime *)[linearTimes objectAtIndex:i];
+        
+        // playback policy object is ignored for now. The app is responsible to set and enforce playback policy
+        [function appendFormat:@"%s{ \\\"clipURI\\\": \\\"%s\\\", "
+                               "\\\"eClipType\\\": \\\"%@\\\", "
+                               "\\\"clipBeginMediaTime\\\": %f, "
+                               "\\\"clipEndMediaTime\\\": %f, "
+                               "\\\"startTime\\\": %f, "
+                               "\\\"linearDuration\\\": %f, "
+                               "\\\"deleteAfterPlayed\\\": %s, "
+                               "\\\"playbackPolicyObj\\\": \\\"%@\\\", "
+                               "\\\"eRollType\\\": \\\"%@\\\", "
+                               "\\\"appendTo\\\": %d }",
+                               0 == i ? "" : ", ",
+                               [[ad.clipURL absoluteString] cStringUsingEncoding:NSUTF8StringEncoding],
+                               eClipType,
+                               ad.mediaTime.clipBeginMediaTime,
+                               ad.mediaTime.clipEndMediaTime,
+                               linearTime.startTime,
+                               linearTime.duration,
+                               ad.deleteAfterPlayed ? "true" : "false",
+                               ad.policy,
+                               [Scheduler rollTypeFromAdType:ad.type],
+                               ad.appendTo];
+    }
+    [function appendString:@"] } }\")"];
+    result = [self callJavaScriptWithString:function];
+    
+    if (nil != result)
+    {
+        NSData* data = [result dataUsingEncoding:[NSString defaultCStringEncoding]];
+        NSError* error = nil;
+        NSDictionary* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
+        assert (nil == error);
+        [clipIds addObjectsFromArray:[json_out objectForKey:@"ids"]];
+    }
+    
+    return (nil != result);
+}
+
 //
 // cancel a specific ad in the framework
 //
@@ -232,6 +324,56 @@
     return (nil != result);
 }
 
+//
+// append a set of main content clips to the playlist in the framework with a single call.
+// The clips are validated as a set and nothing is appended if any of them fails.
+//
+// Arguments:
+// [clipURLs]: The URLs of the clips to be appended, in playback order
+// [mediaTimes]: The MediaTime objects for the clips, in the same order as clipURLs
+// [clipIds]: The output array the clipIds (NSNumber) for the appended clips are added to
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) appendContentClips:(NSArray *)clipURLs withMediaTimes:(NSArray *)mediaTimes andGetClipIds:(NSMutableArray *)clipIds
+{
+    assert (nil != clipIds);
+    assert ([clipURLs count] == [mediaTimes count]);
+    NSString *result = nil;
+    
+    NSMutableString *function = [NSMutableString stringWithString:@"PLAYER_SEQUENCER.scheduler.runJSON("
+                                 "\"{\\\"func\\\": \\\"appendContentClips\\\","
+                                 "\\\"params\\\": "
+                                 "{ \\\"clips\\\": ["];
+    
+    for (NSUInteger i = 0; i < [clipURLs count]; ++i)
+    {
+        NSURL *clipURL = (NSURL *)[clipURLs objectAtIndex:i];
+        MediaTime *mediaTime = (MediaTime *)[mediaTimes objectAtIndex:i];
+        
+        [function appendFormat:@"%s{ \\\"clipURI\\\": \\\"%s\\\", "
+                               "\\\"clipBeginMediaTime\\\": %f, "
+                               "\\\"clipEndMediaTime\\\": %f }",
+                               0 == i ? "" : ", ",
+                               [[clipURL absoluteString] cStringUsingEncoding:NSUTF8StringEncoding],
+                               mediaTime.clipBeginMediaTime,
+                               mediaTime.clipEndMediaTime];
+    }
+    [function appendString:@"] } }\")"];
+    result = [self callJavaScriptWithString:function];
+    
+    if (nil != result)
+    {
+        NSData* data = [result dataUsingEncoding:[NSString defaultCStringEncoding]];
+        NSError* error = nil;
+        NSDictionary* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
+        assert (nil == error);
+        [clipIds addObjectsFromArray:[json_out objectForKey:@"ids"]];
+    }
+    
+    return (nil != result);
+}
+
 //
 // set the SeekToStart entry in the sequential playlist
 //
@@ -275,9 +417,98 @@
     return (nil != result);
 }
 
+//
+// get the playlist entries of a type that overlap a linear time range
+//
+// Arguments:
+// [entries]: The output array of entries in playlist order. Each entry is an NSDictionary with the keys
+//            id, eClipType, clipURI, linearStartTime and linearDuration
+// [type]: The type of the entries to get
+// [startTime]: The start of the range in linear time (inclusive)
+// [endTime]: The end of the range in linear time (exclusive)
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) getEntries:(NSArray **)entries ofType:(PlaylistEntryType)type inRangeFrom:(NSTimeInterval)startTime to:(NSTimeInterval)endTime
+{
+    assert (nil != entries);
+    NSString *result = nil;
+    *entries = nil;
+    
+    NSString *function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.scheduler.runJSON("
+                           "\"{\\\"func\\\": \\\"getEntriesInRange\\\", "
+                           "\\\"params\\\": "
+                           "{ \\\"startTime\\\": %f, "
+                           "\\\"endTime\\\": %f, "
+                           "\\\"eClipType\\\": \\\"%@\\\" } }\")",
+                           startTime,
+                           endTime,
+                           [Scheduler clipTypeFromPlaylistEntryType:type]] autorelease];
+    result = [self queryJavaScriptWithString:function];
+    
+    if (nil != result)
+    {
+        NSData* data = [result dataUsingEncoding:[NSString defaultCStringEncoding]];
+        NSError* error = nil;
+        NSDictionary* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
+        assert (nil == error);
+        *entries = [json_out objectForKey:@"entries"];
+    }
+    
+    return (nil != result);
+}
+
+//
+// get the changes made to the sequential playlist after a given version
+//
+// Arguments:
+// [changes]: The output array of changes. Each change is an NSDictionary with the keys
+//            version, operation ("insert", "split", "weld", "update", "remove" or "removeAll"),
+//            id, idRelated, linearStartTime and linearDuration
+// [sinceVersion]: The playlist version last seen by the caller, 0 for all the changes kept
+// [currentVersion]: The output current version of the playlist
+// [isComplete]: The output flag that is NO if older changes were dropped from the bounded
+//               journal, in which case the caller has to read the whole playlist again
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) getPlaylistChanges:(NSArray **)changes sinceVersion:(int32_t)sinceVersion currentVersion:(int32_t *)currentVersion isComplete:(BOOL *)isComplete
+{
+    assert (nil != changes);
+    assert (nil != currentVersion);
+    assert (nil != isComplete);
+    NSString *result = nil;
+    *changes = nil;
+    
+    NSString *function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.scheduler.runJSON("
+                           "\"{\\\"func\\\": \\\"getPlaylistChanges\\\", "
+                           "\\\"params\\\": "
+                           "{\\\"sinceVersion\\\": %d } }\")",
+                           sinceVersion] autorelease];
+    result = [self queryJavaScriptWithString:function];
+    
+    if (nil != result)
+    {
+        NSData* data = [result dataUsingEncoding:[NSString defaultCStringEncoding]];
+        NSError* error = nil;
+        NSDictionary* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
+        assert (nil == error);
+        *changes = [json_out objectForKey:@"changes"];
+        *currentVersion = [[json_out objectForKey:@"version"] intValue];
+        *isComplete = [[json_out objectForKey:@"isComplete"] boolValue];
+    }
+    
+    return (nil != result);
+}
+
 #pragma mark -
 #pragma mark Properties:
 
+- (uint32_t) javaScriptCallCount
+{
+    return javaScriptCallCount;
+}
+
 - (BOOL) isReady
 {
     NSString *result = nil;
@@ -286,7 +517,7 @@
     function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.scheduler.runJSON("
                  "\"{\\\"func\\\": \\\"createContentClipParams\\\" }\")"] autorelease];
     SEQUENCER_LOG(@"JavaScript call: %s", [function cStringUsingEncoding:NSUTF8StringEncoding]);
-    result = [webView stringByEvaluatingJavaScriptFromString:function];
+    result = [engineHost evaluateScript:function];
     
     SEQUENCER_LOG(@"JavaScript result is %@", result);
     
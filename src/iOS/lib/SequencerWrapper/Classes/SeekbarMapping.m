@@ -0,0 +1,172 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "SeekbarMapping.h"
+
+@implementation SeekbarMapping
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize segmentId;
+@synthesize playbackPolicy;
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the seekbar mapping
+//
+// Arguments:
+// [json]: the getSeekbarMapping result of the sequencer plugin chain
+// [aSegmentId]: the playback segment the mapping was exported for
+// [aSequencerCallCount]: the Sequencer JavaScript call count after the mapping was exported
+// [aSchedulerCallCount]: the Scheduler JavaScript call count after the mapping was exported
+//
+// Returns: The seekbar mapping instance.
+//
+- (id) initWithJSON:(NSDictionary *)json segmentId:(int32_t)aSegmentId sequencerCallCount:(uint32_t)aSequencerCallCount schedulerCallCount:(uint32_t)aSchedulerCallCount
+{
+    self = [super init];
+
+    if (self){
+        segmentId = aSegmentId;
+        sequencerCallCount = aSequencerCallCount;
+        schedulerCallCount = aSchedulerCallCount;
+        seekbarOffset = [[json objectForKey:@"seekbarOffset"] doubleValue];
+        minSeekbarPosition = [[json objectForKey:@"minSeekbarPosition"] doubleValue];
+        maxSeekbarPosition = [[json objectForKey:@"maxSeekbarPosition"] doubleValue];
+        isClampedToRange = [[json objectForKey:@"isClampedToRange"] boolValue];
+        playbackPolicy = [[json objectForKey:@"playbackPolicy"] retain];
+        clipBeginMediaTime = [[json objectForKey:@"clipBeginMediaTime"] doubleValue];
+        clipEndMediaTime = [[json objectForKey:@"clipEndMediaTime"] doubleValue];
+        isLiveWindowApplied = [[json objectForKey:@"isLiveWindowApplied"] boolValue];
+    }
+
+    return self;
+}
+
+//
+// check if the mapping can still be used
+//
+// Arguments:
+// [aSegmentId]: the current playback segment
+// [aSequencerCallCount]: the current Sequencer JavaScript call count
+// [aSchedulerCallCount]: the current Scheduler JavaScript call count
+//
+// Returns: YES if the mapping is still valid and NO otherwise
+//
+- (BOOL) isValidForSegmentId:(int32_t)aSegmentId sequencerCallCount:(uint32_t)aSequencerCallCount schedulerCallCount:(uint32_t)aSchedulerCallCount
+{
+    return (segmentId == aSegmentId &&
+            sequencerCallCount == aSequencerCallCount &&
+            schedulerCallCount == aSchedulerCallCount);
+}
+
+//
+// get seekbar time from media time for VOD content
+//
+// Arguments:
+// [seekTime]: the seekbar time to fill in
+// [position]: the current playback position in media time
+// [rate]: the current playback rate
+//
+// Returns: YES for success and NO if the sequencer needs to be called since
+// the position is outside of the segment.
+//
+- (BOOL) getSeekbarTime:(SeekbarTime *)seekTime withPlaybackPosition:(NSTimeInterval)position playbackRate:(double)rate
+{
+    assert(nil != seekTime);
+    NSTimeInterval currentSeekbarPosition = position + seekbarOffset;
+
+    // Leave the range exceeded and clip changed handling to mediaToSeekbarTime
+    if ((rate < 0 && position < clipBeginMediaTime) ||
+        (rate >= 0 && clipEndMediaTime < position))
+    {
+        return NO;
+    }
+
+    if (isClampedToRange)
+    {
+        if (currentSeekbarPosition < minSeekbarPosition)
+        {
+            currentSeekbarPosition = minSeekbarPosition;
+        }
+        else if (maxSeekbarPosition < currentSeekbarPosition)
+        {
+            currentSeekbarPosition = maxSeekbarPosition;
+        }
+    }
+
+    seekTime.currentSeekbarPosition = currentSeekbarPosition;
+    seekTime.minSeekbarPosition = minSeekbarPosition;
+    seekTime.maxSeekbarPosition = maxSeekbarPosition;
+
+    return YES;
+}
+
+//
+// get seekbar time from media time for live content
+//
+// Arguments:
+// [seekTime]: the seekbar time to fill in
+// [position]: the current playback position in media time
+// [rate]: the current playback rate
+// [leftDvrEdge]: the left edge of the DVR window in media time
+// [livePosition]: the live position in media time
+//
+// Returns: YES for success and NO if the sequencer needs to be called since
+// the position is outside of the segment or taken over by the left DVR edge.
+//
+- (BOOL) getSeekbarTime:(SeekbarTime *)seekTime withPlaybackPosition:(NSTimeInterval)position playbackRate:(double)rate leftDvrEdge:(NSTimeInterval)leftDvrEdge livePosition:(NSTimeInterval)livePosition
+{
+    if (![self getSeekbarTime:seekTime withPlaybackPosition:position playbackRate:rate])
+    {
+        return NO;
+    }
+
+    if (isLiveWindowApplied)
+    {
+        // The live sequencer plugin reports the left DVR edge take over as an error
+        if (position + seekbarOffset < leftDvrEdge)
+        {
+            return NO;
+        }
+
+        if (seekTime.minSeekbarPosition < leftDvrEdge)
+        {
+            seekTime.minSeekbarPosition = leftDvrEdge;
+        }
+
+        if (seekTime.maxSeekbarPosition > livePosition)
+        {
+            seekTime.maxSeekbarPosition = livePosition;
+        }
+    }
+
+    return YES;
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    [playbackPolicy release];
+
+    [super dealloc];
+}
+
+@end
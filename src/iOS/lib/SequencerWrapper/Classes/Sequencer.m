@@ -17,17 +17,41 @@
 #import "PlaybackSegment_Internal.h"
 #import "Scheduler_Internal.h"
 #import "AdResolver_Internal.h"
+#import "SeekbarMapping.h"
+#import "WebViewEngineHost.h"
 #import "Trace.h"
 
 // Define constant like: NSString * const NotImplementedException = @"NotImplementedException";
 NSString * const SequencerErrorDomain = @"PLAYER_SEQUENCER";
 NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
 
+// The result status values of PLAYER_SEQUENCER.sequencerStatus
+static NSString * const SequencerStatusOK = @"ok";
+static NSString * const SequencerStatusDvrTakeover = @"dvrTakeover";
+static NSString * const SequencerStatusRangeExceeded = @"rangeExceeded";
+static NSString * const SequencerStatusOutsidePlaylist = @"outsidePlaylist";
+
 @implementation Sequencer
 
 @synthesize adResolver;
 @synthesize scheduler;
 @synthesize lastError;
+@synthesize engineHost;
+
+#pragma mark -
+#pragma mark Public class methods:
+
+//
+// get the names of the script files of the sequencer core in loading order
+//
+// Arguments: none
+//
+// Returns: the array of script file names in the main bundle
+//
++ (NSArray *) scriptNames
+{
+    return [NSArray arrayWithObjects:@"SlabPool.js", @"Scheduler.js", @"Sequencer.js", @"AdResolver.js", @"SequencerPlugin.js", nil];
+}
 
 #pragma mark -
 #pragma mark Internal class methods:
@@ -76,6 +100,66 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
     return error;
 }
 
+//
+// create the error for a sequencer plugin result status
+//
+// Arguments:
+// [status]: the status of the result, one of PLAYER_SEQUENCER.sequencerStatus
+// [reason]: the failure reason of the error
+//
+// Returns: the error in SequencerErrorDomain, nil if the status is missing or ok
+//
++ (NSError *) errorWithStatus:(NSString *)status reason:(NSString *)reason
+{
+    SequencerErrorCode code = SequencerErrorCode_Unexpected;
+    
+    if (![status isKindOfClass:[NSString class]] || [status isEqualToString:SequencerStatusOK])
+    {
+        return nil;
+    }
+    
+    if ([status isEqualToString:SequencerStatusDvrTakeover])
+    {
+        code = SequencerErrorCode_DvrTakeover;
+    }
+    else if ([status isEqualToString:SequencerStatusRangeExceeded])
+    {
+        code = SequencerErrorCode_RangeExceeded;
+    }
+    else if ([status isEqualToString:SequencerStatusOutsidePlaylist])
+    {
+        code = SequencerErrorCode_OutsidePlaylist;
+    }
+    
+    NSMutableDictionary *userInfo = [[NSMutableDictionary alloc] init];
+    [userInfo setObject:[NSString stringWithFormat:@"%@:%@", SequencerErrorDomain, status] forKey:NSLocalizedDescriptionKey];
+    [userInfo setObject:reason forKey:NSLocalizedFailureReasonErrorKey];
+    NSError *error = [NSError errorWithDomain:SequencerErrorDomain code:code userInfo:userInfo];
+    [userInfo release];
+    
+    return error;
+}
+
+//
+// get the shared error for the dvrTakeover status of mediaToSeekbarTime
+//
+// Arguments: none
+//
+// Returns: the error in SequencerErrorDomain with the SequencerErrorCode_DvrTakeover code
+//
++ (NSError *) dvrTakeoverError
+{
+    static NSError *dvrTakeoverError = nil;
+    static dispatch_once_t onceToken;
+    
+    dispatch_once(&onceToken, ^{
+        dvrTakeoverError = [[Sequencer errorWithStatus:SequencerStatusDvrTakeover
+                                                reason:@"mediaToSeekbarTime failed since the current playback position is taken over by left DVR edge"] retain];
+    });
+    
+    return dvrTakeoverError;
+}
+
 + (NSString *) jsonStringFromXmlString:(NSString *)xmlString
 {
     return [[[xmlString stringByReplacingOccurrencesOfString:@"\"" withString:@"\\\\\\\""] stringByReplacingOccurrencesOfString:@"\r" withString:@"\\\r"] stringByReplacingOccurrencesOfString:@"\n" withString:@"\\\n"];
@@ -84,11 +168,8 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
 #pragma mark -
 #pragma mark Private instance methods:
 
-- (PlaybackSegment *) parseJSONPlaybackSegment:(NSString *)jsonResult
-{    
-    NSData* data = [jsonResult dataUsingEncoding:[NSString defaultCStringEncoding]];
-    NSError* error = nil;
-    NSDictionary* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
+- (PlaybackSegment *) parsePlaybackSegment:(NSDictionary *)json_out
+{
     NSDictionary *nClip = [json_out objectForKey:@"clip"];
     
     if ([NSNull null] == (NSNull *)nClip)
@@ -157,10 +238,62 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
     return segment;
 }
 
+- (PlaybackSegment *) parseJSONPlaybackSegment:(NSString *)jsonResult
+{    
+    NSData* data = [jsonResult dataUsingEncoding:[NSString defaultCStringEncoding]];
+    NSError* error = nil;
+    NSDictionary* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
+    
+    return [self parsePlaybackSegment:json_out];
+}
+
+//
+// parse the result of a seek call. A seek which failed with an expected condition
+// returns a status instead of throwing, the status is reported in lastError.
+//
+// Arguments:
+// [seekSegment]: the output playback segment, nil if there is no segment to play
+// [jsonResult]: the JSON result of the seek call
+// [functionName]: the name of the seek function for the error reason
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) parseJSONSeekResult:(NSString *)jsonResult segment:(PlaybackSegment **)seekSegment function:(NSString *)functionName
+{
+    *seekSegment = nil;
+    if ([jsonResult isEqualToString:@"null"])
+    {
+        return YES;
+    }
+    
+    NSData* data = [jsonResult dataUsingEncoding:[NSString defaultCStringEncoding]];
+    NSError* error = nil;
+    NSDictionary* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
+    if (![json_out isKindOfClass:[NSDictionary class]])
+    {
+        return YES;
+    }
+    
+    NSString *nStatus = [json_out objectForKey:@"status"];
+    NSError *statusError = [Sequencer errorWithStatus:nStatus
+                                               reason:[NSString stringWithFormat:@"%@ failed with status %@", functionName, nStatus]];
+    if (nil != statusError)
+    {
+        self.lastError = statusError;
+        return NO;
+    }
+    
+    *seekSegment = [self parsePlaybackSegment:json_out];
+    return YES;
+}
+
 - (NSString *) callJavaScriptWithString:(NSString *)aString
 {
+    // Any sequencer call may change the playback segments or the sequential playlist,
+    // so a call made after the seekbar mapping was exported invalidates it
+    javaScriptCallCount++;
     SEQUENCER_LOG(@"JavaScript call: %s", [aString cStringUsingEncoding:NSUTF8StringEncoding]);
-    NSString *result = [webView stringByEvaluatingJavaScriptFromString:aString];
+    NSString *result = [engineHost evaluateScript:aString];
     
     SEQUENCER_LOG(@"JavaScript result is %@", result);
 
@@ -174,6 +307,134 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
     return result;
 }
 
+//
+// export the media to seekbar time mapping for the segment from the sequencer plugin chain.
+// On failure, or when a plugin does not export one, the mapping is left empty so the
+// next seekbar update calls mediaToSeekbarTime again.
+//
+// Arguments:
+// [aSegment]: the current playback segment
+//
+// Returns: none
+//
+- (void) updateSeekbarMappingForSegment:(PlaybackSegment *)aSegment
+{
+    [seekbarMapping release];
+    seekbarMapping = nil;
+    
+    NSString *function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.sequencerPluginChain.runJSON("
+                           "\"{\\\"func\\\": \\\"getSeekbarMapping\\\", "
+                           "\\\"params\\\": "
+                           "{ \\\"currentSegmentId\\\": %d } }\")",
+                           aSegment.segmentId] autorelease];
+    NSString *result = [self callJavaScriptWithString:function];
+    if (nil != result)
+    {
+        NSData* data = [result dataUsingEncoding:[NSString defaultCStringEncoding]];
+        NSError* error = nil;
+        NSDictionary* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
+        if ([json_out isKindOfClass:[NSDictionary class]])
+        {
+            seekbarMapping = [[SeekbarMapping alloc] initWithJSON:json_out
+                                                        segmentId:aSegment.segmentId
+                                               sequencerCallCount:javaScriptCallCount
+                                               schedulerCallCount:scheduler.javaScriptCallCount];
+        }
+    }
+}
+
+//
+// get seekbar time from the result of mediaToSeekbarTime and update the current segment boundary
+// if the clip has changed
+//
+// Arguments:
+// [seekTime]: the seekbar time to fill in
+// [policy]: the output ad policy object
+// [result]: the JSON result of mediaToSeekbarTime
+// [aSegment]: the current playback segment
+// [isClipChanged]: YES if the clip of the segment has changed
+// [rangeExceeded]: output boolean indicating if the playback range has been exceeded.
+// [updateMapping]: YES to export the seekbar mapping for the segment
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) getSeekbarTime:(SeekbarTime *)seekTime andPlaybackPolicy:(NSString **)policy fromResult:(NSString *)result currentSegment:(PlaybackSegment *)aSegment isClipChanged:(BOOL)isClipChanged playbackRangeExceeded:(BOOL *)rangeExceeded updateMapping:(BOOL)updateMapping
+{
+    BOOL success = NO;
+    
+    do {
+        NSString *function = nil;
+        
+        NSData* data = [result dataUsingEncoding:[NSString defaultCStringEncoding]];
+        NSError* error = nil;
+        NSDictionary* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
+        NSNumber *nCurrentSeekbarPosition = [json_out objectForKey:@"currentSeekbarPosition"];
+        NSNumber *nMinSeekbarPosition = [json_out objectForKey:@"minSeekbarPosition"];
+        NSNumber *nMaxSeekbarPosition = [json_out objectForKey:@"maxSeekbarPosition"];
+        NSString *nPlaybackPolicy = [json_out objectForKey:@"playbackPolicy"];
+        NSString *nPlaybackRangeExceeded = [json_out objectForKey:@"playbackRangeExceeded"];
+        NSString *nStatus = [json_out objectForKey:@"status"];
+        
+        if ([SequencerStatusDvrTakeover isEqualToString:nStatus])
+        {
+            // The seekbar timer gets this status on every tick until the player is moved back into
+            // the DVR window, so the error is shared instead of created for each call
+            self.lastError = [Sequencer dvrTakeoverError];
+            break;
+        }
+        
+        seekTime.currentSeekbarPosition = [nCurrentSeekbarPosition floatValue];
+        seekTime.minSeekbarPosition = [nMinSeekbarPosition floatValue];
+        seekTime.maxSeekbarPosition = [nMaxSeekbarPosition floatValue];
+        *rangeExceeded = [nPlaybackRangeExceeded boolValue];
+        *policy = nPlaybackPolicy;
+        
+        // Update the current segment boundary if the clip has changed
+        if (isClipChanged)
+        {
+            // We need to update the current segment boundary
+            function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.playbackSegmentPool.getPlaybackSegment(%d).clip.clipBeginMediaTime",
+                         aSegment.segmentId] autorelease];
+            result = [self callJavaScriptWithString:function];
+            if (nil == result)
+            {
+                break;
+            }
+            aSegment.clip.mediaTime.clipBeginMediaTime = [result floatValue];
+            
+            function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.playbackSegmentPool.getPlaybackSegment(%d).clip.clipEndMediaTime",
+                         aSegment.segmentId] autorelease];
+            result = [self callJavaScriptWithString:function];
+            if (nil == result)
+            {
+                break;
+            }
+            aSegment.clip.mediaTime.clipEndMediaTime = [result floatValue];
+        }
+        
+        if (updateMapping)
+        {
+            [self updateSeekbarMappingForSegment:aSegment];
+        }
+        
+        success = YES;
+    } while (NO);
+    
+    return success;
+}
+
+#ifdef ENABLE_SEQUENCER_PLAYLIST_DUMP
+//
+// log the whole sequential playlist. This serializes the entire playlist so it is only
+// compiled in for debugging; use [Scheduler getPlaylistChanges:] to follow the changes otherwise.
+//
+- (void) dumpPlaylist
+{
+    NSString *result = [engineHost evaluateScript:@"PLAYER_SEQUENCER.sequentialPlaylist.testProbe_toJSON()"];
+    NSLog(@"Sequential playlist is %@", result);
+}
+#endif
+
 #pragma mark -
 #pragma mark Notification callbacks:
 
@@ -182,25 +443,38 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
 #pragma mark Public instance methods:
 
 //
-// Constructor for the sequencer
+// Constructor for the sequencer running the scripts in a UIWebView
 //
 // Arguments: none
 //
 // Returns: The sequencer instance.
 //
 - (id) init
+{
+    WebViewEngineHost *webViewHost = [[[WebViewEngineHost alloc] initWithScripts:[Sequencer scriptNames]] autorelease];
+    
+    return [self initWithEngineHost:webViewHost];
+}
+
+//
+// Constructor for the sequencer
+//
+// Arguments:
+// [anEngineHost]: the JavaScript engine host which has loaded the scripts of [Sequencer scriptNames]
+//
+// Returns: The sequencer instance.
+//
+- (id) initWithEngineHost:(id<JavaScriptEngineHost>)anEngineHost
 {
     self = [super init];
     
     if (self){
-        webView = [[UIWebView alloc] init];
-        [webView loadHTMLString:@"<script src=\"Scheduler.js\"></script>"
-         "<script src=\"Sequencer.js\"></script>"
-         "<script src=\"AdResolver.js\"></script>"
-         "<script src=\"SequencerPlugin.js\"></script>" baseURL:[NSURL fileURLWithPath:[[NSBundle mainBundle] resourcePath]]];
-        adResolver = [[AdResolver alloc] initWithUIWebView:webView];
-        scheduler = [[Scheduler alloc] initWithUIWebView:webView];
+        engineHost = [anEngineHost retain];
+        adResolver = [[AdResolver alloc] initWithEngineHost:engineHost];
+        scheduler = [[Scheduler alloc] initWithEngineHost:engineHost];
         lastError = nil;
+        javaScriptCallCount = 0;
+        seekbarMapping = nil;
     }
     
     return self;
@@ -210,7 +484,7 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
 // get seekbar time from media time
 //
 // Arguments:
-// [seekTime]: the output seekbar time
+// [seekTime]: the output seekbar time, which is retained
 // [policy]: the output ad policy object
 // [aMediaTime]: the current playback time in media time
 // [aRate]: the current playback rate
@@ -221,6 +495,35 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
 //
 - (BOOL) getSeekbarTime:(SeekbarTime **)seekTime andPlaybackPolicy:(NSString **)policy withMediaTime:(MediaTime *)aMediaTime playbackRate:(double)aRate currentSegment:(PlaybackSegment *)aSegment playbackRangeExceeded:(BOOL *)rangeExceeded
 {
+    SeekbarTime *value = [[SeekbarTime alloc] init];
+    
+    if (![self updateSeekbarTime:value andPlaybackPolicy:policy withMediaTime:aMediaTime playbackRate:aRate currentSegment:aSegment playbackRangeExceeded:rangeExceeded])
+    {
+        [value release];
+        return NO;
+    }
+    
+    *seekTime = value;
+    return YES;
+}
+
+//
+// get seekbar time from media time into a seekbar time owned by the caller, so the periodic
+// seekbar update does not allocate one for every call
+//
+// Arguments:
+// [seekTime]: the seekbar time to fill in
+// [policy]: the output ad policy object
+// [aMediaTime]: the current playback time in media time
+// [aRate]: the current playback rate
+// [aSegment]: the current playback segment
+// [rangeExceeded]: output boolean indicating if the playback range has been exceeded.
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) updateSeekbarTime:(SeekbarTime *)seekTime andPlaybackPolicy:(NSString **)policy withMediaTime:(MediaTime *)aMediaTime playbackRate:(double)aRate currentSegment:(PlaybackSegment *)aSegment playbackRangeExceeded:(BOOL *)rangeExceeded
+{
+    assert(nil != seekTime);
     assert(nil != rangeExceeded);
     *rangeExceeded = NO;
     BOOL isClipChanged = NO;
@@ -229,6 +532,17 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
     do {
         NSString *result = nil;
         
+        // Use the native seekbar mapping while it is valid so the periodic seekbar update does not call JavaScript
+        if ([seekbarMapping isValidForSegmentId:aSegment.segmentId sequencerCallCount:javaScriptCallCount schedulerCallCount:scheduler.javaScriptCallCount])
+        {
+            if ([seekbarMapping getSeekbarTime:seekTime withPlaybackPosition:aMediaTime.currentPlaybackPosition playbackRate:aRate])
+            {
+                *policy = seekbarMapping.playbackPolicy;
+                success = YES;
+                break;
+            }
+        }
+        
         // Check if the clip has changed
         NSString *function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.playbackSegmentPool.getPlaybackSegment(%d).isClipChanged",
                                aSegment.segmentId] autorelease];
@@ -258,46 +572,7 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
             break;
         }
         
-        NSData* data = [result dataUsingEncoding:[NSString defaultCStringEncoding]];
-        NSError* error = nil;
-        NSDictionary* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
-        NSNumber *nCurrentSeekbarPosition = [json_out objectForKey:@"currentSeekbarPosition"];
-        NSNumber *nMinSeekbarPosition = [json_out objectForKey:@"minSeekbarPosition"];
-        NSNumber *nMaxSeekbarPosition = [json_out objectForKey:@"maxSeekbarPosition"];
-        NSString *nPlaybackPolicy = [json_out objectForKey:@"playbackPolicy"];
-        NSString *nPlaybackRangeExceeded = [json_out objectForKey:@"playbackRangeExceeded"];
-        
-        (*seekTime) = [[SeekbarTime alloc] init];
-        (*seekTime).currentSeekbarPosition = [nCurrentSeekbarPosition floatValue];
-        (*seekTime).minSeekbarPosition = [nMinSeekbarPosition floatValue];
-        (*seekTime).maxSeekbarPosition = [nMaxSeekbarPosition floatValue];
-        *rangeExceeded = [nPlaybackRangeExceeded boolValue];
-        *policy = nPlaybackPolicy;
-        
-        // Update the current segment boundary if the clip has changed
-        if (isClipChanged)
-        {
-            // We need to update the current segment boundary
-            function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.playbackSegmentPool.getPlaybackSegment(%d).clip.clipBeginMediaTime",
-                         aSegment.segmentId] autorelease];
-            result = [self callJavaScriptWithString:function];
-            if (nil == result)
-            {
-                break;
-            }
-            aSegment.clip.mediaTime.clipBeginMediaTime = [result floatValue];
-            
-            function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.playbackSegmentPool.getPlaybackSegment(%d).clip.clipEndMediaTime",
-                         aSegment.segmentId] autorelease];
-            result = [self callJavaScriptWithString:function];
-            if (nil == result)
-            {
-                break;
-            }
-            aSegment.clip.mediaTime.clipEndMediaTime = [result floatValue];
-        }
-        
-        success = YES;
+        success = [self getSeekbarTime:seekTime andPlaybackPolicy:policy fromResult:result currentSegment:aSegment isClipChanged:isClipChanged playbackRangeExceeded:rangeExceeded updateMapping:YES];
     } while (NO);
     
     return success;
@@ -307,7 +582,7 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
 // get seekbar time from media time
 //
 // Arguments:
-// [seekTime]: the output seekbar time
+// [seekTime]: the output seekbar time, which is retained
 // [policy]: the output ad policy object
 // [aMediaTime]: the current playback time in media time
 // [aRate]: the current playback rate
@@ -321,6 +596,37 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
 //
 - (BOOL) getSeekbarTime:(SeekbarTime **)seekTime andPlaybackPolicy:(NSString **)policy withMediaTime:(MediaTime *)aMediaTime playbackRate:(double)aRate currentSegment:(PlaybackSegment *)aSegment playbackRangeExceeded:(BOOL *)rangeExceeded leftDvrEdge:(NSTimeInterval)leftDvrEdge livePosition:(NSTimeInterval)livePosition liveEnded:(BOOL)liveEnded
 {
+    SeekbarTime *value = [[SeekbarTime alloc] init];
+    
+    if (![self updateSeekbarTime:value andPlaybackPolicy:policy withMediaTime:aMediaTime playbackRate:aRate currentSegment:aSegment playbackRangeExceeded:rangeExceeded leftDvrEdge:leftDvrEdge livePosition:livePosition liveEnded:liveEnded])
+    {
+        [value release];
+        return NO;
+    }
+    
+    *seekTime = value;
+    return YES;
+}
+
+//
+// get seekbar time from media time into a seekbar time owned by the caller
+//
+// Arguments:
+// [seekTime]: the seekbar time to fill in
+// [policy]: the output ad policy object
+// [aMediaTime]: the current playback time in media time
+// [aRate]: the current playback rate
+// [aSegment]: the current playback segment
+// [rangeExceeded]: output boolean indicating if the playback range has been exceeded.
+// [leftDvrEdge]: the left edge of the DVR window in media time
+// [livePosition]: the live position in media time
+// [liveEnded]: YES if the live presentation ended
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) updateSeekbarTime:(SeekbarTime *)seekTime andPlaybackPolicy:(NSString **)policy withMediaTime:(MediaTime *)aMediaTime playbackRate:(double)aRate currentSegment:(PlaybackSegment *)aSegment playbackRangeExceeded:(BOOL *)rangeExceeded leftDvrEdge:(NSTimeInterval)leftDvrEdge livePosition:(NSTimeInterval)livePosition liveEnded:(BOOL)liveEnded
+{
+    assert(nil != seekTime);
     assert(nil != rangeExceeded);
     *rangeExceeded = NO;
     BOOL isClipChanged = NO;
@@ -329,6 +635,18 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
     do {
         NSString *result = nil;
         
+        // Use the native seekbar mapping while it is valid so the periodic seekbar update does not call JavaScript
+        if (!liveEnded &&
+            [seekbarMapping isValidForSegmentId:aSegment.segmentId sequencerCallCount:javaScriptCallCount schedulerCallCount:scheduler.javaScriptCallCount])
+        {
+            if ([seekbarMapping getSeekbarTime:seekTime withPlaybackPosition:aMediaTime.currentPlaybackPosition playbackRate:aRate leftDvrEdge:leftDvrEdge livePosition:livePosition])
+            {
+                *policy = seekbarMapping.playbackPolicy;
+                success = YES;
+                break;
+            }
+        }
+        
         // Check if the clip has changed
         NSString *function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.playbackSegmentPool.getPlaybackSegment(%d).isClipChanged",
                                aSegment.segmentId] autorelease];
@@ -364,46 +682,7 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
             break;
         }
         
-        NSData* data = [result dataUsingEncoding:[NSString defaultCStringEncoding]];
-        NSError* error = nil;
-        NSDictionary* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
-        NSNumber *nCurrentSeekbarPosition = [json_out objectForKey:@"currentSeekbarPosition"];
-        NSNumber *nMinSeekbarPosition = [json_out objectForKey:@"minSeekbarPosition"];
-        NSNumber *nMaxSeekbarPosition = [json_out objectForKey:@"maxSeekbarPosition"];
-        NSString *nPlaybackPolicy = [json_out objectForKey:@"playbackPolicy"];
-        NSString *nPlaybackRangeExceeded = [json_out objectForKey:@"playbackRangeExceeded"];
-        
-        (*seekTime) = [[SeekbarTime alloc] init];
-        (*seekTime).currentSeekbarPosition = [nCurrentSeekbarPosition floatValue];
-        (*seekTime).minSeekbarPosition = [nMinSeekbarPosition floatValue];
-        (*seekTime).maxSeekbarPosition = [nMaxSeekbarPosition floatValue];
-        *rangeExceeded = [nPlaybackRangeExceeded boolValue];
-        *policy = nPlaybackPolicy;
-        
-        // Update the current segment boundary if the clip has changed
-        if (isClipChanged)
-        {
-            // We need to update the current segment boundary
-            function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.playbackSegmentPool.getPlaybackSegment(%d).clip.clipBeginMediaTime",
-                         aSegment.segmentId] autorelease];
-            result = [self callJavaScriptWithString:function];
-            if (nil == result)
-            {
-                break;
-            }
-            aSegment.clip.mediaTime.clipBeginMediaTime = [result floatValue];
-            
-            function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.playbackSegmentPool.getPlaybackSegment(%d).clip.clipEndMediaTime",
-                         aSegment.segmentId] autorelease];
-            result = [self callJavaScriptWithString:function];
-            if (nil == result)
-            {
-                break;
-            }
-            aSegment.clip.mediaTime.clipEndMediaTime = [result floatValue];
-        }
-        
-        success = YES;
+        success = [self getSeekbarTime:seekTime andPlaybackPolicy:policy fromResult:result currentSegment:aSegment isClipChanged:isClipChanged playbackRangeExceeded:rangeExceeded updateMapping:!liveEnded];
     } while (NO);
     
     return success;
@@ -459,12 +738,12 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
                           "\\\"params\\\": { \\\"linearSeekPosition\\\": %f } }\")",
                           linearSeekPosition] autorelease];
     result = [self callJavaScriptWithString:function];    
-    if (nil != result && ![result isEqualToString:@"null"])
+    if (nil == result)
     {
-        *seekSegment = [self parseJSONPlaybackSegment:result];
+        return NO;
     }
     
-    return (nil != result);
+    return [self parseJSONSeekResult:result segment:seekSegment function:@"seekFromLinearPosition"];
 }
 
 //
@@ -487,18 +766,18 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
                            "\"{\\\"func\\\": \\\"seekFromLinearPosition\\\", "
                            "\\\"params\\\": "
                            "{ \\\"linearSeekPosition\\\": %f, "
-                           "{ \\\"leftDvrEdge\\\": %f, "
+                           "\\\"leftDvrEdge\\\": %f, "
                            "\\\"livePosition\\\": %f } }\")",
                            linearSeekPosition,
                            leftDvrEdge,
                            livePosition] autorelease];
     result = [self callJavaScriptWithString:function];
-    if (nil != result && ![result isEqualToString:@"null"])
+    if (nil == result)
     {
-        *seekSegment = [self parseJSONPlaybackSegment:result];
+        return NO;
     }
     
-    return (nil != result);
+    return [self parseJSONSeekResult:result segment:seekSegment function:@"seekFromLinearPosition"];
 }
 
 //
@@ -523,12 +802,12 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
                            seekbarPosition.currentSeekbarPosition,
                            aSegment.segmentId] autorelease];
     result = [self callJavaScriptWithString:function];
-    if (nil != result && ![result isEqualToString:@"null"])
+    if (nil == result)
     {
-        *seekSegment = [self parseJSONPlaybackSegment:result];
+        return NO;
     }
     
-    return (nil != result);
+    return [self parseJSONSeekResult:result segment:seekSegment function:@"seekFromSeekbarPosition"];
 }
 
 //
@@ -566,9 +845,9 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
         *nextSegment = [self parseJSONPlaybackSegment:result];
     }
     
-    // Dump the playlist
-    function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.sequentialPlaylist.testProbe_toJSON()"] autorelease];
-    [self callJavaScriptWithString:function];
+#ifdef ENABLE_SEQUENCER_PLAYLIST_DUMP
+    [self dumpPlaylist];
+#endif
 
     return (nil != result);    
 }
@@ -607,6 +886,58 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
     return (nil != result);
 }
 
+//
+// look ahead of the current playback segment for the segments to be played next, without
+// creating playback segments in the sequencer. The segments only describe the upcoming
+// playlist entries: their segmentId is 0 and they can not be passed back to the sequencer.
+//
+// Arguments:
+// [segments]: the output array of PlaybackSegment in playback order, empty at the end of the playlist
+// [currentSegment]: the current playback segment
+// [playbackRate]: the current playback rate
+// [count]: the maximum number of segments to look ahead
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) getUpcomingSegments:(NSArray **)segments withCurrentSegment:(PlaybackSegment *)currentSegment currentPlaybackRate:(double)playbackRate count:(int32_t)count
+{
+    assert (nil != segments);
+    NSString *result = nil;
+    *segments = nil;
+    
+    NSString *function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.sequencerPluginChain.runJSON("
+                           "\"{\\\"func\\\": \\\"getUpcomingSegments\\\", "
+                           "\\\"params\\\": "
+                           "{ \\\"currentSegmentId\\\": %d, "
+                           "\\\"currentPlaybackRate\\\": %f, "
+                           "\\\"count\\\": %d } }\")",
+                           currentSegment.segmentId,
+                           playbackRate,
+                           count] autorelease];
+    result = [self callJavaScriptWithString:function];
+    if (nil != result)
+    {
+        NSData* data = [result dataUsingEncoding:[NSString defaultCStringEncoding]];
+        NSError* error = nil;
+        NSDictionary* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
+        NSArray *nSegments = [json_out objectForKey:@"segments"];
+        NSMutableArray *upcomingSegments = [NSMutableArray arrayWithCapacity:[nSegments count]];
+        
+        for (NSDictionary *nSegment in nSegments)
+        {
+            PlaybackSegment *segment = [self parsePlaybackSegment:nSegment];
+            if (nil != segment)
+            {
+                [upcomingSegments addObject:segment];
+                [segment release];
+            }
+        }
+        *segments = upcomingSegments;
+    }
+    
+    return (nil != result);
+}
+
 //
 // get the next segment after the current playlist entry has an error
 //
@@ -645,13 +976,51 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
         *nextSegment = [self parseJSONPlaybackSegment:result];
     }
     
-    // Dump the playlist
-    function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.sequentialPlaylist.testProbe_toJSON()"] autorelease];
-    [self callJavaScriptWithString:function];
+#ifdef ENABLE_SEQUENCER_PLAYLIST_DUMP
+    [self dumpPlaylist];
+#endif
     
     return (nil != result);
 }
 
+//
+// publish the live window tracked from the live playlist refreshes to the sequencer plugin chain
+//
+// Arguments:
+// [leftDvrEdge]: the left edge of the DVR window in media time
+// [livePosition]: the live position in media time
+// [leftDvrEdgeRate]: the rate of change of the left DVR edge in seconds per second
+// [livePositionRate]: the rate of change of the live position in seconds per second
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) updateLiveWindowWithLeftDvrEdge:(NSTimeInterval)leftDvrEdge livePosition:(NSTimeInterval)livePosition leftDvrEdgeRate:(double)leftDvrEdgeRate livePositionRate:(double)livePositionRate
+{
+    NSString *function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.sequencerPluginChain.runJSON("
+                           "\"{\\\"func\\\": \\\"updateLiveWindow\\\", "
+                           "\\\"params\\\": "
+                           "{ \\\"leftDvrEdge\\\": %f, "
+                           "\\\"livePosition\\\": %f, "
+                           "\\\"leftDvrEdgeRate\\\": %f, "
+                           "\\\"livePositionRate\\\": %f } }\")",
+                           leftDvrEdge,
+                           livePosition,
+                           leftDvrEdgeRate,
+                           livePositionRate] autorelease];
+    
+    // The live window does not change the playback segments or the sequential playlist, so unlike
+    // callJavaScriptWithString this keeps the seekbar mapping valid
+    SEQUENCER_LOG(@"JavaScript call: %s", [function cStringUsingEncoding:NSUTF8StringEncoding]);
+    NSString *result = [engineHost evaluateScript:function];
+    NSError *error = [Sequencer parseJSONException:result];
+    if (nil != error)
+    {
+        self.lastError = error;
+    }
+    
+    return (nil == error);
+}
+
 #pragma mark -
 #pragma mark Properties:
 
@@ -662,7 +1031,7 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
     
     function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.playbackSegmentPool.testProbe_toJSON()"] autorelease];
     SEQUENCER_LOG(@"JavaScript call: %s", [function cStringUsingEncoding:NSUTF8StringEncoding]);
-    result = [webView stringByEvaluatingJavaScriptFromString:function];
+    result = [engineHost evaluateScript:function];
     
     SEQUENCER_LOG(@"JavaScript result is %@", result);
     
@@ -673,7 +1042,7 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
                      "\\\"params\\\": "
                      "{ \\\"checkLoad\\\": true } }\")"] autorelease];
         SEQUENCER_LOG(@"JavaScript call: %s", [function cStringUsingEncoding:NSUTF8StringEncoding]);
-        result = [webView stringByEvaluatingJavaScriptFromString:function];
+        result = [engineHost evaluateScript:function];
         
         SEQUENCER_LOG(@"JavaScript result is %@", result);
     }
@@ -691,6 +1060,8 @@ NSString * const SequencerUnexpectedError = @"PLAYER_SEQUENCER:UnexpectedError";
     [adResolver release];
     [scheduler release];
     [lastError release];
+    [seekbarMapping release];
+    [engineHost release];
     
     [super dealloc];
 }
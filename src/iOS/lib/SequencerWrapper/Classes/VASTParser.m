@@ -47,12 +47,21 @@
     return (NSTimeInterval)(([[hmsArray objectAtIndex:0] intValue] * 60 + [[hmsArray objectAtIndex:1] intValue]) * 60 + [[hmsArray objectAtIndex:2] floatValue]);
 }
 
-- (NSArray *) parseJSONAdList:(NSString *)jsonResult
+- (NSArray *) jsonArrayFromString:(NSString *)jsonResult
 {
     NSData* data = [jsonResult dataUsingEncoding:[NSString defaultCStringEncoding]];
     NSError* error = nil;
-    NSMutableArray* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
-    if (nil == json_out)
+    return [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
+}
+
+- (NSArray *) parseJSONAdList:(NSString *)jsonResult
+{
+    return [self adListFromJSON:[self jsonArrayFromString:jsonResult]];
+}
+
+- (NSArray *) adListFromJSON:(NSArray *)json_out
+{
+    if (![json_out isKindOfClass:[NSArray class]])
     {
         return nil;
     }
@@ -157,10 +166,12 @@
 
 - (NSArray *) parseJSONCreativeList:(NSString *)jsonResult
 {
-    NSData* data = [jsonResult dataUsingEncoding:[NSString defaultCStringEncoding]];
-    NSError* error = nil;
-    NSMutableArray* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
-    if (nil == json_out)
+    return [self creativeListFromJSON:[self jsonArrayFromString:jsonResult]];
+}
+
+- (NSArray *) creativeListFromJSON:(NSArray *)json_out
+{
+    if (![json_out isKindOfClass:[NSArray class]])
     {
         return nil;
     }
@@ -294,10 +305,12 @@
 
 - (NSArray *) parseJSONLinearTrackingEventsList:(NSString *)jsonResult
 {
-    NSData* data = [jsonResult dataUsingEncoding:[NSString defaultCStringEncoding]];
-    NSError* error = nil;
-    NSMutableArray* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
-    if (nil == json_out)
+    return [self linearTrackingEventsListFromJSON:[self jsonArrayFromString:jsonResult]];
+}
+
+- (NSArray *) linearTrackingEventsListFromJSON:(NSArray *)json_out
+{
+    if (![json_out isKindOfClass:[NSArray class]])
     {
         return nil;
     }
@@ -322,10 +335,12 @@
 
 - (NSArray *) parseJSONVideoClicksList:(NSString *)jsonResult
 {
-    NSData* data = [jsonResult dataUsingEncoding:[NSString defaultCStringEncoding]];
-    NSError* error = nil;
-    NSMutableArray* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
-    if (nil == json_out)
+    return [self videoClicksListFromJSON:[self jsonArrayFromString:jsonResult]];
+}
+
+- (NSArray *) videoClicksListFromJSON:(NSArray *)json_out
+{
+    if (![json_out isKindOfClass:[NSArray class]])
     {
         return nil;
     }
@@ -363,10 +378,12 @@
 
 - (NSArray *) parseJSONIconsList:(NSString *)jsonResult
 {
-    NSData* data = [jsonResult dataUsingEncoding:[NSString defaultCStringEncoding]];
-    NSError* error = nil;
-    NSMutableArray* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
-    if (nil == json_out)
+    return [self iconsListFromJSON:[self jsonArrayFromString:jsonResult]];
+}
+
+- (NSArray *) iconsListFromJSON:(NSArray *)json_out
+{
+    if (![json_out isKindOfClass:[NSArray class]])
     {
         return nil;
     }
@@ -426,10 +443,12 @@
 
 - (NSArray *) parseJSONMediaFileList:(NSString *)jsonResult
 {
-    NSData* data = [jsonResult dataUsingEncoding:[NSString defaultCStringEncoding]];
-    NSError* error = nil;
-    NSMutableArray* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
-    if (nil == json_out)
+    return [self mediaFileListFromJSON:[self jsonArrayFromString:jsonResult]];
+}
+
+- (NSArray *) mediaFileListFromJSON:(NSArray *)json_out
+{
+    if (![json_out isKindOfClass:[NSArray class]])
     {
         return nil;
     }
@@ -465,10 +484,12 @@
 
 - (NSArray *) parseJSONCompanionAdsList:(NSString *)jsonResult
 {
-    NSData* data = [jsonResult dataUsingEncoding:[NSString defaultCStringEncoding]];
-    NSError* error = nil;
-    NSMutableArray* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
-    if (nil == json_out)
+    return [self companionAdsListFromJSON:[self jsonArrayFromString:jsonResult]];
+}
+
+- (NSArray *) companionAdsListFromJSON:(NSArray *)json_out
+{
+    if (![json_out isKindOfClass:[NSArray class]])
     {
         return nil;
     }
@@ -530,10 +551,12 @@
 
 - (NSArray *) parseJSONNonLinearAdsList:(NSString *)jsonResult
 {
-    NSData* data = [jsonResult dataUsingEncoding:[NSString defaultCStringEncoding]];
-    NSError* error = nil;
-    NSMutableArray* json_out = [NSJSONSerialization JSONObjectWithData:data options:kNilOptions error:&error];
-    if (nil == json_out)
+    return [self nonLinearAdsListFromJSON:[self jsonArrayFromString:jsonResult]];
+}
+
+- (NSArray *) nonLinearAdsListFromJSON:(NSArray *)json_out
+{
+    if (![json_out isKindOfClass:[NSArray class]])
     {
         return nil;
     }
@@ -574,10 +597,76 @@
     return adsList;
 }
 
+- (CompositeElement *) expandedElement:(CompositeElement *)element withName:(NSString *)name elementList:(NSArray *)elementList
+{
+    if (nil == element)
+    {
+        element = [[[CompositeElement alloc] init] autorelease];
+        element.name = name;
+        element.elementCount = [elementList count];
+    }
+    element.expanded = YES;
+    element.elementList = elementList;
+    
+    return element;
+}
+
+- (NSArray *) parseJSONAdTree:(NSString *)jsonResult
+{
+    NSArray *json_out = [self jsonArrayFromString:jsonResult];
+    NSArray *adList = [self adListFromJSON:json_out];
+    
+    for (NSUInteger adIndex = 0; adIndex < [adList count]; ++adIndex)
+    {
+        Ad *ad = [adList objectAtIndex:adIndex];
+        NSArray *nCreatives = [[json_out objectAtIndex:adIndex] objectForKey:@"creatives"];
+        NSArray *creativeList = [self creativeListFromJSON:nCreatives];
+        if (nil == creativeList)
+        {
+            continue;
+        }
+        ad.creatives = [self expandedElement:ad.creatives withName:@"Creatives" elementList:creativeList];
+        
+        for (NSUInteger creativeIndex = 0; creativeIndex < [creativeList count]; ++creativeIndex)
+        {
+            Creative *creative = [creativeList objectAtIndex:creativeIndex];
+            NSDictionary *nCreative = [nCreatives objectAtIndex:creativeIndex];
+            switch (creative.type)
+            {
+                case Linear:
+                    creative.mediaFiles = [self expandedElement:creative.mediaFiles withName:@"MediaFiles"
+                                                    elementList:[self mediaFileListFromJSON:[nCreative objectForKey:@"mediaFiles"]]];
+                    creative.trackingEvents = [self expandedElement:creative.trackingEvents withName:@"TrackingEvents"
+                                                        elementList:[self linearTrackingEventsListFromJSON:[nCreative objectForKey:@"trackingEvents"]]];
+                    creative.videoClicks = [self expandedElement:creative.videoClicks withName:@"VideoClicks"
+                                                     elementList:[self videoClicksListFromJSON:[nCreative objectForKey:@"videoClicks"]]];
+                    creative.icons = [self expandedElement:creative.icons withName:@"Icons"
+                                               elementList:[self iconsListFromJSON:[nCreative objectForKey:@"icons"]]];
+                    break;
+                    
+                case CompanionAds:
+                    creative.companion = [self expandedElement:creative.companion withName:@"Companion"
+                                                   elementList:[self companionAdsListFromJSON:[nCreative objectForKey:@"companionAds"]]];
+                    break;
+                    
+                case NonlinearAds:
+                    creative.nonlinear = [self expandedElement:creative.nonlinear withName:@"Nonlinear"
+                                                   elementList:[self nonLinearAdsListFromJSON:[nCreative objectForKey:@"nonLinearAds"]]];
+                    break;
+                    
+                default:
+                    break;
+            }
+        }
+    }
+    
+    return adList;
+}
+
 - (NSString *) callJavaScriptWithString:(NSString *)aString
 {
     SEQUENCER_LOG(@"JavaScript call: %s", [aString cStringUsingEncoding:NSUTF8StringEncoding]);
-    NSString *result = [webView stringByEvaluatingJavaScriptFromString:aString];
+    NSString *result = [engineHost evaluateScript:aString];
     
     SEQUENCER_LOG(@"JavaScript result is %@", result);
     
@@ -598,12 +687,12 @@
 #pragma mark -
 #pragma mark Public instance methods:
 
-- (id) initWithUIWebView:(UIWebView *)aWebView
+- (id) initWithEngineHost:(id<JavaScriptEngineHost>)anEngineHost
 {
     self = [super init];
     
     if (self){
-        webView = aWebView;
+        engineHost = anEngineHost;
     }
     
     return self;
@@ -924,6 +1013,36 @@
     return (nil != result);
 }
 
+//
+// get the Ad list from the VAST entry with all the creatives and their lists expanded.
+// This takes a single JavaScript call instead of one call per Ad and per Creative list.
+//
+// Arguments:
+// [adList]: the output list of the Ad elements in the VAST entry. The creatives of each Ad
+// and the media files, tracking events, video clicks, icons, companion and nonlinear ads
+// of each Creative have expanded set to YES and the objects in elementList.
+// [entryId]: the entry Id of VAST entry
+//
+// Returns: YES for success and NO for failure
+//
+- (BOOL) resolveAllAds:(NSArray **)adList withEntryId:(int32_t)entryId
+{
+    NSString *result = nil;
+    *adList = nil;
+    
+    NSString *function = [[[NSString alloc] initWithFormat:@"PLAYER_SEQUENCER.theAdResolver.runJSON("
+                           "\"{\\\"func\\\": \\\"vast.resolveAll\\\", "
+                           "\\\"params\\\": { \\\"entryId\\\": %d } }\")",
+                           entryId] autorelease];
+    result = [self callJavaScriptWithString:function];
+    if (nil != result && ![result isEqualToString:@"null"])
+    {
+        *adList = [self parseJSONAdTree:result];
+    }
+    
+    return (nil != result);
+}
+
 #pragma mark -
 #pragma mark Properties:
 
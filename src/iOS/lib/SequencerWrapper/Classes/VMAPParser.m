@@ -195,7 +195,7 @@
 - (NSString *) callJavaScriptWithString:(NSString *)aString
 {
     SEQUENCER_LOG(@"JavaScript call: %s", [aString cStringUsingEncoding:NSUTF8StringEncoding]);
-    NSString *result = [webView stringByEvaluatingJavaScriptFromString:aString];
+    NSString *result = [engineHost evaluateScript:aString];
     
     SEQUENCER_LOG(@"JavaScript result is %@", result);
     
@@ -216,12 +216,12 @@
 #pragma mark -
 #pragma mark Public instance methods:
 
-- (id) initWithUIWebView:(UIWebView *)aWebView
+- (id) initWithEngineHost:(id<JavaScriptEngineHost>)anEngineHost
 {
     self = [super init];
     
     if (self){
-        webView = aWebView;
+        engineHost = anEngineHost;
     }
     
     return self;
@@ -0,0 +1,97 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "WebViewEngineHost.h"
+#import "Trace.h"
+
+@implementation WebViewEngineHost
+
+#pragma mark -
+#pragma mark Properties:
+
+@synthesize evaluationCount;
+@synthesize evaluationTime;
+
+- (BOOL) requiresMainThread
+{
+    // UIWebView can only be used on the main thread
+    return YES;
+}
+
+#pragma mark -
+#pragma mark Public instance methods:
+
+//
+// Constructor for the UIWebView engine host
+//
+// Arguments:
+// [scriptNames]: the names of the script files in the main bundle to load, in loading order
+//
+// Returns: The engine host instance. The scripts are loaded asynchronously by the web view.
+//
+- (id) initWithScripts:(NSArray *)scriptNames
+{
+    self = [super init];
+    
+    if (self){
+        NSMutableString *html = [NSMutableString string];
+        for (NSString *scriptName in scriptNames)
+        {
+            [html appendFormat:@"<script src=\"%@\"></script>", scriptName];
+        }
+        
+        webView = [[UIWebView alloc] init];
+        [webView loadHTMLString:html baseURL:[NSURL fileURLWithPath:[[NSBundle mainBundle] resourcePath]]];
+        evaluationCount = 0;
+        evaluationTime = 0;
+    }
+    
+    return self;
+}
+
+//
+// evaluate a script in the web view
+//
+// Arguments:
+// [script]: the script to evaluate
+//
+// Returns: the result of the script converted to a string
+//
+- (NSString *) evaluateScript:(NSString *)script
+{
+    CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+    NSString *result = [webView stringByEvaluatingJavaScriptFromString:script];
+    NSTimeInterval elapsed = CFAbsoluteTimeGetCurrent() - startTime;
+    
+    evaluationCount++;
+    evaluationTime += elapsed;
+    SEQUENCER_LOG(@"JavaScript evaluation took %f ms", elapsed * 1000);
+    
+    return result;
+}
+
+#pragma mark -
+#pragma mark Destructor:
+
+- (void) dealloc
+{
+    SEQUENCER_LOG(@"WebViewEngineHost dealloc called.");
+    
+    [webView release];
+    
+    [super dealloc];
+}
+
+@end
@@ -0,0 +1,35 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import "ManifestDownloadManager.h"
+
+@interface ManifestDownloadRequest(_internal)
+
+- (id) initWithManager:(ManifestDownloadManager *)aManager url:(NSURL *)aUrl priority:(ManifestDownloadPriority)aPriority timeout:(NSTimeInterval)aTimeout deadline:(CFAbsoluteTime)aDeadline cacheUsage:(ManifestDownloadCacheUsage)aCacheUsage order:(uint64_t)anOrder completionQueue:(dispatch_queue_t)aQueue completion:(ManifestDownloadCompletionHandler)aCompletion;
+- (NSString *) hostKey;
+- (NSComparisonResult) compareForStart:(ManifestDownloadRequest *)other;
+- (void) setCachedEntry:(ManifestCacheEntry *)entry;
+- (BOOL) startWithDelegateQueue:(NSOperationQueue *)queue;
+- (void) deliverManifest:(NSString *)manifest error:(NSError *)error;
+- (void) finishWithManifest:(NSString *)manifest error:(NSError *)error;
+
+@end
+
+@interface ManifestDownloadManager(_internal)
+
+- (void) requestDidFinish:(ManifestDownloadRequest *)request withManifest:(NSString *)manifest error:(NSError *)error;
+- (void) cancelRequest:(ManifestDownloadRequest *)request withErrorCode:(NSInteger)code;
+
+@end
@@ -17,7 +17,9 @@
 
 @interface Scheduler(_internal)
 
-- (id) initWithUIWebView:(UIWebView *)aWebView;
+@property(nonatomic, readonly) uint32_t javaScriptCallCount;
+
+- (id) initWithEngineHost:(id<JavaScriptEngineHost>)anEngineHost;
 
 @end
 
@@ -0,0 +1,50 @@
+// ----------------------------------------------------------------------------
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// ----------------------------------------------------------------------------
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// THIS CODE IS PROVIDED *AS IS* BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED,
+// INCLUDING WITHOUT LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE,
+// FITNESS FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "SeekbarTime.h"
+
+//
+// Native copy of the media to seekbar time mapping exported by the sequencer plugin chain
+// for one playback segment. The mapping is valid until the segment changes, the Sequencer calls
+// into JavaScript again or the Scheduler makes a call that may change the playlist. The read-only
+// range queries of the Scheduler keep the mapping.
+//
+@interface SeekbarMapping : NSObject
+{
+@private
+    int32_t segmentId;
+    uint32_t sequencerCallCount;
+    uint32_t schedulerCallCount;
+    NSTimeInterval seekbarOffset;
+    NSTimeInterval minSeekbarPosition;
+    NSTimeInterval maxSeekbarPosition;
+    BOOL isClampedToRange;
+    NSString *playbackPolicy;
+    NSTimeInterval clipBeginMediaTime;
+    NSTimeInterval clipEndMediaTime;
+    BOOL isLiveWindowApplied;
+}
+
+@property(nonatomic, readonly) int32_t segmentId;
+@property(nonatomic, readonly) NSString *playbackPolicy;
+
+- (id) initWithJSON:(NSDictionary *)json segmentId:(int32_t)aSegmentId sequencerCallCount:(uint32_t)aSequencerCallCount schedulerCallCount:(uint32_t)aSchedulerCallCount;
+- (BOOL) isValidForSegmentId:(int32_t)aSegmentId sequencerCallCount:(uint32_t)aSequencerCallCount schedulerCallCount:(uint32_t)aSchedulerCallCount;
+- (BOOL) getSeekbarTime:(SeekbarTime *)seekTime withPlaybackPosition:(NSTimeInterval)position playbackRate:(double)rate;
+- (BOOL) getSeekbarTime:(SeekbarTime *)seekTime withPlaybackPosition:(NSTimeInterval)position playbackRate:(double)rate leftDvrEdge:(NSTimeInterval)leftDvrEdge livePosition:(NSTimeInterval)livePosition;
+
+@end
@@ -18,6 +18,7 @@
 @interface Sequencer(_internal)
 
 + (NSError *) parseJSONException:(NSString *)jsonResult;
++ (NSError *) errorWithStatus:(NSString *)status reason:(NSString *)reason;
 + (NSString *) jsonStringFromXmlString:(NSString *)xmlString;
 
 @end
@@ -17,7 +17,7 @@
 
 @interface VASTParser(_internal)
 
-- (id) initWithUIWebView:(UIWebView *)aWebView;
+- (id) initWithEngineHost:(id<JavaScriptEngineHost>)anEngineHost;
 
 @end
 
@@ -17,7 +17,7 @@
 
 @interface VMAPParser(_internal)
 
-- (id) initWithUIWebView:(UIWebView *)aWebView;
+- (id) initWithEngineHost:(id<JavaScriptEngineHost>)anEngineHost;
 
 @end
 